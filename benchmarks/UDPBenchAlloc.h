@@ -0,0 +1,20 @@
+#pragma once
+
+// UDPBenchAlloc - process-wide counts of operator new calls, from a
+// replacement of the global allocation functions linked into the benchmark.
+// Direct malloc() calls are not seen.
+
+#include <cstdint>
+
+namespace udpdirect {
+namespace bench {
+
+struct BenchAllocations {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+
+BenchAllocations allocationSnapshot();
+
+} // namespace bench
+} // namespace udpdirect
@@ -0,0 +1,179 @@
+#include "UDPBenchHarness.h"
+
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+
+namespace udpdirect {
+namespace bench {
+
+// Upper bound on one poll() wait, so stop() is noticed
+static const int kPollTimeoutMs = 20;
+
+BenchReceiver::BenchReceiver(std::shared_ptr<UDPBufferPool> pool, std::shared_ptr<UDPSocketStats> stats,
+                             BenchCallInvoker& invoker, BenchRuntime& runtime, const BenchReceiverConfig& config)
+    : pool_(pool),
+      invoker_(invoker),
+      runtime_(runtime),
+      config_(config),
+      batchIO_(pool),
+      pipeline_(std::move(stats), nullptr, config.trace),
+      ring_(std::make_shared<UDPPacketRing>(pool, config.ringCapacity)) {
+    if (config_.batched) {
+        batcher_ = std::make_shared<UDPMessageBatcher>(config_.batch, pool);
+    }
+}
+
+BenchReceiver::~BenchReceiver() {
+    stop();
+    // Queued drains reference this receiver
+    invoker_.flush();
+}
+
+void BenchReceiver::start(uint32_t socketId, int fd) {
+    socketId_ = socketId;
+    fd_ = fd;
+    stopping_ = false;
+    thread_ = std::thread([this] { readLoop(); });
+}
+
+void BenchReceiver::stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    stopping_ = true;
+    thread_.join();
+    if (batcher_ && !batcher_->empty()) {
+        flushBatch();
+    }
+    batchIO_.releaseReserve();
+}
+
+BenchReceiverStats BenchReceiver::stats() const {
+    UDPBatchIOStats io = batchIO_.stats();
+    BenchReceiverStats stats;
+    stats.polls = polls_.load(std::memory_order_relaxed);
+    stats.receiveSyscalls = io.receiveSyscalls;
+    stats.receivedPackets = io.receivedPackets;
+    stats.poolDrops = io.dropped + injectDrops_.load(std::memory_order_relaxed);
+    stats.ringDrops = ring_->droppedTotal();
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void BenchReceiver::readLoop() {
+    struct pollfd entry = {fd_, POLLIN, 0};
+    while (!stopping_.load(std::memory_order_relaxed)) {
+        int timeoutMs = kPollTimeoutMs;
+        if (batchDeadlineNs_ != 0) {
+            uint64_t nowNs = UDPMonotonicNowNs();
+            if (nowNs >= batchDeadlineNs_) {
+                flushBatch();
+                continue;
+            }
+            timeoutMs = (int)((batchDeadlineNs_ - nowNs + 999999) / 1000000);
+        }
+        polls_.fetch_add(1, std::memory_order_relaxed);
+        int ready = poll(&entry, 1, timeoutMs);
+        if (ready > 0 && (entry.revents & POLLIN)) {
+            drain();
+        }
+    }
+}
+
+// Mirrors drainBatchReceiveOnFD: bounded rounds of full batches per wake-up
+void BenchReceiver::drain() {
+    UDPReceivedDatagram datagrams[UDPBatchIO::kMaxBatch];
+    UDPReceiveContext context = pipeline_.context(socketId_);
+
+    for (int round = 0; round < kMaxRounds; round++) {
+        int receiveErrno = 0;
+        size_t received = batchIO_.receive(fd_, config_.slotSize, datagrams, UDPBatchIO::kMaxBatch, receiveErrno);
+        for (size_t i = 0; i < received; i++) {
+            UDPBufferSlot& slot = datagrams[i].slot;
+            size_t length = slot.length;
+            uint32_t route = 0;
+            std::shared_ptr<std::vector<uint8_t>> message;
+            if (pipeline_.process(context, slot.data, length, datagrams[i].source, route, message) ==
+                UDPReceiveVerdict::Deliver) {
+                slot.length = (uint32_t)length;
+                deliver(slot, datagrams[i].source, route, datagrams[i].kernelTimestampNs);
+            } else {
+                pool_->release(slot);
+            }
+        }
+        if (receiveErrno == ENOBUFS) {
+            pipeline_.countDrop(context, 0);
+        }
+        if (received < UDPBatchIO::kMaxBatch) {
+            break;
+        }
+    }
+}
+
+// Mirrors the didReceiveData: path: filter off the caller's bytes, then one copy into a slot
+bool BenchReceiver::inject(uint32_t socketId, const uint8_t* data, size_t length, const UDPSocketAddress& source) {
+    socketId_ = socketId;
+    UDPReceiveContext context = pipeline_.context(socketId);
+    uint32_t route = 0;
+    std::shared_ptr<std::vector<uint8_t>> message;
+    if (pipeline_.process(context, data, length, source, route, message) != UDPReceiveVerdict::Deliver) {
+        return true;
+    }
+    UDPBufferSlot slot = pool_->acquire(length);
+    if (!slot) {
+        pipeline_.countDrop(context, length);
+        injectDrops_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    memcpy(slot.data, data, length);
+    deliver(slot, source, route, 0);
+    return true;
+}
+
+// Mirrors UDPDirectJSI's onSlotReceived for sockets without routes or polling
+void BenchReceiver::deliver(const UDPBufferSlot& slot, const UDPSocketAddress& source, uint32_t route,
+                            uint64_t kernelNs) {
+    if (batcher_) {
+        auto result = batcher_->append(socketId_, slot, source, UDPMonotonicNowNs());
+        if (result == UDPMessageBatcher::AppendResult::FlushNow) {
+            flushBatch();
+        } else if (result == UDPMessageBatcher::AppendResult::StartTimer) {
+            batchDeadlineNs_ = UDPMonotonicNowNs() + (uint64_t)batcher_->config().maxDelayUs * 1000;
+        }
+        return;
+    }
+
+    UDPPacketDescriptor descriptor;
+    descriptor.slot = slot;
+    descriptor.source = source;
+    descriptor.socketId = socketId_;
+    descriptor.receivedNs = UDPMonotonicNowNs();
+    descriptor.kernelNs = kernelNs;
+    descriptor.route = route;
+    ring_->push(descriptor);
+
+    if (ring_->requestWake()) {
+        // A lone pointer fits std::function's inline storage, so waking does not allocate either
+        invoker_.invokeAsync([this]() {
+            runtime_.drainReceiveRing(*ring_);
+        });
+    }
+}
+
+void BenchReceiver::flushBatch() {
+    batchDeadlineNs_ = 0;
+    if (batcher_->empty()) {
+        return;
+    }
+    std::shared_ptr<UDPMessageBatch> batch = batcher_->take();
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    uint32_t socketId = socketId_;
+    BenchRuntime* runtime = &runtime_;
+    invoker_.invokeAsync([socketId, batch, runtime]() {
+        runtime->deliverBatch(socketId, batch);
+    });
+}
+
+} // namespace bench
+} // namespace udpdirect
@@ -0,0 +1,100 @@
+#pragma once
+
+// UDPBenchHarness - the native receive path as the iOS manager drives it,
+// with a poll() loop in place of the dispatch read source: batched reads,
+// the receive pipeline, then the ring and a JS-thread drain through the
+// stand-in CallInvoker, or the message batcher for batching sockets.
+
+#include "UDPBatchIO.h"
+#include "UDPBenchRuntime.h"
+#include "UDPBufferPool.h"
+#include "UDPMessageBatcher.h"
+#include "UDPPacketRing.h"
+#include "UDPReceivePipeline.h"
+#include "UDPSocketStats.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace udpdirect {
+namespace bench {
+
+struct BenchReceiverConfig {
+    size_t slotSize = UDPBufferPool::kSizeClasses[0];
+    size_t ringCapacity = 4096;  // as UDPDirectJSI's receive rings
+    bool batched = false;        // deliver through UDPMessageBatcher instead of the ring
+    UDPMessageBatcher::Config batch;
+    std::shared_ptr<UDPTrace> trace;  // for the pipeline; null for a disabled one
+};
+
+struct BenchReceiverStats {
+    uint64_t polls = 0;           // poll() calls, the stand-in for dispatch source wake-ups
+    uint64_t receiveSyscalls = 0;
+    uint64_t receivedPackets = 0;
+    uint64_t poolDrops = 0;       // datagrams lost to an exhausted pool or budget
+    uint64_t ringDrops = 0;
+    uint64_t batches = 0;
+};
+
+/**
+ * BenchReceiver
+ *
+ * Reads one descriptor on its own thread, the stand-in for a receive queue.
+ * Configure pipeline() before start(); after that it belongs to the thread.
+ */
+class BenchReceiver {
+public:
+    static constexpr int kMaxRounds = 8;  // as kBatchReceiveMaxRounds
+
+    BenchReceiver(std::shared_ptr<UDPBufferPool> pool, std::shared_ptr<UDPSocketStats> stats,
+                  BenchCallInvoker& invoker, BenchRuntime& runtime, const BenchReceiverConfig& config);
+    ~BenchReceiver();
+
+    BenchReceiver(const BenchReceiver&) = delete;
+    BenchReceiver& operator=(const BenchReceiver&) = delete;
+
+    UDPReceivePipeline& pipeline() { return pipeline_; }
+
+    void start(uint32_t socketId, int fd);
+    void stop();
+
+    /**
+     * Run `data` through the path GCDAsyncUdpSocket deliveries take, without a
+     * socket. Call from one thread, and not while the receiver is started.
+     *
+     * @return false if no receive slot was free
+     */
+    bool inject(uint32_t socketId, const uint8_t* data, size_t length, const UDPSocketAddress& source);
+
+    BenchReceiverStats stats() const;
+
+private:
+    void readLoop();
+    void drain();
+    void deliver(const UDPBufferSlot& slot, const UDPSocketAddress& source, uint32_t route, uint64_t kernelNs);
+    void flushBatch();
+
+    std::shared_ptr<UDPBufferPool> pool_;
+    BenchCallInvoker& invoker_;
+    BenchRuntime& runtime_;
+    BenchReceiverConfig config_;
+    UDPBatchIO batchIO_;
+    UDPReceivePipeline pipeline_;
+    std::shared_ptr<UDPPacketRing> ring_;
+    std::shared_ptr<UDPMessageBatcher> batcher_;
+    uint64_t batchDeadlineNs_ = 0;  // 0 when no batch is pending
+
+    uint32_t socketId_ = 0;
+    int fd_ = -1;
+    std::thread thread_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<uint64_t> polls_{0};
+    std::atomic<uint64_t> injectDrops_{0};
+    std::atomic<uint64_t> batches_{0};
+};
+
+} // namespace bench
+} // namespace udpdirect
@@ -0,0 +1,110 @@
+#include "UDPBenchRuntime.h"
+
+#include "UDPReceiveDrain.h"
+#include "UDPSocketStats.h"
+
+namespace udpdirect {
+namespace bench {
+
+BenchCallInvoker::BenchCallInvoker() : thread_([this] { run(); }) {}
+
+BenchCallInvoker::~BenchCallInvoker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+void BenchCallInvoker::invokeAsync(std::function<void()>&& work) {
+    invocations_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(work));
+    }
+    wake_.notify_one();
+}
+
+void BenchCallInvoker::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return queue_.empty() && !busy_; });
+}
+
+void BenchCallInvoker::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return;
+        }
+        running_.swap(queue_);
+        busy_ = true;
+        lock.unlock();
+        for (auto& work : running_) {
+            work();
+        }
+        running_.clear();
+        lock.lock();
+        busy_ = false;
+        if (queue_.empty()) {
+            idle_.notify_all();
+        }
+    }
+}
+
+// Event blocks as in UDPDirectJSI
+static const size_t kEventBlockSize = 192;
+static const size_t kMaxCachedEventBlocks = 8192;
+
+BenchRuntime::BenchRuntime()
+    : eventBlocks_(std::make_shared<UDPBlockCache>(kEventBlockSize, kMaxCachedEventBlocks)) {}
+
+void BenchRuntime::setOnMessage(uint32_t socketId, MessageHandler handler) {
+    handlers_[socketId].onMessage = std::move(handler);
+    handlersVersion_++;
+}
+
+void BenchRuntime::setOnMessageBatch(uint32_t socketId, BatchHandler handler) {
+    handlers_[socketId].onMessageBatch = std::move(handler);
+    handlersVersion_++;
+}
+
+void BenchRuntime::removeHandlers(uint32_t socketId) {
+    handlers_.erase(socketId);
+    handlersVersion_++;
+}
+
+// The shared drain, so this measures the same loop UDPDirectJSI runs
+size_t BenchRuntime::drainReceiveRing(UDPPacketRing& ring) {
+    const auto& pool = ring.pool();
+    const auto& blocks = eventBlocks_;
+    return UDPDrainReceiveRing(ring, handlers_, handlersVersion_, trace_.get(), &receiveLatency_,
+        [](const Handlers& handlers, const UDPPacketDescriptor&) -> const MessageHandler* {
+            return handlers.onMessage ? &handlers.onMessage : nullptr;
+        },
+        [&pool, &blocks](const MessageHandler& onMessage, const UDPPacketDescriptor& descriptor) {
+            // The event owns the slot from here on, as the host object does until GC
+            auto event = UDPMakeRecycled<BenchMessageEvent>(blocks);
+            event->socketId = descriptor.socketId;
+            event->data = UDPMakeRecycled<BenchSlotBuffer>(blocks, pool, descriptor.slot);
+            event->source = descriptor.source;
+            event->receivedNs = descriptor.receivedNs;
+            event->kernelNs = descriptor.kernelNs;
+            onMessage(*event);
+        });
+}
+
+void BenchRuntime::deliverBatch(uint32_t socketId, const std::shared_ptr<UDPMessageBatch>& batch) {
+    auto found = handlers_.find(socketId);
+    if (found == handlers_.end() || !found->second.onMessageBatch) {
+        return;
+    }
+    if (batch->firstReceivedNs != 0) {
+        receiveLatency_.record(UDPMonotonicNowNs() - batch->firstReceivedNs);
+    }
+    found->second.onMessageBatch(*batch);
+}
+
+} // namespace bench
+} // namespace udpdirect
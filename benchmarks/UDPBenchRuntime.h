@@ -0,0 +1,146 @@
+#pragma once
+
+// UDPBenchRuntime - stand-ins for the React Native side of the receive path:
+// a CallInvoker whose invokeAsync() runs work on one "JS thread", and a
+// runtime that drains the receive ring into per-socket handlers through the
+// same UDPDrainReceiveRing as UDPDirectJSI, minus the JS engine.
+
+#include "UDPBlockCache.h"
+#include "UDPBufferPool.h"
+#include "UDPLatencyHistogram.h"
+#include "UDPMessageBatcher.h"
+#include "UDPPacketRing.h"
+#include "UDPSocketAddress.h"
+#include "UDPTrace.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace udpdirect {
+namespace bench {
+
+/**
+ * Stand-in for facebook::react::CallInvoker. Work runs in order on a single
+ * thread that lives as long as the invoker.
+ */
+class BenchCallInvoker {
+public:
+    BenchCallInvoker();
+    ~BenchCallInvoker();
+
+    BenchCallInvoker(const BenchCallInvoker&) = delete;
+    BenchCallInvoker& operator=(const BenchCallInvoker&) = delete;
+
+    void invokeAsync(std::function<void()>&& work);
+
+    /**
+     * Block until everything invoked so far has run.
+     */
+    void flush();
+
+    uint64_t invocations() const { return invocations_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    // Swapped with running_ on each wake-up, so both keep their capacity and a steady
+    // stream of work does not allocate
+    std::vector<std::function<void()>> queue_;
+    std::vector<std::function<void()>> running_;  // invoker thread only
+    bool busy_ = false;  // running_ is being worked through
+    bool stopping_ = false;
+    std::atomic<uint64_t> invocations_{0};
+    std::thread thread_;
+};
+
+/**
+ * Holds a pool slot for as long as an event references it, like the
+ * PooledSlotBuffer behind a message event's ArrayBuffer.
+ */
+class BenchSlotBuffer {
+public:
+    BenchSlotBuffer(std::shared_ptr<UDPBufferPool> pool, UDPBufferSlot slot) : pool_(std::move(pool)), slot_(slot) {}
+    ~BenchSlotBuffer() { pool_->release(slot_); }
+
+    BenchSlotBuffer(const BenchSlotBuffer&) = delete;
+    BenchSlotBuffer& operator=(const BenchSlotBuffer&) = delete;
+
+    const uint8_t* data() const { return slot_.data; }
+    size_t size() const { return slot_.length; }
+
+private:
+    std::shared_ptr<UDPBufferPool> pool_;
+    UDPBufferSlot slot_;
+};
+
+/**
+ * What an onMessage handler receives; stands in for MessageEventHostObject.
+ */
+struct BenchMessageEvent {
+    uint32_t socketId = 0;
+    std::shared_ptr<BenchSlotBuffer> data;
+    UDPSocketAddress source;
+    uint64_t receivedNs = 0;
+    uint64_t kernelNs = 0;
+};
+
+/**
+ * Stand-in for the jsi::Runtime side of UDPDirectJSI: the per-socket handler
+ * table and the ring and batch drains. Everything but the constructor runs
+ * on the invoker's thread.
+ */
+class BenchRuntime {
+public:
+    using MessageHandler = std::function<void(const BenchMessageEvent&)>;
+    using BatchHandler = std::function<void(const UDPMessageBatch&)>;
+
+    BenchRuntime();
+
+    BenchRuntime(const BenchRuntime&) = delete;
+    BenchRuntime& operator=(const BenchRuntime&) = delete;
+
+    void setOnMessage(uint32_t socketId, MessageHandler handler);
+    void setOnMessageBatch(uint32_t socketId, BatchHandler handler);
+    void removeHandlers(uint32_t socketId);
+
+    // Records Deliver and Drop events while draining, as UDPDirectJSI does with g_trace
+    void setTrace(std::shared_ptr<UDPTrace> trace) { trace_ = std::move(trace); }
+
+    /**
+     * Deliver everything queued in `ring` to each socket's onMessage with
+     * UDPDrainReceiveRing.
+     *
+     * @return Datagrams delivered
+     */
+    size_t drainReceiveRing(UDPPacketRing& ring);
+
+    void deliverBatch(uint32_t socketId, const std::shared_ptr<UDPMessageBatch>& batch);
+
+    // Datagram read from the socket -> handler invoked
+    UDPLatencyHistogram& receiveLatency() { return receiveLatency_; }
+
+private:
+    struct Handlers {
+        MessageHandler onMessage;
+        BatchHandler onMessageBatch;
+    };
+
+    std::unordered_map<uint32_t, Handlers> handlers_;
+    uint64_t handlersVersion_ = 0;
+    UDPLatencyHistogram receiveLatency_;
+    std::shared_ptr<UDPTrace> trace_;
+    std::shared_ptr<UDPBlockCache> eventBlocks_;  // as UDPDirectJSI's g_eventBlocks
+};
+
+} // namespace bench
+} // namespace udpdirect
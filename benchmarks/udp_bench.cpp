@@ -0,0 +1,1654 @@
+// udp_bench - throughput, latency, allocation and syscall benchmarks for the
+// portable core, over loopback sockets on the build host. Results go to
+// stdout (or --output) as JSON, a readable summary to stderr.
+
+#include "UDPBenchAlloc.h"
+#include "UDPBenchHarness.h"
+#include "UDPBenchRuntime.h"
+
+#include "UDPBatchIO.h"
+#include "UDPBufferPool.h"
+#include "UDPCapture.h"
+#include "UDPChecksum.h"
+#include "UDPDatagramSocket.h"
+#include "UDPEndpointTable.h"
+#include "UDPFragmenter.h"
+#include "UDPHandleTable.h"
+#include "UDPLatencyHistogram.h"
+#include "UDPSocketAddress.h"
+#include "UDPSocketStats.h"
+#include "UDPTrace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <future>
+#include <memory>
+#include <poll.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include <sys/utsname.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#ifndef UDP_DIRECT_VERSION
+#define UDP_DIRECT_VERSION "unknown"
+#endif
+#ifndef UDP_BENCH_BUILD_TYPE
+#define UDP_BENCH_BUILD_TYPE "unknown"
+#endif
+
+using namespace udpdirect;
+using namespace udpdirect::bench;
+
+namespace {
+
+// Bump when a field changes meaning, so trackers do not compare across it
+const int kSchemaVersion = 1;
+
+const uint32_t kSocketId = 1;
+const size_t kStampBytes = 16;  // send time and sequence number at the front of every payload
+const int kSocketBufferBytes = 4 * 1024 * 1024;
+const size_t kPipelineInFlight = UDPBatchIO::kMaxBatch;  // one read burst
+const size_t kFragmentedMessageBytes = 64 * 1024;
+const size_t kFragmentDatagramBytes = 1400;  // a typical path MTU less the IP and UDP headers
+const size_t kFragmentsInFlight = 256;       // far inside the receive buffer, so the kernel drops none
+const uint64_t kReplayDatagrams = 4096;      // per pass over the capture file
+
+struct Options {
+    std::vector<std::string> scenarios;  // every scenario unless --scenarios narrows it
+    double seconds = 2.0;
+    double warmupSeconds = 0.2;
+    size_t payloadBytes = 256;
+    int window = 1;          // echo: round trips in flight
+    uint64_t floodRate = 0;  // flood: datagrams per second, 0 for as fast as possible
+    std::string output;
+};
+
+// Everything counted between the start and the end of the measured window
+struct Counters {
+    BenchAllocations allocations;
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    uint64_t sent = 0;
+    uint64_t sendSyscalls = 0;
+    uint64_t receiveSyscalls = 0;
+    uint64_t polls = 0;
+    uint64_t wakeups = 0;
+    uint64_t drops = 0;
+};
+
+struct Result {
+    std::string name;
+    std::string description;
+    double seconds = 0;
+    Counters counters;
+    UDPLatencySummary latency;   // what the scenario measures end to end
+    UDPLatencySummary delivery;  // socket read -> handler
+    uint64_t lost = 0;           // sent but never delivered, over the whole run
+};
+
+Counters operator-(const Counters& end, const Counters& begin) {
+    Counters delta;
+    delta.allocations.count = end.allocations.count - begin.allocations.count;
+    delta.allocations.bytes = end.allocations.bytes - begin.allocations.bytes;
+    delta.packets = end.packets - begin.packets;
+    delta.bytes = end.bytes - begin.bytes;
+    delta.sent = end.sent - begin.sent;
+    delta.sendSyscalls = end.sendSyscalls - begin.sendSyscalls;
+    delta.receiveSyscalls = end.receiveSyscalls - begin.receiveSyscalls;
+    delta.polls = end.polls - begin.polls;
+    delta.wakeups = end.wakeups - begin.wakeups;
+    delta.drops = end.drops - begin.drops;
+    return delta;
+}
+
+void stamp(uint8_t* payload, uint64_t sequence) {
+    uint64_t nowNs = UDPMonotonicNowNs();
+    memcpy(payload, &nowNs, sizeof(nowNs));
+    memcpy(payload + sizeof(nowNs), &sequence, sizeof(sequence));
+}
+
+uint64_t stampedNs(const uint8_t* payload) {
+    uint64_t sentNs;
+    memcpy(&sentNs, payload, sizeof(sentNs));
+    return sentNs;
+}
+
+UDPSocketAddress loopback() {
+    UDPSocketAddress address;
+    UDPSocketAddress::fromNumericHost("127.0.0.1", 0, address);
+    return address;
+}
+
+size_t slotSizeFor(size_t payloadBytes) {
+    for (uint32_t size : UDPBufferPool::kSizeClasses) {
+        if (payloadBytes <= size) {
+            return size;
+        }
+    }
+    return UDPBufferPool::maxSlotSize();
+}
+
+void fail(const std::string& what) {
+    fprintf(stderr, "udp_bench: %s\n", what.c_str());
+    exit(1);
+}
+
+// Waits out the warm-up, then takes `sample` at the start and end of the measured window
+void measure(const Options& options, Result& result, const std::function<Counters()>& sample,
+             const std::vector<UDPLatencyHistogram*>& histograms) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.warmupSeconds));
+    for (UDPLatencyHistogram* histogram : histograms) {
+        histogram->reset();
+    }
+    Counters begin = sample();
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    Counters end = sample();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.counters = end - begin;
+}
+
+const char kBase64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+std::string base64Encode(const uint8_t* data, size_t length) {
+    std::string out;
+    out.reserve((length + 2) / 3 * 4);
+    for (size_t i = 0; i < length; i += 3) {
+        uint32_t group = (uint32_t)data[i] << 16;
+        if (i + 1 < length) {
+            group |= (uint32_t)data[i + 1] << 8;
+        }
+        if (i + 2 < length) {
+            group |= data[i + 2];
+        }
+        out += kBase64Alphabet[(group >> 18) & 63];
+        out += kBase64Alphabet[(group >> 12) & 63];
+        out += i + 1 < length ? kBase64Alphabet[(group >> 6) & 63] : '=';
+        out += i + 2 < length ? kBase64Alphabet[group & 63] : '=';
+    }
+    return out;
+}
+
+std::vector<uint8_t> base64Decode(const std::string& text) {
+    static const std::vector<int8_t> values = [] {
+        std::vector<int8_t> table(256, -1);
+        for (int i = 0; i < 64; i++) {
+            table[(uint8_t)kBase64Alphabet[i]] = (int8_t)i;
+        }
+        return table;
+    }();
+    std::vector<uint8_t> out;
+    out.reserve(text.size() / 4 * 3);
+    uint32_t group = 0;
+    int bits = 0;
+    for (char c : text) {
+        int8_t value = values[(uint8_t)c];
+        if (value < 0) {
+            break;  // padding
+        }
+        group = (group << 6) | (uint32_t)value;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back((uint8_t)(group >> bits));
+        }
+    }
+    return out;
+}
+
+enum class PipelineMode {
+    Plain,
+    Traced,  // with the trace ring recording Receive and Deliver
+    Base64   // each datagram also round-trips through base64, as the string 'message' event did
+};
+
+// The receive path without a socket: copy into a slot, pipeline, ring, JS-thread drain.
+// At most one read burst is in flight, so latency is not queueing behind the producer.
+Result runPipeline(const Options& options, PipelineMode mode) {
+    Result result;
+    if (mode == PipelineMode::Plain) {
+        result.name = "pipeline";
+        result.description = "in-memory datagrams through slot copy, receive pipeline, ring and JS-thread drain";
+    } else if (mode == PipelineMode::Traced) {
+        result.name = "pipeline-traced";
+        result.description = "the pipeline scenario with the trace ring enabled";
+    } else {
+        result.name = "pipeline-base64";
+        result.description = "the pipeline scenario with each datagram base64-encoded and decoded again";
+    }
+
+    auto pool = std::make_shared<UDPBufferPool>();
+    auto stats = std::make_shared<UDPSocketStats>(16);
+    stats->attach(kSocketId);
+    BenchCallInvoker invoker;
+    BenchRuntime runtime;
+    BenchReceiverConfig config;
+    config.slotSize = slotSizeFor(options.payloadBytes);
+    if (mode == PipelineMode::Traced) {
+        // Default-sized, as the manager creates it
+        config.trace = std::make_shared<UDPTrace>();
+        config.trace->setEnabled(true);
+        runtime.setTrace(config.trace);
+    }
+    BenchReceiver receiver(pool, stats, invoker, runtime, config);
+
+    UDPLatencyHistogram latency;
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> deliveredBytes{0};
+    invoker.invokeAsync([&] {
+        runtime.setOnMessage(kSocketId, [&](const BenchMessageEvent& event) {
+            size_t size = event.data->size();
+            if (mode == PipelineMode::Base64) {
+                // The native encode for the event string, then the decode JS does to get bytes back
+                size = base64Decode(base64Encode(event.data->data(), event.data->size())).size();
+            }
+            latency.record(UDPMonotonicNowNs() - stampedNs(event.data->data()));
+            deliveredBytes.fetch_add(size, std::memory_order_relaxed);
+            delivered.fetch_add(1, std::memory_order_release);
+        });
+    });
+    invoker.flush();
+
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> injected{0};
+    UDPSocketAddress source = loopback();
+    source.port = 9;
+    std::thread producer([&] {
+        std::vector<uint8_t> payload(options.payloadBytes, 0xA5);
+        uint64_t sequence = 0;
+        while (!stopping.load(std::memory_order_relaxed)) {
+            if (injected.load(std::memory_order_relaxed) - delivered.load(std::memory_order_acquire) >=
+                kPipelineInFlight) {
+                std::this_thread::yield();
+                continue;
+            }
+            stamp(payload.data(), sequence++);
+            // Counted first so the handler never sees more deliveries than injections
+            injected.fetch_add(1, std::memory_order_relaxed);
+            if (!receiver.inject(kSocketId, payload.data(), payload.size(), source)) {
+                injected.fetch_sub(1, std::memory_order_relaxed);
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    auto sample = [&] {
+        Counters counters;
+        counters.allocations = allocationSnapshot();
+        counters.packets = delivered.load(std::memory_order_relaxed);
+        counters.bytes = deliveredBytes.load(std::memory_order_relaxed);
+        counters.sent = injected.load(std::memory_order_relaxed);
+        counters.wakeups = invoker.invocations();
+        BenchReceiverStats receiverStats = receiver.stats();
+        counters.drops = receiverStats.poolDrops + receiverStats.ringDrops;
+        return counters;
+    };
+    measure(options, result, sample, {&latency, &runtime.receiveLatency()});
+
+    stopping = true;
+    producer.join();
+    invoker.flush();
+    result.latency = latency.summary();
+    result.delivery = runtime.receiveLatency().summary();
+    result.lost = injected.load() - delivered.load();
+    return result;
+}
+
+// Records kReplayDatagrams inbound datagrams to a pcapng file, as startCapture would, and
+// returns its path. Each payload carries its index where the stamp's sequence number goes.
+std::string writeReplayCapture(const Options& options) {
+    const char* directory = getenv("TMPDIR");
+    std::string path = std::string(directory && *directory ? directory : "/tmp") + "/udp_bench_replay_" +
+                       std::to_string(getpid()) + ".pcapng";
+    // Room for the whole capture, so the writer thread's pace does not decide what is kept
+    UDPCaptureConfig config;
+    config.ringBytes = std::min(std::max(kReplayDatagrams * (options.payloadBytes + 128), UDPCapture::kMinRingBytes),
+                                UDPCapture::kMaxRingBytes);
+    UDPCapture capture;
+    capture.noteSocket(kSocketId, 9000);
+    std::string error = capture.start(path, config);
+    if (!error.empty()) {
+        fail("replay capture: " + error);
+    }
+    UDPSocketAddress peer = loopback();
+    peer.port = 9;
+    std::vector<uint8_t> payload(options.payloadBytes, 0xA5);
+    for (uint64_t i = 0; i < kReplayDatagrams; i++) {
+        memcpy(payload.data() + sizeof(uint64_t), &i, sizeof(i));
+        capture.record(UDPCaptureDirection::Inbound, kSocketId, peer, payload.data(), payload.size(), 1000 * (i + 1));
+    }
+    capture.stop();
+    UDPCaptureStats stats = capture.stats();
+    if (stats.captured == 0 || stats.writeErrors != 0) {
+        fail("replay capture: " + std::to_string(stats.captured) + " captured, " +
+             std::to_string(stats.writeErrors) + " write errors");
+    }
+    return path;
+}
+
+// A capture played back through the pipeline scenario's receiver at speed 0: read from the
+// mapped file, slot copy, receive pipeline, ring and JS-thread drain. The file is reopened
+// after each pass, so the reader's open and scan are part of the cost.
+Result runReplay(const Options& options) {
+    Result result;
+    result.name = "replay";
+    result.description = "a pcapng capture replayed at speed 0 through the receive pipeline, ring and drain";
+
+    std::string path = writeReplayCapture(options);
+    auto pool = std::make_shared<UDPBufferPool>();
+    auto stats = std::make_shared<UDPSocketStats>(16);
+    stats->attach(kSocketId);
+    BenchCallInvoker invoker;
+    BenchRuntime runtime;
+    BenchReceiverConfig config;
+    config.slotSize = slotSizeFor(options.payloadBytes);
+    BenchReceiver receiver(pool, stats, invoker, runtime, config);
+
+    // Captured payloads cannot be stamped, so injection times are kept by the index each carries
+    std::vector<uint64_t> injectedNs(kReplayDatagrams, 0);
+    UDPLatencyHistogram latency;
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> deliveredBytes{0};
+    invoker.invokeAsync([&] {
+        runtime.setOnMessage(kSocketId, [&](const BenchMessageEvent& event) {
+            uint64_t index;
+            memcpy(&index, event.data->data() + sizeof(uint64_t), sizeof(index));
+            latency.record(UDPMonotonicNowNs() - injectedNs[index % kReplayDatagrams]);
+            deliveredBytes.fetch_add(event.data->size(), std::memory_order_relaxed);
+            delivered.fetch_add(1, std::memory_order_release);
+        });
+    });
+    invoker.flush();
+
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> injected{0};
+    std::thread producer([&] {
+        UDPCaptureReplay::Options replayOptions;
+        replayOptions.speed = 0;
+        while (!stopping.load(std::memory_order_relaxed)) {
+            auto reader = std::make_unique<UDPCaptureReader>();
+            std::string error = reader->open(path);
+            if (!error.empty()) {
+                fail("replay: " + error);
+            }
+            UDPCaptureReplay replay(std::move(reader), replayOptions);
+            while (!stopping.load(std::memory_order_relaxed)) {
+                if (injected.load(std::memory_order_relaxed) - delivered.load(std::memory_order_acquire) >=
+                    kPipelineInFlight) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                const UDPCapturedDatagram* datagram = replay.peek();
+                if (!datagram) {
+                    break;
+                }
+                replay.dueNs(UDPMonotonicNowNs());
+                uint64_t index;
+                memcpy(&index, datagram->payload + sizeof(uint64_t), sizeof(index));
+                injectedNs[index % kReplayDatagrams] = UDPMonotonicNowNs();
+                injected.fetch_add(1, std::memory_order_relaxed);
+                if (!receiver.inject(kSocketId, datagram->payload, datagram->length, datagram->source)) {
+                    injected.fetch_sub(1, std::memory_order_relaxed);
+                    std::this_thread::yield();
+                    continue;
+                }
+                replay.pop();
+            }
+        }
+    });
+
+    auto sample = [&] {
+        Counters counters;
+        counters.allocations = allocationSnapshot();
+        counters.packets = delivered.load(std::memory_order_relaxed);
+        counters.bytes = deliveredBytes.load(std::memory_order_relaxed);
+        counters.sent = injected.load(std::memory_order_relaxed);
+        counters.wakeups = invoker.invocations();
+        BenchReceiverStats receiverStats = receiver.stats();
+        counters.drops = receiverStats.poolDrops + receiverStats.ringDrops;
+        return counters;
+    };
+    measure(options, result, sample, {&latency, &runtime.receiveLatency()});
+
+    stopping = true;
+    producer.join();
+    invoker.flush();
+    unlink(path.c_str());
+    result.latency = latency.summary();
+    result.delivery = runtime.receiveLatency().summary();
+    result.lost = injected.load() - delivered.load();
+    return result;
+}
+
+// Request/response over loopback: the client keeps `window` pings in flight and the
+// server's JS-thread handler echoes each one with an immediate send
+Result runEcho(const Options& options) {
+    Result result;
+    result.name = "echo";
+    result.description = "loopback round trips; server reads in batches and echoes from the JS-thread handler";
+
+    UDPDatagramSocketOptions socketOptions;
+    socketOptions.receiveBufferBytes = kSocketBufferBytes;
+    socketOptions.sendBufferBytes = kSocketBufferBytes;
+    UDPDatagramSocket server;
+    UDPDatagramSocket client;
+    std::string error = server.open(loopback(), socketOptions);
+    if (error.empty()) {
+        error = client.open(loopback(), socketOptions);
+    }
+    if (!error.empty()) {
+        fail(error);
+    }
+
+    auto pool = std::make_shared<UDPBufferPool>();
+    auto stats = std::make_shared<UDPSocketStats>(16);
+    stats->attach(kSocketId);
+    BenchCallInvoker invoker;
+    BenchRuntime runtime;
+    BenchReceiverConfig config;
+    config.slotSize = slotSizeFor(options.payloadBytes);
+    BenchReceiver receiver(pool, stats, invoker, runtime, config);
+
+    std::atomic<uint64_t> serverSends{0};
+    std::atomic<uint64_t> serverSendFailures{0};
+    int serverFd = server.fd();
+    invoker.invokeAsync([&] {
+        runtime.setOnMessage(kSocketId, [&](const BenchMessageEvent& event) {
+            // What socket.send(event.data, event.address, event.port) does for a resolved endpoint
+            sockaddr_storage storage;
+            socklen_t length = event.source.toSockaddr(storage);
+            int sendErrno = 0;
+            if (UDPSendDatagram(serverFd, event.data->data(), event.data->size(), (const sockaddr*)&storage, length,
+                                sendErrno) != UDPSendStatus::Sent) {
+                serverSendFailures.fetch_add(1, std::memory_order_relaxed);
+            }
+            serverSends.fetch_add(1, std::memory_order_relaxed);
+        });
+    });
+    invoker.flush();
+    receiver.start(kSocketId, serverFd);
+
+    // Client on its own thread, so the main thread only samples
+    auto clientPool = std::make_shared<UDPBufferPool>();
+    UDPBatchIO clientIO(clientPool);
+    UDPLatencyHistogram latency;
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> roundTrips{0};
+    std::atomic<uint64_t> roundTripBytes{0};
+    std::atomic<uint64_t> clientSends{0};
+    std::atomic<uint64_t> clientPolls{0};
+    std::atomic<uint64_t> lostPings{0};
+    UDPSocketAddress serverAddress = server.localAddress();
+
+    std::thread clientThread([&] {
+        std::vector<uint8_t> payload(options.payloadBytes, 0x5A);
+        uint64_t sequence = 0;
+        auto sendPing = [&] {
+            stamp(payload.data(), sequence++);
+            int sendErrno = 0;
+            client.sendTo(payload.data(), payload.size(), serverAddress, sendErrno);
+            clientSends.fetch_add(1, std::memory_order_relaxed);
+        };
+        for (int i = 0; i < options.window; i++) {
+            sendPing();
+        }
+        UDPReceivedDatagram replies[UDPBatchIO::kMaxBatch];
+        struct pollfd entry = {client.fd(), POLLIN, 0};
+        while (!stopping.load(std::memory_order_relaxed)) {
+            clientPolls.fetch_add(1, std::memory_order_relaxed);
+            int ready = poll(&entry, 1, 100);
+            if (ready == 0) {
+                // A ping went missing; put a new one in flight so the window stays full
+                lostPings.fetch_add(1, std::memory_order_relaxed);
+                sendPing();
+                continue;
+            }
+            int receiveErrno = 0;
+            size_t received = clientIO.receive(client.fd(), slotSizeFor(options.payloadBytes), replies,
+                                               UDPBatchIO::kMaxBatch, receiveErrno);
+            uint64_t nowNs = UDPMonotonicNowNs();
+            for (size_t i = 0; i < received; i++) {
+                latency.record(nowNs - stampedNs(replies[i].slot.data));
+                roundTripBytes.fetch_add(replies[i].slot.length, std::memory_order_relaxed);
+                clientPool->release(replies[i].slot);
+            }
+            roundTrips.fetch_add(received, std::memory_order_relaxed);
+            for (size_t i = 0; i < received; i++) {
+                sendPing();
+            }
+        }
+        clientIO.releaseReserve();
+    });
+
+    auto sample = [&] {
+        Counters counters;
+        counters.allocations = allocationSnapshot();
+        counters.packets = roundTrips.load(std::memory_order_relaxed);
+        counters.bytes = roundTripBytes.load(std::memory_order_relaxed);
+        counters.sent = clientSends.load(std::memory_order_relaxed);
+        BenchReceiverStats receiverStats = receiver.stats();
+        UDPBatchIOStats clientStats = clientIO.stats();
+        counters.sendSyscalls = clientSends.load(std::memory_order_relaxed) +
+                                serverSends.load(std::memory_order_relaxed);
+        counters.receiveSyscalls = receiverStats.receiveSyscalls + clientStats.receiveSyscalls;
+        counters.polls = receiverStats.polls + clientPolls.load(std::memory_order_relaxed);
+        counters.wakeups = invoker.invocations();
+        counters.drops = receiverStats.poolDrops + receiverStats.ringDrops +
+                         serverSendFailures.load(std::memory_order_relaxed);
+        return counters;
+    };
+    measure(options, result, sample, {&latency, &runtime.receiveLatency()});
+
+    stopping = true;
+    clientThread.join();
+    receiver.stop();
+    invoker.flush();
+    result.latency = latency.summary();
+    result.delivery = runtime.receiveLatency().summary();
+    result.lost = lostPings.load();
+    return result;
+}
+
+enum class FloodMode {
+    Events,   // sendmmsg bursts, one event per datagram
+    Batched,  // sendmmsg bursts, delivered through the message batcher
+    SendTo    // the same bursts as one sendto per datagram, one event per datagram
+};
+
+// One-way flood: a sender thread pushes batches as fast as allowed while the receiver
+// reads, runs the pipeline and delivers one datagram per event or in batches
+Result runFlood(const Options& options, FloodMode mode) {
+    bool batched = mode == FloodMode::Batched;
+    Result result;
+    if (mode == FloodMode::Events) {
+        result.name = "flood";
+        result.description = "loopback flood delivered one event per datagram through the ring";
+    } else if (mode == FloodMode::Batched) {
+        result.name = "flood-batched";
+        result.description = "loopback flood delivered through the message batcher, one JS call per batch";
+    } else {
+        result.name = "flood-sendto";
+        result.description = "loopback flood sent with one sendto per datagram instead of sendmmsg";
+    }
+
+    UDPDatagramSocketOptions socketOptions;
+    socketOptions.receiveBufferBytes = kSocketBufferBytes;
+    socketOptions.sendBufferBytes = kSocketBufferBytes;
+    UDPDatagramSocket receiverSocket;
+    UDPDatagramSocket senderSocket;
+    std::string error = receiverSocket.open(loopback(), socketOptions);
+    if (error.empty()) {
+        error = senderSocket.open(loopback(), socketOptions);
+    }
+    if (!error.empty()) {
+        fail(error);
+    }
+
+    auto pool = std::make_shared<UDPBufferPool>();
+    auto stats = std::make_shared<UDPSocketStats>(16);
+    stats->attach(kSocketId);
+    BenchCallInvoker invoker;
+    BenchRuntime runtime;
+    BenchReceiverConfig config;
+    config.slotSize = slotSizeFor(options.payloadBytes);
+    config.batched = batched;
+    BenchReceiver receiver(pool, stats, invoker, runtime, config);
+
+    UDPLatencyHistogram latency;
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> deliveredBytes{0};
+    invoker.invokeAsync([&] {
+        if (batched) {
+            runtime.setOnMessageBatch(kSocketId, [&](const UDPMessageBatch& batch) {
+                uint64_t nowNs = UDPMonotonicNowNs();
+                size_t count = batch.count();
+                for (size_t i = 0; i < count; i++) {
+                    latency.record(nowNs - stampedNs(batch.datagram(i)));
+                    deliveredBytes.fetch_add(batch.length(i), std::memory_order_relaxed);
+                }
+                delivered.fetch_add(count, std::memory_order_relaxed);
+            });
+        } else {
+            runtime.setOnMessage(kSocketId, [&](const BenchMessageEvent& event) {
+                latency.record(UDPMonotonicNowNs() - stampedNs(event.data->data()));
+                deliveredBytes.fetch_add(event.data->size(), std::memory_order_relaxed);
+                delivered.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+    });
+    invoker.flush();
+    receiver.start(kSocketId, receiverSocket.fd());
+
+    UDPBatchIO senderIO;
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> senderPolls{0};
+    std::atomic<uint64_t> singleSends{0};     // FloodMode::SendTo
+    std::atomic<uint64_t> singleSyscalls{0};
+    UDPSocketAddress destination = receiverSocket.localAddress();
+
+    std::thread sender([&] {
+        std::vector<uint8_t> buffers(UDPBatchIO::kMaxBatch * options.payloadBytes, 0x3C);
+        UDPBatchSendItem items[UDPBatchIO::kMaxBatch];
+        for (size_t i = 0; i < UDPBatchIO::kMaxBatch; i++) {
+            items[i].data = &buffers[i * options.payloadBytes];
+            items[i].length = options.payloadBytes;
+            items[i].destination = destination;
+        }
+        uint64_t sequence = 0;
+        uint64_t startNs = UDPMonotonicNowNs();
+        struct pollfd entry = {senderSocket.fd(), POLLOUT, 0};
+        while (!stopping.load(std::memory_order_relaxed)) {
+            size_t count = UDPBatchIO::kMaxBatch;
+            if (options.floodRate > 0) {
+                uint64_t dueCount = (UDPMonotonicNowNs() - startNs) * options.floodRate / 1000000000ull;
+                if (dueCount <= sequence) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    continue;
+                }
+                count = std::min<uint64_t>(count, dueCount - sequence);
+            }
+            for (size_t i = 0; i < count; i++) {
+                stamp(&buffers[i * options.payloadBytes], sequence + i);
+            }
+            int sendErrno = 0;
+            size_t sent = 0;
+            if (mode == FloodMode::SendTo) {
+                for (; sent < count; sent++) {
+                    singleSyscalls.fetch_add(1, std::memory_order_relaxed);
+                    if (senderSocket.sendTo(items[sent].data, items[sent].length, destination, sendErrno) !=
+                        UDPSendStatus::Sent) {
+                        break;
+                    }
+                }
+                singleSends.fetch_add(sent, std::memory_order_relaxed);
+            } else {
+                sent = senderIO.send(senderSocket.fd(), items, count, sendErrno);
+            }
+            sequence += sent;
+            if (sent < count && sendErrno == EAGAIN) {
+                senderPolls.fetch_add(1, std::memory_order_relaxed);
+                poll(&entry, 1, 10);
+            }
+        }
+    });
+
+    auto sample = [&] {
+        Counters counters;
+        counters.allocations = allocationSnapshot();
+        counters.packets = delivered.load(std::memory_order_relaxed);
+        counters.bytes = deliveredBytes.load(std::memory_order_relaxed);
+        UDPBatchIOStats senderStats = senderIO.stats();
+        BenchReceiverStats receiverStats = receiver.stats();
+        counters.sent = senderStats.sentPackets + singleSends.load(std::memory_order_relaxed);
+        counters.sendSyscalls = senderStats.sendSyscalls + singleSyscalls.load(std::memory_order_relaxed);
+        counters.receiveSyscalls = receiverStats.receiveSyscalls;
+        counters.polls = receiverStats.polls + senderPolls.load(std::memory_order_relaxed);
+        counters.wakeups = invoker.invocations();
+        counters.drops = receiverStats.poolDrops + receiverStats.ringDrops;
+        return counters;
+    };
+    measure(options, result, sample, {&latency, &runtime.receiveLatency()});
+
+    stopping = true;
+    sender.join();
+    // Let the receiver catch up with what is still queued before counting losses
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    receiver.stop();
+    invoker.flush();
+    result.latency = latency.summary();
+    result.delivery = runtime.receiveLatency().summary();
+    uint64_t sentTotal = senderIO.stats().sentPackets + singleSends.load();
+    uint64_t deliveredTotal = delivered.load();
+    result.lost = sentTotal > deliveredTotal ? sentTotal - deliveredTotal : 0;
+    return result;
+}
+
+// A sender and a sink nobody reads. Once the sink's buffer is full the kernel drops what
+// arrives, so the sender never waits on a reader and only the send path is timed.
+struct SendPair {
+    UDPDatagramSocket sender;
+    UDPDatagramSocket sink;
+    sockaddr_storage sinkAddress;
+    socklen_t sinkAddressLength = 0;
+};
+
+void openSendPair(SendPair& pair) {
+    UDPDatagramSocketOptions socketOptions;
+    socketOptions.sendBufferBytes = kSocketBufferBytes;
+    std::string error = pair.sink.open(loopback());
+    if (error.empty()) {
+        error = pair.sender.open(loopback(), socketOptions);
+    }
+    if (!error.empty()) {
+        fail(error);
+    }
+    pair.sinkAddressLength = pair.sink.localAddress().toSockaddr(pair.sinkAddress);
+}
+
+using SendOne = std::function<UDPSendStatus(const uint8_t* payload, size_t length, int& error)>;
+
+// Calls `sendOne` back to back on a sender thread; latency is the time spent in one call
+Result runSendLoop(const Options& options, Result result, SendPair& pair, const SendOne& sendOne) {
+    UDPLatencyHistogram latency;
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> sent{0};
+    std::atomic<uint64_t> sentBytes{0};
+    std::atomic<uint64_t> attempts{0};
+    std::atomic<uint64_t> polls{0};
+    std::atomic<uint64_t> failures{0};
+
+    std::thread sender([&] {
+        std::vector<uint8_t> payload(options.payloadBytes, 0x6B);
+        uint64_t sequence = 0;
+        struct pollfd entry = {pair.sender.fd(), POLLOUT, 0};
+        while (!stopping.load(std::memory_order_relaxed)) {
+            stamp(payload.data(), sequence);
+            int sendErrno = 0;
+            uint64_t startNs = UDPMonotonicNowNs();
+            UDPSendStatus status = sendOne(payload.data(), payload.size(), sendErrno);
+            latency.record(UDPMonotonicNowNs() - startNs);
+            attempts.fetch_add(1, std::memory_order_relaxed);
+            if (status == UDPSendStatus::Sent) {
+                sequence++;
+                sent.fetch_add(1, std::memory_order_relaxed);
+                sentBytes.fetch_add(payload.size(), std::memory_order_relaxed);
+            } else if (status == UDPSendStatus::Deferred) {
+                polls.fetch_add(1, std::memory_order_relaxed);
+                poll(&entry, 1, 10);
+            } else {
+                failures.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    });
+
+    auto sample = [&] {
+        Counters counters;
+        counters.allocations = allocationSnapshot();
+        counters.packets = sent.load(std::memory_order_relaxed);
+        counters.bytes = sentBytes.load(std::memory_order_relaxed);
+        counters.sent = counters.packets;
+        counters.sendSyscalls = attempts.load(std::memory_order_relaxed);
+        counters.polls = polls.load(std::memory_order_relaxed);
+        counters.drops = failures.load(std::memory_order_relaxed);
+        return counters;
+    };
+    measure(options, result, sample, {&latency});
+
+    stopping = true;
+    sender.join();
+    result.latency = latency.summary();
+    return result;
+}
+
+// udpSendDirect's immediate send: sendto straight from the caller's buffer, against the copy
+// into a fresh buffer that the NSData path made for every payload
+Result runSend(const Options& options, bool copied) {
+    Result result;
+    result.name = copied ? "send-copied" : "send-direct";
+    result.description = copied
+        ? "per-datagram sendto of a heap copy of the payload, as the NSData path made"
+        : "per-datagram sendto straight from the caller's buffer, as udpSendDirect does";
+
+    SendPair pair;
+    openSendPair(pair);
+    int fd = pair.sender.fd();
+    const sockaddr* address = (const sockaddr*)&pair.sinkAddress;
+    socklen_t addressLength = pair.sinkAddressLength;
+    if (copied) {
+        return runSendLoop(options, result, pair, [&](const uint8_t* payload, size_t length, int& error) {
+            std::vector<uint8_t> copy(payload, payload + length);
+            return UDPSendDatagram(fd, copy.data(), copy.size(), address, addressLength, error);
+        });
+    }
+    return runSendLoop(options, result, pair, [&](const uint8_t* payload, size_t length, int& error) {
+        return UDPSendDatagram(fd, payload, length, address, addressLength, error);
+    });
+}
+
+// A flood spread over `queues` SO_REUSEPORT sockets bound to one port, each read by its own
+// receiver thread and ring, as sockets on different receive queues are. Sends rotate over
+// several source ports so the kernel's flow hash has flows to spread.
+Result runShardedFlood(const Options& options, size_t queues) {
+    const size_t kSenders = 8;
+    Result result;
+    result.name = "flood-sharded-" + std::to_string(queues);
+    result.description = "loopback flood fanned out over " + std::to_string(queues) +
+                         " SO_REUSEPORT sockets, each on its own receive thread and ring";
+
+    UDPDatagramSocketOptions socketOptions;
+    socketOptions.receiveBufferBytes = kSocketBufferBytes;
+    socketOptions.sendBufferBytes = kSocketBufferBytes;
+    UDPDatagramSocketOptions shardOptions = socketOptions;
+    shardOptions.reusePort = true;
+    std::vector<std::unique_ptr<UDPDatagramSocket>> shards;
+    std::vector<std::unique_ptr<UDPDatagramSocket>> senders;
+    UDPSocketAddress bindAddress = loopback();
+    for (size_t i = 0; i < queues; i++) {
+        shards.push_back(std::make_unique<UDPDatagramSocket>());
+        std::string error = shards.back()->open(bindAddress, shardOptions);
+        if (!error.empty()) {
+            fail(error);
+        }
+        bindAddress = shards.back()->localAddress();
+    }
+    for (size_t i = 0; i < kSenders; i++) {
+        senders.push_back(std::make_unique<UDPDatagramSocket>());
+        std::string error = senders.back()->open(loopback(), socketOptions);
+        if (!error.empty()) {
+            fail(error);
+        }
+    }
+
+    auto pool = std::make_shared<UDPBufferPool>();
+    auto stats = std::make_shared<UDPSocketStats>(16);
+    BenchCallInvoker invoker;
+    BenchRuntime runtime;
+    BenchReceiverConfig config;
+    config.slotSize = slotSizeFor(options.payloadBytes);
+    std::vector<std::unique_ptr<BenchReceiver>> receivers;
+    for (size_t i = 0; i < queues; i++) {
+        stats->attach(kSocketId + (uint32_t)i);
+        receivers.push_back(std::make_unique<BenchReceiver>(pool, stats, invoker, runtime, config));
+    }
+
+    UDPLatencyHistogram latency;
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> deliveredBytes{0};
+    invoker.invokeAsync([&] {
+        for (size_t i = 0; i < queues; i++) {
+            runtime.setOnMessage(kSocketId + (uint32_t)i, [&](const BenchMessageEvent& event) {
+                latency.record(UDPMonotonicNowNs() - stampedNs(event.data->data()));
+                deliveredBytes.fetch_add(event.data->size(), std::memory_order_relaxed);
+                delivered.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+    });
+    invoker.flush();
+    for (size_t i = 0; i < queues; i++) {
+        receivers[i]->start(kSocketId + (uint32_t)i, shards[i]->fd());
+    }
+
+    UDPBatchIO senderIO;
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> senderPolls{0};
+
+    std::thread sender([&] {
+        std::vector<uint8_t> buffers(UDPBatchIO::kMaxBatch * options.payloadBytes, 0x2D);
+        UDPBatchSendItem items[UDPBatchIO::kMaxBatch];
+        for (size_t i = 0; i < UDPBatchIO::kMaxBatch; i++) {
+            items[i].data = &buffers[i * options.payloadBytes];
+            items[i].length = options.payloadBytes;
+            items[i].destination = bindAddress;
+        }
+        uint64_t sequence = 0;
+        uint64_t startNs = UDPMonotonicNowNs();
+        size_t next = 0;
+        while (!stopping.load(std::memory_order_relaxed)) {
+            // Short bursts per source port, so every flow keeps arriving
+            size_t count = UDPBatchIO::kMaxBatch / 4;
+            if (options.floodRate > 0) {
+                uint64_t dueCount = (UDPMonotonicNowNs() - startNs) * options.floodRate / 1000000000ull;
+                if (dueCount <= sequence) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    continue;
+                }
+                count = std::min<uint64_t>(count, dueCount - sequence);
+            }
+            for (size_t i = 0; i < count; i++) {
+                stamp(&buffers[i * options.payloadBytes], sequence + i);
+            }
+            UDPDatagramSocket& senderSocket = *senders[next++ % kSenders];
+            int sendErrno = 0;
+            size_t sent = senderIO.send(senderSocket.fd(), items, count, sendErrno);
+            sequence += sent;
+            if (sent < count && sendErrno == EAGAIN) {
+                senderPolls.fetch_add(1, std::memory_order_relaxed);
+                struct pollfd entry = {senderSocket.fd(), POLLOUT, 0};
+                poll(&entry, 1, 10);
+            }
+        }
+    });
+
+    auto sample = [&] {
+        Counters counters;
+        counters.allocations = allocationSnapshot();
+        counters.packets = delivered.load(std::memory_order_relaxed);
+        counters.bytes = deliveredBytes.load(std::memory_order_relaxed);
+        UDPBatchIOStats senderStats = senderIO.stats();
+        counters.sent = senderStats.sentPackets;
+        counters.sendSyscalls = senderStats.sendSyscalls;
+        counters.polls = senderPolls.load(std::memory_order_relaxed);
+        for (const std::unique_ptr<BenchReceiver>& receiver : receivers) {
+            BenchReceiverStats receiverStats = receiver->stats();
+            counters.receiveSyscalls += receiverStats.receiveSyscalls;
+            counters.polls += receiverStats.polls;
+            counters.drops += receiverStats.poolDrops + receiverStats.ringDrops;
+        }
+        counters.wakeups = invoker.invocations();
+        return counters;
+    };
+    measure(options, result, sample, {&latency, &runtime.receiveLatency()});
+
+    stopping = true;
+    sender.join();
+    // Let the receivers catch up with what is still queued before counting losses
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    for (const std::unique_ptr<BenchReceiver>& receiver : receivers) {
+        receiver->stop();
+    }
+    invoker.flush();
+    result.latency = latency.summary();
+    result.delivery = runtime.receiveLatency().summary();
+    uint64_t sentTotal = senderIO.stats().sentPackets;
+    uint64_t deliveredTotal = delivered.load();
+    result.lost = sentTotal > deliveredTotal ? sentTotal - deliveredTotal : 0;
+    return result;
+}
+
+// 64 KiB messages fragmented over loopback. A lossy stand-in on the sender drops each
+// fragment with probability lossPercent / 100; the receiver reassembles what arrives.
+Result runFragments(const Options& options, unsigned lossPercent) {
+    Result result;
+    result.name = "fragments-loss-" + std::to_string(lossPercent);
+    result.description = "64 KiB messages in 1400 byte fragments over loopback, reassembled, " +
+                         std::to_string(lossPercent) + "% of fragments dropped";
+
+    UDPDatagramSocketOptions socketOptions;
+    socketOptions.receiveBufferBytes = kSocketBufferBytes;
+    socketOptions.sendBufferBytes = kSocketBufferBytes;
+    UDPDatagramSocket receiverSocket;
+    UDPDatagramSocket senderSocket;
+    std::string error = receiverSocket.open(loopback(), socketOptions);
+    if (error.empty()) {
+        error = senderSocket.open(loopback(), socketOptions);
+    }
+    if (!error.empty()) {
+        fail(error);
+    }
+
+    auto pool = std::make_shared<UDPBufferPool>();
+    UDPBatchIO receiverIO(pool);
+    UDPBatchIO senderIO;
+    UDPReassembler reassembler(UDPReassembler::Config{});
+    UDPLatencyHistogram latency;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> receiverStopping{false};
+    std::atomic<uint64_t> messagesSent{0};
+    std::atomic<uint64_t> fragmentsSent{0};
+    std::atomic<uint64_t> fragmentsReceived{0};
+    std::atomic<uint64_t> completed{0};
+    std::atomic<uint64_t> completedBytes{0};
+    std::atomic<uint64_t> polls{0};
+
+    // Reads and reassembles, as a socket's receive queue does with the reassembly stage
+    std::thread receiver([&] {
+        UDPReceivedDatagram datagrams[UDPBatchIO::kMaxBatch];
+        struct pollfd entry = {receiverSocket.fd(), POLLIN, 0};
+        while (!receiverStopping.load(std::memory_order_relaxed)) {
+            polls.fetch_add(1, std::memory_order_relaxed);
+            if (poll(&entry, 1, 20) <= 0) {
+                continue;
+            }
+            int receiveErrno = 0;
+            size_t received = receiverIO.receive(receiverSocket.fd(), slotSizeFor(kFragmentDatagramBytes), datagrams,
+                                                 UDPBatchIO::kMaxBatch, receiveErrno);
+            uint64_t nowNs = UDPMonotonicNowNs();
+            for (size_t i = 0; i < received; i++) {
+                std::shared_ptr<std::vector<uint8_t>> message;
+                if (reassembler.receive(datagrams[i].slot.data, datagrams[i].slot.length, datagrams[i].source, nowNs,
+                                        message) == UDPReassembler::Result::Complete) {
+                    latency.record(nowNs - stampedNs(message->data()));
+                    completedBytes.fetch_add(message->size(), std::memory_order_relaxed);
+                    completed.fetch_add(1, std::memory_order_relaxed);
+                }
+                pool->release(datagrams[i].slot);
+            }
+            fragmentsReceived.fetch_add(received, std::memory_order_relaxed);
+        }
+        receiverIO.releaseReserve();
+    });
+
+    UDPSocketAddress destination = receiverSocket.localAddress();
+    std::thread sender([&] {
+        std::vector<uint8_t> message(kFragmentedMessageBytes, 0x47);
+        UDPFragmentBatch batch;
+        std::vector<UDPBatchSendItem> items;
+        std::mt19937 random(lossPercent + 1);
+        std::uniform_int_distribution<unsigned> percent(0, 99);
+        struct pollfd entry = {senderSocket.fd(), POLLOUT, 0};
+        uint32_t messageId = 0;
+        while (!stopping.load(std::memory_order_relaxed)) {
+            stamp(message.data(), messageId);
+            UDPFragmenter::fragment(message.data(), message.size(), messageId++, kFragmentDatagramBytes, batch);
+            items.clear();
+            for (size_t i = 0; i < batch.count(); i++) {
+                if (percent(random) < lossPercent) {
+                    continue;
+                }
+                UDPBatchSendItem item;
+                item.data = &batch.datagrams[batch.offsets[i]];
+                item.length = batch.lengths[i];
+                item.destination = destination;
+                items.push_back(item);
+            }
+
+            size_t next = 0;
+            while (next < items.size() && !stopping.load(std::memory_order_relaxed)) {
+                if (fragmentsSent.load(std::memory_order_relaxed) -
+                        fragmentsReceived.load(std::memory_order_relaxed) >= kFragmentsInFlight) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                size_t count = std::min(items.size() - next, UDPBatchIO::kMaxBatch);
+                int sendErrno = 0;
+                size_t sent = senderIO.send(senderSocket.fd(), &items[next], count, sendErrno);
+                next += sent;
+                fragmentsSent.fetch_add(sent, std::memory_order_relaxed);
+                if (sent < count && sendErrno == EAGAIN) {
+                    polls.fetch_add(1, std::memory_order_relaxed);
+                    poll(&entry, 1, 10);
+                }
+            }
+            messagesSent.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    auto sample = [&] {
+        Counters counters;
+        counters.allocations = allocationSnapshot();
+        counters.packets = completed.load(std::memory_order_relaxed);
+        counters.bytes = completedBytes.load(std::memory_order_relaxed);
+        counters.sent = messagesSent.load(std::memory_order_relaxed);
+        counters.sendSyscalls = senderIO.stats().sendSyscalls;
+        counters.receiveSyscalls = receiverIO.stats().receiveSyscalls;
+        counters.polls = polls.load(std::memory_order_relaxed);
+        UDPReassemblerStats reassembly = reassembler.stats();
+        counters.drops = reassembly.messagesTimedOut + reassembly.messagesEvicted;
+        return counters;
+    };
+    measure(options, result, sample, {&latency});
+
+    stopping = true;
+    sender.join();
+    // Let the receiver take in what is still queued before counting losses
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    receiverStopping = true;
+    receiver.join();
+    result.latency = latency.summary();
+    uint64_t sentTotal = messagesSent.load();
+    uint64_t completedTotal = completed.load();
+    result.lost = sentTotal > completedTotal ? sentTotal - completedTotal : 0;
+    return result;
+}
+
+enum class DestinationMode {
+    Host,      // host string parsed and checked for broadcast on every send
+    Endpoint,  // endpoint handle resolved once
+    Connected  // connected socket, no address per send
+};
+
+// How a send names its destination, all sending from the caller's buffer
+Result runSendDestination(const Options& options, DestinationMode mode) {
+    Result result;
+    if (mode == DestinationMode::Host) {
+        result.name = "send-host";
+        result.description = "per-datagram sendto, parsing the host string and checking for broadcast each time";
+    } else if (mode == DestinationMode::Endpoint) {
+        result.name = "send-endpoint";
+        result.description = "per-datagram sendto to a pre-resolved endpoint handle";
+    } else {
+        result.name = "send-connected";
+        result.description = "per-datagram send on a connected socket";
+    }
+
+    SendPair pair;
+    openSendPair(pair);
+    int fd = pair.sender.fd();
+    uint16_t port = pair.sink.localAddress().port;
+
+    if (mode == DestinationMode::Host) {
+        std::string host = pair.sink.localAddress().hostString();
+        return runSendLoop(options, result, pair, [&](const uint8_t* payload, size_t length, int& error) {
+            UDPSocketAddress destination;
+            if (!UDPSocketAddress::fromNumericHost(host.c_str(), port, destination) ||
+                UDPEndpoint::isBroadcastAddress(destination)) {
+                error = EINVAL;
+                return UDPSendStatus::Failed;
+            }
+            sockaddr_storage address;
+            socklen_t addressLength = destination.toSockaddr(address);
+            return UDPSendDatagram(fd, payload, length, (const sockaddr*)&address, addressLength, error);
+        });
+    }
+    if (mode == DestinationMode::Endpoint) {
+        UDPEndpointTable endpoints;
+        UDPEndpointTable::Handle handle = endpoints.intern(pair.sink.localAddress());
+        return runSendLoop(options, result, pair, [&](const uint8_t* payload, size_t length, int& error) {
+            const UDPEndpoint* endpoint = endpoints.get(handle);
+            if (!endpoint) {
+                error = EINVAL;
+                return UDPSendStatus::Failed;
+            }
+            return UDPSendDatagram(fd, payload, length, (const sockaddr*)&endpoint->sockaddr,
+                                   endpoint->sockaddrLength, error);
+        });
+    }
+    std::string connectError = pair.sender.connect(pair.sink.localAddress());
+    if (!connectError.empty()) {
+        fail(connectError);
+    }
+    return runSendLoop(options, result, pair, [&](const uint8_t* payload, size_t length, int& error) {
+        return UDPSendDatagram(fd, payload, length, nullptr, 0, error);
+    });
+}
+
+void spinFor(uint64_t ns) {
+    uint64_t endNs = UDPMonotonicNowNs() + ns;
+    while (UDPMonotonicNowNs() < endNs) {
+    }
+}
+
+// App start-up against a busy control queue: behind 10 ms of queued work, the JS thread
+// opens 12 sockets' worth of control calls, waiting on each as dispatch_sync did, or
+// getting a promise settled through the CallInvoker. Latency is the time the JS thread is
+// held in one call.
+Result runControl(const Options& options, bool async) {
+    const int kBacklogTasks = 100;
+    const uint64_t kBacklogTaskNs = 100 * 1000;  // 10 ms of closes and queued sends in all
+    const int kCallsPerRound = 12;
+    const uint64_t kCallNs = 20 * 1000;          // about a create or bind
+    Result result;
+    result.name = async ? "control-async" : "control-sync";
+    result.description = async ? "control calls behind a busy queue, settled as promises through the CallInvoker"
+                               : "control calls behind a busy queue, each waited on as dispatch_sync did";
+
+    BenchCallInvoker controlQueue;
+    BenchCallInvoker jsInvoker;
+    UDPLatencyHistogram latency;
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> settled{0};
+
+    std::thread jsThread([&] {
+        uint64_t issued = 0;
+        while (!stopping.load(std::memory_order_relaxed)) {
+            for (int i = 0; i < kBacklogTasks; i++) {
+                controlQueue.invokeAsync([&] { spinFor(kBacklogTaskNs); });
+            }
+            for (int i = 0; i < kCallsPerRound; i++) {
+                uint64_t startNs = UDPMonotonicNowNs();
+                if (async) {
+                    controlQueue.invokeAsync([&] {
+                        spinFor(kCallNs);
+                        jsInvoker.invokeAsync([&] { settled.fetch_add(1, std::memory_order_relaxed); });
+                    });
+                } else {
+                    // Shared, so the control queue may still be inside set_value() when the wait returns
+                    auto done = std::make_shared<std::promise<void>>();
+                    std::future<void> ready = done->get_future();
+                    controlQueue.invokeAsync([&, done] {
+                        spinFor(kCallNs);
+                        done->set_value();
+                    });
+                    ready.wait();
+                    settled.fetch_add(1, std::memory_order_relaxed);
+                }
+                latency.record(UDPMonotonicNowNs() - startNs);
+                issued++;
+            }
+            // The next round starts once this one has settled, so backlogs do not pile up
+            while (settled.load(std::memory_order_relaxed) < issued) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    });
+
+    auto sample = [&] {
+        Counters counters;
+        counters.allocations = allocationSnapshot();
+        counters.packets = settled.load(std::memory_order_relaxed);
+        counters.sent = counters.packets;
+        counters.wakeups = jsInvoker.invocations();
+        return counters;
+    };
+    measure(options, result, sample, {&latency});
+
+    stopping = true;
+    jsThread.join();
+    controlQueue.flush();
+    jsInvoker.flush();
+    result.latency = latency.summary();
+    return result;
+}
+
+// Micro scenarios publish their counters once per chunk of steps, so publishing costs little
+const uint64_t kMicroChunk = 256;
+
+// Calls `step` back to back on a worker thread, with no sockets. Each call handles one
+// packet and returns its bytes. Latency is the mean time per step over each chunk.
+template <typename Step>
+Result runMicro(const Options& options, Result result, Step step) {
+    UDPLatencyHistogram latency;
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> packets{0};
+    std::atomic<uint64_t> bytes{0};
+
+    std::thread worker([&] {
+        uint64_t done = 0;
+        uint64_t doneBytes = 0;
+        while (!stopping.load(std::memory_order_relaxed)) {
+            uint64_t startNs = UDPMonotonicNowNs();
+            for (uint64_t i = 0; i < kMicroChunk; i++) {
+                doneBytes += step();
+            }
+            latency.record((UDPMonotonicNowNs() - startNs) / kMicroChunk);
+            done += kMicroChunk;
+            packets.store(done, std::memory_order_relaxed);
+            bytes.store(doneBytes, std::memory_order_relaxed);
+        }
+    });
+
+    auto sample = [&] {
+        Counters counters;
+        counters.allocations = allocationSnapshot();
+        counters.packets = packets.load(std::memory_order_relaxed);
+        counters.bytes = bytes.load(std::memory_order_relaxed);
+        return counters;
+    };
+    measure(options, result, sample, {&latency});
+
+    stopping = true;
+    worker.join();
+    result.latency = latency.summary();
+    return result;
+}
+
+// Finding a socket's state from a delegate callback, at `sockets` open sockets: the
+// generation-checked handle table, or the linear scan over socket pointers it replaced
+Result runLookup(const Options& options, size_t sockets, bool scan) {
+    Result result;
+    result.name = std::string(scan ? "lookup-scan-" : "lookup-handle-") + std::to_string(sockets);
+    result.description = scan ? "socket state found by scanning the socket pointers"
+                              : "socket state found through a generation-checked handle";
+
+    struct BenchSocketState {
+        uint32_t id = 0;
+    };
+    std::vector<std::unique_ptr<BenchSocketState>> states;
+    std::vector<const void*> pointers;
+    std::vector<UDPHandleTable<BenchSocketState*>::Handle> handles;
+    UDPHandleTable<BenchSocketState*> table;
+    for (size_t i = 0; i < sockets; i++) {
+        states.push_back(std::make_unique<BenchSocketState>());
+        states.back()->id = (uint32_t)i;
+        pointers.push_back(states.back().get());
+        handles.push_back(table.allocate(states.back().get()));
+    }
+
+    // Callbacks arrive for sockets in no particular order
+    uint64_t random = 0x9E3779B97F4A7C15ull;
+    uint64_t found = 0;
+    result = runMicro(options, result, [&]() -> size_t {
+        random = random * 6364136223846793005ull + 1442695040888963407ull;
+        size_t pick = (size_t)(random >> 33) % sockets;
+        if (scan) {
+            const void* target = pointers[pick];
+            for (size_t i = 0; i < sockets; i++) {
+                if (pointers[i] == target) {
+                    found += states[i]->id;
+                    break;
+                }
+            }
+        } else if (BenchSocketState** state = table.get(handles[pick])) {
+            found += (*state)->id;
+        }
+        return 0;
+    });
+    // Keeps the lookups from being optimised away
+    if (found == UINT64_MAX) {
+        fprintf(stderr, "udp_bench: %llu\n", (unsigned long long)found);
+    }
+    return result;
+}
+
+// Checksum throughput over payload-sized datagrams: each CRC32C kernel this CPU has,
+// xxHash64, and the receive stage verifying and stripping a CRC32C trailer
+void runChecksums(const Options& options, std::vector<Result>& results) {
+    std::vector<uint8_t> datagram(options.payloadBytes);
+    for (size_t i = 0; i < datagram.size(); i++) {
+        datagram[i] = (uint8_t)(i * 131 + 7);
+    }
+    const uint8_t* data = datagram.data();
+    size_t length = datagram.size();
+    uint64_t digest = 0;
+
+    for (const UDPCrc32cKernel& kernel : UDPCrc32cKernels()) {
+        Result result;
+        result.name = std::string("checksum-crc32c-") + kernel.name;
+        result.description = std::string("CRC32C of each datagram with the ") + kernel.name + " kernel";
+        auto update = kernel.update;
+        results.push_back(runMicro(options, result, [&]() -> size_t {
+            digest += update(0xFFFFFFFFu, data, length);
+            return length;
+        }));
+    }
+
+    Result xxh64;
+    xxh64.name = "checksum-xxh64";
+    xxh64.description = "xxHash64 of each datagram";
+    results.push_back(runMicro(options, xxh64, [&]() -> size_t {
+        digest += UDPXxHash64(data, length);
+        return length;
+    }));
+
+    // The trailer goes on top of the payload, as a sender stamps it
+    UDPChecksumConfig config;
+    UDPChecksumVerifier verifier(config);
+    std::vector<uint8_t> stamped(datagram);
+    stamped.resize(length + UDPChecksumVerifier::trailerSize(config.kind));
+    verifier.stamp(stamped.data(), length, stamped.size());
+    Result verify;
+    verify.name = "checksum-verify";
+    verify.description = "receive-stage CRC32C trailer check of each datagram";
+    results.push_back(runMicro(options, verify, [&]() -> size_t {
+        size_t verifiedLength = stamped.size();
+        digest += verifier.verify(stamped.data(), verifiedLength) ? 1 : 0;
+        return stamped.size();
+    }));
+
+    // Keeps the checksums from being optimised away
+    if (digest == UINT64_MAX) {
+        fprintf(stderr, "udp_bench: %llu\n", (unsigned long long)digest);
+    }
+}
+
+// Each scenario appends one result, or one per configuration it sweeps
+struct Scenario {
+    const char* name;
+    std::function<void(const Options&, std::vector<Result>&)> run;
+};
+
+const std::vector<Scenario>& scenarios() {
+    static const std::vector<Scenario> all = {
+        {"pipeline", [](const Options& options, std::vector<Result>& results) {
+             results.push_back(runPipeline(options, PipelineMode::Plain));
+         }},
+        {"pipeline-traced", [](const Options& options, std::vector<Result>& results) {
+             results.push_back(runPipeline(options, PipelineMode::Traced));
+         }},
+        {"pipeline-base64", [](const Options& options, std::vector<Result>& results) {
+             results.push_back(runPipeline(options, PipelineMode::Base64));
+         }},
+        {"replay", [](const Options& options, std::vector<Result>& results) {
+             results.push_back(runReplay(options));
+         }},
+        {"echo", [](const Options& options, std::vector<Result>& results) {
+             results.push_back(runEcho(options));
+         }},
+        {"flood", [](const Options& options, std::vector<Result>& results) {
+             results.push_back(runFlood(options, FloodMode::Events));
+         }},
+        {"flood-batched", [](const Options& options, std::vector<Result>& results) {
+             results.push_back(runFlood(options, FloodMode::Batched));
+         }},
+        {"flood-sendto", [](const Options& options, std::vector<Result>& results) {
+             results.push_back(runFlood(options, FloodMode::SendTo));
+         }},
+        {"flood-sharded", [](const Options& options, std::vector<Result>& results) {
+             for (size_t queues : {1, 2, 4}) {
+                 results.push_back(runShardedFlood(options, queues));
+             }
+         }},
+        {"fragments", [](const Options& options, std::vector<Result>& results) {
+             for (unsigned lossPercent : {0u, 1u, 5u}) {
+                 results.push_back(runFragments(options, lossPercent));
+             }
+         }},
+        {"send", [](const Options& options, std::vector<Result>& results) {
+             results.push_back(runSend(options, false));
+             results.push_back(runSend(options, true));
+         }},
+        {"send-destination", [](const Options& options, std::vector<Result>& results) {
+             results.push_back(runSendDestination(options, DestinationMode::Host));
+             results.push_back(runSendDestination(options, DestinationMode::Endpoint));
+             results.push_back(runSendDestination(options, DestinationMode::Connected));
+         }},
+        {"control", [](const Options& options, std::vector<Result>& results) {
+             results.push_back(runControl(options, false));
+             results.push_back(runControl(options, true));
+         }},
+        {"checksum", runChecksums},
+        {"lookup", [](const Options& options, std::vector<Result>& results) {
+             for (size_t sockets : {1, 10, 100, 1000}) {
+                 results.push_back(runLookup(options, sockets, false));
+                 results.push_back(runLookup(options, sockets, true));
+             }
+         }},
+    };
+    return all;
+}
+
+const Scenario* findScenario(const std::string& name) {
+    for (const Scenario& scenario : scenarios()) {
+        if (name == scenario.name) {
+            return &scenario;
+        }
+    }
+    return nullptr;
+}
+
+double perPacket(uint64_t value, uint64_t packets) {
+    return packets == 0 ? 0 : (double)value / (double)packets;
+}
+
+std::string jsonString(const std::string& value) {
+    std::string out = "\"";
+    for (char c : value) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+std::string jsonNumber(double value) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.6g", value);
+    return text;
+}
+
+std::string latencyJson(const UDPLatencySummary& summary) {
+    std::ostringstream out;
+    out << "{\"count\": " << summary.count << ", \"min\": " << summary.minNs << ", \"mean\": "
+        << jsonNumber(summary.meanNs) << ", \"p50\": " << summary.p50Ns << ", \"p90\": " << summary.p90Ns
+        << ", \"p99\": " << summary.p99Ns << ", \"p999\": " << summary.p999Ns << ", \"max\": " << summary.maxNs
+        << "}";
+    return out.str();
+}
+
+std::string resultJson(const Result& result) {
+    const Counters& c = result.counters;
+    uint64_t syscalls = c.sendSyscalls + c.receiveSyscalls + c.polls;
+    std::ostringstream out;
+    out << "    {\n"
+        << "      \"name\": " << jsonString(result.name) << ",\n"
+        << "      \"description\": " << jsonString(result.description) << ",\n"
+        << "      \"seconds\": " << jsonNumber(result.seconds) << ",\n"
+        << "      \"packets\": " << c.packets << ",\n"
+        << "      \"bytes\": " << c.bytes << ",\n"
+        << "      \"pps\": " << jsonNumber(result.seconds > 0 ? c.packets / result.seconds : 0) << ",\n"
+        << "      \"mbPerSecond\": " << jsonNumber(result.seconds > 0 ? c.bytes / result.seconds / 1e6 : 0) << ",\n"
+        << "      \"latencyNs\": " << latencyJson(result.latency) << ",\n"
+        << "      \"deliveryLatencyNs\": " << latencyJson(result.delivery) << ",\n"
+        << "      \"allocationsPerPacket\": " << jsonNumber(perPacket(c.allocations.count, c.packets)) << ",\n"
+        << "      \"allocatedBytesPerPacket\": " << jsonNumber(perPacket(c.allocations.bytes, c.packets)) << ",\n"
+        << "      \"syscallsPerPacket\": " << jsonNumber(perPacket(syscalls, c.packets)) << ",\n"
+        << "      \"syscalls\": {\"send\": " << c.sendSyscalls << ", \"receive\": " << c.receiveSyscalls
+        << ", \"poll\": " << c.polls << "},\n"
+        << "      \"wakeupsPerPacket\": " << jsonNumber(perPacket(c.wakeups, c.packets)) << ",\n"
+        << "      \"sent\": " << c.sent << ",\n"
+        << "      \"dropped\": " << c.drops << ",\n"
+        << "      \"lost\": " << result.lost << "\n"
+        << "    }";
+    return out.str();
+}
+
+std::string reportJson(const Options& options, const std::vector<Result>& results) {
+    struct utsname host;
+    memset(&host, 0, sizeof(host));
+    uname(&host);
+    char timestamp[32];
+    time_t now = time(nullptr);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    std::ostringstream out;
+    out << "{\n"
+        << "  \"schema\": " << kSchemaVersion << ",\n"
+        << "  \"version\": " << jsonString(UDP_DIRECT_VERSION) << ",\n"
+        << "  \"timestamp\": " << jsonString(timestamp) << ",\n"
+        << "  \"host\": {\"system\": " << jsonString(host.sysname) << ", \"release\": " << jsonString(host.release)
+        << ", \"machine\": " << jsonString(host.machine) << ", \"cpus\": " << std::thread::hardware_concurrency()
+        << ", \"compiler\": " << jsonString(__VERSION__) << ", \"buildType\": " << jsonString(UDP_BENCH_BUILD_TYPE)
+        << "},\n"
+        << "  \"config\": {\"seconds\": " << jsonNumber(options.seconds) << ", \"warmupSeconds\": "
+        << jsonNumber(options.warmupSeconds) << ", \"payloadBytes\": " << options.payloadBytes
+        << ", \"window\": " << options.window << ", \"floodRate\": " << options.floodRate << "},\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        out << resultJson(results[i]) << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return out.str();
+}
+
+void printSummary(const Result& result) {
+    const Counters& c = result.counters;
+    double pps = result.seconds > 0 ? c.packets / result.seconds : 0;
+    fprintf(stderr, "%-20s %10.0f pps %8.1f MB/s  p50 %7.1f us  p99 %8.1f us  p999 %8.1f us  "
+                    "%5.2f allocs/pkt  %5.2f syscalls/pkt  lost %llu\n",
+            result.name.c_str(), pps, result.seconds > 0 ? c.bytes / result.seconds / 1e6 : 0,
+            result.latency.p50Ns / 1e3, result.latency.p99Ns / 1e3, result.latency.p999Ns / 1e3,
+            perPacket(c.allocations.count, c.packets),
+            perPacket(c.sendSyscalls + c.receiveSyscalls + c.polls, c.packets), (unsigned long long)result.lost);
+}
+
+void usage() {
+    std::string names;
+    for (const Scenario& scenario : scenarios()) {
+        names += names.empty() ? "" : ", ";
+        names += scenario.name;
+    }
+    fprintf(stderr,
+            "usage: udp_bench [options]\n"
+            "  --scenarios LIST  comma-separated: %s (default: all)\n"
+            "  --seconds N       measured time per scenario (default 2)\n"
+            "  --warmup N        unmeasured time before it (default 0.2)\n"
+            "  --payload BYTES   datagram size, %zu to 65507 (default 256)\n"
+            "  --window N        echo round trips in flight (default 1)\n"
+            "  --rate PPS        flood send rate, 0 for unlimited (default 0)\n"
+            "  --output FILE     write the JSON report there instead of stdout\n",
+            names.c_str(), kStampBytes);
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (const Scenario& scenario : scenarios()) {
+        options.scenarios.push_back(scenario.name);
+    }
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        }
+        if (i + 1 >= argc) {
+            fprintf(stderr, "udp_bench: %s needs a value\n", arg.c_str());
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--scenarios") {
+            options.scenarios.clear();
+            std::stringstream list(value);
+            std::string name;
+            while (std::getline(list, name, ',')) {
+                if (!findScenario(name)) {
+                    fprintf(stderr, "udp_bench: unknown scenario %s\n", name.c_str());
+                    return false;
+                }
+                options.scenarios.push_back(name);
+            }
+        } else if (arg == "--seconds") {
+            options.seconds = atof(value.c_str());
+        } else if (arg == "--warmup") {
+            options.warmupSeconds = atof(value.c_str());
+        } else if (arg == "--payload") {
+            options.payloadBytes = strtoul(value.c_str(), nullptr, 10);
+        } else if (arg == "--window") {
+            options.window = atoi(value.c_str());
+        } else if (arg == "--rate") {
+            options.floodRate = strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--output") {
+            options.output = value;
+        } else {
+            fprintf(stderr, "udp_bench: unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    if (options.payloadBytes < kStampBytes || options.payloadBytes > 65507) {
+        fprintf(stderr, "udp_bench: --payload must be %zu to 65507 bytes\n", kStampBytes);
+        return false;
+    }
+    if (options.seconds <= 0 || options.warmupSeconds < 0 || options.window < 1 || options.scenarios.empty()) {
+        fprintf(stderr, "udp_bench: --seconds must be positive, --warmup not negative, --window at least 1\n");
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+
+    std::vector<Result> results;
+    for (const std::string& name : options.scenarios) {
+        size_t first = results.size();
+        findScenario(name)->run(options, results);
+        for (size_t i = first; i < results.size(); i++) {
+            printSummary(results[i]);
+        }
+    }
+
+    std::string report = reportJson(options, results);
+    if (options.output.empty()) {
+        fputs(report.c_str(), stdout);
+        return 0;
+    }
+    FILE* file = fopen(options.output.c_str(), "w");
+    if (!file || fputs(report.c_str(), file) < 0 || fclose(file) != 0) {
+        fprintf(stderr, "udp_bench: cannot write %s: %s\n", options.output.c_str(), strerror(errno));
+        return 1;
+    }
+    return 0;
+}
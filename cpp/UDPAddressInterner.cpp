@@ -0,0 +1,28 @@
+#include "UDPAddressInterner.h"
+
+namespace udpdirect {
+
+UDPAddressInterner::UDPAddressInterner(size_t capacity) {
+    size_t slotCount = 1;
+    while (slotCount < capacity) {
+        slotCount <<= 1;
+    }
+    slots_.reset(new Slot[slotCount]);
+    mask_ = slotCount - 1;
+}
+
+const std::string& UDPAddressInterner::host(const UDPSocketAddress& address) {
+    UDPSocketAddress key = address;
+    key.port = 0;
+    Slot& slot = slots_[key.hash() & mask_];
+    if (slot.address == key && slot.address) {
+        hits_++;
+        return slot.host;
+    }
+    misses_++;
+    slot.address = key;
+    slot.host = key.hostString();
+    return slot.host;
+}
+
+} // namespace udpdirect
@@ -0,0 +1,57 @@
+#pragma once
+
+// UDPAddressInterner - small direct-mapped cache from a binary sender address
+// to its numeric host string, so a busy peer is formatted once instead of once
+// per datagram.
+
+#include "UDPSocketAddress.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace udpdirect {
+
+/**
+ * UDPAddressInterner
+ *
+ * Keyed by family, address bytes and scope; the port is not part of the key.
+ * A sender whose slot is taken by another address is formatted again on its
+ * next lookup and takes the slot back, so the table never grows and needs no
+ * eviction policy.
+ *
+ * Not thread-safe; the JSI layer keeps it on the JS thread.
+ */
+class UDPAddressInterner {
+public:
+    /**
+     * @param capacity Slot count, rounded up to a power of two
+     */
+    explicit UDPAddressInterner(size_t capacity = 256);
+
+    UDPAddressInterner(const UDPAddressInterner&) = delete;
+    UDPAddressInterner& operator=(const UDPAddressInterner&) = delete;
+
+    /**
+     * Host string of `address`. The reference stays valid until the next
+     * call.
+     */
+    const std::string& host(const UDPSocketAddress& address);
+
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+
+private:
+    struct Slot {
+        UDPSocketAddress address;  // port always 0
+        std::string host;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+} // namespace udpdirect
@@ -0,0 +1,286 @@
+#include "UDPBatchIO.h"
+#include "UDPSocketStats.h"
+
+#include <cerrno>
+#include <cstring>
+#include <sys/time.h>
+#include <time.h>
+
+namespace udpdirect {
+
+// Wall-clock nanoseconds from a SCM_TIMESTAMP(NS) control message, 0 if there is none
+static uint64_t kernelTimestampNs(const msghdr& header) {
+    if (header.msg_controllen < sizeof(cmsghdr)) {
+        return 0;
+    }
+    msghdr& mutableHeader = const_cast<msghdr&>(header);
+    for (cmsghdr* control = CMSG_FIRSTHDR(&mutableHeader); control; control = CMSG_NXTHDR(&mutableHeader, control)) {
+        if (control->cmsg_level != SOL_SOCKET) {
+            continue;
+        }
+#if defined(SCM_TIMESTAMPNS)
+        if (control->cmsg_type == SCM_TIMESTAMPNS) {
+            timespec time;
+            memcpy(&time, CMSG_DATA(control), sizeof(time));
+            return (uint64_t)time.tv_sec * 1000000000ull + (uint64_t)time.tv_nsec;
+        }
+#endif
+        if (control->cmsg_type == SCM_TIMESTAMP) {
+            timeval time;
+            memcpy(&time, CMSG_DATA(control), sizeof(time));
+            return (uint64_t)time.tv_sec * 1000000000ull + (uint64_t)time.tv_usec * 1000ull;
+        }
+    }
+    return 0;
+}
+
+UDPBatchIO::UDPBatchIO(std::shared_ptr<UDPBufferPool> receivePool) : receivePool_(std::move(receivePool)) {
+    memset(iov_, 0, sizeof(iov_));
+    memset(addresses_, 0, sizeof(addresses_));
+    memset(messages_, 0, sizeof(messages_));
+    memset(control_, 0, sizeof(control_));
+}
+
+int UDPBatchIO::enableReceiveTimestamps(int fd) {
+    int on = 1;
+#if defined(SO_TIMESTAMPNS)
+    int option = SO_TIMESTAMPNS;
+#else
+    int option = SO_TIMESTAMP;
+#endif
+    return setsockopt(fd, SOL_SOCKET, option, &on, sizeof(on)) == 0 ? 0 : errno;
+}
+
+UDPBatchIO::~UDPBatchIO() {
+    releaseReserve();
+}
+
+void UDPBatchIO::prepareSend(const UDPBatchSendItem* items, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        iov_[i].iov_base = const_cast<uint8_t*>(items[i].data);
+        iov_[i].iov_len = items[i].length;
+
+#if UDP_BATCH_IO_HAS_MMSG
+        msghdr& header = messages_[i].msg_hdr;
+#else
+        msghdr& header = messages_[i];
+#endif
+        memset(&header, 0, sizeof(header));
+        header.msg_name = &addresses_[i];
+        header.msg_namelen = items[i].destination.toSockaddr(addresses_[i]);
+        header.msg_iov = &iov_[i];
+        header.msg_iovlen = 1;
+    }
+}
+
+size_t UDPBatchIO::send(int fd, const UDPBatchSendItem* items, size_t count, int& error) {
+    error = 0;
+    size_t sent = 0;
+    uint64_t bytes = 0;
+
+    while (sent < count) {
+        size_t chunk = count - sent < kMaxBatch ? count - sent : kMaxBatch;
+        prepareSend(items + sent, chunk);
+
+#if UDP_BATCH_IO_HAS_MMSG
+        int result = sendmmsg(fd, messages_, (unsigned int)chunk, MSG_DONTWAIT);
+        sendSyscalls_.fetch_add(1, std::memory_order_relaxed);
+        if (result < 0) {
+            error = errno;
+            break;
+        }
+        for (int i = 0; i < result; i++) {
+            bytes += items[sent + i].length;
+        }
+        sent += (size_t)result;
+        if ((size_t)result < chunk) {
+            // sendmmsg only reports why the next message failed on a later call;
+            // treat a short count as would-block.
+            error = EAGAIN;
+            break;
+        }
+#else
+        size_t i = 0;
+        for (; i < chunk; i++) {
+            ssize_t result = sendmsg(fd, &messages_[i], MSG_DONTWAIT);
+            sendSyscalls_.fetch_add(1, std::memory_order_relaxed);
+            if (result < 0) {
+                error = errno;
+                break;
+            }
+            bytes += items[sent + i].length;
+        }
+        sent += i;
+        if (error != 0) {
+            break;
+        }
+#endif
+    }
+
+    sentPackets_.fetch_add(sent, std::memory_order_relaxed);
+    sentBytes_.fetch_add(bytes, std::memory_order_relaxed);
+    return sent;
+}
+
+bool UDPBatchIO::fillReserve(size_t slotSize, size_t count) {
+    if (reserveCount_ > 0 && reserveSlotSize_ != slotSize) {
+        releaseReserve();
+    }
+    reserveSlotSize_ = slotSize;
+    while (reserveCount_ < count) {
+        UDPBufferSlot slot = receivePool_->acquire(slotSize);
+        if (!slot) {
+            break;
+        }
+        reserve_[reserveCount_++] = slot;
+    }
+    return reserveCount_ > 0;
+}
+
+void UDPBatchIO::prepareReceive(size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        iov_[i].iov_base = reserve_[i].data;
+        iov_[i].iov_len = reserve_[i].capacity;
+
+#if UDP_BATCH_IO_HAS_MMSG
+        msghdr& header = messages_[i].msg_hdr;
+        messages_[i].msg_len = 0;
+#else
+        msghdr& header = messages_[i];
+#endif
+        memset(&header, 0, sizeof(header));
+        header.msg_name = &addresses_[i];
+        header.msg_namelen = sizeof(sockaddr_storage);
+        header.msg_iov = &iov_[i];
+        header.msg_iovlen = 1;
+        header.msg_control = control_[i];
+        header.msg_controllen = kControlSize;
+    }
+}
+
+size_t UDPBatchIO::receive(int fd, size_t slotSize, UDPReceivedDatagram* out, size_t maxCount, int& error) {
+    error = 0;
+    if (!receivePool_ || maxCount == 0) {
+        error = EINVAL;
+        return 0;
+    }
+    if (maxCount > kMaxBatch) {
+        maxCount = kMaxBatch;
+    }
+
+    if (!fillReserve(slotSize, maxCount)) {
+        // Pool exhausted. Consume one datagram anyway so a level-triggered read
+        // source does not spin on it; a zero-length read discards it.
+        ssize_t discarded = recv(fd, nullptr, 0, MSG_DONTWAIT);
+        receiveSyscalls_.fetch_add(1, std::memory_order_relaxed);
+        if (discarded < 0) {
+            error = errno;
+        } else {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            error = ENOBUFS;
+        }
+        return 0;
+    }
+    size_t count = reserveCount_ < maxCount ? reserveCount_ : maxCount;
+    prepareReceive(count);
+
+    size_t received = 0;
+#if UDP_BATCH_IO_HAS_MMSG
+    int result = recvmmsg(fd, messages_, (unsigned int)count, MSG_DONTWAIT, nullptr);
+    receiveSyscalls_.fetch_add(1, std::memory_order_relaxed);
+    if (result < 0) {
+        error = errno;
+        return 0;
+    }
+    received = (size_t)result;
+#else
+    for (; received < count; received++) {
+        ssize_t result = recvmsg(fd, &messages_[received], MSG_DONTWAIT);
+        receiveSyscalls_.fetch_add(1, std::memory_order_relaxed);
+        if (result < 0) {
+            error = errno;
+            break;
+        }
+        iov_[received].iov_len = (size_t)result;
+    }
+    if (received > 0 && (error == EAGAIN || error == EWOULDBLOCK)) {
+        error = 0;
+    }
+#endif
+
+    size_t delivered = 0;
+    size_t kept = 0;
+    uint64_t bytes = 0;
+    uint64_t timestamped = 0;
+    uint64_t monotonicNowNs = 0;
+    uint64_t realtimeNowNs = 0;
+    for (size_t i = 0; i < received; i++) {
+#if UDP_BATCH_IO_HAS_MMSG
+        const msghdr& header = messages_[i].msg_hdr;
+        size_t length = messages_[i].msg_len;
+#else
+        const msghdr& header = messages_[i];
+        size_t length = iov_[i].iov_len;
+#endif
+        if (header.msg_flags & MSG_TRUNC) {
+            truncated_.fetch_add(1, std::memory_order_relaxed);
+            reserve_[kept++] = reserve_[i];
+            continue;
+        }
+        UDPReceivedDatagram& datagram = out[delivered++];
+        datagram.slot = reserve_[i];
+        datagram.slot.length = (uint32_t)length;
+        UDPSocketAddress::fromSockaddr(reinterpret_cast<const sockaddr*>(&addresses_[i]), header.msg_namelen,
+                                       datagram.source);
+        bytes += length;
+
+        // The kernel stamps with the wall clock; carry the datagram's age over to the
+        // monotonic clock, sampling both clocks once per batch
+        datagram.kernelTimestampNs = 0;
+        uint64_t kernelNs = kernelTimestampNs(header);
+        if (kernelNs != 0) {
+            if (timestamped++ == 0) {
+                monotonicNowNs = UDPMonotonicNowNs();
+                realtimeNowNs = UDPRealtimeNowNs();
+            }
+            uint64_t ageNs = realtimeNowNs > kernelNs ? realtimeNowNs - kernelNs : 0;
+            datagram.kernelTimestampNs = ageNs < monotonicNowNs ? monotonicNowNs - ageNs : 1;
+        }
+    }
+
+    // Compact the reserve: slots of truncated datagrams plus the untouched tail
+    for (size_t i = received; i < reserveCount_; i++) {
+        reserve_[kept++] = reserve_[i];
+    }
+    reserveCount_ = kept;
+
+    receivedPackets_.fetch_add(delivered, std::memory_order_relaxed);
+    receivedBytes_.fetch_add(bytes, std::memory_order_relaxed);
+    if (timestamped > 0) {
+        timestamped_.fetch_add(timestamped, std::memory_order_relaxed);
+    }
+    return delivered;
+}
+
+void UDPBatchIO::releaseReserve() {
+    for (size_t i = 0; i < reserveCount_; i++) {
+        receivePool_->release(reserve_[i]);
+    }
+    reserveCount_ = 0;
+}
+
+UDPBatchIOStats UDPBatchIO::stats() const {
+    UDPBatchIOStats stats;
+    stats.sendSyscalls = sendSyscalls_.load(std::memory_order_relaxed);
+    stats.sentPackets = sentPackets_.load(std::memory_order_relaxed);
+    stats.sentBytes = sentBytes_.load(std::memory_order_relaxed);
+    stats.receiveSyscalls = receiveSyscalls_.load(std::memory_order_relaxed);
+    stats.receivedPackets = receivedPackets_.load(std::memory_order_relaxed);
+    stats.receivedBytes = receivedBytes_.load(std::memory_order_relaxed);
+    stats.truncated = truncated_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.timestamped = timestamped_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace udpdirect
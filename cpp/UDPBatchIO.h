@@ -0,0 +1,156 @@
+#pragma once
+
+// UDPBatchIO - batched datagram send/receive on a raw socket descriptor.
+// Uses sendmmsg/recvmmsg on Linux and a sendmsg/recvmsg loop elsewhere.
+
+#include "UDPBufferPool.h"
+#include "UDPSocketAddress.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+// Define as 0 to exercise the portable loop on Linux
+#ifndef UDP_BATCH_IO_HAS_MMSG
+#if defined(__linux__)
+#define UDP_BATCH_IO_HAS_MMSG 1
+#else
+#define UDP_BATCH_IO_HAS_MMSG 0
+#endif
+#endif
+
+namespace udpdirect {
+
+/**
+ * One outbound datagram. `data` is only read during UDPBatchIO::send().
+ */
+struct UDPBatchSendItem {
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+    UDPSocketAddress destination;
+};
+
+/**
+ * One inbound datagram. The caller owns `slot` and must release it to the pool.
+ */
+struct UDPReceivedDatagram {
+    UDPBufferSlot slot;
+    UDPSocketAddress source;
+    // When the kernel received the datagram, moved onto the UDPMonotonicNowNs
+    // clock; 0 unless timestamps are enabled on the socket
+    uint64_t kernelTimestampNs = 0;
+};
+
+/**
+ * Counters for judging syscall amortisation: packets per syscall is
+ * sentPackets / sendSyscalls (and likewise for receive). A receive call that
+ * only finds EAGAIN still counts as a syscall.
+ */
+struct UDPBatchIOStats {
+    uint64_t sendSyscalls = 0;
+    uint64_t sentPackets = 0;
+    uint64_t sentBytes = 0;
+    uint64_t receiveSyscalls = 0;
+    uint64_t receivedPackets = 0;
+    uint64_t receivedBytes = 0;
+    uint64_t truncated = 0;  // datagrams larger than the receive slot size, dropped
+    uint64_t dropped = 0;    // datagrams discarded because the pool was exhausted
+    uint64_t timestamped = 0;  // received datagrams that carried a kernel timestamp
+};
+
+/**
+ * UDPBatchIO
+ *
+ * Not thread-safe: each instance keeps its message headers preallocated and
+ * is meant to be driven from one thread (or under one lock). Stats can be read
+ * from any thread.
+ *
+ * All calls are non-blocking (MSG_DONTWAIT). Errors are reported through the
+ * `error` out-parameter as an errno value, 0 on success; EAGAIN simply means
+ * the socket buffer is full (send) or empty (receive).
+ */
+class UDPBatchIO {
+public:
+    static constexpr size_t kMaxBatch = 64;
+    static constexpr size_t kControlSize = 64;  // room for one timestamp control message
+
+    /**
+     * @param receivePool Pool that receive() fills; may be null for send-only use
+     */
+    explicit UDPBatchIO(std::shared_ptr<UDPBufferPool> receivePool = nullptr);
+    ~UDPBatchIO();
+
+    UDPBatchIO(const UDPBatchIO&) = delete;
+    UDPBatchIO& operator=(const UDPBatchIO&) = delete;
+
+    /**
+     * Send `count` datagrams on `fd` in order, stopping at the first one the
+     * kernel does not accept.
+     *
+     * @return Number of datagrams sent from the front of `items`
+     */
+    size_t send(int fd, const UDPBatchSendItem* items, size_t count, int& error);
+
+    /**
+     * Receive up to `maxCount` (at most kMaxBatch) queued datagrams into pool
+     * slots able to hold `slotSize` bytes. Datagrams that do not fit are
+     * dropped and counted as truncated.
+     *
+     * Unused slots are kept in a small reserve for the next call instead of
+     * going back to the pool, so they show up as in use in the pool stats.
+     *
+     * @return Number of entries written to `out`
+     */
+    size_t receive(int fd, size_t slotSize, UDPReceivedDatagram* out, size_t maxCount, int& error);
+
+    /**
+     * Hand the receive reserve back to the pool.
+     */
+    void releaseReserve();
+
+    /**
+     * Ask the kernel to timestamp datagrams received on `fd`
+     * (SO_TIMESTAMPNS on Linux, SO_TIMESTAMP elsewhere). receive() then fills
+     * in kernelTimestampNs.
+     *
+     * @return 0 on success, otherwise an errno value
+     */
+    static int enableReceiveTimestamps(int fd);
+
+    UDPBatchIOStats stats() const;
+
+private:
+    bool fillReserve(size_t slotSize, size_t count);
+    void prepareSend(const UDPBatchSendItem* items, size_t count);
+    void prepareReceive(size_t count);
+
+    std::shared_ptr<UDPBufferPool> receivePool_;
+
+    UDPBufferSlot reserve_[kMaxBatch];
+    size_t reserveCount_ = 0;
+    size_t reserveSlotSize_ = 0;
+
+    iovec iov_[kMaxBatch];
+    sockaddr_storage addresses_[kMaxBatch];
+    alignas(cmsghdr) uint8_t control_[kMaxBatch][kControlSize];
+#if UDP_BATCH_IO_HAS_MMSG
+    mmsghdr messages_[kMaxBatch];
+#else
+    msghdr messages_[kMaxBatch];
+#endif
+
+    std::atomic<uint64_t> sendSyscalls_{0};
+    std::atomic<uint64_t> sentPackets_{0};
+    std::atomic<uint64_t> sentBytes_{0};
+    std::atomic<uint64_t> receiveSyscalls_{0};
+    std::atomic<uint64_t> receivedPackets_{0};
+    std::atomic<uint64_t> receivedBytes_{0};
+    std::atomic<uint64_t> truncated_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> timestamped_{0};
+};
+
+} // namespace udpdirect
@@ -0,0 +1,52 @@
+#include "UDPBlockCache.h"
+
+#include <new>
+
+namespace udpdirect {
+
+UDPBlockCache::UDPBlockCache(size_t blockSize, size_t maxCached) : blockSize_(blockSize), maxCached_(maxCached) {
+    free_.reserve(maxCached_);
+}
+
+UDPBlockCache::~UDPBlockCache() {
+    for (void* block : free_) {
+        ::operator delete(block);
+    }
+}
+
+void* UDPBlockCache::allocate(size_t bytes) {
+    if (bytes <= blockSize_) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+            void* block = free_.back();
+            free_.pop_back();
+            reused_.fetch_add(1, std::memory_order_relaxed);
+            return block;
+        }
+    }
+    allocated_.fetch_add(1, std::memory_order_relaxed);
+    // Every cacheable block is blockSize_ long, whatever it was first asked for
+    return ::operator new(bytes <= blockSize_ ? blockSize_ : bytes);
+}
+
+void UDPBlockCache::deallocate(void* block, size_t bytes) {
+    if (bytes <= blockSize_) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.size() < maxCached_) {
+            free_.push_back(block);
+            return;
+        }
+    }
+    ::operator delete(block);
+}
+
+UDPBlockCacheStats UDPBlockCache::stats() const {
+    UDPBlockCacheStats stats;
+    stats.reused = reused_.load(std::memory_order_relaxed);
+    stats.allocated = allocated_.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.cached = free_.size();
+    return stats;
+}
+
+} // namespace udpdirect
@@ -0,0 +1,96 @@
+#pragma once
+
+// UDPBlockCache - fixed-size heap blocks kept on a free list once released,
+// for the small objects made and dropped once per datagram (message events
+// and the buffers behind their ArrayBuffers). With UDPRecyclingAllocator and
+// std::allocate_shared, object and control block come out of one cached
+// block, so a steady stream of events stops reaching the heap.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace udpdirect {
+
+struct UDPBlockCacheStats {
+    uint64_t reused = 0;     // allocations served from the free list
+    uint64_t allocated = 0;  // allocations that went to the heap
+    uint64_t cached = 0;     // blocks on the free list now
+};
+
+/**
+ * UDPBlockCache
+ *
+ * Blocks are allocated lazily and never given back while the cache lives,
+ * up to maxCached of them; beyond that, released blocks are freed. Requests
+ * larger than blockSize bypass the cache.
+ *
+ * Thread-safe: objects are usually made on the JS thread and released by
+ * whichever thread runs the garbage collector's finalizers.
+ */
+class UDPBlockCache {
+public:
+    UDPBlockCache(size_t blockSize, size_t maxCached);
+    ~UDPBlockCache();
+
+    UDPBlockCache(const UDPBlockCache&) = delete;
+    UDPBlockCache& operator=(const UDPBlockCache&) = delete;
+
+    void* allocate(size_t bytes);
+    void deallocate(void* block, size_t bytes);
+
+    size_t blockSize() const { return blockSize_; }
+    UDPBlockCacheStats stats() const;
+
+private:
+    size_t blockSize_;
+    size_t maxCached_;
+    mutable std::mutex mutex_;
+    std::vector<void*> free_;  // reserved up front, so push_back never allocates
+
+    std::atomic<uint64_t> reused_{0};
+    std::atomic<uint64_t> allocated_{0};
+};
+
+/**
+ * Allocator over a UDPBlockCache, for std::allocate_shared. Copies share the
+ * cache, which stays alive until the last object made through it is gone.
+ */
+template <typename T>
+class UDPRecyclingAllocator {
+public:
+    using value_type = T;
+
+    explicit UDPRecyclingAllocator(std::shared_ptr<UDPBlockCache> cache) : cache_(std::move(cache)) {}
+
+    template <typename U>
+    UDPRecyclingAllocator(const UDPRecyclingAllocator<U>& other) : cache_(other.cache()) {}
+
+    T* allocate(size_t count) { return static_cast<T*>(cache_->allocate(count * sizeof(T))); }
+    void deallocate(T* pointer, size_t count) { cache_->deallocate(pointer, count * sizeof(T)); }
+
+    const std::shared_ptr<UDPBlockCache>& cache() const { return cache_; }
+
+    template <typename U>
+    bool operator==(const UDPRecyclingAllocator<U>& other) const { return cache_ == other.cache(); }
+    template <typename U>
+    bool operator!=(const UDPRecyclingAllocator<U>& other) const { return cache_ != other.cache(); }
+
+private:
+    std::shared_ptr<UDPBlockCache> cache_;
+};
+
+/**
+ * std::allocate_shared through `cache`: one cached block for the object and
+ * its control block.
+ */
+template <typename T, typename... Args>
+std::shared_ptr<T> UDPMakeRecycled(const std::shared_ptr<UDPBlockCache>& cache, Args&&... args) {
+    return std::allocate_shared<T>(UDPRecyclingAllocator<T>(cache), std::forward<Args>(args)...);
+}
+
+} // namespace udpdirect
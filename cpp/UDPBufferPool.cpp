@@ -0,0 +1,269 @@
+#include "UDPBufferPool.h"
+
+#include <new>
+
+namespace udpdirect {
+
+namespace {
+
+// Keep every slot cache-line aligned so neighbouring datagrams written on the
+// delegate queue never share a line with one being read on the JS thread.
+constexpr uint32_t kSlotAlignment = 64;
+
+uint32_t roundUp(uint32_t value, uint32_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Heap slots carry their reference count in a header in front of the data
+struct HeapSlotHeader {
+    std::atomic<uint32_t> refs;
+    uint32_t length;
+};
+constexpr size_t kHeapHeaderSize = kSlotAlignment;
+static_assert(sizeof(HeapSlotHeader) <= kHeapHeaderSize, "heap slot header too large");
+
+HeapSlotHeader* heapHeader(const UDPBufferSlot& slot) {
+    return reinterpret_cast<HeapSlotHeader*>(slot.data - kHeapHeaderSize);
+}
+
+} // namespace
+
+UDPBufferPool::UDPBufferPool() : UDPBufferPool(Config()) {}
+
+UDPBufferPool::UDPBufferPool(const Config& config) {
+    for (size_t c = 0; c < kSizeClassCount; c++) {
+        SizeClass& sizeClass = classes_[c];
+        sizeClass.slotSize = kSizeClasses[c];
+        sizeClass.stride = roundUp(kSizeClasses[c], kSlotAlignment);
+        sizeClass.slotCount = config.slotCounts[c];
+
+        if (sizeClass.slotCount == 0) {
+            sizeClass.head.store(kNil, std::memory_order_relaxed);
+            continue;
+        }
+
+        sizeClass.slab.reset(new uint8_t[(size_t)sizeClass.stride * sizeClass.slotCount]);
+        sizeClass.next.reset(new std::atomic<uint32_t>[sizeClass.slotCount]);
+        sizeClass.refs.reset(new std::atomic<uint32_t>[sizeClass.slotCount]);
+        for (uint32_t i = 0; i < sizeClass.slotCount; i++) {
+            uint32_t next = (i + 1 < sizeClass.slotCount) ? i + 1 : kNil;
+            sizeClass.next[i].store(next, std::memory_order_relaxed);
+            sizeClass.refs[i].store(0, std::memory_order_relaxed);
+        }
+        sizeClass.head.store(0, std::memory_order_relaxed);
+        slabBytes_ += (uint64_t)sizeClass.slotSize * sizeClass.slotCount;
+    }
+    setBudget(config.budgetBytes, config.overflow);
+}
+
+UDPBufferPool::~UDPBufferPool() = default;
+
+bool UDPBufferPool::pop(SizeClass& sizeClass, uint32_t& index) {
+    uint64_t head = sizeClass.head.load(std::memory_order_acquire);
+    for (;;) {
+        uint32_t top = (uint32_t)head;
+        if (top == kNil) {
+            return false;
+        }
+        uint32_t next = sizeClass.next[top].load(std::memory_order_relaxed);
+        uint64_t replacement = (((head >> 32) + 1) << 32) | next;
+        if (sizeClass.head.compare_exchange_weak(head, replacement,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_acquire)) {
+            index = top;
+            return true;
+        }
+    }
+}
+
+void UDPBufferPool::push(SizeClass& sizeClass, uint32_t index) {
+    uint64_t head = sizeClass.head.load(std::memory_order_relaxed);
+    uint64_t replacement;
+    do {
+        sizeClass.next[index].store((uint32_t)head, std::memory_order_relaxed);
+        replacement = (((head >> 32) + 1) << 32) | index;
+    } while (!sizeClass.head.compare_exchange_weak(head, replacement,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed));
+}
+
+bool UDPBufferPool::reserveBytes(uint64_t bytes) {
+    uint64_t budget = budgetBytes_.load(std::memory_order_relaxed);
+    uint64_t inUse = inUseBytes_.load(std::memory_order_relaxed);
+    do {
+        if (inUse + bytes > budget) {
+            return false;
+        }
+    } while (!inUseBytes_.compare_exchange_weak(inUse, inUse + bytes, std::memory_order_relaxed));
+
+    uint64_t highWater = highWaterBytes_.load(std::memory_order_relaxed);
+    while (inUse + bytes > highWater &&
+           !highWaterBytes_.compare_exchange_weak(highWater, inUse + bytes, std::memory_order_relaxed)) {
+    }
+    return true;
+}
+
+void UDPBufferPool::unreserveBytes(uint64_t bytes) {
+    inUseBytes_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+std::atomic<uint32_t>* UDPBufferPool::refCount(const UDPBufferSlot& slot) {
+    if (!slot) {
+        return nullptr;
+    }
+    if (slot.sizeClass == kHeapClass) {
+        return &heapHeader(slot)->refs;
+    }
+    if (slot.sizeClass >= kSizeClassCount || slot.index >= classes_[slot.sizeClass].slotCount) {
+        return nullptr;
+    }
+    return &classes_[slot.sizeClass].refs[slot.index];
+}
+
+UDPBufferSlot UDPBufferPool::acquireHeap(size_t length) {
+    UDPBufferSlot slot;
+    if (!reserveBytes(length)) {
+        overBudget_.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+    uint8_t* block = new (std::nothrow) uint8_t[kHeapHeaderSize + (length > 0 ? length : 1)];
+    if (!block) {
+        unreserveBytes(length);
+        return slot;
+    }
+    auto* header = new (block) HeapSlotHeader;
+    header->refs.store(1, std::memory_order_relaxed);
+    header->length = (uint32_t)length;
+
+    heapInUse_.fetch_add(1, std::memory_order_relaxed);
+    heapAcquired_.fetch_add(1, std::memory_order_relaxed);
+
+    slot.data = block + kHeapHeaderSize;
+    slot.capacity = (uint32_t)length;
+    slot.length = (uint32_t)length;
+    slot.sizeClass = kHeapClass;
+    return slot;
+}
+
+UDPBufferSlot UDPBufferPool::acquire(size_t length) {
+    UDPBufferSlot slot;
+    if (length > maxSlotSize()) {
+        return slot;
+    }
+
+    size_t first = 0;
+    while (first < kSizeClassCount && kSizeClasses[first] < length) {
+        first++;
+    }
+
+    bool overBudget = false;
+    for (size_t c = first; c < kSizeClassCount; c++) {
+        SizeClass& sizeClass = classes_[c];
+        if (!reserveBytes(sizeClass.slotSize)) {
+            // Larger classes would cost even more; a heap slot only costs `length`
+            overBudget = true;
+            break;
+        }
+        uint32_t index;
+        if (!pop(sizeClass, index)) {
+            unreserveBytes(sizeClass.slotSize);
+            continue;
+        }
+
+        uint32_t inUse = sizeClass.inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+        uint32_t highWater = sizeClass.highWater.load(std::memory_order_relaxed);
+        while (inUse > highWater &&
+               !sizeClass.highWater.compare_exchange_weak(highWater, inUse, std::memory_order_relaxed)) {
+        }
+        sizeClass.acquired.fetch_add(1, std::memory_order_relaxed);
+        sizeClass.refs[index].store(1, std::memory_order_relaxed);
+
+        slot.data = sizeClass.slab.get() + (size_t)sizeClass.stride * index;
+        slot.capacity = sizeClass.slotSize;
+        slot.length = (uint32_t)length;
+        slot.index = index;
+        slot.sizeClass = (uint16_t)c;
+        return slot;
+    }
+
+    if (!overBudget) {
+        classes_[first < kSizeClassCount ? first : kSizeClassCount - 1].exhausted.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (overflow_.load(std::memory_order_relaxed) == UDPPoolOverflowPolicy::Heap) {
+        return acquireHeap(length);
+    }
+    if (overBudget) {
+        overBudget_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return slot;
+}
+
+void UDPBufferPool::retain(const UDPBufferSlot& slot) {
+    if (std::atomic<uint32_t>* refs = refCount(slot)) {
+        refs->fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void UDPBufferPool::release(const UDPBufferSlot& slot) {
+    std::atomic<uint32_t>* refs = refCount(slot);
+    if (!refs) {
+        return;
+    }
+    // acq_rel so the last owner sees every write made through other references
+    if (refs->fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    if (slot.sizeClass == kHeapClass) {
+        HeapSlotHeader* header = heapHeader(slot);
+        unreserveBytes(header->length);
+        heapInUse_.fetch_sub(1, std::memory_order_relaxed);
+        header->~HeapSlotHeader();
+        delete[] reinterpret_cast<uint8_t*>(header);
+        return;
+    }
+
+    SizeClass& sizeClass = classes_[slot.sizeClass];
+    sizeClass.inUse.fetch_sub(1, std::memory_order_relaxed);
+    unreserveBytes(sizeClass.slotSize);
+    push(sizeClass, slot.index);
+}
+
+void UDPBufferPool::setBudget(uint64_t budgetBytes, UDPPoolOverflowPolicy overflow) {
+    budgetBytes_.store(budgetBytes != 0 ? budgetBytes : defaultBudget(overflow), std::memory_order_relaxed);
+    defaultBudget_.store(budgetBytes == 0, std::memory_order_relaxed);
+    overflow_.store(overflow, std::memory_order_relaxed);
+}
+
+uint64_t UDPBufferPool::defaultBudget(UDPPoolOverflowPolicy overflow) const {
+    if (overflow == UDPPoolOverflowPolicy::Heap) {
+        return slabBytes_ + slabBytes_ * kDefaultHeapHeadroomPercent / 100;
+    }
+    return slabBytes_;
+}
+
+void UDPBufferPool::getStats(UDPBufferPoolClassStats* out) const {
+    for (size_t c = 0; c < kSizeClassCount; c++) {
+        const SizeClass& sizeClass = classes_[c];
+        out[c].slotSize = sizeClass.slotSize;
+        out[c].slotCount = sizeClass.slotCount;
+        out[c].inUse = sizeClass.inUse.load(std::memory_order_relaxed);
+        out[c].highWater = sizeClass.highWater.load(std::memory_order_relaxed);
+        out[c].acquired = sizeClass.acquired.load(std::memory_order_relaxed);
+        out[c].exhausted = sizeClass.exhausted.load(std::memory_order_relaxed);
+    }
+}
+
+UDPBufferPoolBudgetStats UDPBufferPool::budgetStats() const {
+    UDPBufferPoolBudgetStats stats;
+    stats.budgetBytes = budgetBytes_.load(std::memory_order_relaxed);
+    stats.defaultBudget = defaultBudget_.load(std::memory_order_relaxed);
+    stats.inUseBytes = inUseBytes_.load(std::memory_order_relaxed);
+    stats.highWaterBytes = highWaterBytes_.load(std::memory_order_relaxed);
+    stats.heapInUse = heapInUse_.load(std::memory_order_relaxed);
+    stats.heapAcquired = heapAcquired_.load(std::memory_order_relaxed);
+    stats.overBudget = overBudget_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace udpdirect
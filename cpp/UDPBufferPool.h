@@ -0,0 +1,184 @@
+#pragma once
+
+// UDPBufferPool - fixed-slab receive buffer pool shared by the socket layer
+// and the JSI bindings. Portable C++17, no Objective-C or JSI dependencies.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace udpdirect {
+
+/**
+ * Handle to one slot of a UDPBufferPool.
+ *
+ * This is a plain value type so it can be captured by Objective-C blocks and
+ * std::function lambdas. Slots are reference counted: acquire() hands out one
+ * reference, retain() adds more, and every reference is handed back with
+ * UDPBufferPool::release() exactly once.
+ */
+struct UDPBufferSlot {
+    uint8_t* data = nullptr;
+    uint32_t capacity = 0;
+    uint32_t length = 0;
+    uint32_t index = 0;
+    uint16_t sizeClass = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+/**
+ * Snapshot of one size class, used for diagnostics.
+ */
+struct UDPBufferPoolClassStats {
+    uint32_t slotSize = 0;
+    uint32_t slotCount = 0;
+    uint32_t inUse = 0;
+    uint32_t highWater = 0;
+    uint64_t acquired = 0;
+    uint64_t exhausted = 0;  // acquire() found this class (and all larger ones) empty
+};
+
+/**
+ * What acquire() does once no preallocated slot fits.
+ */
+enum class UDPPoolOverflowPolicy {
+    Drop,  // fail the acquire; the caller drops the datagram
+    Heap   // allocate the slot from the heap, still within the byte budget
+};
+
+/**
+ * Pool-wide accounting against the byte budget. Slab slots count their full
+ * slot size, heap slots their length.
+ */
+struct UDPBufferPoolBudgetStats {
+    uint64_t budgetBytes = 0;
+    bool defaultBudget = true;  // budgetBytes was derived from the slab size, not set explicitly
+    uint64_t inUseBytes = 0;
+    uint64_t highWaterBytes = 0;
+    uint32_t heapInUse = 0;
+    uint64_t heapAcquired = 0;
+    uint64_t overBudget = 0;  // acquires refused because they would exceed the budget
+};
+
+/**
+ * UDPBufferPool
+ *
+ * Preallocates every slot up front, one contiguous slab per size class, so the
+ * steady-state receive path never touches the heap. Slots are acquired on the
+ * socket delegate queue and released from whichever thread drops the last
+ * reference (usually the JS thread when an ArrayBuffer is collected), so the
+ * free lists are lock-free tagged stacks.
+ */
+class UDPBufferPool {
+public:
+    static constexpr size_t kSizeClassCount = 3;
+    static constexpr uint32_t kSizeClasses[kSizeClassCount] = {1500, 9000, 65535};
+
+    struct Config {
+        uint32_t slotCounts[kSizeClassCount] = {1024, 64, 16};
+        uint64_t budgetBytes = 0;  // cap on bytes held in slots; 0 means defaultBudget(overflow)
+        UDPPoolOverflowPolicy overflow = UDPPoolOverflowPolicy::Drop;
+    };
+
+    UDPBufferPool();
+    explicit UDPBufferPool(const Config& config);
+    ~UDPBufferPool();
+
+    UDPBufferPool(const UDPBufferPool&) = delete;
+    UDPBufferPool& operator=(const UDPBufferPool&) = delete;
+
+    /**
+     * Acquire a slot able to hold `length` bytes. Picks the smallest size class
+     * that fits and spills into larger classes when it is exhausted.
+     *
+     * @return A slot with `length` preset and one reference, or an empty slot
+     *         if nothing fits or the budget is spent.
+     */
+    UDPBufferSlot acquire(size_t length);
+
+    /**
+     * Add a reference to a slot already held by the caller. Safe to call from
+     * any thread.
+     */
+    void retain(const UDPBufferSlot& slot);
+
+    /**
+     * Drop one reference; the last one returns the slot to its free list (or
+     * frees a heap slot). O(1) and safe to call from any thread.
+     */
+    void release(const UDPBufferSlot& slot);
+
+    /**
+     * Change the budget and overflow policy at runtime. Slots already handed
+     * out are not affected, so inUseBytes may sit above a lowered budget
+     * until they come back.
+     *
+     * @param budgetBytes Cap on bytes held in slots, or 0 for defaultBudget(overflow)
+     */
+    void setBudget(uint64_t budgetBytes, UDPPoolOverflowPolicy overflow);
+
+    /**
+     * The budget used when none is given: the slab size under Drop, and the
+     * slab size plus kDefaultHeapHeadroomPercent of it under Heap. The slabs
+     * alone fill a slab-sized budget, so Heap needs room above it to ever
+     * allocate.
+     */
+    uint64_t defaultBudget(UDPPoolOverflowPolicy overflow) const;
+
+    static constexpr uint64_t kDefaultHeapHeadroomPercent = 50;
+
+    /**
+     * Fill `out` with one entry per size class (kSizeClassCount entries).
+     */
+    void getStats(UDPBufferPoolClassStats* out) const;
+
+    UDPBufferPoolBudgetStats budgetStats() const;
+
+    /**
+     * Bytes of preallocated slab, the default budget.
+     */
+    uint64_t slabBytes() const { return slabBytes_; }
+
+    static constexpr uint32_t maxSlotSize() { return kSizeClasses[kSizeClassCount - 1]; }
+
+private:
+    struct SizeClass {
+        uint32_t slotSize = 0;
+        uint32_t stride = 0;
+        uint32_t slotCount = 0;
+        std::unique_ptr<uint8_t[]> slab;
+        std::unique_ptr<std::atomic<uint32_t>[]> next;
+        std::unique_ptr<std::atomic<uint32_t>[]> refs;
+        std::atomic<uint64_t> head{0};  // (tag << 32) | index
+        std::atomic<uint32_t> inUse{0};
+        std::atomic<uint32_t> highWater{0};
+        std::atomic<uint64_t> acquired{0};
+        std::atomic<uint64_t> exhausted{0};
+    };
+
+    static constexpr uint32_t kNil = 0xFFFFFFFFu;
+    static constexpr uint16_t kHeapClass = kSizeClassCount;  // sizeClass of heap-allocated slots
+
+    bool pop(SizeClass& sizeClass, uint32_t& index);
+    void push(SizeClass& sizeClass, uint32_t index);
+    bool reserveBytes(uint64_t bytes);
+    void unreserveBytes(uint64_t bytes);
+    std::atomic<uint32_t>* refCount(const UDPBufferSlot& slot);
+    UDPBufferSlot acquireHeap(size_t length);
+
+    SizeClass classes_[kSizeClassCount];
+    uint64_t slabBytes_ = 0;
+
+    std::atomic<uint64_t> budgetBytes_{0};
+    std::atomic<bool> defaultBudget_{true};
+    std::atomic<UDPPoolOverflowPolicy> overflow_{UDPPoolOverflowPolicy::Drop};
+    std::atomic<uint64_t> inUseBytes_{0};
+    std::atomic<uint64_t> highWaterBytes_{0};
+    std::atomic<uint32_t> heapInUse_{0};
+    std::atomic<uint64_t> heapAcquired_{0};
+    std::atomic<uint64_t> overBudget_{0};
+};
+
+} // namespace udpdirect
@@ -0,0 +1,791 @@
+#include "UDPCapture.h"
+
+#include "UDPSocketStats.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace udpdirect {
+
+namespace {
+
+// pcapng block types and options
+constexpr uint32_t kSectionHeaderBlock = 0x0A0D0D0A;
+constexpr uint32_t kInterfaceBlock = 0x00000001;
+constexpr uint32_t kSimplePacketBlock = 0x00000003;
+constexpr uint32_t kEnhancedPacketBlock = 0x00000006;
+constexpr uint32_t kByteOrderMagic = 0x1A2B3C4D;
+constexpr uint16_t kOptionEnd = 0;
+constexpr uint16_t kOptionIfName = 2;
+constexpr uint16_t kOptionIfTsresol = 9;
+constexpr uint16_t kOptionEpbFlags = 2;
+
+// classic pcap magics, as read in file byte order
+constexpr uint32_t kPcapMicros = 0xA1B2C3D4;
+constexpr uint32_t kPcapNanos = 0xA1B23C4D;
+
+// link types
+constexpr uint32_t kLinkNull = 0;
+constexpr uint32_t kLinkEthernet = 1;
+constexpr uint32_t kLinkRaw = 101;
+constexpr uint32_t kLinkLoop = 108;
+constexpr uint32_t kLinkLinuxSll = 113;
+constexpr uint32_t kLinkIPv4 = 228;
+constexpr uint32_t kLinkIPv6 = 229;
+constexpr uint32_t kLinkLinuxSll2 = 276;
+
+constexpr size_t kIPv4HeaderSize = 20;
+constexpr size_t kIPv6HeaderSize = 40;
+constexpr size_t kUDPHeaderSize = 8;
+constexpr size_t kEnhancedPacketOverhead = 28 + 12 + 4;  // header, epb_flags + end, trailing length
+
+const char kSocketPrefix[] = "socket ";
+
+size_t pad4(size_t length) {
+    return (length + 3) & ~(size_t)3;
+}
+
+void putBE16(uint8_t* p, uint16_t value) {
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)value;
+}
+
+uint16_t getBE16(const uint8_t* p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+uint16_t ipv4HeaderChecksum(const uint8_t* header) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < kIPv4HeaderSize; i += 2) {
+        sum += getBE16(header + i);
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return (uint16_t)~sum;
+}
+
+bool writeAll(int fd, const uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = ::write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return true;
+}
+
+uint64_t ticksToNs(uint64_t ticks, uint64_t ticksPerSecond) {
+    if (ticksPerSecond == 1000000000ULL) {
+        return ticks;
+    }
+    if (ticksPerSecond == 0) {
+        return 0;
+    }
+    return ticks / ticksPerSecond * 1000000000ULL + ticks % ticksPerSecond * 1000000000ULL / ticksPerSecond;
+}
+
+/**
+ * IP and UDP header for a datagram between `source` and `destination`; the
+ * family comes from whichever address is set. Returns the header length.
+ */
+size_t buildHeaders(uint8_t* out, const UDPSocketAddress& source, const UDPSocketAddress& destination,
+                    size_t payloadLength) {
+    bool ipv6 = source.isIPv6() || destination.isIPv6();
+    size_t udpLength = std::min(kUDPHeaderSize + payloadLength, (size_t)0xFFFF);
+    uint8_t* udp;
+    if (ipv6) {
+        memset(out, 0, kIPv6HeaderSize);
+        out[0] = 0x60;
+        putBE16(out + 4, (uint16_t)udpLength);
+        out[6] = IPPROTO_UDP;
+        out[7] = 64;
+        if (source.isIPv6()) {
+            memcpy(out + 8, source.bytes, 16);
+        }
+        if (destination.isIPv6()) {
+            memcpy(out + 24, destination.bytes, 16);
+        }
+        udp = out + kIPv6HeaderSize;
+    } else {
+        memset(out, 0, kIPv4HeaderSize);
+        out[0] = 0x45;
+        putBE16(out + 2, (uint16_t)std::min(kIPv4HeaderSize + udpLength, (size_t)0xFFFF));
+        putBE16(out + 6, 0x4000);  // don't fragment
+        out[8] = 64;
+        out[9] = IPPROTO_UDP;
+        memcpy(out + 12, source.bytes, 4);
+        memcpy(out + 16, destination.bytes, 4);
+        putBE16(out + 10, ipv4HeaderChecksum(out));
+        udp = out + kIPv4HeaderSize;
+    }
+    putBE16(udp, source.port);
+    putBE16(udp + 2, destination.port);
+    putBE16(udp + 4, (uint16_t)udpLength);
+    putBE16(udp + 6, 0);  // no checksum
+    return (ipv6 ? kIPv6HeaderSize : kIPv4HeaderSize) + kUDPHeaderSize;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// UDPCapture
+
+std::string UDPCapture::validate(const UDPCaptureConfig& config) {
+    if (config.snapLength == 0 || config.snapLength > kMaxSnapLength) {
+        return "snapLength must be 1 to " + std::to_string(kMaxSnapLength) + " bytes";
+    }
+    if (config.ringBytes < kMinRingBytes || config.ringBytes > kMaxRingBytes) {
+        return "ringBytes must be " + std::to_string(kMinRingBytes / 1024) + " KB to " +
+               std::to_string(kMaxRingBytes / (1024 * 1024)) + " MB";
+    }
+    return std::string();
+}
+
+UDPCapture::~UDPCapture() {
+    stop();
+}
+
+std::string UDPCapture::start(const std::string& path, const UDPCaptureConfig& config) {
+    std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+    if (active_.load(std::memory_order_relaxed)) {
+        return "capture already running";
+    }
+    std::string error = validate(config);
+    if (!error.empty()) {
+        return error;
+    }
+    if (path.empty()) {
+        return "path is empty";
+    }
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return "cannot open " + path + ": " + strerror(errno);
+    }
+    // Preallocated and touched once here, so recording never faults pages in
+    void* ring = mmap(nullptr, config.ringBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED) {
+        ::close(fd);
+        return "cannot map a " + std::to_string(config.ringBytes) + " byte ring: " + strerror(errno);
+    }
+    memset(ring, 0, config.ringBytes);
+
+    // Section header: byte-order magic, version 1.0, section length unknown
+    uint8_t header[28];
+    uint32_t headerWords[] = {kSectionHeaderBlock, (uint32_t)sizeof(header), kByteOrderMagic};
+    memcpy(header, headerWords, 12);
+    uint16_t version[] = {1, 0};
+    memcpy(header + 12, version, 4);
+    int64_t sectionLength = -1;
+    memcpy(header + 16, &sectionLength, 8);
+    uint32_t trailer = sizeof(header);
+    memcpy(header + 24, &trailer, 4);
+    if (!writeAll(fd, header, sizeof(header))) {
+        std::string message = "cannot write " + path + ": " + strerror(errno);
+        munmap(ring, config.ringBytes);
+        ::close(fd);
+        return message;
+    }
+
+    captured_.store(0, std::memory_order_relaxed);
+    dropped_.store(0, std::memory_order_relaxed);
+    truncated_.store(0, std::memory_order_relaxed);
+    bytesWritten_.store(sizeof(header), std::memory_order_relaxed);
+    writeErrors_.store(0, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ring_ = (uint8_t*)ring;
+        ringBytes_ = config.ringBytes;
+        head_ = tail_ = used_ = highWater_ = 0;
+        stopping_ = false;
+        snapLength_ = config.snapLength;
+        wallOffsetNs_ = (int64_t)UDPRealtimeNowNs() - (int64_t)UDPMonotonicNowNs();
+        interfaces_.clear();
+    }
+    fd_ = fd;
+    writer_ = std::thread([this] { writerLoop(); });
+    active_.store(true, std::memory_order_relaxed);
+    return std::string();
+}
+
+void UDPCapture::stop() {
+    std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+    if (!active_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    active_.store(false, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    writer_.join();
+
+    uint8_t* ring;
+    size_t ringBytes;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ring = ring_;
+        ringBytes = ringBytes_;
+        ring_ = nullptr;
+        ringBytes_ = 0;
+    }
+    munmap(ring, ringBytes);
+    if (::close(fd_) != 0) {
+        writeErrors_.fetch_add(1, std::memory_order_relaxed);
+    }
+    fd_ = -1;
+}
+
+void UDPCapture::noteSocket(uint32_t socketId, uint16_t localPort) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    localPorts_[socketId] = localPort;
+}
+
+void UDPCapture::forgetSocket(uint32_t socketId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    localPorts_.erase(socketId);
+}
+
+void UDPCapture::put(const void* bytes, size_t length) {
+    size_t first = std::min(length, ringBytes_ - head_);
+    memcpy(ring_ + head_, bytes, first);
+    if (first < length) {
+        memcpy(ring_, (const uint8_t*)bytes + first, length - first);
+    }
+    head_ = (head_ + length) % ringBytes_;
+    used_ += length;
+}
+
+void UDPCapture::record(UDPCaptureDirection direction, uint32_t socketId, const UDPSocketAddress& peer,
+                        const uint8_t* data, size_t length, uint64_t monotonicNs) {
+    if (!active_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (monotonicNs == 0) {
+        monotonicNs = UDPMonotonicNowNs();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stopping_ || !ring_) {
+        return;
+    }
+
+    UDPSocketAddress local;
+    local.family = peer.isIPv6() ? AF_INET6 : AF_INET;
+    auto port = localPorts_.find(socketId);
+    local.port = port != localPorts_.end() ? port->second : 0;
+
+    uint8_t headers[kIPv6HeaderSize + kUDPHeaderSize];
+    size_t headerLength = direction == UDPCaptureDirection::Outbound ? buildHeaders(headers, local, peer, length)
+                                                                     : buildHeaders(headers, peer, local, length);
+    size_t kept = std::min(length, (size_t)snapLength_);
+    size_t packetLength = headerLength + kept;
+    size_t blockLength = kEnhancedPacketOverhead + pad4(packetLength);
+
+    // The first record of a socket also carries its interface block
+    auto known = interfaces_.find(socketId);
+    bool newInterface = known == interfaces_.end();
+    std::string name;
+    size_t interfaceLength = 0;
+    if (newInterface) {
+        name = kSocketPrefix + std::to_string(socketId);
+        // header, linktype + snaplen, if_name, if_tsresol, end, trailing length
+        interfaceLength = 16 + 4 + pad4(name.size()) + 8 + 4 + 4;
+    }
+
+    if (ringBytes_ - used_ < blockLength + interfaceLength) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    bool wasEmpty = used_ == 0;
+    static const uint8_t zeros[4] = {};
+
+    uint32_t interfaceId;
+    if (newInterface) {
+        interfaceId = (uint32_t)interfaces_.size();
+        interfaces_.emplace(socketId, interfaceId);
+        uint32_t words[] = {kInterfaceBlock, (uint32_t)interfaceLength};
+        put(words, 8);
+        uint16_t linkType[] = {(uint16_t)kLinkRaw, 0};
+        put(linkType, 4);
+        uint32_t snapLength = snapLength_ + (uint32_t)(kIPv6HeaderSize + kUDPHeaderSize);
+        put(&snapLength, 4);
+        uint16_t nameOption[] = {kOptionIfName, (uint16_t)name.size()};
+        put(nameOption, 4);
+        put(name.data(), name.size());
+        put(zeros, pad4(name.size()) - name.size());
+        uint16_t resolutionOption[] = {kOptionIfTsresol, 1};
+        put(resolutionOption, 4);
+        uint8_t resolution[4] = {9, 0, 0, 0};  // 10^-9
+        put(resolution, 4);
+        put(zeros, 4);
+        uint32_t trailer = (uint32_t)interfaceLength;
+        put(&trailer, 4);
+    } else {
+        interfaceId = known->second;
+    }
+
+    uint64_t timestamp = (uint64_t)((int64_t)monotonicNs + wallOffsetNs_);
+    uint32_t words[] = {kEnhancedPacketBlock,
+                        (uint32_t)blockLength,
+                        interfaceId,
+                        (uint32_t)(timestamp >> 32),
+                        (uint32_t)timestamp,
+                        (uint32_t)packetLength,
+                        (uint32_t)(headerLength + length)};
+    put(words, sizeof(words));
+    put(headers, headerLength);
+    put(data, kept);
+    put(zeros, pad4(packetLength) - packetLength);
+    uint16_t flagsOption[] = {kOptionEpbFlags, 4};
+    put(flagsOption, 4);
+    uint32_t flags = (uint32_t)direction;  // bits 0-1: 1 inbound, 2 outbound
+    put(&flags, 4);
+    put(zeros, 4);
+    uint32_t trailer = (uint32_t)blockLength;
+    put(&trailer, 4);
+
+    highWater_ = std::max(highWater_, used_);
+    lock.unlock();
+
+    captured_.fetch_add(1, std::memory_order_relaxed);
+    if (kept < length) {
+        truncated_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (wasEmpty) {
+        wake_.notify_one();
+    }
+}
+
+void UDPCapture::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [this] { return used_ > 0 || stopping_; });
+        if (used_ == 0) {
+            return;  // stopping, and everything is out
+        }
+        // Producers never reuse bytes until used_ drops, so the chunk is safe to write unlocked
+        size_t chunk = std::min(used_, ringBytes_ - tail_);
+        const uint8_t* from = ring_ + tail_;
+        lock.unlock();
+        if (writeAll(fd_, from, chunk)) {
+            bytesWritten_.fetch_add(chunk, std::memory_order_relaxed);
+        } else {
+            writeErrors_.fetch_add(1, std::memory_order_relaxed);
+        }
+        lock.lock();
+        tail_ = (tail_ + chunk) % ringBytes_;
+        used_ -= chunk;
+    }
+}
+
+UDPCaptureStats UDPCapture::stats() const {
+    UDPCaptureStats stats;
+    stats.active = active();
+    stats.captured = captured_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.truncated = truncated_.load(std::memory_order_relaxed);
+    stats.bytesWritten = bytesWritten_.load(std::memory_order_relaxed);
+    stats.writeErrors = writeErrors_.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.ringBytes = ringBytes_;
+    stats.ringHighWater = highWater_;
+    return stats;
+}
+
+// ---------------------------------------------------------------------------
+// UDPCaptureReader
+
+UDPCaptureReader::~UDPCaptureReader() {
+    if (data_) {
+        munmap((void*)data_, size_);
+    }
+}
+
+std::string UDPCaptureReader::open(const std::string& path) {
+    if (data_) {
+        return "reader already open";
+    }
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return "cannot open " + path + ": " + strerror(errno);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        std::string message = "cannot stat " + path + ": " + strerror(errno);
+        ::close(fd);
+        return message;
+    }
+    if (info.st_size < 24) {
+        ::close(fd);
+        return path + " is not a capture file";
+    }
+    void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return "cannot map " + path + ": " + strerror(errno);
+    }
+    data_ = (const uint8_t*)mapped;
+    size_ = (size_t)info.st_size;
+
+    uint32_t magic;
+    memcpy(&magic, data_, 4);
+    if (magic == kSectionHeaderBlock) {
+        pcapng_ = true;
+        return std::string();  // byte order is read per section
+    }
+    if (magic == kPcapMicros || magic == kPcapNanos) {
+        swapped_ = false;
+    } else if (magic == __builtin_bswap32(kPcapMicros) || magic == __builtin_bswap32(kPcapNanos)) {
+        swapped_ = true;
+        magic = __builtin_bswap32(magic);
+    } else {
+        return path + " is not a pcap or pcapng file";
+    }
+    pcapTicksPerSecond_ = magic == kPcapNanos ? 1000000000ULL : 1000000ULL;
+    pcapLinkType_ = read32(data_ + 20) & 0x0FFFFFFF;  // upper bits carry FCS information
+    offset_ = 24;
+    return std::string();
+}
+
+uint16_t UDPCaptureReader::read16(const uint8_t* p) const {
+    uint16_t value;
+    memcpy(&value, p, 2);
+    return swapped_ ? __builtin_bswap16(value) : value;
+}
+
+uint32_t UDPCaptureReader::read32(const uint8_t* p) const {
+    uint32_t value;
+    memcpy(&value, p, 4);
+    return swapped_ ? __builtin_bswap32(value) : value;
+}
+
+bool UDPCaptureReader::next(UDPCapturedDatagram& out) {
+    if (!data_ || malformed_) {
+        return false;
+    }
+    return pcapng_ ? nextPcapng(out) : nextPcap(out);
+}
+
+bool UDPCaptureReader::nextPcap(UDPCapturedDatagram& out) {
+    while (offset_ + 16 <= size_) {
+        const uint8_t* record = data_ + offset_;
+        uint64_t seconds = read32(record);
+        uint64_t fraction = read32(record + 4);
+        size_t captured = read32(record + 8);
+        size_t original = read32(record + 12);
+        if (captured > size_ - offset_ - 16) {
+            malformed_ = true;  // cut short, as a capture still being written often is
+            return false;
+        }
+        offset_ += 16 + captured;
+        out = UDPCapturedDatagram();
+        out.timestampNs = seconds * 1000000000ULL + ticksToNs(fraction, pcapTicksPerSecond_);
+        if (decode(pcapLinkType_, record + 16, captured, original, out)) {
+            return true;
+        }
+        skipped_++;
+    }
+    return false;
+}
+
+bool UDPCaptureReader::nextPcapng(UDPCapturedDatagram& out) {
+    while (offset_ + 12 <= size_) {
+        const uint8_t* block = data_ + offset_;
+        uint32_t type;
+        memcpy(&type, block, 4);  // the section header type reads the same in both byte orders
+
+        if (type == kSectionHeaderBlock) {
+            uint32_t magic;
+            memcpy(&magic, block + 8, 4);
+            if (magic == kByteOrderMagic) {
+                swapped_ = false;
+            } else if (magic == __builtin_bswap32(kByteOrderMagic)) {
+                swapped_ = true;
+            } else {
+                malformed_ = true;
+                return false;
+            }
+            interfaces_.clear();
+        } else {
+            type = read32(block);
+        }
+
+        uint32_t length = read32(block + 4);
+        if (length < 12 || length % 4 != 0 || length > size_ - offset_) {
+            malformed_ = true;
+            return false;
+        }
+        offset_ += length;
+        const uint8_t* body = block + 8;
+        size_t bodyLength = length - 12;
+
+        if (type == kInterfaceBlock) {
+            if (bodyLength < 8) {
+                malformed_ = true;
+                return false;
+            }
+            Interface interface;
+            interface.linkType = read16(body);
+            for (size_t at = 8; at + 4 <= bodyLength;) {
+                uint16_t code = read16(body + at);
+                uint16_t optionLength = read16(body + at + 2);
+                const uint8_t* value = body + at + 4;
+                if (code == kOptionEnd || at + 4 + optionLength > bodyLength) {
+                    break;
+                }
+                if (code == kOptionIfTsresol && optionLength >= 1) {
+                    uint8_t exponent = value[0] & 0x7F;
+                    uint64_t ticks = 1;
+                    for (uint8_t i = 0; i < exponent && ticks <= UINT64_MAX / 10; i++) {
+                        ticks *= (value[0] & 0x80) ? 2 : 10;
+                    }
+                    interface.ticksPerSecond = ticks;
+                } else if (code == kOptionIfName) {
+                    std::string name((const char*)value, optionLength);
+                    size_t prefix = sizeof(kSocketPrefix) - 1;
+                    if (name.compare(0, prefix, kSocketPrefix) == 0) {
+                        interface.socketId = (uint32_t)strtoul(name.c_str() + prefix, nullptr, 10);
+                    }
+                }
+                at += 4 + pad4(optionLength);
+            }
+            interfaces_.push_back(interface);
+            continue;
+        }
+
+        if (type == kEnhancedPacketBlock) {
+            if (bodyLength < 20) {
+                malformed_ = true;
+                return false;
+            }
+            uint32_t interfaceId = read32(body);
+            size_t captured = read32(body + 12);
+            size_t original = read32(body + 16);
+            if (interfaceId >= interfaces_.size() || captured > bodyLength - 20) {
+                malformed_ = true;
+                return false;
+            }
+            const Interface& interface = interfaces_[interfaceId];
+            out = UDPCapturedDatagram();
+            uint64_t ticks = ((uint64_t)read32(body + 4) << 32) | read32(body + 8);
+            out.timestampNs = ticksToNs(ticks, interface.ticksPerSecond);
+            out.socketId = interface.socketId;
+            for (size_t at = 20 + pad4(captured); at + 4 <= bodyLength;) {
+                uint16_t code = read16(body + at);
+                uint16_t optionLength = read16(body + at + 2);
+                if (code == kOptionEnd || at + 4 + optionLength > bodyLength) {
+                    break;
+                }
+                if (code == kOptionEpbFlags && optionLength == 4) {
+                    out.direction = (UDPCaptureDirection)(read32(body + at + 4) & 0x3);
+                }
+                at += 4 + pad4(optionLength);
+            }
+            if (out.direction != UDPCaptureDirection::Inbound && out.direction != UDPCaptureDirection::Outbound) {
+                out.direction = UDPCaptureDirection::Unknown;
+            }
+            if (decode(interface.linkType, body + 20, captured, original, out)) {
+                return true;
+            }
+            skipped_++;
+            continue;
+        }
+
+        if (type == kSimplePacketBlock) {
+            if (bodyLength < 4 || interfaces_.empty()) {
+                malformed_ = true;
+                return false;
+            }
+            size_t original = read32(body);
+            size_t captured = std::min(original, bodyLength - 4);
+            out = UDPCapturedDatagram();
+            out.socketId = interfaces_[0].socketId;
+            if (decode(interfaces_[0].linkType, body + 4, captured, original, out)) {
+                return true;
+            }
+            skipped_++;
+            continue;
+        }
+        // Name resolution, statistics, custom and obsolete blocks carry no datagrams
+    }
+    return false;
+}
+
+bool UDPCaptureReader::decode(uint32_t linkType, const uint8_t* data, size_t captured, size_t original,
+                              UDPCapturedDatagram& out) {
+    (void)original;  // the UDP length field says how long the datagram was
+    const uint8_t* ip = data;
+    size_t available = captured;
+
+    switch (linkType) {
+        case kLinkRaw:
+        case kLinkIPv4:
+        case kLinkIPv6:
+            break;
+        case kLinkNull:
+        case kLinkLoop:
+            // 4 byte address family whose byte order depends on the writer; the IP version says the same
+            if (available < 4) {
+                return false;
+            }
+            ip += 4;
+            available -= 4;
+            break;
+        case kLinkEthernet: {
+            if (available < 14) {
+                return false;
+            }
+            size_t header = 14;
+            uint16_t etherType = getBE16(data + 12);
+            while ((etherType == 0x8100 || etherType == 0x88A8) && available >= header + 4) {
+                etherType = getBE16(data + header + 2);  // VLAN tag
+                header += 4;
+            }
+            if (etherType != 0x0800 && etherType != 0x86DD) {
+                return false;
+            }
+            ip += header;
+            available -= header;
+            break;
+        }
+        case kLinkLinuxSll:
+            if (available < 16) {
+                return false;
+            }
+            ip += 16;
+            available -= 16;
+            break;
+        case kLinkLinuxSll2:
+            if (available < 20) {
+                return false;
+            }
+            ip += 20;
+            available -= 20;
+            break;
+        default:
+            return false;
+    }
+
+    if (available < 1) {
+        return false;
+    }
+    const uint8_t* udp;
+    size_t remaining;
+    uint8_t version = ip[0] >> 4;
+    if (version == 4) {
+        size_t headerLength = (size_t)(ip[0] & 0x0F) * 4;
+        if (headerLength < kIPv4HeaderSize || available < headerLength || ip[9] != IPPROTO_UDP) {
+            return false;
+        }
+        if ((getBE16(ip + 6) & 0x3FFF) != 0) {
+            return false;  // a fragment
+        }
+        out.source.family = out.destination.family = AF_INET;
+        memcpy(out.source.bytes, ip + 12, 4);
+        memcpy(out.destination.bytes, ip + 16, 4);
+        udp = ip + headerLength;
+        remaining = available - headerLength;
+    } else if (version == 6) {
+        if (available < kIPv6HeaderSize) {
+            return false;
+        }
+        out.source.family = out.destination.family = AF_INET6;
+        memcpy(out.source.bytes, ip + 8, 16);
+        memcpy(out.destination.bytes, ip + 24, 16);
+        uint8_t nextHeader = ip[6];
+        size_t at = kIPv6HeaderSize;
+        for (;;) {
+            if (nextHeader == IPPROTO_UDP) {
+                break;
+            }
+            if (available < at + 8) {
+                return false;
+            }
+            if (nextHeader == IPPROTO_HOPOPTS || nextHeader == IPPROTO_ROUTING || nextHeader == IPPROTO_DSTOPTS) {
+                nextHeader = ip[at];
+                at += ((size_t)ip[at + 1] + 1) * 8;
+            } else if (nextHeader == IPPROTO_FRAGMENT) {
+                if ((getBE16(ip + at + 2) & 0xFFF9) != 0) {
+                    return false;  // a real fragment, not an atomic one
+                }
+                nextHeader = ip[at];
+                at += 8;
+            } else {
+                return false;
+            }
+        }
+        if (available < at) {
+            return false;
+        }
+        udp = ip + at;
+        remaining = available - at;
+    } else {
+        return false;
+    }
+
+    if (remaining < kUDPHeaderSize) {
+        return false;
+    }
+    out.source.port = getBE16(udp);
+    out.destination.port = getBE16(udp + 2);
+    size_t udpLength = getBE16(udp + 4);
+    size_t payloadCaptured = remaining - kUDPHeaderSize;
+    // Length 0 is an IPv6 jumbogram; take what was captured
+    size_t payloadLength = udpLength >= kUDPHeaderSize ? udpLength - kUDPHeaderSize : payloadCaptured;
+    out.payload = udp + kUDPHeaderSize;
+    out.length = std::min(payloadCaptured, payloadLength);
+    out.truncated = payloadCaptured < payloadLength;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// UDPCaptureReplay
+
+UDPCaptureReplay::UDPCaptureReplay(std::unique_ptr<UDPCaptureReader> reader, const Options& options)
+    : reader_(std::move(reader)), options_(options) {}
+
+const UDPCapturedDatagram* UDPCaptureReplay::peek() {
+    if (pending_) {
+        return &current_;
+    }
+    while (reader_->next(current_)) {
+        if (current_.direction == UDPCaptureDirection::Outbound ||
+            (options_.socketId != 0 && current_.socketId != options_.socketId)) {
+            filtered_++;
+            continue;
+        }
+        pending_ = true;
+        return &current_;
+    }
+    return nullptr;
+}
+
+uint64_t UDPCaptureReplay::dueNs(uint64_t nowNs) {
+    if (!started_) {
+        started_ = true;
+        startNs_ = nowNs;
+        firstCaptureNs_ = current_.timestampNs;
+    }
+    if (options_.speed <= 0) {
+        return startNs_;
+    }
+    uint64_t offset = current_.timestampNs > firstCaptureNs_ ? current_.timestampNs - firstCaptureNs_ : 0;
+    return startNs_ + (uint64_t)((double)offset / options_.speed);
+}
+
+} // namespace udpdirect
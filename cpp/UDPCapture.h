@@ -0,0 +1,261 @@
+#pragma once
+
+// UDPCapture - opt-in pcapng recording of received and sent datagrams, and a
+// reader that plays pcapng or pcap files back as datagrams. Recording copies
+// each datagram into a preallocated ring; a background thread writes the ring
+// to the file, so the receive and send paths never touch the disk.
+
+#include "UDPSocketAddress.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace udpdirect {
+
+enum class UDPCaptureDirection : uint8_t {
+    Unknown = 0,
+    Inbound = 1,
+    Outbound = 2
+};
+
+struct UDPCaptureConfig {
+    uint32_t snapLength = 65535;        // payload bytes kept per datagram
+    size_t ringBytes = 4 * 1024 * 1024;  // records waiting for the writer thread
+};
+
+struct UDPCaptureStats {
+    bool active = false;
+    uint64_t captured = 0;      // datagrams written to the ring
+    uint64_t dropped = 0;       // datagrams lost because the ring was full
+    uint64_t truncated = 0;     // datagrams cut to snapLength
+    uint64_t bytesWritten = 0;  // file bytes, headers included
+    uint64_t writeErrors = 0;
+    size_t ringBytes = 0;
+    size_t ringHighWater = 0;
+};
+
+/**
+ * UDPCapture
+ *
+ * Writes one pcapng section. Each socket id gets its own interface block
+ * named "socket <id>" (LINKTYPE_RAW, nanosecond timestamps) the first time
+ * it records; each datagram is an enhanced packet block with a synthesized
+ * IPv4/IPv6 and UDP header carrying the peer and local port, and the
+ * direction in epb_flags. UDP checksums are left zero.
+ *
+ * record() may be called from any thread. When capture is off it costs one
+ * relaxed load; when on, one mutex acquisition and a copy into the ring. A
+ * full ring drops the datagram and counts it.
+ */
+class UDPCapture {
+public:
+    static constexpr uint32_t kMaxSnapLength = 65535;
+    static constexpr size_t kMinRingBytes = 64 * 1024;
+    static constexpr size_t kMaxRingBytes = 256 * 1024 * 1024;
+
+    /**
+     * @return Empty string if valid, otherwise what is wrong
+     */
+    static std::string validate(const UDPCaptureConfig& config);
+
+    UDPCapture() = default;
+    ~UDPCapture();
+
+    UDPCapture(const UDPCapture&) = delete;
+    UDPCapture& operator=(const UDPCapture&) = delete;
+
+    /**
+     * Create `path` (truncating it) and start recording.
+     *
+     * @return Empty string on success, otherwise what went wrong
+     */
+    std::string start(const std::string& path, const UDPCaptureConfig& config);
+
+    /**
+     * Stop recording, write out what is in the ring and close the file.
+     * Blocks until the writer thread has finished.
+     */
+    void stop();
+
+    bool active() const { return active_.load(std::memory_order_relaxed); }
+
+    /**
+     * Local port for the synthesized headers of a socket's datagrams.
+     * Remembered whether or not capture is running.
+     */
+    void noteSocket(uint32_t socketId, uint16_t localPort);
+    void forgetSocket(uint32_t socketId);
+
+    /**
+     * @param peer Sender of an inbound datagram or destination of an
+     *        outbound one; may be unset when unknown
+     * @param monotonicNs When, on the UDPMonotonicNowNs() clock; 0 reads the
+     *        clock, and only when capture is on
+     */
+    void record(UDPCaptureDirection direction, uint32_t socketId, const UDPSocketAddress& peer,
+                const uint8_t* data, size_t length, uint64_t monotonicNs = 0);
+
+    UDPCaptureStats stats() const;
+
+private:
+    void put(const void* bytes, size_t length);
+    void writerLoop();
+
+    std::mutex lifecycleMutex_;  // serialises start() and stop()
+    std::thread writer_;
+    int fd_ = -1;
+
+    // Everything below is guarded by mutex_
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    uint8_t* ring_ = nullptr;  // anonymous mapping of ringBytes_
+    size_t ringBytes_ = 0;
+    size_t head_ = 0;          // next byte producers write
+    size_t tail_ = 0;          // next byte the writer writes out
+    size_t used_ = 0;
+    size_t highWater_ = 0;
+    bool stopping_ = false;
+    uint32_t snapLength_ = kMaxSnapLength;
+    int64_t wallOffsetNs_ = 0;  // realtime minus monotonic at start()
+    std::unordered_map<uint32_t, uint32_t> interfaces_;  // socket id -> pcapng interface id
+    std::unordered_map<uint32_t, uint16_t> localPorts_;
+
+    std::atomic<bool> active_{false};
+    std::atomic<uint64_t> captured_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> truncated_{0};
+    std::atomic<uint64_t> bytesWritten_{0};
+    std::atomic<uint64_t> writeErrors_{0};
+};
+
+/**
+ * One UDP datagram from a capture file. `payload` points into the mapped
+ * file and stays valid until the reader is destroyed.
+ */
+struct UDPCapturedDatagram {
+    uint64_t timestampNs = 0;  // wall clock
+    UDPCaptureDirection direction = UDPCaptureDirection::Unknown;
+    uint32_t socketId = 0;     // from a "socket <id>" interface, 0 otherwise
+    UDPSocketAddress source;
+    UDPSocketAddress destination;
+    const uint8_t* payload = nullptr;
+    size_t length = 0;
+    bool truncated = false;    // captured with a snap length shorter than the datagram
+};
+
+/**
+ * UDPCaptureReader
+ *
+ * Reads pcapng (any number of sections and interfaces) and classic pcap
+ * files in either byte order, with raw IP, Ethernet, BSD loopback and Linux
+ * cooked link types. Packets that are not unfragmented UDP over IPv4/IPv6
+ * are skipped. The file is memory-mapped read-only.
+ *
+ * Not thread-safe.
+ */
+class UDPCaptureReader {
+public:
+    UDPCaptureReader() = default;
+    ~UDPCaptureReader();
+
+    UDPCaptureReader(const UDPCaptureReader&) = delete;
+    UDPCaptureReader& operator=(const UDPCaptureReader&) = delete;
+
+    /**
+     * @return Empty string on success, otherwise what went wrong
+     */
+    std::string open(const std::string& path);
+
+    /**
+     * Advance to the next UDP datagram.
+     *
+     * @return false at the end of the file or at the first malformed block
+     */
+    bool next(UDPCapturedDatagram& out);
+
+    uint64_t skipped() const { return skipped_; }  // packets that were not UDP
+    bool malformed() const { return malformed_; }
+
+private:
+    struct Interface {
+        uint32_t linkType = 0;
+        uint64_t ticksPerSecond = 1000000;
+        uint32_t socketId = 0;
+    };
+
+    bool nextPcapng(UDPCapturedDatagram& out);
+    bool nextPcap(UDPCapturedDatagram& out);
+    bool decode(uint32_t linkType, const uint8_t* data, size_t captured, size_t original, UDPCapturedDatagram& out);
+    uint16_t read16(const uint8_t* p) const;
+    uint32_t read32(const uint8_t* p) const;
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t offset_ = 0;
+    bool pcapng_ = false;
+    bool swapped_ = false;
+    bool malformed_ = false;
+    uint64_t skipped_ = 0;
+
+    // pcap
+    uint32_t pcapLinkType_ = 0;
+    uint64_t pcapTicksPerSecond_ = 1000000;
+
+    // pcapng, current section
+    std::vector<Interface> interfaces_;
+};
+
+/**
+ * UDPCaptureReplay
+ *
+ * Picks the inbound datagrams of a capture and schedules them against the
+ * monotonic clock: at the recorded spacing divided by `speed`, or as fast as
+ * the caller takes them when speed is 0.
+ */
+class UDPCaptureReplay {
+public:
+    struct Options {
+        double speed = 1.0;
+        uint32_t socketId = 0;  // replay only this recorded socket; 0 for all
+    };
+
+    UDPCaptureReplay(std::unique_ptr<UDPCaptureReader> reader, const Options& options);
+
+    /**
+     * The next datagram to deliver, or nullptr when the capture is done.
+     */
+    const UDPCapturedDatagram* peek();
+    void pop() { pending_ = false; delivered_++; }
+
+    /**
+     * When the peeked datagram is due, on the UDPMonotonicNowNs() clock. The
+     * first call fixes the start of the replay at `nowNs`. Call after a
+     * successful peek().
+     */
+    uint64_t dueNs(uint64_t nowNs);
+
+    uint64_t delivered() const { return delivered_; }
+    uint64_t skipped() const { return reader_->skipped() + filtered_; }
+    bool malformed() const { return reader_->malformed(); }
+
+private:
+    std::unique_ptr<UDPCaptureReader> reader_;
+    Options options_;
+    UDPCapturedDatagram current_;
+    bool pending_ = false;
+    bool started_ = false;
+    uint64_t firstCaptureNs_ = 0;
+    uint64_t startNs_ = 0;
+    uint64_t delivered_ = 0;
+    uint64_t filtered_ = 0;
+};
+
+} // namespace udpdirect
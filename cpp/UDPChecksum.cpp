@@ -0,0 +1,363 @@
+#include "UDPChecksum.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define UDP_CRC32C_X86 1
+#include <nmmintrin.h>
+#elif defined(__aarch64__)
+#define UDP_CRC32C_ARM 1
+#include <arm_acle.h>
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#elif defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+#if defined(__clang__)
+#define UDP_TARGET_CRC __attribute__((target("crc")))
+#else
+#define UDP_TARGET_CRC __attribute__((target("+crc")))
+#endif
+#endif
+
+namespace udpdirect {
+
+namespace {
+
+constexpr uint32_t kCrc32cPolynomial = 0x82F63B78;  // reflected
+
+// Bytes per stream in the three-way interleaved hardware kernels. The CRC
+// instructions have a latency of about three cycles and a throughput of one,
+// so three independent streams keep the unit busy.
+constexpr size_t kInterleaveBlock = 128;
+
+uint64_t load64(const uint8_t* data) {
+    uint64_t value;
+    memcpy(&value, data, 8);  // every supported target is little-endian
+    return value;
+}
+
+uint32_t load32(const uint8_t* data) {
+    uint32_t value;
+    memcpy(&value, data, 4);
+    return value;
+}
+
+// Slicing-by-8 tables for the portable kernel
+struct Crc32cTables {
+    uint32_t table[8][256];
+
+    Crc32cTables() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ (kCrc32cPolynomial & (0u - (crc & 1)));
+            }
+            table[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; i++) {
+            for (int slice = 1; slice < 8; slice++) {
+                table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+const Crc32cTables& crc32cTables() {
+    static const Crc32cTables tables;
+    return tables;
+}
+
+uint32_t crc32cScalar(uint32_t state, const uint8_t* data, size_t length) {
+    const auto& t = crc32cTables().table;
+    while (length >= 8) {
+        uint64_t word = load64(data) ^ state;
+        state = t[7][word & 0xFF] ^ t[6][(word >> 8) & 0xFF] ^ t[5][(word >> 16) & 0xFF] ^
+                t[4][(word >> 24) & 0xFF] ^ t[3][(word >> 32) & 0xFF] ^ t[2][(word >> 40) & 0xFF] ^
+                t[1][(word >> 48) & 0xFF] ^ t[0][word >> 56];
+        data += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        state = (state >> 8) ^ t[0][(state ^ *data++) & 0xFF];
+    }
+    return state;
+}
+
+// The CRC register is linear over GF(2), so "append kInterleaveBlock zero bytes"
+// is a 32x32 bit matrix, stored here as four byte-indexed tables. It moves a
+// stream's result past the blocks that follow it before they are combined.
+struct Crc32cShiftTables {
+    uint32_t table[4][256];
+
+    Crc32cShiftTables() {
+        static const uint8_t zeros[kInterleaveBlock] = {};
+        uint32_t columns[32];
+        for (int bit = 0; bit < 32; bit++) {
+            columns[bit] = crc32cScalar(1u << bit, zeros, kInterleaveBlock);
+        }
+        for (int byte = 0; byte < 4; byte++) {
+            for (uint32_t value = 0; value < 256; value++) {
+                uint32_t shifted = 0;
+                for (int bit = 0; bit < 8; bit++) {
+                    if (value & (1u << bit)) {
+                        shifted ^= columns[byte * 8 + bit];
+                    }
+                }
+                table[byte][value] = shifted;
+            }
+        }
+    }
+
+    uint32_t shift(uint32_t state) const {
+        return table[0][state & 0xFF] ^ table[1][(state >> 8) & 0xFF] ^ table[2][(state >> 16) & 0xFF] ^
+               table[3][state >> 24];
+    }
+};
+
+const Crc32cShiftTables& crc32cShiftTables() {
+    static const Crc32cShiftTables tables;
+    return tables;
+}
+
+#if UDP_CRC32C_X86
+
+bool cpuHasCrc32c() {
+    return __builtin_cpu_supports("sse4.2");
+}
+
+__attribute__((target("sse4.2"))) uint32_t crc32cSse42(uint32_t state, const uint8_t* data, size_t length) {
+#if defined(__x86_64__)
+    const Crc32cShiftTables& shift = crc32cShiftTables();
+    while (length >= 3 * kInterleaveBlock) {
+        uint64_t a = state;
+        uint64_t b = 0;
+        uint64_t c = 0;
+        for (size_t i = 0; i < kInterleaveBlock; i += 8) {
+            a = _mm_crc32_u64(a, load64(data + i));
+            b = _mm_crc32_u64(b, load64(data + kInterleaveBlock + i));
+            c = _mm_crc32_u64(c, load64(data + 2 * kInterleaveBlock + i));
+        }
+        state = shift.shift(shift.shift((uint32_t)a) ^ (uint32_t)b) ^ (uint32_t)c;
+        data += 3 * kInterleaveBlock;
+        length -= 3 * kInterleaveBlock;
+    }
+    uint64_t wide = state;
+    while (length >= 8) {
+        wide = _mm_crc32_u64(wide, load64(data));
+        data += 8;
+        length -= 8;
+    }
+    state = (uint32_t)wide;
+#endif
+    while (length >= 4) {
+        state = _mm_crc32_u32(state, load32(data));
+        data += 4;
+        length -= 4;
+    }
+    while (length-- > 0) {
+        state = _mm_crc32_u8(state, *data++);
+    }
+    return state;
+}
+
+#elif UDP_CRC32C_ARM
+
+bool cpuHasCrc32c() {
+#if defined(__ARM_FEATURE_CRC32)
+    return true;
+#elif defined(__APPLE__)
+    int value = 0;
+    size_t size = sizeof(value);
+    return sysctlbyname("hw.optional.armv8_crc32", &value, &size, nullptr, 0) == 0 && value != 0;
+#elif defined(__linux__)
+    return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#else
+    return false;
+#endif
+}
+
+UDP_TARGET_CRC uint32_t crc32cArmv8(uint32_t state, const uint8_t* data, size_t length) {
+    const Crc32cShiftTables& shift = crc32cShiftTables();
+    while (length >= 3 * kInterleaveBlock) {
+        uint32_t a = state;
+        uint32_t b = 0;
+        uint32_t c = 0;
+        for (size_t i = 0; i < kInterleaveBlock; i += 8) {
+            a = __crc32cd(a, load64(data + i));
+            b = __crc32cd(b, load64(data + kInterleaveBlock + i));
+            c = __crc32cd(c, load64(data + 2 * kInterleaveBlock + i));
+        }
+        state = shift.shift(shift.shift(a) ^ b) ^ c;
+        data += 3 * kInterleaveBlock;
+        length -= 3 * kInterleaveBlock;
+    }
+    while (length >= 8) {
+        state = __crc32cd(state, load64(data));
+        data += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        state = __crc32cb(state, *data++);
+    }
+    return state;
+}
+
+#endif
+
+std::vector<UDPCrc32cKernel> detectCrc32cKernels() {
+    std::vector<UDPCrc32cKernel> kernels;
+#if UDP_CRC32C_X86
+    if (cpuHasCrc32c()) {
+        kernels.push_back({"sse4.2", crc32cSse42});
+    }
+#elif UDP_CRC32C_ARM
+    if (cpuHasCrc32c()) {
+        kernels.push_back({"armv8-crc", crc32cArmv8});
+    }
+#endif
+    kernels.push_back({"scalar", crc32cScalar});
+    return kernels;
+}
+
+constexpr uint64_t kXxPrime1 = 11400714785074694791ull;
+constexpr uint64_t kXxPrime2 = 14029467366897019727ull;
+constexpr uint64_t kXxPrime3 = 1609587929392839161ull;
+constexpr uint64_t kXxPrime4 = 9650029242287828579ull;
+constexpr uint64_t kXxPrime5 = 2870177450012600261ull;
+
+uint64_t rotl64(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t xxRound(uint64_t accumulator, uint64_t input) {
+    accumulator += input * kXxPrime2;
+    return rotl64(accumulator, 31) * kXxPrime1;
+}
+
+uint64_t xxMerge(uint64_t accumulator, uint64_t value) {
+    accumulator ^= xxRound(0, value);
+    return accumulator * kXxPrime1 + kXxPrime4;
+}
+
+} // namespace
+
+const std::vector<UDPCrc32cKernel>& UDPCrc32cKernels() {
+    static const std::vector<UDPCrc32cKernel> kernels = detectCrc32cKernels();
+    return kernels;
+}
+
+uint32_t UDPCrc32c(const uint8_t* data, size_t length, uint32_t crc) {
+    static const auto update = UDPCrc32cKernels().front().update;
+    return ~update(~crc, data, length);
+}
+
+uint64_t UDPXxHash64(const uint8_t* data, size_t length, uint64_t seed) {
+    const uint8_t* end = data + length;
+    uint64_t hash;
+    if (length >= 32) {
+        // Four independent lanes per 32-byte stripe; the compiler schedules them in parallel
+        uint64_t v1 = seed + kXxPrime1 + kXxPrime2;
+        uint64_t v2 = seed + kXxPrime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - kXxPrime1;
+        const uint8_t* limit = end - 32;
+        do {
+            v1 = xxRound(v1, load64(data));
+            v2 = xxRound(v2, load64(data + 8));
+            v3 = xxRound(v3, load64(data + 16));
+            v4 = xxRound(v4, load64(data + 24));
+            data += 32;
+        } while (data <= limit);
+        hash = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        hash = xxMerge(hash, v1);
+        hash = xxMerge(hash, v2);
+        hash = xxMerge(hash, v3);
+        hash = xxMerge(hash, v4);
+    } else {
+        hash = seed + kXxPrime5;
+    }
+    hash += length;
+
+    while (data + 8 <= end) {
+        hash ^= xxRound(0, load64(data));
+        hash = rotl64(hash, 27) * kXxPrime1 + kXxPrime4;
+        data += 8;
+    }
+    if (data + 4 <= end) {
+        hash ^= (uint64_t)load32(data) * kXxPrime1;
+        hash = rotl64(hash, 23) * kXxPrime2 + kXxPrime3;
+        data += 4;
+    }
+    while (data < end) {
+        hash ^= (*data++) * kXxPrime5;
+        hash = rotl64(hash, 11) * kXxPrime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= kXxPrime2;
+    hash ^= hash >> 29;
+    hash *= kXxPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+UDPChecksumVerifier::UDPChecksumVerifier(const UDPChecksumConfig& config)
+    : config_(config), trailerSize_(trailerSize(config.kind)) {
+    // Resolve the kernel now rather than on the first datagram
+    UDPCrc32cKernels();
+}
+
+uint64_t UDPChecksumVerifier::compute(const uint8_t* data, size_t length) const {
+    if (config_.kind == UDPChecksumKind::CRC32C) {
+        return UDPCrc32c(data, length);
+    }
+    return UDPXxHash64(data, length, config_.seed);
+}
+
+bool UDPChecksumVerifier::verify(const uint8_t* data, size_t& length) {
+    if (length < config_.offset + trailerSize_) {
+        tooShort_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    size_t covered = length - trailerSize_;
+    uint64_t expected = 0;
+    for (size_t i = 0; i < trailerSize_; i++) {
+        size_t shift = config_.bigEndian ? (trailerSize_ - 1 - i) * 8 : i * 8;
+        expected |= (uint64_t)data[covered + i] << shift;
+    }
+    if (compute(data + config_.offset, covered - config_.offset) != expected) {
+        failed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    verified_.fetch_add(1, std::memory_order_relaxed);
+    if (config_.strip) {
+        length = covered;
+    }
+    return true;
+}
+
+size_t UDPChecksumVerifier::stamp(uint8_t* data, size_t payloadLength, size_t capacity) {
+    if (payloadLength < config_.offset || capacity < payloadLength + trailerSize_) {
+        return 0;
+    }
+    uint64_t value = compute(data + config_.offset, payloadLength - config_.offset);
+    for (size_t i = 0; i < trailerSize_; i++) {
+        size_t shift = config_.bigEndian ? (trailerSize_ - 1 - i) * 8 : i * 8;
+        data[payloadLength + i] = (uint8_t)(value >> shift);
+    }
+    stamped_.fetch_add(1, std::memory_order_relaxed);
+    return payloadLength + trailerSize_;
+}
+
+UDPChecksumStats UDPChecksumVerifier::stats() const {
+    UDPChecksumStats stats;
+    stats.verified = verified_.load(std::memory_order_relaxed);
+    stats.failed = failed_.load(std::memory_order_relaxed);
+    stats.tooShort = tooShort_.load(std::memory_order_relaxed);
+    stats.stamped = stamped_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace udpdirect
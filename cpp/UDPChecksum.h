@@ -0,0 +1,112 @@
+#pragma once
+
+// UDPChecksum - CRC32C and xxHash64 over datagram payloads, and a per-socket
+// stage that verifies (or stamps) a checksum trailer so JS never has to.
+// CRC32C uses the CPU's CRC instructions when it has them, chosen at runtime.
+
+#include "UDPPacketFilter.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace udpdirect {
+
+/**
+ * CRC32C (Castagnoli, as in iSCSI and SCTP). Pass the previous result as
+ * `crc` to continue over more data.
+ */
+uint32_t UDPCrc32c(const uint8_t* data, size_t length, uint32_t crc = 0);
+
+/**
+ * xxHash64, bit-exact with the reference implementation.
+ */
+uint64_t UDPXxHash64(const uint8_t* data, size_t length, uint64_t seed = 0);
+
+/**
+ * A CRC32C implementation usable on this CPU. `update` takes and returns the
+ * raw register (no pre- or post-inversion).
+ */
+struct UDPCrc32cKernel {
+    const char* name;
+    uint32_t (*update)(uint32_t state, const uint8_t* data, size_t length);
+};
+
+/**
+ * Every CRC32C kernel this CPU supports, fastest first; the first one is what
+ * UDPCrc32c uses. Always ends with the portable "scalar" kernel.
+ */
+const std::vector<UDPCrc32cKernel>& UDPCrc32cKernels();
+
+enum class UDPChecksumKind : uint8_t {
+    CRC32C,  // 4 byte trailer
+    XXH64    // 8 byte trailer
+};
+
+struct UDPChecksumConfig {
+    UDPChecksumKind kind = UDPChecksumKind::CRC32C;
+    uint32_t offset = 0;       // first covered byte; coverage ends where the trailer starts
+    bool bigEndian = true;     // trailer byte order
+    uint64_t seed = 0;         // XXH64 only
+    bool strip = true;         // deliver verified datagrams without their trailer
+    UDPFilterDecision onFailure = {UDPFilterAction::Drop, 0};
+};
+
+struct UDPChecksumStats {
+    uint64_t verified = 0;
+    uint64_t failed = 0;    // trailer did not match
+    uint64_t tooShort = 0;  // shorter than offset + trailer; treated as failed
+    uint64_t stamped = 0;
+};
+
+/**
+ * UDPChecksumVerifier
+ *
+ * Receive side: verify() checks the trailer of one datagram. Send side:
+ * stamp() appends the trailer to a payload in place. Both use the same
+ * kernels and configuration, so two peers sharing a config interoperate.
+ *
+ * verify() runs on the socket's receive queue and stamp() on the JS thread;
+ * neither touches shared state but the relaxed counters.
+ */
+class UDPChecksumVerifier {
+public:
+    explicit UDPChecksumVerifier(const UDPChecksumConfig& config);
+
+    UDPChecksumVerifier(const UDPChecksumVerifier&) = delete;
+    UDPChecksumVerifier& operator=(const UDPChecksumVerifier&) = delete;
+
+    static size_t trailerSize(UDPChecksumKind kind) { return kind == UDPChecksumKind::CRC32C ? 4 : 8; }
+
+    /**
+     * @param length In: datagram length. Out: length to deliver, without the
+     *        trailer when the datagram verified and `strip` is set.
+     * @return true if the trailer matches
+     */
+    bool verify(const uint8_t* data, size_t& length);
+
+    /**
+     * Append the trailer for data[0, payloadLength) at data + payloadLength.
+     *
+     * @return The stamped length, or 0 if `capacity` has no room for the trailer
+     */
+    size_t stamp(uint8_t* data, size_t payloadLength, size_t capacity);
+
+    const UDPChecksumConfig& config() const { return config_; }
+    UDPChecksumStats stats() const;
+
+private:
+    uint64_t compute(const uint8_t* data, size_t length) const;
+
+    UDPChecksumConfig config_;
+    size_t trailerSize_;
+
+    std::atomic<uint64_t> verified_{0};
+    std::atomic<uint64_t> failed_{0};
+    std::atomic<uint64_t> tooShort_{0};
+    std::atomic<uint64_t> stamped_{0};
+};
+
+} // namespace udpdirect
@@ -0,0 +1,127 @@
+#include "UDPDatagramSocket.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+namespace udpdirect {
+
+UDPSendStatus UDPSendDatagram(int fd, const void* bytes, size_t length, const sockaddr* address,
+                              socklen_t addressLength, int& error) {
+    // The descriptor is non-blocking already; MSG_DONTWAIT keeps a caller on the JS
+    // thread from ever parking even if it is not
+    ssize_t result = address ? sendto(fd, bytes, length, MSG_DONTWAIT, address, addressLength)
+                             : send(fd, bytes, length, MSG_DONTWAIT);
+    if (result >= 0) {
+        error = 0;
+        return UDPSendStatus::Sent;
+    }
+    error = errno;
+    switch (error) {
+        case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+        case EWOULDBLOCK:
+#endif
+        case ENOBUFS:
+        case EINTR:
+        case EACCES:  // broadcast not enabled yet; the queued path enables it
+            return UDPSendStatus::Deferred;
+        default:
+            return UDPSendStatus::Failed;
+    }
+}
+
+UDPDatagramSocket::~UDPDatagramSocket() {
+    close();
+}
+
+std::string UDPDatagramSocket::open(const UDPSocketAddress& bindAddress, const UDPDatagramSocketOptions& options) {
+    if (fd_ >= 0) {
+        return "socket already open";
+    }
+    sockaddr_storage storage;
+    socklen_t length = bindAddress.toSockaddr(storage);
+    if (length == 0) {
+        return "bind address is unset";
+    }
+
+    int fd = socket(bindAddress.family, SOCK_DGRAM, IPPROTO_UDP);
+    if (fd < 0) {
+        return std::string("cannot create socket: ") + strerror(errno);
+    }
+    auto fail = [fd](const char* what) {
+        std::string message = std::string(what) + ": " + strerror(errno);
+        ::close(fd);
+        return message;
+    };
+    if (fcntl(fd, F_SETFD, FD_CLOEXEC) != 0 || fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0) {
+        return fail("cannot make socket non-blocking");
+    }
+    if (options.reuseAddress) {
+        int on = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) != 0) {
+            return fail("cannot set SO_REUSEADDR");
+        }
+    }
+    if (options.reusePort) {
+        int on = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0) {
+            return fail("cannot set SO_REUSEPORT");
+        }
+    }
+    if (options.receiveBufferBytes > 0 &&
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &options.receiveBufferBytes, sizeof(options.receiveBufferBytes)) != 0) {
+        return fail("cannot set SO_RCVBUF");
+    }
+    if (options.sendBufferBytes > 0 &&
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &options.sendBufferBytes, sizeof(options.sendBufferBytes)) != 0) {
+        return fail("cannot set SO_SNDBUF");
+    }
+    if (bind(fd, (const sockaddr*)&storage, length) != 0) {
+        return fail(("cannot bind to " + bindAddress.hostString() + " port " + std::to_string(bindAddress.port)).c_str());
+    }
+
+    sockaddr_storage bound;
+    socklen_t boundLength = sizeof(bound);
+    if (getsockname(fd, (sockaddr*)&bound, &boundLength) != 0 ||
+        !UDPSocketAddress::fromSockaddr((const sockaddr*)&bound, boundLength, localAddress_)) {
+        return fail("cannot read the bound address");
+    }
+    fd_ = fd;
+    return "";
+}
+
+std::string UDPDatagramSocket::connect(const UDPSocketAddress& peer) {
+    if (fd_ < 0) {
+        return "socket not open";
+    }
+    sockaddr_storage storage;
+    socklen_t length = peer.toSockaddr(storage);
+    if (length == 0) {
+        return "peer address is unset";
+    }
+    if (::connect(fd_, (const sockaddr*)&storage, length) != 0) {
+        return std::string("cannot connect: ") + strerror(errno);
+    }
+    return "";
+}
+
+void UDPDatagramSocket::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    localAddress_ = UDPSocketAddress();
+}
+
+UDPSendStatus UDPDatagramSocket::sendTo(const void* bytes, size_t length, const UDPSocketAddress& destination,
+                                        int& error) {
+    sockaddr_storage storage;
+    socklen_t addressLength = destination.toSockaddr(storage);
+    return UDPSendDatagram(fd_, bytes, length, addressLength ? (const sockaddr*)&storage : nullptr, addressLength,
+                           error);
+}
+
+} // namespace udpdirect
@@ -0,0 +1,81 @@
+#pragma once
+
+// UDPDatagramSocket - a plain non-blocking POSIX UDP descriptor, and the
+// immediate-send call every send path shares. The iOS manager leaves socket
+// lifecycle to GCDAsyncUdpSocket and only uses UDPSendDatagram(); the Linux
+// benchmarks own their sockets through UDPDatagramSocket.
+
+#include "UDPSocketAddress.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/socket.h>
+
+namespace udpdirect {
+
+enum class UDPSendStatus {
+    Sent,
+    Deferred,  // transient (buffer full, interrupted, broadcast not enabled); retry through a queue
+    Failed
+};
+
+/**
+ * One non-blocking send: sendto() when `address` is set, send() on a
+ * connected descriptor otherwise.
+ *
+ * @param error Out: errno for Deferred and Failed, 0 when sent
+ */
+UDPSendStatus UDPSendDatagram(int fd, const void* bytes, size_t length, const sockaddr* address,
+                              socklen_t addressLength, int& error);
+
+struct UDPDatagramSocketOptions {
+    int receiveBufferBytes = 0;  // SO_RCVBUF; 0 keeps the system default
+    int sendBufferBytes = 0;     // SO_SNDBUF; 0 keeps the system default
+    bool reuseAddress = false;
+    bool reusePort = false;      // SO_REUSEPORT, so several sockets can bind one port
+};
+
+/**
+ * UDPDatagramSocket
+ *
+ * Owns one descriptor of the bind address's family, non-blocking and
+ * close-on-exec. Not thread-safe to open or close; fd() may be used from any
+ * thread in between.
+ */
+class UDPDatagramSocket {
+public:
+    UDPDatagramSocket() = default;
+    ~UDPDatagramSocket();
+
+    UDPDatagramSocket(const UDPDatagramSocket&) = delete;
+    UDPDatagramSocket& operator=(const UDPDatagramSocket&) = delete;
+
+    /**
+     * Create the descriptor and bind it; port 0 picks an ephemeral port.
+     *
+     * @return Empty string on success, otherwise what went wrong
+     */
+    std::string open(const UDPSocketAddress& bindAddress, const UDPDatagramSocketOptions& options = {});
+
+    /**
+     * @return Empty string on success, otherwise what went wrong
+     */
+    std::string connect(const UDPSocketAddress& peer);
+
+    void close();
+
+    int fd() const { return fd_; }
+    bool isOpen() const { return fd_ >= 0; }
+
+    // The bound address, with the port the system picked
+    const UDPSocketAddress& localAddress() const { return localAddress_; }
+
+    UDPSendStatus sendTo(const void* bytes, size_t length, const UDPSocketAddress& destination, int& error);
+
+private:
+    int fd_ = -1;
+    UDPSocketAddress localAddress_;
+};
+
+} // namespace udpdirect
@@ -0,0 +1,95 @@
+#include "UDPEndpointTable.h"
+
+#include <cerrno>
+#include <netdb.h>
+
+namespace udpdirect {
+
+UDPEndpoint UDPEndpoint::fromAddress(const UDPSocketAddress& address) {
+    UDPEndpoint endpoint;
+    endpoint.address = address;
+    endpoint.sockaddrLength = address.toSockaddr(endpoint.sockaddr);
+    endpoint.broadcast = isBroadcastAddress(address);
+    return endpoint;
+}
+
+bool UDPEndpoint::isBroadcastAddress(const UDPSocketAddress& address) {
+    return address.family == AF_INET && address.bytes[3] == 255;
+}
+
+UDPEndpointTable::UDPEndpointTable(uint32_t capacity, uint16_t generationSeed)
+    : table_(capacity, generationSeed) {}
+
+UDPEndpointTable::Handle UDPEndpointTable::resolve(const char* host, uint16_t port, int& error) {
+    error = 0;
+    if (!host) {
+        error = EAI_NONAME;
+        return kInvalidHandle;
+    }
+
+    UDPSocketAddress address;
+    if (!UDPSocketAddress::fromNumericHost(host, port, address)) {
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_DGRAM;
+        addrinfo* results = nullptr;
+        int status = getaddrinfo(host, nullptr, &hints, &results);
+        if (status != 0) {
+            error = status;
+            return kInvalidHandle;
+        }
+        // First usable answer, in the resolver's preference order
+        bool found = false;
+        for (addrinfo* info = results; info && !found; info = info->ai_next) {
+            found = UDPSocketAddress::fromSockaddr(info->ai_addr, info->ai_addrlen, address);
+        }
+        freeaddrinfo(results);
+        if (!found) {
+            error = EAI_NONAME;
+            return kInvalidHandle;
+        }
+        address.port = port;
+    }
+
+    Handle handle = intern(address);
+    if (handle == kInvalidHandle) {
+        error = ENOSPC;
+    }
+    return handle;
+}
+
+UDPEndpointTable::Handle UDPEndpointTable::intern(const UDPSocketAddress& address) {
+    auto existing = handlesByAddress_.find(address);
+    if (existing != handlesByAddress_.end()) {
+        table_.get(existing->second)->refs++;
+        return existing->second;
+    }
+
+    Entry entry;
+    entry.endpoint = UDPEndpoint::fromAddress(address);
+    entry.refs = 1;
+    Handle handle = table_.allocate(entry);
+    if (handle != kInvalidHandle) {
+        handlesByAddress_.emplace(address, handle);
+    }
+    return handle;
+}
+
+const UDPEndpoint* UDPEndpointTable::get(Handle handle) const {
+    const Entry* entry = table_.get(handle);
+    return entry ? &entry->endpoint : nullptr;
+}
+
+bool UDPEndpointTable::release(Handle handle) {
+    Entry* entry = table_.get(handle);
+    if (!entry) {
+        return false;
+    }
+    if (--entry->refs == 0) {
+        handlesByAddress_.erase(entry->endpoint.address);
+        table_.release(handle);
+    }
+    return true;
+}
+
+} // namespace udpdirect
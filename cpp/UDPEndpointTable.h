@@ -0,0 +1,96 @@
+#pragma once
+
+// UDPEndpointTable - destinations resolved once into ready-to-use sockaddrs and
+// addressed by generation-checked handles, so repeated sends to the same peer
+// skip string conversion, parsing and resolution.
+
+#include "UDPHandleTable.h"
+#include "UDPSocketAddress.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/socket.h>
+#include <unordered_map>
+
+namespace udpdirect {
+
+/**
+ * A resolved destination. Plain value type, safe to copy into queued blocks.
+ */
+struct UDPEndpoint {
+    UDPSocketAddress address;
+    sockaddr_storage sockaddr = {};
+    socklen_t sockaddrLength = 0;
+    bool broadcast = false;  // needs SO_BROADCAST on the sending socket
+
+    static UDPEndpoint fromAddress(const UDPSocketAddress& address);
+
+    /**
+     * Limited broadcast or an IPv4 address ending in .255, the same rule the
+     * queued send path applies to host strings.
+     */
+    static bool isBroadcastAddress(const UDPSocketAddress& address);
+};
+
+/**
+ * UDPEndpointTable
+ *
+ * Resolving the same address and port again returns the same handle with
+ * one more reference; release() drops one. Handles use the UDPHandleTable
+ * layout, so a released handle never matches a later endpoint.
+ *
+ * Not thread-safe; callers serialise access (the JSI layer keeps it on the
+ * JS thread).
+ */
+class UDPEndpointTable {
+public:
+    using Handle = UDPHandleTable<int>::Handle;
+    static constexpr Handle kInvalidHandle = 0;
+
+    /**
+     * @param generationSeed As for UDPHandleTable; seed per process so handles
+     *        kept across a JS reload do not match new endpoints.
+     */
+    explicit UDPEndpointTable(uint32_t capacity = 4096, uint16_t generationSeed = 1);
+
+    /**
+     * Resolve `host` (numeric, or a name looked up with getaddrinfo, which
+     * blocks) and intern the result.
+     *
+     * @param error Set to 0 on success, otherwise an EAI_* code from
+     *        getaddrinfo or ENOSPC when the table is full.
+     * @return A handle, or kInvalidHandle on failure
+     */
+    Handle resolve(const char* host, uint16_t port, int& error);
+
+    /**
+     * Intern an already decoded address.
+     */
+    Handle intern(const UDPSocketAddress& address);
+
+    const UDPEndpoint* get(Handle handle) const;
+
+    /**
+     * Drop one reference; the endpoint goes away with the last one.
+     *
+     * @return false if the handle was not live
+     */
+    bool release(Handle handle);
+
+    size_t size() const { return table_.size(); }
+
+private:
+    struct Entry {
+        UDPEndpoint endpoint;
+        uint32_t refs = 0;
+    };
+
+    struct AddressHash {
+        size_t operator()(const UDPSocketAddress& address) const { return (size_t)address.hash(); }
+    };
+
+    UDPHandleTable<Entry> table_;
+    std::unordered_map<UDPSocketAddress, Handle, AddressHash> handlesByAddress_;
+};
+
+} // namespace udpdirect
@@ -0,0 +1,224 @@
+#include "UDPFragmenter.h"
+
+#include <cstring>
+
+namespace udpdirect {
+
+static void writeU16(uint8_t* out, uint16_t value) {
+    out[0] = (uint8_t)(value >> 8);
+    out[1] = (uint8_t)value;
+}
+
+static void writeU32(uint8_t* out, uint32_t value) {
+    out[0] = (uint8_t)(value >> 24);
+    out[1] = (uint8_t)(value >> 16);
+    out[2] = (uint8_t)(value >> 8);
+    out[3] = (uint8_t)value;
+}
+
+static uint16_t readU16(const uint8_t* in) {
+    return (uint16_t)((in[0] << 8) | in[1]);
+}
+
+static uint32_t readU32(const uint8_t* in) {
+    return ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | in[3];
+}
+
+void UDPFragmentHeader::write(uint8_t* out) const {
+    writeU16(out, kMagic);
+    out[2] = kVersion;
+    out[3] = 0;
+    writeU32(out + 4, messageId);
+    writeU32(out + 8, totalLength);
+    writeU16(out + 12, fragmentIndex);
+    writeU16(out + 14, fragmentCount);
+}
+
+bool UDPFragmentHeader::read(const uint8_t* data, size_t length, UDPFragmentHeader& out) {
+    if (length < kSize || readU16(data) != kMagic || data[2] != kVersion) {
+        return false;
+    }
+    out.messageId = readU32(data + 4);
+    out.totalLength = readU32(data + 8);
+    out.fragmentIndex = readU16(data + 12);
+    out.fragmentCount = readU16(data + 14);
+    return true;
+}
+
+bool UDPFragmenter::fragment(const uint8_t* data, size_t length, uint32_t messageId, size_t maxDatagramSize,
+                             UDPFragmentBatch& out) {
+    out.datagrams.clear();
+    out.offsets.clear();
+    out.lengths.clear();
+    if (maxDatagramSize <= UDPFragmentHeader::kSize || length > UINT32_MAX) {
+        return false;
+    }
+    size_t maxPayload = maxDatagramSize - UDPFragmentHeader::kSize;
+    size_t count = length == 0 ? 1 : (length + maxPayload - 1) / maxPayload;
+    if (count > kMaxFragments) {
+        return false;
+    }
+
+    UDPFragmentHeader header;
+    header.messageId = messageId;
+    header.totalLength = (uint32_t)length;
+    header.fragmentCount = (uint16_t)count;
+    size_t payloadSize = UDPFragmentHeader::fragmentPayloadSize(header.totalLength, header.fragmentCount);
+
+    out.datagrams.resize(length + count * UDPFragmentHeader::kSize);
+    uint8_t* cursor = out.datagrams.data();
+    for (size_t i = 0; i < count; i++) {
+        size_t offset = i * payloadSize;
+        size_t chunk = i + 1 < count ? payloadSize : length - offset;
+        header.fragmentIndex = (uint16_t)i;
+        header.write(cursor);
+        if (chunk > 0) {
+            memcpy(cursor + UDPFragmentHeader::kSize, data + offset, chunk);
+        }
+        out.offsets.push_back((uint32_t)(cursor - out.datagrams.data()));
+        out.lengths.push_back((uint32_t)(UDPFragmentHeader::kSize + chunk));
+        cursor += UDPFragmentHeader::kSize + chunk;
+    }
+    return true;
+}
+
+UDPReassembler::UDPReassembler(const Config& config) : config_(config) {
+    partials_.reserve(config_.maxPendingMessages);
+}
+
+uint64_t UDPReassembler::keyFor(const UDPSocketAddress& source, uint32_t messageId) {
+    return source.hash() ^ ((uint64_t)messageId * 0x9E3779B97F4A7C15ull);
+}
+
+void UDPReassembler::erase(std::unordered_map<uint64_t, Partial>::iterator it) {
+    pendingMessages_.fetch_sub(1, std::memory_order_relaxed);
+    pendingBytes_.fetch_sub(it->second.buffer->size(), std::memory_order_relaxed);
+    partials_.erase(it);
+}
+
+void UDPReassembler::expire(uint64_t nowNs) {
+    // Sweeping is O(table), so do it at most a few times per timeout
+    if (nowNs < nextSweepNs_) {
+        return;
+    }
+    nextSweepNs_ = nowNs + config_.timeoutNs / 4;
+    for (auto it = partials_.begin(); it != partials_.end();) {
+        auto current = it++;
+        if (nowNs - current->second.firstSeenNs > config_.timeoutNs) {
+            messagesTimedOut_.fetch_add(1, std::memory_order_relaxed);
+            erase(current);
+        }
+    }
+}
+
+void UDPReassembler::evictOldest() {
+    auto oldest = partials_.end();
+    for (auto it = partials_.begin(); it != partials_.end(); ++it) {
+        if (oldest == partials_.end() || it->second.firstSeenNs < oldest->second.firstSeenNs) {
+            oldest = it;
+        }
+    }
+    if (oldest != partials_.end()) {
+        messagesEvicted_.fetch_add(1, std::memory_order_relaxed);
+        erase(oldest);
+    }
+}
+
+UDPReassembler::Result UDPReassembler::receive(const uint8_t* data, size_t length, const UDPSocketAddress& source,
+                                               uint64_t nowNs, std::shared_ptr<std::vector<uint8_t>>& message) {
+    UDPFragmentHeader header;
+    if (!UDPFragmentHeader::read(data, length, header)) {
+        return Result::NotFragment;
+    }
+    fragmentsReceived_.fetch_add(1, std::memory_order_relaxed);
+    expire(nowNs);
+
+    // The payload must be exactly what the sender's even split puts at this index
+    size_t payloadSize = UDPFragmentHeader::fragmentPayloadSize(header.totalLength, header.fragmentCount);
+    size_t expected = header.fragmentIndex + 1 < header.fragmentCount
+        ? payloadSize
+        : header.totalLength - payloadSize * (header.fragmentCount - 1);
+    if (header.fragmentCount == 0 || header.fragmentIndex >= header.fragmentCount ||
+        header.totalLength > config_.maxMessageSize ||
+        payloadSize * (header.fragmentCount - 1) > header.totalLength ||
+        length - UDPFragmentHeader::kSize != expected) {
+        invalidFragments_.fetch_add(1, std::memory_order_relaxed);
+        return Result::Dropped;
+    }
+    const uint8_t* payload = data + UDPFragmentHeader::kSize;
+    size_t offset = (size_t)header.fragmentIndex * payloadSize;
+
+    if (header.fragmentCount == 1) {
+        message = std::make_shared<std::vector<uint8_t>>(payload, payload + expected);
+        messagesCompleted_.fetch_add(1, std::memory_order_relaxed);
+        return Result::Complete;
+    }
+
+    uint64_t key = keyFor(source, header.messageId);
+    auto it = partials_.find(key);
+    if (it != partials_.end() && (it->second.messageId != header.messageId || it->second.source != source ||
+                                  it->second.fragmentCount != header.fragmentCount ||
+                                  it->second.buffer->size() != header.totalLength)) {
+        // Hash collision with another message, or the sender reused the id: the newer one wins
+        messagesEvicted_.fetch_add(1, std::memory_order_relaxed);
+        erase(it);
+        it = partials_.end();
+    }
+
+    if (it == partials_.end()) {
+        if (header.totalLength > config_.maxPendingBytes) {
+            invalidFragments_.fetch_add(1, std::memory_order_relaxed);
+            return Result::Dropped;
+        }
+        while (!partials_.empty() &&
+               (partials_.size() >= config_.maxPendingMessages ||
+                pendingBytes_.load(std::memory_order_relaxed) + header.totalLength > config_.maxPendingBytes)) {
+            evictOldest();
+        }
+        Partial partial;
+        partial.source = source;
+        partial.messageId = header.messageId;
+        partial.fragmentCount = header.fragmentCount;
+        partial.firstSeenNs = nowNs;
+        partial.buffer = std::make_shared<std::vector<uint8_t>>(header.totalLength);
+        partial.received.assign((header.fragmentCount + 63) / 64, 0);
+        it = partials_.emplace(key, std::move(partial)).first;
+        pendingMessages_.fetch_add(1, std::memory_order_relaxed);
+        pendingBytes_.fetch_add(header.totalLength, std::memory_order_relaxed);
+    }
+
+    Partial& partial = it->second;
+    uint64_t bit = 1ull << (header.fragmentIndex % 64);
+    uint64_t& word = partial.received[header.fragmentIndex / 64];
+    if (word & bit) {
+        duplicateFragments_.fetch_add(1, std::memory_order_relaxed);
+        return Result::Dropped;
+    }
+    word |= bit;
+    memcpy(partial.buffer->data() + offset, payload, expected);
+
+    if (++partial.receivedCount < partial.fragmentCount) {
+        return Result::Pending;
+    }
+    message = std::move(partial.buffer);
+    pendingMessages_.fetch_sub(1, std::memory_order_relaxed);
+    pendingBytes_.fetch_sub(message->size(), std::memory_order_relaxed);
+    partials_.erase(it);
+    messagesCompleted_.fetch_add(1, std::memory_order_relaxed);
+    return Result::Complete;
+}
+
+UDPReassemblerStats UDPReassembler::stats() const {
+    UDPReassemblerStats stats;
+    stats.fragmentsReceived = fragmentsReceived_.load(std::memory_order_relaxed);
+    stats.duplicateFragments = duplicateFragments_.load(std::memory_order_relaxed);
+    stats.invalidFragments = invalidFragments_.load(std::memory_order_relaxed);
+    stats.messagesCompleted = messagesCompleted_.load(std::memory_order_relaxed);
+    stats.messagesTimedOut = messagesTimedOut_.load(std::memory_order_relaxed);
+    stats.messagesEvicted = messagesEvicted_.load(std::memory_order_relaxed);
+    stats.pendingMessages = pendingMessages_.load(std::memory_order_relaxed);
+    stats.pendingBytes = pendingBytes_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace udpdirect
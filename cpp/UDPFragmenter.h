@@ -0,0 +1,162 @@
+#pragma once
+
+// UDPFragmenter - optional framing for messages larger than one datagram.
+// The sender splits a message into evenly sized fragments with a small
+// header; the receiver reassembles them in a bounded table and hands over
+// one complete buffer per message.
+
+#include "UDPSocketAddress.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace udpdirect {
+
+/**
+ * Fragment header, 16 bytes in network byte order at the start of every
+ * fragment:
+ *
+ *   magic (2) 'UF' | version (1) | reserved (1) | messageId (4)
+ *   totalLength (4) | fragmentIndex (2) | fragmentCount (2)
+ *
+ * Every fragment but the last carries ceil(totalLength / fragmentCount)
+ * payload bytes, so the receiver can place fragments without a per-fragment
+ * offset.
+ */
+struct UDPFragmentHeader {
+    static constexpr size_t kSize = 16;
+    static constexpr uint16_t kMagic = 0x5546;
+    static constexpr uint8_t kVersion = 1;
+
+    uint32_t messageId = 0;
+    uint32_t totalLength = 0;
+    uint16_t fragmentIndex = 0;
+    uint16_t fragmentCount = 0;
+
+    void write(uint8_t* out) const;
+
+    /**
+     * @return false if `data` does not start with a fragment header
+     */
+    static bool read(const uint8_t* data, size_t length, UDPFragmentHeader& out);
+
+    static size_t fragmentPayloadSize(uint32_t totalLength, uint16_t fragmentCount) {
+        return fragmentCount == 0 ? 0 : (totalLength + fragmentCount - 1) / fragmentCount;
+    }
+};
+
+/**
+ * One message cut into datagrams: fragment i is
+ * datagrams[offsets[i] .. offsets[i] + lengths[i]).
+ */
+struct UDPFragmentBatch {
+    std::vector<uint8_t> datagrams;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> lengths;
+
+    size_t count() const { return offsets.size(); }
+};
+
+/**
+ * UDPFragmenter
+ *
+ * Sender side. Reuses `out` between messages, so steady-state fragmenting
+ * does not allocate.
+ */
+class UDPFragmenter {
+public:
+    static constexpr size_t kMaxFragments = 0xFFFF;
+
+    /**
+     * @param maxDatagramSize Largest datagram to produce, header included
+     * @return false if the message needs more than kMaxFragments fragments,
+     *         or maxDatagramSize leaves no room for payload
+     */
+    static bool fragment(const uint8_t* data, size_t length, uint32_t messageId, size_t maxDatagramSize,
+                         UDPFragmentBatch& out);
+};
+
+struct UDPReassemblerStats {
+    uint64_t fragmentsReceived = 0;
+    uint64_t duplicateFragments = 0;
+    uint64_t invalidFragments = 0;  // inconsistent header, bad length or over maxMessageSize
+    uint64_t messagesCompleted = 0;
+    uint64_t messagesTimedOut = 0;
+    uint64_t messagesEvicted = 0;   // pushed out of a full table before completing
+    uint64_t pendingMessages = 0;
+    uint64_t pendingBytes = 0;
+};
+
+/**
+ * UDPReassembler
+ *
+ * Receiver side. Partial messages are keyed by sender and message id. The
+ * table is bounded by message count and by buffered bytes; when either limit
+ * is hit the oldest partial message is evicted. Partial messages older than
+ * the timeout are dropped on the next receive() after they expire.
+ *
+ * Not thread-safe: receive() runs on the socket's receive queue. Stats can be
+ * read from any thread.
+ */
+class UDPReassembler {
+public:
+    struct Config {
+        size_t maxMessageSize = 1024 * 1024;
+        size_t maxPendingMessages = 32;
+        size_t maxPendingBytes = 8 * 1024 * 1024;
+        uint64_t timeoutNs = 2000000000ull;
+    };
+
+    enum class Result {
+        NotFragment,  // no fragment header; the datagram is an ordinary one
+        Pending,      // fragment consumed, message not complete yet
+        Complete,     // `message` holds the whole message
+        Dropped       // fragment was invalid or a duplicate
+    };
+
+    explicit UDPReassembler(const Config& config);
+
+    UDPReassembler(const UDPReassembler&) = delete;
+    UDPReassembler& operator=(const UDPReassembler&) = delete;
+
+    Result receive(const uint8_t* data, size_t length, const UDPSocketAddress& source, uint64_t nowNs,
+                   std::shared_ptr<std::vector<uint8_t>>& message);
+
+    UDPReassemblerStats stats() const;
+    const Config& config() const { return config_; }
+
+private:
+    struct Partial {
+        UDPSocketAddress source;
+        uint32_t messageId = 0;
+        uint16_t fragmentCount = 0;
+        uint16_t receivedCount = 0;
+        uint64_t firstSeenNs = 0;
+        std::shared_ptr<std::vector<uint8_t>> buffer;
+        std::vector<uint64_t> received;  // bitmap by fragment index
+    };
+
+    static uint64_t keyFor(const UDPSocketAddress& source, uint32_t messageId);
+    void expire(uint64_t nowNs);
+    void evictOldest();
+    void erase(std::unordered_map<uint64_t, Partial>::iterator it);
+
+    Config config_;
+    std::unordered_map<uint64_t, Partial> partials_;
+    uint64_t nextSweepNs_ = 0;
+
+    std::atomic<uint64_t> fragmentsReceived_{0};
+    std::atomic<uint64_t> duplicateFragments_{0};
+    std::atomic<uint64_t> invalidFragments_{0};
+    std::atomic<uint64_t> messagesCompleted_{0};
+    std::atomic<uint64_t> messagesTimedOut_{0};
+    std::atomic<uint64_t> messagesEvicted_{0};
+    std::atomic<uint64_t> pendingMessages_{0};
+    std::atomic<uint64_t> pendingBytes_{0};
+};
+
+} // namespace udpdirect
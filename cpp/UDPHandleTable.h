@@ -0,0 +1,151 @@
+#pragma once
+
+// UDPHandleTable - dense table of per-socket state addressed by small integer
+// handles. Each handle carries its slot's generation, so a handle kept after
+// the slot was released and reused fails lookup instead of aliasing.
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace udpdirect {
+
+/**
+ * UDPHandleTable
+ *
+ * Handle layout: (generation << 16) | index. Generations are never 0, so 0 is
+ * never a valid handle, and every handle is exactly representable as a JS
+ * number. Storage is reserved up front, so pointers returned by get() stay
+ * valid until the handle is released.
+ *
+ * Not thread-safe; callers serialise access.
+ */
+template <typename T>
+class UDPHandleTable {
+public:
+    using Handle = uint32_t;
+
+    static constexpr Handle kInvalidHandle = 0;
+    static constexpr uint32_t kIndexBits = 16;
+    static constexpr uint32_t kMaxCapacity = 1u << kIndexBits;
+
+    /**
+     * @param capacity Maximum number of live handles (at most kMaxCapacity)
+     * @param generationSeed First generation used by every slot. Seeding from
+     *        something that differs per process keeps handles from one table
+     *        from matching live handles in the next (e.g. across JS reloads).
+     */
+    explicit UDPHandleTable(uint32_t capacity = 4096, uint16_t generationSeed = 1)
+        : capacity_(capacity > kMaxCapacity ? kMaxCapacity : capacity),
+          generationSeed_(generationSeed == 0 ? 1 : generationSeed) {
+        slots_.reserve(capacity_);
+    }
+
+    /**
+     * @return A new handle, or kInvalidHandle if the table is full
+     */
+    Handle allocate(T value = T()) {
+        uint32_t index;
+        if (freeHead_ != kNoSlot) {
+            index = freeHead_;
+            freeHead_ = slots_[index].nextFree;
+        } else if (slots_.size() < capacity_) {
+            index = (uint32_t)slots_.size();
+            slots_.emplace_back();
+            slots_[index].generation = generationSeed_;
+        } else {
+            return kInvalidHandle;
+        }
+
+        Slot& slot = slots_[index];
+        slot.value = std::move(value);
+        slot.live = true;
+        count_++;
+        return makeHandle(slot.generation, index);
+    }
+
+    /**
+     * Free the slot behind `handle` and retire its generation.
+     *
+     * @return false if the handle was not live
+     */
+    bool release(Handle handle) {
+        Slot* slot = lookup(handle);
+        if (!slot) {
+            return false;
+        }
+        slot->value = T();
+        slot->live = false;
+        slot->generation = (uint16_t)(slot->generation + 1);
+        if (slot->generation == 0) {
+            slot->generation = 1;
+        }
+        slot->nextFree = freeHead_;
+        freeHead_ = indexOf(handle);
+        count_--;
+        return true;
+    }
+
+    T* get(Handle handle) {
+        Slot* slot = lookup(handle);
+        return slot ? &slot->value : nullptr;
+    }
+
+    const T* get(Handle handle) const {
+        return const_cast<UDPHandleTable*>(this)->get(handle);
+    }
+
+    bool contains(Handle handle) const { return get(handle) != nullptr; }
+
+    /**
+     * Call fn(handle, value) for every live entry.
+     */
+    template <typename Fn>
+    void forEach(Fn&& fn) {
+        for (uint32_t i = 0; i < (uint32_t)slots_.size(); i++) {
+            if (slots_[i].live) {
+                fn(makeHandle(slots_[i].generation, i), slots_[i].value);
+            }
+        }
+    }
+
+    size_t size() const { return count_; }
+    uint32_t capacity() const { return capacity_; }
+
+    static uint32_t indexOf(Handle handle) { return handle & (kMaxCapacity - 1); }
+
+private:
+    static constexpr uint32_t kNoSlot = 0xFFFFFFFFu;
+
+    struct Slot {
+        T value{};
+        uint16_t generation = 1;
+        bool live = false;
+        uint32_t nextFree = kNoSlot;
+    };
+
+    static Handle makeHandle(uint16_t generation, uint32_t index) {
+        return ((Handle)generation << kIndexBits) | index;
+    }
+
+    Slot* lookup(Handle handle) {
+        uint32_t index = indexOf(handle);
+        if (handle == kInvalidHandle || index >= slots_.size()) {
+            return nullptr;
+        }
+        Slot& slot = slots_[index];
+        if (!slot.live || slot.generation != (uint16_t)(handle >> kIndexBits)) {
+            return nullptr;
+        }
+        return &slot;
+    }
+
+    std::vector<Slot> slots_;
+    uint32_t capacity_;
+    uint16_t generationSeed_;
+    uint32_t freeHead_ = kNoSlot;
+    size_t count_ = 0;
+};
+
+} // namespace udpdirect
@@ -0,0 +1,309 @@
+#include "UDPInterfaceMonitor.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#endif
+
+namespace udpdirect {
+
+namespace {
+
+bool addressLess(const UDPSocketAddress& a, const UDPSocketAddress& b) {
+    if (a.family != b.family) {
+        return a.family < b.family;
+    }
+    int order = memcmp(a.bytes, b.bytes, a.isIPv6() ? 16 : 4);
+    if (order != 0) {
+        return order < 0;
+    }
+    return a.scopeId < b.scopeId;
+}
+
+// Stable order, so two reads of an unchanged system compare equal
+void normalize(std::vector<UDPInterface>& interfaces) {
+    for (auto& interface : interfaces) {
+        for (auto& address : interface.addresses) {
+            address.port = 0;
+        }
+        std::sort(interface.addresses.begin(), interface.addresses.end(), addressLess);
+        interface.addresses.erase(std::unique(interface.addresses.begin(), interface.addresses.end()),
+                                  interface.addresses.end());
+    }
+    std::sort(interfaces.begin(), interfaces.end(), [](const UDPInterface& a, const UDPInterface& b) {
+        return a.index != b.index ? a.index < b.index : a.name < b.name;
+    });
+}
+
+} // namespace
+
+bool UDPInterface::isUp() const {
+    return (flags & IFF_UP) != 0 && (flags & IFF_RUNNING) != 0;
+}
+
+bool UDPInterface::isLoopback() const {
+    return (flags & IFF_LOOPBACK) != 0;
+}
+
+bool UDPInterface::supportsMulticast() const {
+    return (flags & IFF_MULTICAST) != 0;
+}
+
+UDPSocketAddress UDPInterface::firstAddress(uint8_t family) const {
+    for (const auto& address : addresses) {
+        if (address.family == family) {
+            return address;
+        }
+    }
+    return UDPSocketAddress();
+}
+
+bool UDPInterface::operator==(const UDPInterface& other) const {
+    return index == other.index && name == other.name && mtu == other.mtu && flags == other.flags &&
+           addresses == other.addresses;
+}
+
+const UDPInterface* UDPInterfaceTable::byIndex(uint32_t index) const {
+    for (const auto& interface : interfaces) {
+        if (interface.index == index) {
+            return &interface;
+        }
+    }
+    return nullptr;
+}
+
+const UDPInterface* UDPInterfaceTable::byName(const std::string& name) const {
+    for (const auto& interface : interfaces) {
+        if (interface.name == name) {
+            return &interface;
+        }
+    }
+    return nullptr;
+}
+
+const UDPInterface* UDPInterfaceTable::byAddress(const UDPSocketAddress& address) const {
+    UDPSocketAddress key = address;
+    key.port = 0;
+    for (const auto& interface : interfaces) {
+        for (const auto& candidate : interface.addresses) {
+            // Scope ids only disambiguate link-local addresses, which callers often pass without one
+            if (candidate.family == key.family &&
+                memcmp(candidate.bytes, key.bytes, key.isIPv6() ? 16 : 4) == 0) {
+                return &interface;
+            }
+        }
+    }
+    return nullptr;
+}
+
+const UDPInterface* UDPInterfaceTable::find(const std::string& nameIndexOrAddress) const {
+    if (nameIndexOrAddress.empty()) {
+        return nullptr;
+    }
+    if (const UDPInterface* interface = byName(nameIndexOrAddress)) {
+        return interface;
+    }
+    char* end = nullptr;
+    unsigned long index = strtoul(nameIndexOrAddress.c_str(), &end, 10);
+    if (end && *end == '\0') {
+        return byIndex((uint32_t)index);
+    }
+    UDPSocketAddress address;
+    if (UDPSocketAddress::fromNumericHost(nameIndexOrAddress.c_str(), 0, address)) {
+        return byAddress(address);
+    }
+    return nullptr;
+}
+
+bool UDPReadSystemInterfaces(std::vector<UDPInterface>& out) {
+    struct ifaddrs* entries = nullptr;
+    if (getifaddrs(&entries) != 0) {
+        return false;
+    }
+    int probe = socket(AF_INET, SOCK_DGRAM, 0);  // for SIOCGIFMTU
+
+    out.clear();
+    for (struct ifaddrs* entry = entries; entry != nullptr; entry = entry->ifa_next) {
+        if (!entry->ifa_name) {
+            continue;
+        }
+        auto found = std::find_if(out.begin(), out.end(),
+                                  [entry](const UDPInterface& interface) { return interface.name == entry->ifa_name; });
+        if (found == out.end()) {
+            UDPInterface interface;
+            interface.name = entry->ifa_name;
+            interface.index = if_nametoindex(entry->ifa_name);
+            interface.flags = entry->ifa_flags;
+            if (probe >= 0) {
+                struct ifreq request;
+                memset(&request, 0, sizeof(request));
+                strncpy(request.ifr_name, entry->ifa_name, sizeof(request.ifr_name) - 1);
+                if (ioctl(probe, SIOCGIFMTU, &request) == 0 && request.ifr_mtu > 0) {
+                    interface.mtu = (uint32_t)request.ifr_mtu;
+                }
+            }
+            out.push_back(std::move(interface));
+            found = out.end() - 1;
+        }
+        if (!entry->ifa_addr) {
+            continue;
+        }
+        socklen_t length = entry->ifa_addr->sa_family == AF_INET6 ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+        UDPSocketAddress address;
+        if (UDPSocketAddress::fromSockaddr(entry->ifa_addr, length, address)) {
+            found->addresses.push_back(address);
+        }
+    }
+
+    if (probe >= 0) {
+        close(probe);
+    }
+    freeifaddrs(entries);
+    return true;
+}
+
+UDPInterfaceMonitor::UDPInterfaceMonitor(UDPInterfaceSource source)
+    : source_(std::move(source)), table_(std::make_shared<UDPInterfaceTable>()) {}
+
+std::shared_ptr<const UDPInterfaceTable> UDPInterfaceMonitor::table() {
+    if (stale_.load(std::memory_order_acquire)) {
+        refresh();
+    }
+    {
+        std::lock_guard<std::mutex> lock(tableMutex_);
+        if (table_->version != 0) {
+            return table_;
+        }
+    }
+    // The first load may be running on another thread, which has already cleared stale_;
+    // wait for it rather than hand out the empty placeholder
+    std::lock_guard<std::mutex> refreshLock(refreshMutex_);
+    std::lock_guard<std::mutex> lock(tableMutex_);
+    return table_;
+}
+
+bool UDPInterfaceMonitor::refresh() {
+    std::lock_guard<std::mutex> refreshLock(refreshMutex_);
+    // Cleared before the read, so a change reported while it runs marks the result stale again
+    stale_.store(false, std::memory_order_release);
+    refreshes_.fetch_add(1, std::memory_order_relaxed);
+
+    std::vector<UDPInterface> interfaces;
+    if (!source_ || !source_(interfaces)) {
+        failures_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    normalize(interfaces);
+
+    std::shared_ptr<const UDPInterfaceTable> current;
+    {
+        std::lock_guard<std::mutex> lock(tableMutex_);
+        current = table_;
+    }
+    if (current->version != 0 && current->interfaces == interfaces) {
+        return false;
+    }
+
+    auto next = std::make_shared<UDPInterfaceTable>();
+    next->version = current->version + 1;
+    next->interfaces = std::move(interfaces);
+    changes_.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(tableMutex_);
+    table_ = std::move(next);
+    return true;
+}
+
+void UDPInterfaceMonitor::invalidate() {
+    notifications_.fetch_add(1, std::memory_order_relaxed);
+    stale_.store(true, std::memory_order_release);
+}
+
+UDPInterfaceMonitorStats UDPInterfaceMonitor::stats() const {
+    UDPInterfaceMonitorStats stats;
+    {
+        std::lock_guard<std::mutex> lock(tableMutex_);
+        stats.version = table_->version;
+    }
+    stats.refreshes = refreshes_.load(std::memory_order_relaxed);
+    stats.changes = changes_.load(std::memory_order_relaxed);
+    stats.failures = failures_.load(std::memory_order_relaxed);
+    stats.notifications = notifications_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+int UDPInterfaceMonitor::openChangeSocket() {
+#if defined(__linux__)
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+    if (fd < 0) {
+        return -1;
+    }
+    struct sockaddr_nl local;
+    memset(&local, 0, sizeof(local));
+    local.nl_family = AF_NETLINK;
+    local.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR | RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE;
+    if (bind(fd, (struct sockaddr*)&local, sizeof(local)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+#else
+    // Darwin's PF_ROUTE messages are not in the iOS SDK; the manager uses the Network framework
+    return -1;
+#endif
+}
+
+size_t UDPInterfaceMonitor::drainChangeSocket(int fd) {
+    size_t relevant = 0;
+#if defined(__linux__)
+    alignas(struct nlmsghdr) char buffer[8192];
+    for (;;) {
+        ssize_t received = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // EAGAIN once drained; ENOBUFS means messages were lost, which still means "changed"
+            if (errno == ENOBUFS) {
+                relevant++;
+                continue;
+            }
+            break;
+        }
+        if (received == 0) {
+            break;
+        }
+        size_t remaining = (size_t)received;
+        for (struct nlmsghdr* header = (struct nlmsghdr*)buffer; NLMSG_OK(header, remaining);
+             header = NLMSG_NEXT(header, remaining)) {
+            switch (header->nlmsg_type) {
+                case RTM_NEWLINK:
+                case RTM_DELLINK:
+                case RTM_NEWADDR:
+                case RTM_DELADDR:
+                case RTM_NEWROUTE:
+                case RTM_DELROUTE:
+                    relevant++;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+#else
+    (void)fd;
+#endif
+    return relevant;
+}
+
+} // namespace udpdirect
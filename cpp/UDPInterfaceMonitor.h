@@ -0,0 +1,148 @@
+#pragma once
+
+// UDPInterfaceMonitor - the host's network interfaces read once into a
+// versioned table and re-read only when the system reports an interface or
+// routing change (or on request), instead of walking getifaddrs per call.
+
+#include "UDPSocketAddress.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace udpdirect {
+
+struct UDPInterface {
+    uint32_t index = 0;   // if_nametoindex; what IPV6_MULTICAST_IF and scope ids use
+    std::string name;
+    uint32_t mtu = 0;     // 0 if the system did not report one
+    uint32_t flags = 0;   // IFF_* bits
+    std::vector<UDPSocketAddress> addresses;  // port 0, sorted
+
+    bool isUp() const;
+    bool isLoopback() const;
+    bool supportsMulticast() const;
+
+    // First address of `family`, or an unset address
+    UDPSocketAddress firstAddress(uint8_t family) const;
+
+    bool operator==(const UDPInterface& other) const;
+    bool operator!=(const UDPInterface& other) const { return !(*this == other); }
+};
+
+/**
+ * One immutable snapshot of the interfaces, ordered by index. A new version
+ * is published only when something in it changed.
+ */
+struct UDPInterfaceTable {
+    uint64_t version = 0;  // 0 until the first successful read
+    std::vector<UDPInterface> interfaces;
+
+    const UDPInterface* byIndex(uint32_t index) const;
+    const UDPInterface* byName(const std::string& name) const;
+
+    // Interface owning `address`; the port is ignored
+    const UDPInterface* byAddress(const UDPSocketAddress& address) const;
+
+    /**
+     * Resolve what callers pass to name an interface: a name ("en0"), a
+     * decimal index or one of its numeric addresses.
+     */
+    const UDPInterface* find(const std::string& nameIndexOrAddress) const;
+};
+
+/**
+ * Where the monitor reads interfaces from. Returns false if the read failed,
+ * in which case the current table is kept.
+ */
+using UDPInterfaceSource = std::function<bool(std::vector<UDPInterface>& out)>;
+
+/**
+ * The system's interfaces through getifaddrs, with MTU from SIOCGIFMTU.
+ */
+bool UDPReadSystemInterfaces(std::vector<UDPInterface>& out);
+
+struct UDPInterfaceMonitorStats {
+    uint64_t version = 0;
+    uint64_t refreshes = 0;      // source reads
+    uint64_t changes = 0;        // reads that published a new version
+    uint64_t failures = 0;       // source reads that failed
+    uint64_t notifications = 0;  // change notifications passed to invalidate()
+};
+
+/**
+ * UDPInterfaceMonitor
+ *
+ * The owner feeds it change notifications through invalidate(); the next
+ * table() call, or an explicit refresh(), re-reads the source. Between
+ * changes, table() is a shared_ptr copy under a mutex.
+ *
+ * openChangeSocket() returns a descriptor that turns readable on interface,
+ * address and route changes where the platform has one (a NETLINK_ROUTE
+ * socket on Linux). Elsewhere it returns -1 and the owner uses the platform's
+ * own notifications.
+ *
+ * Thread-safe.
+ */
+class UDPInterfaceMonitor {
+public:
+    explicit UDPInterfaceMonitor(UDPInterfaceSource source = UDPReadSystemInterfaces);
+
+    UDPInterfaceMonitor(const UDPInterfaceMonitor&) = delete;
+    UDPInterfaceMonitor& operator=(const UDPInterfaceMonitor&) = delete;
+
+    /**
+     * The current table, refreshed first if it was invalidated.
+     */
+    std::shared_ptr<const UDPInterfaceTable> table();
+
+    /**
+     * Re-read the source now.
+     *
+     * @return true if a new version was published
+     */
+    bool refresh();
+
+    /**
+     * Mark the table stale so the next table() re-reads it. Cheap; call it
+     * for every change notification.
+     */
+    void invalidate();
+
+    bool isStale() const { return stale_.load(std::memory_order_acquire); }
+
+    UDPInterfaceMonitorStats stats() const;
+
+    /**
+     * @return A non-blocking descriptor that is readable after interface
+     *         changes, or -1 if this platform has none. The caller closes it.
+     */
+    static int openChangeSocket();
+
+    /**
+     * Read everything pending on a descriptor from openChangeSocket().
+     *
+     * @return Number of interface, address and route messages read
+     */
+    static size_t drainChangeSocket(int fd);
+
+private:
+    UDPInterfaceSource source_;
+
+    std::mutex refreshMutex_;  // serialises source reads
+    mutable std::mutex tableMutex_;
+    std::shared_ptr<const UDPInterfaceTable> table_;
+    std::atomic<bool> stale_{true};
+
+    std::atomic<uint64_t> refreshes_{0};
+    std::atomic<uint64_t> changes_{0};
+    std::atomic<uint64_t> failures_{0};
+    std::atomic<uint64_t> notifications_{0};
+};
+
+} // namespace udpdirect
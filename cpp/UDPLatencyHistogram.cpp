@@ -0,0 +1,96 @@
+#include "UDPLatencyHistogram.h"
+
+namespace udpdirect {
+
+static uint32_t highestBit(uint64_t value) {
+    return 63 - (uint32_t)__builtin_clzll(value);
+}
+
+size_t UDPLatencyHistogram::bucketIndex(uint64_t valueNs) {
+    if (valueNs < kSubBucketCount) {
+        return (size_t)valueNs;
+    }
+    uint32_t exponent = highestBit(valueNs);
+    if (exponent >= kMaxExponent) {
+        return kBucketCount - 1;
+    }
+    uint32_t shift = exponent - kSubBucketBits;
+    size_t subBucket = (size_t)((valueNs >> shift) & (kSubBucketCount - 1));
+    return (size_t)(shift + 1) * kSubBucketCount + subBucket;
+}
+
+uint64_t UDPLatencyHistogram::bucketLowerBound(size_t index) {
+    if (index < kSubBucketCount) {
+        return index;
+    }
+    uint32_t shift = (uint32_t)(index / kSubBucketCount) - 1;
+    uint64_t subBucket = index % kSubBucketCount;
+    return (kSubBucketCount + subBucket) << shift;
+}
+
+uint64_t UDPLatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < kSubBucketCount) {
+        return index;
+    }
+    uint32_t shift = (uint32_t)(index / kSubBucketCount) - 1;
+    return bucketLowerBound(index) + (1ull << shift) - 1;
+}
+
+void UDPLatencyHistogram::record(uint64_t valueNs) {
+    buckets_[bucketIndex(valueNs)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sumNs_.fetch_add(valueNs, std::memory_order_relaxed);
+
+    uint64_t current = minNs_.load(std::memory_order_relaxed);
+    while (valueNs < current && !minNs_.compare_exchange_weak(current, valueNs, std::memory_order_relaxed)) {
+    }
+    current = maxNs_.load(std::memory_order_relaxed);
+    while (valueNs > current && !maxNs_.compare_exchange_weak(current, valueNs, std::memory_order_relaxed)) {
+    }
+}
+
+UDPLatencySummary UDPLatencyHistogram::summary() const {
+    uint64_t counts[kBucketCount];
+    uint64_t total = 0;
+    for (size_t i = 0; i < kBucketCount; i++) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    UDPLatencySummary summary;
+    if (total == 0) {
+        return summary;
+    }
+    summary.count = total;
+    summary.minNs = minNs_.load(std::memory_order_relaxed);
+    summary.maxNs = maxNs_.load(std::memory_order_relaxed);
+    summary.meanNs = (double)sumNs_.load(std::memory_order_relaxed) / (double)count_.load(std::memory_order_relaxed);
+
+    const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    uint64_t* outputs[] = {&summary.p50Ns, &summary.p90Ns, &summary.p99Ns, &summary.p999Ns};
+    size_t q = 0;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount && q < 4; i++) {
+        seen += counts[i];
+        while (q < 4 && (double)seen >= quantiles[q] * (double)total) {
+            uint64_t midpoint = bucketLowerBound(i) + (bucketUpperBound(i) - bucketLowerBound(i)) / 2;
+            // Midpoints can overshoot the exact extremes
+            if (midpoint > summary.maxNs) midpoint = summary.maxNs;
+            if (midpoint < summary.minNs) midpoint = summary.minNs;
+            *outputs[q++] = midpoint;
+        }
+    }
+    return summary;
+}
+
+void UDPLatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sumNs_.store(0, std::memory_order_relaxed);
+    minNs_.store(UINT64_MAX, std::memory_order_relaxed);
+    maxNs_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace udpdirect
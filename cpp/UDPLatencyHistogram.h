@@ -0,0 +1,67 @@
+#pragma once
+
+// UDPLatencyHistogram - lock-free HDR-style latency histogram. Buckets are
+// log-linear: every power of two is split into 8 equal sub-buckets, so any
+// recorded value is reported within 12.5% using a few hundred counters.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace udpdirect {
+
+/**
+ * Percentile summary of a histogram, all values in nanoseconds. Percentiles
+ * are bucket midpoints; min and max are exact.
+ */
+struct UDPLatencySummary {
+    uint64_t count = 0;
+    uint64_t minNs = 0;
+    uint64_t maxNs = 0;
+    double meanNs = 0;
+    uint64_t p50Ns = 0;
+    uint64_t p90Ns = 0;
+    uint64_t p99Ns = 0;
+    uint64_t p999Ns = 0;
+};
+
+/**
+ * UDPLatencyHistogram
+ *
+ * record() may be called from any number of threads; summary() may run
+ * concurrently and sees a slightly fuzzy but consistent-enough view.
+ */
+class UDPLatencyHistogram {
+public:
+    static constexpr uint32_t kSubBucketBits = 3;
+    static constexpr uint32_t kSubBucketCount = 1u << kSubBucketBits;
+    static constexpr uint32_t kMaxExponent = 40;  // values from 2^40 ns (~18 min) up land in the last bucket
+    static constexpr size_t kBucketCount = (kMaxExponent - kSubBucketBits + 1) * kSubBucketCount;
+
+    UDPLatencyHistogram() = default;
+
+    UDPLatencyHistogram(const UDPLatencyHistogram&) = delete;
+    UDPLatencyHistogram& operator=(const UDPLatencyHistogram&) = delete;
+
+    void record(uint64_t valueNs);
+
+    UDPLatencySummary summary() const;
+
+    /**
+     * Zero every counter. Records racing with reset() may survive it.
+     */
+    void reset();
+
+    static size_t bucketIndex(uint64_t valueNs);
+    static uint64_t bucketLowerBound(size_t index);
+    static uint64_t bucketUpperBound(size_t index);
+
+private:
+    std::atomic<uint64_t> buckets_[kBucketCount] = {};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sumNs_{0};
+    std::atomic<uint64_t> minNs_{UINT64_MAX};
+    std::atomic<uint64_t> maxNs_{0};
+};
+
+} // namespace udpdirect
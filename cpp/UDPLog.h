@@ -0,0 +1,21 @@
+#pragma once
+
+// UDPLog - compile-time log levels. Log macros are defined per file on top of
+// UDP_LOG_ENABLED so that anything above UDP_LOG_LEVEL compiles to nothing,
+// arguments included.
+
+#define UDP_LOG_LEVEL_OFF 0
+#define UDP_LOG_LEVEL_ERROR 1
+#define UDP_LOG_LEVEL_INFO 2
+#define UDP_LOG_LEVEL_DEBUG 3  // per-packet messages
+
+// Override with -DUDP_LOG_LEVEL=... (e.g. UDP_LOG_LEVEL_DEBUG to see every packet)
+#ifndef UDP_LOG_LEVEL
+#ifdef NDEBUG
+#define UDP_LOG_LEVEL UDP_LOG_LEVEL_ERROR
+#else
+#define UDP_LOG_LEVEL UDP_LOG_LEVEL_INFO
+#endif
+#endif
+
+#define UDP_LOG_ENABLED(level) (UDP_LOG_LEVEL >= (level))
@@ -0,0 +1,94 @@
+#include "UDPMessageBatcher.h"
+
+#include <cstring>
+
+namespace udpdirect {
+
+namespace {
+
+// Sources are interned per batch. Bursts almost always come from a handful of
+// peers, so a short linear scan beats hashing.
+constexpr size_t kMaxAddressScan = 16;
+
+bool sameHost(const UDPSocketAddress& a, const UDPSocketAddress& b) {
+    return a.family == b.family && a.scopeId == b.scopeId && memcmp(a.bytes, b.bytes, sizeof(a.bytes)) == 0;
+}
+
+} // namespace
+
+void UDPMessageBatch::pack() {
+    if (slots.empty() || payload.size() == payloadBytes) {
+        return;
+    }
+    payload.resize(payloadBytes);
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (length(i) > 0) {
+            memcpy(payload.data() + index[i * kIndexStride], slots[i].data, length(i));
+        }
+    }
+}
+
+void UDPMessageBatch::releaseSlots() {
+    for (const UDPBufferSlot& slot : slots) {
+        pool->release(slot);
+    }
+    slots.clear();
+}
+
+UDPMessageBatcher::UDPMessageBatcher(const Config& config, std::shared_ptr<UDPBufferPool> pool)
+    : config_(config), pool_(std::move(pool)) {
+    if (config_.maxBatch == 0) {
+        config_.maxBatch = 1;
+    }
+    startBatch();
+}
+
+void UDPMessageBatcher::startBatch() {
+    current_ = std::make_shared<UDPMessageBatch>();
+    current_->pool = pool_;
+    current_->slots.reserve(config_.maxBatch);
+    current_->index.reserve((size_t)config_.maxBatch * UDPMessageBatch::kIndexStride);
+}
+
+UDPMessageBatcher::AppendResult UDPMessageBatcher::append(uint32_t socketId, const UDPBufferSlot& slot,
+                                                          const UDPSocketAddress& source, uint64_t receivedNs) {
+    UDPMessageBatch& batch = *current_;
+    bool wasEmpty = batch.count() == 0;
+    if (wasEmpty) {
+        batch.firstReceivedNs = receivedNs;
+    }
+
+    uint32_t sourceIndex = (uint32_t)batch.sources.size();
+    size_t scanFrom = batch.sources.size() > kMaxAddressScan ? batch.sources.size() - kMaxAddressScan : 0;
+    for (size_t i = batch.sources.size(); i > scanFrom; i--) {
+        if (sameHost(batch.sources[i - 1], source)) {
+            sourceIndex = (uint32_t)(i - 1);
+            break;
+        }
+    }
+    if (sourceIndex == batch.sources.size()) {
+        batch.sources.push_back(source);
+    }
+
+    batch.slots.push_back(slot);
+    batch.index.push_back((uint32_t)batch.payloadBytes);
+    batch.index.push_back(slot.length);
+    batch.index.push_back(source.port);
+    batch.index.push_back(sourceIndex);
+    batch.index.push_back(socketId);
+    batch.payloadBytes += slot.length;
+
+    if (batch.count() >= config_.maxBatch) {
+        return AppendResult::FlushNow;
+    }
+    return wasEmpty ? AppendResult::StartTimer : AppendResult::Appended;
+}
+
+std::shared_ptr<UDPMessageBatch> UDPMessageBatcher::take() {
+    std::shared_ptr<UDPMessageBatch> batch = std::move(current_);
+    generation_++;
+    startBatch();
+    return batch;
+}
+
+} // namespace udpdirect
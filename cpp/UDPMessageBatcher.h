@@ -0,0 +1,122 @@
+#pragma once
+
+// UDPMessageBatcher - collects received datagrams, still in their receive pool
+// slots, plus an index table so JS can be handed a whole burst with a single
+// invokeAsync.
+
+#include "UDPBufferPool.h"
+#include "UDPSocketAddress.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace udpdirect {
+
+/**
+ * One flush worth of datagrams.
+ *
+ * Each datagram stays in the pool slot it was received into until the batch
+ * is destroyed or packed. `index` holds kIndexStride uint32 values per
+ * datagram: offset into the packed payload, length, sender port, index into
+ * `sources`, and socket id. JS reads it through a Uint32Array. Sources are
+ * kept binary; formatting them is left to whoever reads them.
+ *
+ * Not thread-safe; once taken from the batcher a batch belongs to its reader.
+ */
+struct UDPMessageBatch {
+    static constexpr size_t kIndexStride = 5;
+
+    UDPMessageBatch() = default;
+    ~UDPMessageBatch() { releaseSlots(); }
+
+    UDPMessageBatch(const UDPMessageBatch&) = delete;
+    UDPMessageBatch& operator=(const UDPMessageBatch&) = delete;
+
+    std::shared_ptr<UDPBufferPool> pool;
+    std::vector<UDPBufferSlot> slots;       // one per datagram until releaseSlots()
+    std::vector<uint32_t> index;
+    std::vector<UDPSocketAddress> sources;  // distinct sender hosts; ports are in `index`
+    std::vector<uint8_t> payload;           // empty until pack()
+    size_t payloadBytes = 0;                // sum of the datagram lengths
+    uint64_t firstReceivedNs = 0;           // receive time of the first datagram, as passed to append()
+
+    size_t count() const { return index.size() / kIndexStride; }
+
+    /**
+     * Bytes of datagram `i`: in its slot, or in `payload` once the slots are gone.
+     */
+    const uint8_t* datagram(size_t i) const {
+        return i < slots.size() ? slots[i].data : payload.data() + index[i * kIndexStride];
+    }
+    uint32_t length(size_t i) const { return index[i * kIndexStride + 1]; }
+
+    /**
+     * Copy the datagrams back to back into `payload`, at their index offsets.
+     * Does nothing once packed or after releaseSlots().
+     */
+    void pack();
+
+    /**
+     * Hand the slots back to the pool. Call pack() first if the bytes are
+     * still needed.
+     */
+    void releaseSlots();
+};
+
+/**
+ * UDPMessageBatcher
+ *
+ * Not thread-safe: append() and take() are expected to run on the socket
+ * delegate queue, which is also where the flush timer fires.
+ */
+class UDPMessageBatcher {
+public:
+    struct Config {
+        uint32_t maxBatch = 64;      // flush once this many datagrams are queued
+        uint32_t maxDelayUs = 1000;  // flush at most this long after the first datagram
+    };
+
+    enum class AppendResult {
+        Appended,      // batch already had a pending timer
+        StartTimer,    // first datagram of a new batch, caller should arm the flush timer
+        FlushNow       // batch reached maxBatch, caller should flush immediately
+    };
+
+    /**
+     * @param pool The pool appended slots belong to
+     */
+    UDPMessageBatcher(const Config& config, std::shared_ptr<UDPBufferPool> pool);
+
+    /**
+     * Add a received datagram. The batch takes over the caller's reference
+     * to `slot`; nothing is copied.
+     */
+    AppendResult append(uint32_t socketId, const UDPBufferSlot& slot, const UDPSocketAddress& source,
+                        uint64_t receivedNs = 0);
+
+    /**
+     * Hand over the current batch (possibly empty) and start a new one.
+     */
+    std::shared_ptr<UDPMessageBatch> take();
+
+    /**
+     * Incremented by every take(). A timer armed for generation N only flushes
+     * if no count-triggered flush happened in the meantime.
+     */
+    uint64_t generation() const { return generation_; }
+
+    bool empty() const { return current_->count() == 0; }
+    const Config& config() const { return config_; }
+
+private:
+    void startBatch();
+
+    Config config_;
+    std::shared_ptr<UDPBufferPool> pool_;
+    std::shared_ptr<UDPMessageBatch> current_;
+    uint64_t generation_ = 0;
+};
+
+} // namespace udpdirect
@@ -0,0 +1,140 @@
+#include "UDPPacketFilter.h"
+
+#include <cstring>
+
+namespace udpdirect {
+
+// Host and port only; the IPv6 scope is not reliably the same on both sides
+static bool sameHost(const UDPSocketAddress& a, const UDPSocketAddress& b) {
+    if (a.family != b.family) {
+        return false;
+    }
+    return memcmp(a.bytes, b.bytes, a.family == AF_INET6 ? 16 : 4) == 0;
+}
+
+std::string UDPPacketFilter::validate(const std::vector<UDPFilterRule>& rules) {
+    if (rules.size() > kMaxRules) {
+        return "at most " + std::to_string(kMaxRules) + " rules";
+    }
+    for (size_t i = 0; i < rules.size(); i++) {
+        const UDPFilterRule& rule = rules[i];
+        std::string prefix = "rule " + std::to_string(i) + ": ";
+        switch (rule.match) {
+            case UDPFilterMatch::Magic:
+                if (rule.bytes.empty() || rule.bytes.size() > kMaxMagicBytes) {
+                    return prefix + "magic needs 1 to " + std::to_string(kMaxMagicBytes) + " bytes";
+                }
+                break;
+            case UDPFilterMatch::Source:
+                if (rule.sources.empty()) {
+                    return prefix + "source needs at least one address or port";
+                }
+                break;
+            case UDPFilterMatch::Length:
+                if (rule.minLength > rule.maxLength) {
+                    return prefix + "min length exceeds max length";
+                }
+                break;
+            case UDPFilterMatch::Duplicate:
+                if (rule.width < 1 || rule.width > 8) {
+                    return prefix + "duplicate key width must be 1 to 8 bytes";
+                }
+                break;
+            case UDPFilterMatch::SelfEcho:
+                break;
+        }
+    }
+    return std::string();
+}
+
+UDPPacketFilter::UDPPacketFilter(std::vector<UDPFilterRule> rules, UDPFilterDecision fallback)
+    : rules_(std::move(rules)), fallback_(fallback), hits_(new std::atomic<uint64_t>[rules_.size()]) {
+    for (size_t i = 0; i < rules_.size(); i++) {
+        hits_[i].store(0, std::memory_order_relaxed);
+        if (rules_[i].match == UDPFilterMatch::Duplicate && !dedup_) {
+            dedup_.reset(new DedupSlot[kDedupSlots]);
+        }
+    }
+}
+
+void UDPPacketFilter::setLocalAddresses(std::vector<UDPSocketAddress> addresses) {
+    localAddresses_ = std::move(addresses);
+}
+
+UDPFilterDecision UDPPacketFilter::classify(const uint8_t* data, size_t length,
+                                            const UDPSocketAddress& source, uint64_t nowNs) {
+    for (size_t i = 0; i < rules_.size(); i++) {
+        const UDPFilterRule& rule = rules_[i];
+        bool matched = rule.match == UDPFilterMatch::Duplicate
+            ? isDuplicate(rule, i, data, length, source, nowNs)
+            : matches(rule, data, length, source);
+        if (matched != rule.invert) {
+            hits_[i].fetch_add(1, std::memory_order_relaxed);
+            return UDPFilterDecision{rule.action, rule.route};
+        }
+    }
+    fallbackHits_.fetch_add(1, std::memory_order_relaxed);
+    return fallback_;
+}
+
+bool UDPPacketFilter::matches(const UDPFilterRule& rule, const uint8_t* data, size_t length,
+                              const UDPSocketAddress& source) {
+    switch (rule.match) {
+        case UDPFilterMatch::Magic:
+            return (size_t)rule.offset + rule.bytes.size() <= length &&
+                   memcmp(data + rule.offset, rule.bytes.data(), rule.bytes.size()) == 0;
+
+        case UDPFilterMatch::Source:
+            for (const UDPSocketAddress& allowed : rule.sources) {
+                if ((allowed.family == 0 || sameHost(allowed, source)) &&
+                    (allowed.port == 0 || allowed.port == source.port)) {
+                    return true;
+                }
+            }
+            return false;
+
+        case UDPFilterMatch::SelfEcho:
+            for (const UDPSocketAddress& local : localAddresses_) {
+                if (local.port == source.port && sameHost(local, source)) {
+                    return true;
+                }
+            }
+            return false;
+
+        case UDPFilterMatch::Length:
+            return length >= rule.minLength && length <= rule.maxLength;
+
+        case UDPFilterMatch::Duplicate:
+            break;  // handled by isDuplicate, which also records the key
+    }
+    return false;
+}
+
+bool UDPPacketFilter::isDuplicate(const UDPFilterRule& rule, size_t ruleIndex, const uint8_t* data, size_t length,
+                                  const UDPSocketAddress& source, uint64_t nowNs) {
+    if ((size_t)rule.offset + rule.width > length) {
+        return false;
+    }
+
+    // Key = sender + field + rule, so two Duplicate rules never see each other's entries
+    uint64_t key = source.hash() ^ ((uint64_t)ruleIndex * 0x9E3779B97F4A7C15ull);
+    for (uint32_t i = 0; i < rule.width; i++) {
+        key ^= data[rule.offset + i];
+        key *= 1099511628211ull;
+    }
+    key ^= key >> 29;
+    if (key == 0) {
+        key = 1;
+    }
+
+    // The window runs from the first sighting, so a steady repeat still gets through once per window
+    DedupSlot& slot = dedup_[key & (kDedupSlots - 1)];
+    if (slot.key == key && nowNs - slot.seenNs <= rule.windowNs) {
+        return true;
+    }
+    slot.key = key;
+    slot.seenNs = nowNs;
+    return false;
+}
+
+} // namespace udpdirect
@@ -0,0 +1,121 @@
+#pragma once
+
+// UDPPacketFilter - declarative per-socket classification of received
+// datagrams, so noise is dropped natively before it is copied or posted to JS.
+
+#include "UDPSocketAddress.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace udpdirect {
+
+enum class UDPFilterAction : uint8_t {
+    Drop,     // discard the datagram natively
+    Deliver,  // hand it to the socket's default handler
+    Route     // hand it to the socket's route handler `route`
+};
+
+enum class UDPFilterMatch : uint8_t {
+    Magic,      // `bytes` found at `offset`
+    Source,     // sender is in `sources`
+    SelfEcho,   // sender is this socket itself (one of our interface addresses and our port)
+    Length,     // minLength <= length <= maxLength
+    Duplicate   // same sender and key field already seen within windowNs
+};
+
+struct UDPFilterRule {
+    UDPFilterMatch match = UDPFilterMatch::Length;
+    bool invert = false;  // apply the action when the condition does NOT hold
+    UDPFilterAction action = UDPFilterAction::Deliver;
+    uint32_t route = 0;   // route index for UDPFilterAction::Route
+
+    // Magic and Duplicate: where the compared bytes start
+    uint32_t offset = 0;
+
+    // Magic
+    std::vector<uint8_t> bytes;
+
+    // Source: family 0 matches any host, port 0 any port
+    std::vector<UDPSocketAddress> sources;
+
+    // Length
+    uint32_t minLength = 0;
+    uint32_t maxLength = UINT32_MAX;
+
+    // Duplicate: key is `width` (1..8) bytes at `offset`
+    uint32_t width = 4;
+    uint64_t windowNs = 1000000000ull;
+};
+
+struct UDPFilterDecision {
+    UDPFilterAction action = UDPFilterAction::Deliver;
+    uint32_t route = 0;
+};
+
+/**
+ * UDPPacketFilter
+ *
+ * Rules are tried in order and the first one that matches decides; datagrams
+ * no rule matches get the fallback decision. Each rule counts its hits.
+ *
+ * Not thread-safe: classify() and setLocalAddresses() run on the socket's
+ * receive queue. Hit counters can be read from any thread.
+ */
+class UDPPacketFilter {
+public:
+    static constexpr size_t kMaxRules = 32;
+    static constexpr size_t kMaxMagicBytes = 64;
+    static constexpr size_t kDedupSlots = 1024;  // power of two; older keys are overwritten
+
+    /**
+     * Check `rules` before constructing a filter from them.
+     *
+     * @return Empty string if valid, otherwise what is wrong
+     */
+    static std::string validate(const std::vector<UDPFilterRule>& rules);
+
+    UDPPacketFilter(std::vector<UDPFilterRule> rules, UDPFilterDecision fallback);
+
+    UDPPacketFilter(const UDPPacketFilter&) = delete;
+    UDPPacketFilter& operator=(const UDPPacketFilter&) = delete;
+
+    /**
+     * Addresses SelfEcho compares the sender with: every local interface
+     * address, with the socket's bound port.
+     */
+    void setLocalAddresses(std::vector<UDPSocketAddress> addresses);
+
+    /**
+     * @param nowNs Monotonic time, for the Duplicate window
+     */
+    UDPFilterDecision classify(const uint8_t* data, size_t length, const UDPSocketAddress& source, uint64_t nowNs);
+
+    size_t ruleCount() const { return rules_.size(); }
+    uint64_t hits(size_t rule) const { return hits_[rule].load(std::memory_order_relaxed); }
+    uint64_t fallbackHits() const { return fallbackHits_.load(std::memory_order_relaxed); }
+
+private:
+    struct DedupSlot {
+        uint64_t key = 0;  // 0 = empty
+        uint64_t seenNs = 0;
+    };
+
+    bool matches(const UDPFilterRule& rule, const uint8_t* data, size_t length, const UDPSocketAddress& source);
+    bool isDuplicate(const UDPFilterRule& rule, size_t ruleIndex, const uint8_t* data, size_t length,
+                     const UDPSocketAddress& source, uint64_t nowNs);
+
+    std::vector<UDPFilterRule> rules_;
+    UDPFilterDecision fallback_;
+    std::vector<UDPSocketAddress> localAddresses_;
+    std::unique_ptr<DedupSlot[]> dedup_;  // allocated only when a Duplicate rule exists
+
+    std::unique_ptr<std::atomic<uint64_t>[]> hits_;
+    std::atomic<uint64_t> fallbackHits_{0};
+};
+
+} // namespace udpdirect
@@ -0,0 +1,155 @@
+#include "UDPPacketRing.h"
+
+#include <chrono>
+#include <thread>
+
+namespace udpdirect {
+
+namespace {
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+UDPPacketRing::UDPPacketRing(std::shared_ptr<UDPBufferPool> pool, size_t capacity, UDPBackpressurePolicy policy)
+    : pool_(std::move(pool)), policy_(policy) {
+    size_t cellCount = roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity);
+    mask_ = cellCount - 1;
+    cells_.reset(new Cell[cellCount]);
+    for (size_t i = 0; i < cellCount; i++) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+UDPPacketRing::~UDPPacketRing() {
+    UDPPacketDescriptor descriptor;
+    while (tryDequeue(descriptor)) {
+        pool_->release(descriptor.slot);
+    }
+}
+
+bool UDPPacketRing::tryEnqueue(const UDPPacketDescriptor& descriptor) {
+    // Single producer: enqueuePos_ is only written here.
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Cell& cell = cells_[pos & mask_];
+    size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if ((intptr_t)sequence - (intptr_t)pos != 0) {
+        return false;
+    }
+    cell.descriptor = descriptor;
+    cell.sequence.store(pos + 1, std::memory_order_release);
+    enqueuePos_.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool UDPPacketRing::tryDequeue(UDPPacketDescriptor& out) {
+    // Claimed by CAS because the producer also dequeues when evicting.
+    size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = cells_[pos & mask_];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+        if (diff == 0) {
+            if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                out = cell.descriptor;
+                cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = dequeuePos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void UDPPacketRing::recordDrop(const UDPPacketDescriptor& descriptor) {
+    pool_->release(descriptor.slot);
+    droppedTotal_.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(dropsMutex_);
+    droppedBySocket_[descriptor.socketId]++;
+}
+
+UDPPacketRing::PushResult UDPPacketRing::push(const UDPPacketDescriptor& descriptor) {
+    bool evicted = false;
+    std::chrono::steady_clock::time_point deadline;
+    bool deadlineSet = false;
+
+    for (;;) {
+        if (tryEnqueue(descriptor)) {
+            return evicted ? PushResult::PushedAfterEviction : PushResult::Pushed;
+        }
+
+        // A consumer has claimed the cell we need but not finished copying it out.
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        if (dequeuePos_.load(std::memory_order_acquire) + mask_ + 1 > pos) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        switch (policy_.load(std::memory_order_relaxed)) {
+            case UDPBackpressurePolicy::DropOldest: {
+                UDPPacketDescriptor oldest;
+                if (tryDequeue(oldest)) {
+                    recordDrop(oldest);
+                    evicted = true;
+                }
+                break;
+            }
+            case UDPBackpressurePolicy::DropNewest:
+                recordDrop(descriptor);
+                return PushResult::Dropped;
+            case UDPBackpressurePolicy::Block: {
+                // Bounded: the JS thread may itself be waiting on the delegate queue.
+                auto now = std::chrono::steady_clock::now();
+                if (!deadlineSet) {
+                    deadline = now + std::chrono::microseconds(blockTimeoutUs_.load(std::memory_order_relaxed));
+                    deadlineSet = true;
+                }
+                if (now >= deadline) {
+                    recordDrop(descriptor);
+                    return PushResult::Dropped;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+                break;
+            }
+        }
+    }
+}
+
+bool UDPPacketRing::requestWake() {
+    return !wakePending_.exchange(true, std::memory_order_acq_rel);
+}
+
+void UDPPacketRing::beginDrain() {
+    wakePending_.store(false, std::memory_order_seq_cst);
+}
+
+bool UDPPacketRing::pop(UDPPacketDescriptor& out) {
+    return tryDequeue(out);
+}
+
+size_t UDPPacketRing::size() const {
+    size_t enqueued = enqueuePos_.load(std::memory_order_acquire);
+    size_t dequeued = dequeuePos_.load(std::memory_order_acquire);
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+
+uint64_t UDPPacketRing::droppedForSocket(uint32_t socketId) const {
+    std::lock_guard<std::mutex> lock(dropsMutex_);
+    auto it = droppedBySocket_.find(socketId);
+    return it == droppedBySocket_.end() ? 0 : it->second;
+}
+
+void UDPPacketRing::forgetSocket(uint32_t socketId) {
+    std::lock_guard<std::mutex> lock(dropsMutex_);
+    droppedBySocket_.erase(socketId);
+}
+
+} // namespace udpdirect
@@ -0,0 +1,114 @@
+#pragma once
+
+// UDPPacketRing - bounded single-producer/single-consumer ring of received
+// packet descriptors. The socket delegate queue produces, the JS thread drains.
+
+#include "UDPBufferPool.h"
+#include "UDPSocketAddress.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace udpdirect {
+
+/**
+ * A received datagram in flight. The descriptor owns `slot` until it is either
+ * popped by the consumer or dropped by the ring (which releases it).
+ */
+struct UDPPacketDescriptor {
+    UDPBufferSlot slot;
+    UDPSocketAddress source;
+    uint32_t socketId = 0;
+    uint64_t receivedNs = 0;  // UDPMonotonicNowNs() when the datagram was read, for latency stats
+    uint64_t kernelNs = 0;    // kernel receive time on the same clock; 0 unless the socket asked for timestamps
+    uint32_t route = 0;       // 0 for the default handler, n for packet filter route n - 1
+};
+
+/**
+ * What the producer does when the ring is full.
+ */
+enum class UDPBackpressurePolicy {
+    DropOldest,  // evict the oldest queued packet to make room
+    DropNewest,  // discard the incoming packet
+    Block        // wait for the consumer, up to blockTimeoutUs, then drop the incoming packet
+};
+
+/**
+ * UDPPacketRing
+ *
+ * Each cell carries a sequence number so the producer can evict the oldest
+ * entry (DropOldest) without racing the consumer: both sides claim a cell via
+ * compare-and-swap on the read position before touching it.
+ *
+ * Wake-up protocol: the producer calls requestWake() after each push and only
+ * schedules a drain when it returns true. The consumer calls beginDrain()
+ * before popping, so any packet pushed after that point triggers a new wake.
+ */
+class UDPPacketRing {
+public:
+    enum class PushResult {
+        Pushed,
+        PushedAfterEviction,  // oldest packet was dropped to make room
+        Dropped               // incoming packet was dropped
+    };
+
+    /**
+     * @param pool Pool the descriptor slots belong to; dropped slots are released there
+     * @param capacity Number of cells, rounded up to a power of two
+     */
+    UDPPacketRing(std::shared_ptr<UDPBufferPool> pool, size_t capacity,
+                  UDPBackpressurePolicy policy = UDPBackpressurePolicy::DropOldest);
+    ~UDPPacketRing();
+
+    UDPPacketRing(const UDPPacketRing&) = delete;
+    UDPPacketRing& operator=(const UDPPacketRing&) = delete;
+
+    // Producer side
+    PushResult push(const UDPPacketDescriptor& descriptor);
+    bool requestWake();
+
+    // Consumer side
+    void beginDrain();
+    bool pop(UDPPacketDescriptor& out);
+
+    void setPolicy(UDPBackpressurePolicy policy) { policy_.store(policy, std::memory_order_relaxed); }
+    UDPBackpressurePolicy policy() const { return policy_.load(std::memory_order_relaxed); }
+    void setBlockTimeoutUs(uint32_t timeoutUs) { blockTimeoutUs_.store(timeoutUs, std::memory_order_relaxed); }
+
+    const std::shared_ptr<UDPBufferPool>& pool() const { return pool_; }
+    size_t capacity() const { return mask_ + 1; }
+    size_t size() const;
+    uint64_t droppedTotal() const { return droppedTotal_.load(std::memory_order_relaxed); }
+    uint64_t droppedForSocket(uint32_t socketId) const;
+    void forgetSocket(uint32_t socketId);
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        UDPPacketDescriptor descriptor;
+    };
+
+    bool tryEnqueue(const UDPPacketDescriptor& descriptor);
+    bool tryDequeue(UDPPacketDescriptor& out);
+    void recordDrop(const UDPPacketDescriptor& descriptor);
+
+    std::shared_ptr<UDPBufferPool> pool_;
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    std::atomic<UDPBackpressurePolicy> policy_;
+    std::atomic<uint32_t> blockTimeoutUs_{2000};
+
+    alignas(64) std::atomic<size_t> enqueuePos_{0};
+    alignas(64) std::atomic<size_t> dequeuePos_{0};
+    alignas(64) std::atomic<bool> wakePending_{false};
+
+    std::atomic<uint64_t> droppedTotal_{0};
+    mutable std::mutex dropsMutex_;  // drops are the slow path
+    std::unordered_map<uint32_t, uint64_t> droppedBySocket_;
+};
+
+} // namespace udpdirect
@@ -0,0 +1,177 @@
+#include "UDPPollRing.h"
+
+#include <cstring>
+#include <new>
+
+namespace udpdirect {
+
+namespace {
+
+uint32_t roundUpToPowerOfTwo(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+uint32_t strideFor(uint32_t maxPayload) {
+    // 16-byte aligned so every header field is naturally aligned for typed-array reads
+    return (uint32_t)((UDPPollRing::kEntryHeaderSize + maxPayload + 15) / 16 * 16);
+}
+
+// Producer-only counter: a relaxed load and store, no locked instruction
+void bump(std::atomic<uint64_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+std::string UDPPollRing::validate(uint32_t capacity, uint32_t maxPayload) {
+    if (capacity == 0 || capacity > kMaxCapacity) {
+        return "capacity must be 1 to " + std::to_string(kMaxCapacity) + " entries";
+    }
+    if (maxPayload == 0 || maxPayload > kMaxPayload) {
+        return "maxPayload must be 1 to " + std::to_string(kMaxPayload) + " bytes";
+    }
+    if (kControlSize + (uint64_t)strideFor(maxPayload) * roundUpToPowerOfTwo(capacity) > kMaxBytes) {
+        return "ring larger than " + std::to_string(kMaxBytes / (1024 * 1024)) + " MB";
+    }
+    return std::string();
+}
+
+UDPPollRing::UDPPollRing(uint32_t capacity, uint32_t maxPayload, uint32_t maxAddresses)
+    : capacity_(roundUpToPowerOfTwo(capacity < 1 ? 1 : capacity)),
+      maxPayload_(maxPayload),
+      stride_(strideFor(maxPayload)),
+      maxAddresses_(maxAddresses),
+      data_(new uint8_t[byteLength()]) {
+    memset(data_.get(), 0, byteLength());
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "control words must be plain uint32 for JS");
+    control_ = new (data_.get()) std::atomic<uint32_t>[kControlSize / sizeof(uint32_t)];
+    for (size_t i = 0; i < kControlSize / sizeof(uint32_t); i++) {
+        control_[i].store(0, std::memory_order_relaxed);
+    }
+    control(Magic).store(kMagic, std::memory_order_relaxed);
+    control(Capacity).store(capacity_, std::memory_order_relaxed);
+    control(EntryStride).store(stride_, std::memory_order_relaxed);
+    control(MaxPayload).store(maxPayload_, std::memory_order_relaxed);
+    addressIndex_.reserve(maxAddresses_);
+    addressLastUsed_.reserve(maxAddresses_);
+    addresses_.reserve(maxAddresses_);
+}
+
+// An index is free once every entry naming it is behind Tail, i.e. released by JS
+uint32_t UDPPollRing::evictAddress(uint32_t tail) {
+    for (uint32_t scanned = 0; scanned < maxAddresses_; scanned++) {
+        uint32_t index = evictionHand_;
+        evictionHand_ = evictionHand_ + 1 == maxAddresses_ ? 0 : evictionHand_ + 1;
+        if ((int32_t)(addressLastUsed_[index] - tail) < 0) {
+            return index;
+        }
+    }
+    return kNoAddress;
+}
+
+uint32_t UDPPollRing::intern(const UDPSocketAddress& source, uint32_t head, uint32_t tail) {
+    UDPSocketAddress host = source;
+    host.port = 0;
+    auto found = addressIndex_.find(host);
+    if (found != addressIndex_.end()) {
+        addressLastUsed_[found->second] = head;
+        return found->second;
+    }
+
+    uint32_t index = (uint32_t)addressLastUsed_.size();
+    if (index < maxAddresses_) {
+        addressLastUsed_.push_back(head);
+        addressIndex_.emplace(host, index);
+        std::lock_guard<std::mutex> lock(addressesMutex_);
+        addresses_.push_back(host);
+        return index;
+    }
+
+    index = evictAddress(tail);
+    if (index == kNoAddress) {
+        bump(addressOverflow_);
+        return kNoAddress;
+    }
+    addressIndex_.erase(addresses_[index]);
+    addressIndex_.emplace(host, index);
+    addressLastUsed_[index] = head;
+    {
+        std::lock_guard<std::mutex> lock(addressesMutex_);
+        addresses_[index] = host;
+    }
+    bump(addressEvictions_);
+    // Published with the entry by the Head store
+    control(AddressEpoch).store(control(AddressEpoch).load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return index;
+}
+
+bool UDPPollRing::write(const uint8_t* data, size_t length, const UDPSocketAddress& source) {
+    uint32_t sequence = sequence_++;
+    uint32_t head = control(Head).load(std::memory_order_relaxed);
+    uint32_t tail = control(Tail).load(std::memory_order_acquire);
+    if (head - tail >= capacity_) {
+        bump(overruns_);
+        control(Overruns).store((uint32_t)overruns_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return false;
+    }
+
+    uint8_t* out = entry(head);
+    uint32_t stored = length > maxPayload_ ? maxPayload_ : (uint32_t)length;
+    uint16_t flags = 0;
+    if (stored < length) {
+        flags |= kFlagTruncated;
+        bump(truncated_);
+    }
+    uint16_t port = source.port;
+    uint32_t addressIndex = intern(source, head, tail);
+    memcpy(out, &stored, 4);
+    memcpy(out + 4, &port, 2);
+    memcpy(out + 6, &flags, 2);
+    memcpy(out + 8, &addressIndex, 4);
+    memcpy(out + 12, &sequence, 4);
+    memcpy(out + kEntryHeaderSize, data, stored);
+
+    bump(written_);
+    control(Head).store(head + 1, std::memory_order_release);
+    return true;
+}
+
+uint32_t UDPPollRing::poll() {
+    uint32_t tail = control(Tail).load(std::memory_order_relaxed) + pending_;
+    control(Tail).store(tail, std::memory_order_release);
+    pending_ = control(Head).load(std::memory_order_acquire) - tail;
+    return pending_;
+}
+
+bool UDPPollRing::address(uint32_t index, UDPSocketAddress& out) const {
+    std::lock_guard<std::mutex> lock(addressesMutex_);
+    if (index >= addresses_.size()) {
+        return false;
+    }
+    out = addresses_[index];
+    return true;
+}
+
+UDPPollRingStats UDPPollRing::stats() const {
+    UDPPollRingStats stats;
+    stats.capacity = capacity_;
+    stats.maxPayload = maxPayload_;
+    uint32_t tail = control(Tail).load(std::memory_order_acquire);
+    stats.ready = control(Head).load(std::memory_order_acquire) - tail;
+    stats.written = written_.load(std::memory_order_relaxed);
+    stats.overruns = overruns_.load(std::memory_order_relaxed);
+    stats.truncated = truncated_.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(addressesMutex_);
+        stats.addresses = (uint32_t)addresses_.size();
+    }
+    stats.addressEvictions = addressEvictions_.load(std::memory_order_relaxed);
+    stats.addressOverflow = addressOverflow_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace udpdirect
@@ -0,0 +1,168 @@
+#pragma once
+
+// UDPPollRing - received datagrams written straight into one persistent buffer
+// that JS reads from its own loop. Nothing is posted to the JS thread and no
+// object is created per datagram; JS asks how many entries are ready and reads
+// them in place.
+
+#include "UDPSocketAddress.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace udpdirect {
+
+struct UDPPollRingStats {
+    uint32_t capacity = 0;
+    uint32_t maxPayload = 0;
+    uint32_t ready = 0;        // written, not yet released by poll()
+    uint64_t written = 0;
+    uint64_t overruns = 0;     // datagrams dropped because every entry was unread
+    uint64_t truncated = 0;    // datagrams cut to maxPayload
+    uint32_t addresses = 0;    // distinct sender hosts interned
+    uint64_t addressEvictions = 0; // indices handed to a new host once no unreleased entry used them
+    uint64_t addressOverflow = 0;  // entries written with kNoAddress because every index was in use
+};
+
+/**
+ * UDPPollRing
+ *
+ * Buffer layout, all fields in native byte order (little-endian on every
+ * supported platform):
+ *
+ *   control block, kControlSize bytes: uint32 words indexed by ControlWord
+ *   entries, `capacity` of them, entryStride bytes apart:
+ *     length (4) | port (2) | flags (2) | addressIndex (4) | sequence (4) | payload
+ *
+ * Head and Tail are free-running entry counters; entry n lives at index
+ * n % capacity. The producer appends at Head and never overwrites an entry
+ * JS has not released: when the ring is full the incoming datagram is dropped
+ * and counted in Overruns. Every datagram offered to the ring takes the next
+ * sequence number, so JS sees an overrun as a gap in sequence.
+ *
+ * Senders are interned by host; the port is in the entry. Once the table is
+ * full, an index no unreleased entry refers to is handed to the new host and
+ * AddressEpoch is bumped before the entry is published, so JS drops its cached
+ * lookups when it sees the epoch change after a poll().
+ *
+ * poll() releases the entries the previous poll() returned, so an entry stays
+ * valid until the next poll() for the same ring.
+ *
+ * Single producer (the socket's receive queue) and single consumer (the JS
+ * thread). address() and stats() may be called from any thread.
+ */
+class UDPPollRing {
+public:
+    static constexpr uint32_t kMagic = 0x31525055;  // "UPR1"
+    static constexpr size_t kControlSize = 64;
+    static constexpr size_t kEntryHeaderSize = 16;
+    static constexpr uint32_t kMaxCapacity = 65536;
+    static constexpr uint32_t kMaxPayload = 65507;
+    static constexpr size_t kMaxBytes = 64 * 1024 * 1024;
+    static constexpr uint32_t kNoAddress = UINT32_MAX;
+    static constexpr uint16_t kFlagTruncated = 1;
+
+    enum ControlWord : uint32_t {
+        Magic = 0,
+        Capacity = 1,     // entries, a power of two
+        EntryStride = 2,  // bytes between entries
+        MaxPayload = 3,
+        Head = 4,         // entries written
+        Tail = 5,         // entries released; the first entry poll() returned
+        Overruns = 6,     // low 32 bits of stats().overruns
+        AddressEpoch = 7, // bumped whenever an address index is reassigned
+    };
+
+    /**
+     * Check the geometry before constructing a ring from it.
+     *
+     * @return Empty string if valid, otherwise what is wrong
+     */
+    static std::string validate(uint32_t capacity, uint32_t maxPayload);
+
+    /**
+     * @param capacity Entry count, rounded up to a power of two
+     * @param maxPayload Longest payload an entry holds; longer datagrams are truncated
+     * @param maxAddresses Sender hosts interned at once; indices are reused after that
+     */
+    UDPPollRing(uint32_t capacity, uint32_t maxPayload, uint32_t maxAddresses = 1024);
+
+    UDPPollRing(const UDPPollRing&) = delete;
+    UDPPollRing& operator=(const UDPPollRing&) = delete;
+
+    uint8_t* data() const { return data_.get(); }
+    size_t byteLength() const { return kControlSize + (size_t)stride_ * capacity_; }
+    uint32_t capacity() const { return capacity_; }
+    uint32_t entryStride() const { return stride_; }
+    uint32_t maxPayload() const { return maxPayload_; }
+
+    // Producer side
+    /**
+     * Append one datagram.
+     *
+     * @return false if the ring was full and the datagram was dropped
+     */
+    bool write(const uint8_t* data, size_t length, const UDPSocketAddress& source);
+
+    // Consumer side
+    /**
+     * Release what the previous call returned and report what is ready now.
+     *
+     * @return Number of entries ready, starting at the Tail control word
+     */
+    uint32_t poll();
+
+    /**
+     * Look up an interned sender.
+     *
+     * @return false if `index` was never handed out
+     */
+    bool address(uint32_t index, UDPSocketAddress& out) const;
+
+    UDPPollRingStats stats() const;
+
+private:
+    struct AddressHash {
+        size_t operator()(const UDPSocketAddress& address) const { return (size_t)address.hash(); }
+    };
+
+    std::atomic<uint32_t>& control(ControlWord word) const { return control_[word]; }
+    uint8_t* entry(uint32_t position) const {
+        return data_.get() + kControlSize + (size_t)(position & (capacity_ - 1)) * stride_;
+    }
+    uint32_t intern(const UDPSocketAddress& source, uint32_t head, uint32_t tail);
+    uint32_t evictAddress(uint32_t tail);
+
+    uint32_t capacity_;
+    uint32_t maxPayload_;
+    uint32_t stride_;
+    uint32_t maxAddresses_;
+    std::unique_ptr<uint8_t[]> data_;
+    std::atomic<uint32_t>* control_;  // placed at the start of data_
+
+    // Producer only
+    uint32_t sequence_ = 0;
+    std::unordered_map<UDPSocketAddress, uint32_t, AddressHash> addressIndex_;
+    std::vector<uint32_t> addressLastUsed_;  // Head position of the last entry naming each index
+    uint32_t evictionHand_ = 0;
+
+    // Consumer only: entries handed out by the last poll()
+    uint32_t pending_ = 0;
+
+    mutable std::mutex addressesMutex_;  // taken once per new sender, and by address()
+    std::vector<UDPSocketAddress> addresses_;
+
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> overruns_{0};
+    std::atomic<uint64_t> truncated_{0};
+    std::atomic<uint64_t> addressEvictions_{0};
+    std::atomic<uint64_t> addressOverflow_{0};
+};
+
+} // namespace udpdirect
@@ -0,0 +1,75 @@
+#pragma once
+
+// UDPReceiveDrain - the consumer side of a receive ring, without the JS
+// runtime: pop every queued descriptor, find its socket's handlers through a
+// one-entry cache, and hand the slot back to the pool when nothing takes it.
+// UDPDirectJSI drains into jsi::Function handlers with it, the benchmarks
+// into plain callbacks.
+
+#include "UDPLatencyHistogram.h"
+#include "UDPPacketRing.h"
+#include "UDPSocketStats.h"
+#include "UDPTrace.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace udpdirect {
+
+/**
+ * Deliver everything queued in `ring`. Runs on the ring's consumer thread.
+ *
+ * @param table Per-socket handlers. Handlers may change it; they must bump
+ *        `tableVersion` when they do, which drops the cached lookup.
+ * @param trace Records Deliver and Drop events; may be null
+ * @param latency Records receive -> delivery time; may be null
+ * @param select `Target* (const Handlers&, const UDPPacketDescriptor&)`:
+ *        the handler for this descriptor, or null to drop it
+ * @param deliver `void (Target&, const UDPPacketDescriptor&)`: hand the
+ *        datagram over. It owns descriptor.slot from then on.
+ * @return Datagrams delivered
+ */
+template <typename Handlers, typename Select, typename Deliver>
+size_t UDPDrainReceiveRing(UDPPacketRing& ring, const std::unordered_map<uint32_t, Handlers>& table,
+                           const uint64_t& tableVersion, UDPTrace* trace, UDPLatencyHistogram* latency,
+                           Select&& select, Deliver&& deliver) {
+    ring.beginDrain();
+
+    UDPPacketDescriptor descriptor;
+    UDPBufferPool& pool = *ring.pool();
+
+    // Bursts usually come from one socket, so remember the last lookup
+    uint32_t cachedSocketId = 0;
+    uint64_t cachedVersion = 0;
+    const Handlers* handlers = nullptr;
+    size_t delivered = 0;
+
+    while (ring.pop(descriptor)) {
+        if (descriptor.socketId != cachedSocketId || tableVersion != cachedVersion) {
+            auto found = table.find(descriptor.socketId);
+            handlers = found == table.end() ? nullptr : &found->second;
+            cachedSocketId = descriptor.socketId;
+            cachedVersion = tableVersion;
+        }
+        auto* target = handlers ? select(*handlers, descriptor) : nullptr;
+        if (!target) {
+            if (trace) {
+                UDP_TRACE(*trace, Drop, descriptor.socketId, descriptor.slot.length);
+            }
+            pool.release(descriptor.slot);
+            continue;
+        }
+        if (trace) {
+            UDP_TRACE(*trace, Deliver, descriptor.socketId, descriptor.slot.length);
+        }
+        if (latency) {
+            latency->record(UDPMonotonicNowNs() - descriptor.receivedNs);
+        }
+        deliver(*target, descriptor);
+        delivered++;
+    }
+    return delivered;
+}
+
+} // namespace udpdirect
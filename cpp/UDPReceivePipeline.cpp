@@ -0,0 +1,121 @@
+#include "UDPReceivePipeline.h"
+
+namespace udpdirect {
+
+UDPReceivePipeline::UDPReceivePipeline(std::shared_ptr<UDPSocketStats> stats, std::shared_ptr<UDPCapture> capture,
+                                       std::shared_ptr<UDPTrace> trace)
+    : stats_(std::move(stats)), capture_(std::move(capture)), trace_(std::move(trace)) {
+    if (!trace_) {
+        trace_ = std::make_shared<UDPTrace>(1);
+    }
+}
+
+std::unordered_map<uint32_t, UDPReceiveStages>::iterator UDPReceivePipeline::stagesFor(uint32_t socketId) {
+    return stages_.emplace(socketId, UDPReceiveStages()).first;
+}
+
+void UDPReceivePipeline::pruneIfEmpty(std::unordered_map<uint32_t, UDPReceiveStages>::iterator it) {
+    if (it->second.empty()) {
+        stages_.erase(it);
+    }
+}
+
+void UDPReceivePipeline::setPacketFilter(uint32_t socketId, std::shared_ptr<UDPPacketFilter> filter) {
+    auto it = stagesFor(socketId);
+    it->second.filter = std::move(filter);
+    pruneIfEmpty(it);
+}
+
+void UDPReceivePipeline::setChecksumVerifier(uint32_t socketId, std::shared_ptr<UDPChecksumVerifier> verifier) {
+    auto it = stagesFor(socketId);
+    it->second.checksum = std::move(verifier);
+    pruneIfEmpty(it);
+}
+
+void UDPReceivePipeline::setReassembler(uint32_t socketId, std::shared_ptr<UDPReassembler> reassembler) {
+    auto it = stagesFor(socketId);
+    it->second.reassembler = std::move(reassembler);
+    pruneIfEmpty(it);
+}
+
+UDPPacketFilter* UDPReceivePipeline::packetFilter(uint32_t socketId) const {
+    auto it = stages_.find(socketId);
+    return it == stages_.end() ? nullptr : it->second.filter.get();
+}
+
+void UDPReceivePipeline::forgetSocket(uint32_t socketId) {
+    stages_.erase(socketId);
+}
+
+UDPReceiveContext UDPReceivePipeline::context(uint32_t socketId) const {
+    UDPReceiveContext context;
+    context.socketId = socketId;
+    context.counters = stats_ ? stats_->find(socketId) : nullptr;
+    auto it = stages_.find(socketId);
+    context.stages = it == stages_.end() ? nullptr : &it->second;
+    return context;
+}
+
+UDPReceiveVerdict UDPReceivePipeline::process(const UDPReceiveContext& context, const uint8_t* data, size_t& length,
+                                              const UDPSocketAddress& source, uint32_t& route,
+                                              std::shared_ptr<std::vector<uint8_t>>& message) {
+    UDP_TRACE(*trace_, Receive, context.socketId, length);
+    if (context.counters) {
+        context.counters->countReceived(length);
+    }
+    if (capture_) {
+        capture_->record(UDPCaptureDirection::Inbound, context.socketId, source, data, length);
+    }
+    route = 0;
+    if (!context.stages) {
+        return UDPReceiveVerdict::Deliver;
+    }
+
+    if (UDPPacketFilter* filter = context.stages->filter.get()) {
+        UDPFilterDecision decision = filter->classify(data, length, source, UDPMonotonicNowNs());
+        if (decision.action == UDPFilterAction::Drop) {
+            UDP_TRACE(*trace_, Filtered, context.socketId, length);
+            return UDPReceiveVerdict::Dropped;
+        }
+        route = decision.action == UDPFilterAction::Route ? decision.route + 1 : 0;
+    }
+
+    // Verified datagrams come back with the trailer stripped if the verifier says so;
+    // failures routed elsewhere override the filter's route
+    if (UDPChecksumVerifier* checksum = context.stages->checksum.get()) {
+        if (!checksum->verify(data, length)) {
+            const UDPFilterDecision& onFailure = checksum->config().onFailure;
+            if (onFailure.action == UDPFilterAction::Drop) {
+                UDP_TRACE(*trace_, Filtered, context.socketId, length);
+                return UDPReceiveVerdict::Dropped;
+            }
+            if (onFailure.action == UDPFilterAction::Route) {
+                route = onFailure.route + 1;
+            }
+        }
+    }
+
+    if (UDPReassembler* reassembler = context.stages->reassembler.get()) {
+        switch (reassembler->receive(data, length, source, UDPMonotonicNowNs(), message)) {
+            case UDPReassembler::Result::NotFragment:
+                break;
+            case UDPReassembler::Result::Pending:
+                return UDPReceiveVerdict::Consumed;
+            case UDPReassembler::Result::Dropped:
+                UDP_TRACE(*trace_, Filtered, context.socketId, length);
+                return UDPReceiveVerdict::Consumed;
+            case UDPReassembler::Result::Complete:
+                return UDPReceiveVerdict::Reassembled;
+        }
+    }
+    return UDPReceiveVerdict::Deliver;
+}
+
+void UDPReceivePipeline::countDrop(const UDPReceiveContext& context, size_t length) {
+    UDP_TRACE(*trace_, Drop, context.socketId, length);
+    if (context.counters) {
+        context.counters->drops.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace udpdirect
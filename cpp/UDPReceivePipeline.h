@@ -0,0 +1,105 @@
+#pragma once
+
+// UDPReceivePipeline - what happens to a datagram between the socket read and
+// delivery: counting, capture, packet filter, checksum and reassembly. Shared
+// by every receive path of the iOS socket manager and by the Linux benchmarks.
+
+#include "UDPCapture.h"
+#include "UDPChecksum.h"
+#include "UDPFragmenter.h"
+#include "UDPPacketFilter.h"
+#include "UDPSocketAddress.h"
+#include "UDPSocketStats.h"
+#include "UDPTrace.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace udpdirect {
+
+/**
+ * The optional per-socket stages. Unset stages are skipped.
+ */
+struct UDPReceiveStages {
+    std::shared_ptr<UDPPacketFilter> filter;
+    std::shared_ptr<UDPChecksumVerifier> checksum;
+    std::shared_ptr<UDPReassembler> reassembler;
+
+    bool empty() const { return !filter && !checksum && !reassembler; }
+};
+
+enum class UDPReceiveVerdict {
+    Deliver,      // hand the datagram on with the returned route and length
+    Dropped,      // filtered out or failed its checksum
+    Consumed,     // fragment taken by the reassembler, message not complete
+    Reassembled   // deliver `message` instead of the datagram
+};
+
+/**
+ * Looked up once per socket per read burst, so the per-datagram work takes
+ * no map lookups. Valid until the next stage change.
+ */
+struct UDPReceiveContext {
+    uint32_t socketId = 0;
+    UDPSocketCounters* counters = nullptr;
+    const UDPReceiveStages* stages = nullptr;
+};
+
+/**
+ * UDPReceivePipeline
+ *
+ * One per receive queue. Not thread-safe: the stage table and process() belong
+ * to the thread that reads the queue's sockets. The stats, capture and trace
+ * it reports to are thread-safe and usually shared between pipelines; stats
+ * and capture may be null, a null trace is replaced by a disabled one.
+ */
+class UDPReceivePipeline {
+public:
+    UDPReceivePipeline(std::shared_ptr<UDPSocketStats> stats, std::shared_ptr<UDPCapture> capture,
+                       std::shared_ptr<UDPTrace> trace);
+
+    UDPReceivePipeline(const UDPReceivePipeline&) = delete;
+    UDPReceivePipeline& operator=(const UDPReceivePipeline&) = delete;
+
+    // Passing null removes the stage
+    void setPacketFilter(uint32_t socketId, std::shared_ptr<UDPPacketFilter> filter);
+    void setChecksumVerifier(uint32_t socketId, std::shared_ptr<UDPChecksumVerifier> verifier);
+    void setReassembler(uint32_t socketId, std::shared_ptr<UDPReassembler> reassembler);
+
+    UDPPacketFilter* packetFilter(uint32_t socketId) const;
+    void forgetSocket(uint32_t socketId);
+
+    UDPReceiveContext context(uint32_t socketId) const;
+
+    /**
+     * Run one received datagram through the pipeline. `data` is only read.
+     *
+     * @param length In: bytes received. Out: bytes to deliver, shorter when
+     *        the checksum verifier strips its trailer
+     * @param route Out: 0 for the default handler, n for filter route n - 1
+     * @param message Out: the completed message for Reassembled
+     */
+    UDPReceiveVerdict process(const UDPReceiveContext& context, const uint8_t* data, size_t& length,
+                              const UDPSocketAddress& source, uint32_t& route,
+                              std::shared_ptr<std::vector<uint8_t>>& message);
+
+    /**
+     * Count a datagram discarded after process() said to deliver it, e.g.
+     * because no receive slot was free.
+     */
+    void countDrop(const UDPReceiveContext& context, size_t length);
+
+private:
+    std::unordered_map<uint32_t, UDPReceiveStages>::iterator stagesFor(uint32_t socketId);
+    void pruneIfEmpty(std::unordered_map<uint32_t, UDPReceiveStages>::iterator it);
+
+    std::shared_ptr<UDPSocketStats> stats_;
+    std::shared_ptr<UDPCapture> capture_;
+    std::shared_ptr<UDPTrace> trace_;
+    std::unordered_map<uint32_t, UDPReceiveStages> stages_;
+};
+
+} // namespace udpdirect
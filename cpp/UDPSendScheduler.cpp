@@ -0,0 +1,290 @@
+#include "UDPSendScheduler.h"
+#include "UDPSocketStats.h"
+
+#include <algorithm>
+
+namespace udpdirect {
+
+static constexpr double kNsPerSecond = 1e9;
+
+void UDPTokenBucket::configure(const UDPRateLimit& limit, uint64_t nowNs) {
+    limit_ = limit;
+    byteBurst_ = (double)(limit.burstBytes ? limit.burstBytes : limit.bytesPerSecond / 50);
+    packetBurst_ = (double)(limit.burstPackets ? limit.burstPackets : limit.packetsPerSecond / 50);
+    byteBurst_ = std::max(byteBurst_, 1.0);
+    packetBurst_ = std::max(packetBurst_, 1.0);
+    byteTokens_ = byteBurst_;
+    packetTokens_ = packetBurst_;
+    lastRefillNs_ = nowNs;
+}
+
+void UDPTokenBucket::refill(uint64_t nowNs) {
+    if (nowNs <= lastRefillNs_) {
+        return;
+    }
+    double elapsed = (double)(nowNs - lastRefillNs_) / kNsPerSecond;
+    lastRefillNs_ = nowNs;
+    byteTokens_ = std::min(byteBurst_, byteTokens_ + elapsed * (double)limit_.bytesPerSecond);
+    packetTokens_ = std::min(packetBurst_, packetTokens_ + elapsed * (double)limit_.packetsPerSecond);
+}
+
+uint64_t UDPTokenBucket::delayNs(size_t bytes, uint64_t nowNs) {
+    if (limit_.unlimited()) {
+        return 0;
+    }
+    refill(nowNs);
+
+    // Oversized datagrams only need a full bucket, then run it into debt
+    double wait = 0;
+    if (limit_.bytesPerSecond != 0) {
+        double needed = std::min((double)bytes, byteBurst_);
+        if (byteTokens_ < needed) {
+            wait = (needed - byteTokens_) / (double)limit_.bytesPerSecond;
+        }
+    }
+    if (limit_.packetsPerSecond != 0 && packetTokens_ < 1.0) {
+        wait = std::max(wait, (1.0 - packetTokens_) / (double)limit_.packetsPerSecond);
+    }
+    if (wait <= 0) {
+        return 0;
+    }
+    // Round up so the caller never wakes a hair early and spins
+    return (uint64_t)(wait * kNsPerSecond) + 1;
+}
+
+void UDPTokenBucket::consume(size_t bytes) {
+    if (limit_.bytesPerSecond != 0) {
+        byteTokens_ -= (double)bytes;
+    }
+    if (limit_.packetsPerSecond != 0) {
+        packetTokens_ -= 1.0;
+    }
+}
+
+bool UDPTokenBucket::full(uint64_t nowNs) {
+    refill(nowNs);
+    return (limit_.bytesPerSecond == 0 || byteTokens_ >= byteBurst_) &&
+           (limit_.packetsPerSecond == 0 || packetTokens_ >= packetBurst_);
+}
+
+UDPSendScheduler::UDPSendScheduler(const Config& config, Clock clock)
+    : config_(config), clock_(clock ? std::move(clock) : Clock(UDPMonotonicNowNs)) {}
+
+void UDPSendScheduler::setRateLimit(uint32_t socketId, const UDPRateLimit& socketLimit,
+                                    const UDPRateLimit& destinationLimit) {
+    uint64_t nowNs = clock_();
+    if (socketLimit.unlimited() && destinationLimit.unlimited()) {
+        socketRates_.erase(socketId);
+    } else {
+        SocketRate& rate = socketRates_[socketId];
+        rate.bucket.configure(socketLimit, nowNs);
+        rate.destinationLimit = destinationLimit;
+    }
+    // Destination buckets pick up the new limit when next created
+    for (auto it = destinationBuckets_.begin(); it != destinationBuckets_.end();) {
+        it = (uint32_t)(it->first >> 32) == socketId ? destinationBuckets_.erase(it) : std::next(it);
+    }
+}
+
+bool UDPSendScheduler::enqueue(UDPScheduledSend& send) {
+    uint64_t packets = queuedPackets_.load(std::memory_order_relaxed);
+    uint64_t bytes = queuedBytes_.load(std::memory_order_relaxed);
+    if (packets >= config_.maxQueuedPackets || bytes + send.payload.size() > config_.maxQueuedBytes) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    send.enqueuedNs = clock_();
+    send.sequence = nextSequence_++;
+    send.heldBack = false;
+    queuedBytes_.store(bytes + send.payload.size(), std::memory_order_relaxed);
+    queuedPackets_.store(packets + 1, std::memory_order_relaxed);
+    if (packets + 1 > highWaterPackets_.load(std::memory_order_relaxed)) {
+        highWaterPackets_.store(packets + 1, std::memory_order_relaxed);
+    }
+    enqueued_.fetch_add(1, std::memory_order_relaxed);
+
+    PriorityClass& priorityClass = classes_[std::min((size_t)send.priority, kPriorityCount - 1)];
+    uint32_t socketId = send.socketId;
+    SocketQueue& queue = priorityClass.sockets[socketId];
+    if (queue.sends.empty()) {
+        priorityClass.active.push_back(socketId);
+    }
+    queue.sends.push_back(std::move(send));
+    return true;
+}
+
+// Socket id in the high half, so a socket's buckets can be found without a second index
+uint64_t UDPSendScheduler::destinationKey(uint32_t socketId, const UDPSocketAddress& address) {
+    return ((uint64_t)socketId << 32) | (uint32_t)(address.hash() ^ (address.hash() >> 32));
+}
+
+UDPTokenBucket* UDPSendScheduler::destinationBucket(const UDPScheduledSend& send, uint64_t nowNs) {
+    auto rate = socketRates_.find(send.socketId);
+    if (rate == socketRates_.end() || rate->second.destinationLimit.unlimited()) {
+        return nullptr;
+    }
+    uint64_t key = destinationKey(send.socketId, send.destination.address);
+    auto found = destinationBuckets_.find(key);
+    if (found != destinationBuckets_.end()) {
+        return &found->second;
+    }
+    if (destinationBuckets_.size() >= kMaxDestinationBuckets) {
+        pruneDestinationBuckets(nowNs);
+    }
+    UDPTokenBucket& bucket = destinationBuckets_[key];
+    bucket.configure(rate->second.destinationLimit, nowNs);
+    return &bucket;
+}
+
+// A full bucket carries no state a fresh one would not have, so it can go
+void UDPSendScheduler::pruneDestinationBuckets(uint64_t nowNs) {
+    for (auto it = destinationBuckets_.begin(); it != destinationBuckets_.end();) {
+        it = it->second.full(nowNs) ? destinationBuckets_.erase(it) : std::next(it);
+    }
+}
+
+void UDPSendScheduler::noteDequeued(const UDPScheduledSend& send) {
+    queuedPackets_.fetch_sub(1, std::memory_order_relaxed);
+    queuedBytes_.fetch_sub(send.payload.size(), std::memory_order_relaxed);
+}
+
+// Sends the socket's datagrams in order until its bucket or the run's budget runs out,
+// skipping only those whose destination bucket is empty
+void UDPSendScheduler::dispatchSocket(SocketQueue& queue, uint32_t socketId, uint64_t nowNs, uint64_t& nextNs,
+                                      size_t& budget, std::vector<UDPScheduledSend>& out) {
+    if (blockedSockets_.count(socketId) != 0) {
+        queue.heldBackBefore = nextSequence_;
+        return;
+    }
+    auto rate = socketRates_.find(socketId);
+    UDPTokenBucket* socketBucket = rate == socketRates_.end() ? nullptr : &rate->second.bucket;
+    bool perDestination = rate != socketRates_.end() && !rate->second.destinationLimit.unlimited();
+
+    std::deque<UDPScheduledSend>& sends = queue.sends;
+    size_t kept = 0;
+    size_t i = 0;
+    for (; i < sends.size() && budget > 0; i++) {
+        UDPScheduledSend& send = sends[i];
+        uint64_t socketDelay = socketBucket ? socketBucket->delayNs(send.payload.size(), nowNs) : 0;
+        if (socketDelay != 0) {
+            blockedSockets_.insert(socketId);
+            queue.heldBackBefore = nextSequence_;
+            nextNs = std::min(nextNs, nowNs + socketDelay);
+            break;
+        }
+
+        UDPTokenBucket* bucket = nullptr;
+        if (perDestination) {
+            uint64_t key = destinationKey(socketId, send.destination.address);
+            uint64_t destinationDelay = 0;
+            if (blockedDestinations_.count(key) == 0) {
+                bucket = destinationBucket(send, nowNs);
+                destinationDelay = bucket->delayNs(send.payload.size(), nowNs);
+                if (destinationDelay != 0) {
+                    blockedDestinations_.insert(key);
+                    nextNs = std::min(nextNs, nowNs + destinationDelay);
+                }
+            }
+            if (bucket == nullptr || destinationDelay != 0) {
+                send.heldBack = true;
+                if (kept != i) {
+                    sends[kept] = std::move(send);
+                }
+                kept++;
+                continue;
+            }
+        }
+
+        if (socketBucket) socketBucket->consume(send.payload.size());
+        if (bucket) bucket->consume(send.payload.size());
+        budget--;
+        noteDequeued(send);
+        dispatched_.fetch_add(1, std::memory_order_relaxed);
+        if (send.heldBack || send.sequence < queue.heldBackBefore) {
+            shaped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        shapedLatency_.record(nowNs - send.enqueuedNs);
+        out.push_back(std::move(send));
+    }
+    // [0, kept) were held back, [kept, i) were sent; the rest were not reached
+    sends.erase(sends.begin() + kept, sends.begin() + i);
+}
+
+uint64_t UDPSendScheduler::dispatchReady(std::vector<UDPScheduledSend>& out) {
+    uint64_t nowNs = clock_();
+    uint64_t nextNs = UINT64_MAX;
+    size_t budget = config_.maxDispatchPerRun;
+    blockedSockets_.clear();
+    blockedDestinations_.clear();
+
+    for (PriorityClass& priorityClass : classes_) {
+        size_t count = priorityClass.active.size();
+        size_t start = count == 0 ? 0 : priorityClass.next % count;
+        size_t resume = 0;
+        bool cut = false;
+        stillActive_.clear();
+        for (size_t n = 0; n < count; n++) {
+            uint32_t socketId = priorityClass.active[(start + n) % count];
+            SocketQueue& queue = priorityClass.sockets[socketId];
+            if (budget > 0) {
+                dispatchSocket(queue, socketId, nowNs, nextNs, budget, out);
+            } else if (!cut) {
+                // The first socket the budget did not reach goes first next time
+                cut = true;
+                resume = stillActive_.size();
+            }
+            if (!queue.sends.empty()) {
+                stillActive_.push_back(socketId);
+            }
+        }
+        priorityClass.active.swap(stillActive_);
+        priorityClass.next = resume;
+    }
+
+    if (empty()) {
+        return 0;
+    }
+    // Out of budget with sendable datagrams left: come straight back
+    return budget == 0 ? nowNs : nextNs;
+}
+
+size_t UDPSendScheduler::forgetSocket(uint32_t socketId) {
+    size_t dropped = 0;
+    for (PriorityClass& priorityClass : classes_) {
+        auto found = priorityClass.sockets.find(socketId);
+        if (found == priorityClass.sockets.end()) {
+            continue;
+        }
+        for (const UDPScheduledSend& send : found->second.sends) {
+            noteDequeued(send);
+            dropped++;
+        }
+        priorityClass.sockets.erase(found);
+        auto active = std::find(priorityClass.active.begin(), priorityClass.active.end(), socketId);
+        if (active != priorityClass.active.end()) {
+            priorityClass.active.erase(active);
+        }
+    }
+    socketRates_.erase(socketId);
+    for (auto it = destinationBuckets_.begin(); it != destinationBuckets_.end();) {
+        it = (uint32_t)(it->first >> 32) == socketId ? destinationBuckets_.erase(it) : std::next(it);
+    }
+    discarded_.fetch_add(dropped, std::memory_order_relaxed);
+    return dropped;
+}
+
+UDPSendSchedulerStats UDPSendScheduler::stats() const {
+    UDPSendSchedulerStats stats;
+    stats.queuedPackets = queuedPackets_.load(std::memory_order_relaxed);
+    stats.queuedBytes = queuedBytes_.load(std::memory_order_relaxed);
+    stats.highWaterPackets = highWaterPackets_.load(std::memory_order_relaxed);
+    stats.enqueued = enqueued_.load(std::memory_order_relaxed);
+    stats.dispatched = dispatched_.load(std::memory_order_relaxed);
+    stats.shaped = shaped_.load(std::memory_order_relaxed);
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+    stats.discarded = discarded_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace udpdirect
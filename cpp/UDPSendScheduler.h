@@ -0,0 +1,218 @@
+#pragma once
+
+// UDPSendScheduler - paced sending. Datagrams are queued by priority class
+// and released by per-socket and per-destination token buckets, so a burst
+// submitted by JS leaves at the configured rate instead of overflowing the
+// kernel send buffer.
+
+#include "UDPEndpointTable.h"
+#include "UDPLatencyHistogram.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace udpdirect {
+
+/**
+ * A rate of 0 means unlimited. Bursts default to 20 ms worth of the rate,
+ * and at least one datagram.
+ */
+struct UDPRateLimit {
+    uint64_t bytesPerSecond = 0;
+    uint64_t packetsPerSecond = 0;
+    uint64_t burstBytes = 0;
+    uint64_t burstPackets = 0;
+
+    bool unlimited() const { return bytesPerSecond == 0 && packetsPerSecond == 0; }
+};
+
+/**
+ * Byte and packet token bucket. Starts full. A datagram larger than the byte
+ * burst waits for a full bucket and then leaves the bucket in debt, so the
+ * long-term rate still holds.
+ */
+class UDPTokenBucket {
+public:
+    void configure(const UDPRateLimit& limit, uint64_t nowNs);
+
+    /**
+     * @return 0 if `bytes` may be sent at `nowNs`, otherwise how long to wait
+     */
+    uint64_t delayNs(size_t bytes, uint64_t nowNs);
+    void consume(size_t bytes);
+
+    bool unlimited() const { return limit_.unlimited(); }
+    bool full(uint64_t nowNs);
+
+private:
+    void refill(uint64_t nowNs);
+
+    UDPRateLimit limit_;
+    double byteTokens_ = 0;
+    double packetTokens_ = 0;
+    double byteBurst_ = 0;
+    double packetBurst_ = 0;
+    uint64_t lastRefillNs_ = 0;
+};
+
+enum class UDPSendPriority : uint8_t {
+    High = 0,
+    Normal = 1,
+    Bulk = 2,
+};
+
+/**
+ * One queued datagram. The payload is owned by the queue, since the caller's
+ * buffer is long gone by the time it is sent.
+ */
+struct UDPScheduledSend {
+    uint32_t socketId = 0;
+    UDPEndpoint destination;
+    std::vector<uint8_t> payload;
+    UDPSendPriority priority = UDPSendPriority::Normal;
+    long tag = 0;
+    uint64_t enqueuedNs = 0;  // set by enqueue()
+    uint64_t sequence = 0;    // set by enqueue(); orders held-back marks, see SocketQueue
+    bool heldBack = false;    // a destination bucket was empty when it was due
+};
+
+struct UDPSendSchedulerStats {
+    uint64_t queuedPackets = 0;
+    uint64_t queuedBytes = 0;
+    uint64_t highWaterPackets = 0;
+    uint64_t enqueued = 0;
+    uint64_t dispatched = 0;
+    uint64_t shaped = 0;     // dispatched later than submitted because a bucket was empty
+    uint64_t rejected = 0;   // queue full at enqueue
+    uint64_t discarded = 0;  // still queued when their socket closed
+};
+
+/**
+ * UDPSendScheduler
+ *
+ * Priority classes are strict: a class is only looked at once every ready
+ * datagram of the classes above it has gone. Within a class, datagrams of
+ * one socket keep their order; a socket whose bucket is empty does not hold
+ * up the others. A datagram held back only by its destination's bucket does
+ * not hold up the same socket's datagrams to other destinations.
+ *
+ * Each class queues per socket, so a run skips a held-back socket without
+ * touching its datagrams, and sockets take turns at the head of the class
+ * when maxDispatchPerRun cuts a run short.
+ *
+ * Not thread-safe; callers serialise access. Stats and the latency histogram
+ * can be read from any thread.
+ */
+class UDPSendScheduler {
+public:
+    using Clock = std::function<uint64_t()>;
+
+    struct Config {
+        size_t maxQueuedPackets = 4096;
+        size_t maxQueuedBytes = 4 * 1024 * 1024;
+        size_t maxDispatchPerRun = 256;  // bounds the work done per dispatchReady() call
+    };
+
+    static constexpr size_t kPriorityCount = 3;
+    static constexpr size_t kMaxDestinationBuckets = 1024;  // idle buckets are pruned past this
+
+    /**
+     * @param clock Monotonic nanoseconds; defaults to UDPMonotonicNowNs. Tests
+     *        pass a fake clock to make pacing deterministic.
+     */
+    explicit UDPSendScheduler(const Config& config, Clock clock = nullptr);
+
+    UDPSendScheduler(const UDPSendScheduler&) = delete;
+    UDPSendScheduler& operator=(const UDPSendScheduler&) = delete;
+
+    /**
+     * Limits for all traffic of `socketId`, and separately for each
+     * destination it sends to. Unlimited by default.
+     */
+    void setRateLimit(uint32_t socketId, const UDPRateLimit& socketLimit, const UDPRateLimit& destinationLimit);
+
+    /**
+     * @return false if the queue is full; `send` is left untouched then
+     */
+    bool enqueue(UDPScheduledSend& send);
+
+    /**
+     * Move every datagram the buckets allow right now to `out`, highest
+     * priority first.
+     *
+     * @return Clock time at which the next queued datagram becomes sendable,
+     *         or 0 if the queue is empty
+     */
+    uint64_t dispatchReady(std::vector<UDPScheduledSend>& out);
+
+    /**
+     * Drop the socket's queued datagrams and rate limits.
+     *
+     * @return Number of datagrams discarded
+     */
+    size_t forgetSocket(uint32_t socketId);
+
+    bool empty() const { return queuedPackets_.load(std::memory_order_relaxed) == 0; }
+    uint64_t now() const { return clock_(); }
+
+    UDPSendSchedulerStats stats() const;
+
+    // enqueue() -> handed out by dispatchReady()
+    const UDPLatencyHistogram& shapedLatency() const { return shapedLatency_; }
+
+private:
+    struct SocketRate {
+        UDPTokenBucket bucket;
+        UDPRateLimit destinationLimit;
+    };
+
+    // A blocked socket's datagrams are not visited, so rather than marking each of them,
+    // everything enqueued before heldBackBefore counts as held back
+    struct SocketQueue {
+        std::deque<UDPScheduledSend> sends;
+        uint64_t heldBackBefore = 0;
+    };
+
+    struct PriorityClass {
+        std::unordered_map<uint32_t, SocketQueue> sockets;
+        std::vector<uint32_t> active;  // sockets with queued datagrams, in service order
+        size_t next = 0;               // index in `active` the next run starts at
+    };
+
+    static uint64_t destinationKey(uint32_t socketId, const UDPSocketAddress& address);
+    UDPTokenBucket* destinationBucket(const UDPScheduledSend& send, uint64_t nowNs);
+    void pruneDestinationBuckets(uint64_t nowNs);
+    void noteDequeued(const UDPScheduledSend& send);
+    void dispatchSocket(SocketQueue& queue, uint32_t socketId, uint64_t nowNs, uint64_t& nextNs,
+                        size_t& budget, std::vector<UDPScheduledSend>& out);
+
+    Config config_;
+    Clock clock_;
+    PriorityClass classes_[kPriorityCount];
+    std::unordered_map<uint32_t, SocketRate> socketRates_;
+    std::unordered_map<uint64_t, UDPTokenBucket> destinationBuckets_;
+    uint64_t nextSequence_ = 1;
+
+    // Per-run scratch, kept to avoid reallocating
+    std::unordered_set<uint32_t> blockedSockets_;
+    std::unordered_set<uint64_t> blockedDestinations_;
+    std::vector<uint32_t> stillActive_;
+
+    std::atomic<uint64_t> queuedPackets_{0};
+    std::atomic<uint64_t> queuedBytes_{0};
+    std::atomic<uint64_t> highWaterPackets_{0};
+    std::atomic<uint64_t> enqueued_{0};
+    std::atomic<uint64_t> dispatched_{0};
+    std::atomic<uint64_t> shaped_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> discarded_{0};
+    UDPLatencyHistogram shapedLatency_;
+};
+
+} // namespace udpdirect
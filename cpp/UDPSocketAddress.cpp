@@ -0,0 +1,135 @@
+#include "UDPSocketAddress.h"
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <net/if.h>
+#include <netinet/in.h>
+
+namespace udpdirect {
+
+bool UDPSocketAddress::operator==(const UDPSocketAddress& other) const {
+    if (family != other.family || port != other.port) {
+        return false;
+    }
+    size_t length = family == AF_INET6 ? 16 : 4;
+    return memcmp(bytes, other.bytes, length) == 0 && (family != AF_INET6 || scopeId == other.scopeId);
+}
+
+bool UDPSocketAddress::fromSockaddr(const struct sockaddr* addr, socklen_t length, UDPSocketAddress& out) {
+    if (!addr) {
+        return false;
+    }
+    out = UDPSocketAddress();
+    if (addr->sa_family == AF_INET && length >= (socklen_t)sizeof(sockaddr_in)) {
+        const sockaddr_in* in4 = reinterpret_cast<const sockaddr_in*>(addr);
+        out.family = AF_INET;
+        out.port = ntohs(in4->sin_port);
+        memcpy(out.bytes, &in4->sin_addr, 4);
+        return true;
+    }
+    if (addr->sa_family == AF_INET6 && length >= (socklen_t)sizeof(sockaddr_in6)) {
+        const sockaddr_in6* in6 = reinterpret_cast<const sockaddr_in6*>(addr);
+        out.family = AF_INET6;
+        out.port = ntohs(in6->sin6_port);
+        out.scopeId = in6->sin6_scope_id;
+        memcpy(out.bytes, &in6->sin6_addr, 16);
+        return true;
+    }
+    return false;
+}
+
+bool UDPSocketAddress::fromNumericHost(const char* host, uint16_t port, UDPSocketAddress& out) {
+    if (!host) {
+        return false;
+    }
+    out = UDPSocketAddress();
+    out.port = port;
+
+    in_addr addr4;
+    if (inet_pton(AF_INET, host, &addr4) == 1) {
+        out.family = AF_INET;
+        memcpy(out.bytes, &addr4, 4);
+        return true;
+    }
+
+    // Split off an optional "%scope" suffix, which inet_pton does not accept.
+    char buffer[INET6_ADDRSTRLEN + IF_NAMESIZE + 1];
+    size_t hostLength = strlen(host);
+    if (hostLength >= sizeof(buffer)) {
+        return false;
+    }
+    memcpy(buffer, host, hostLength + 1);
+    char* scope = strchr(buffer, '%');
+    if (scope) {
+        *scope++ = '\0';
+    }
+
+    in6_addr addr6;
+    if (inet_pton(AF_INET6, buffer, &addr6) != 1) {
+        return false;
+    }
+    out.family = AF_INET6;
+    memcpy(out.bytes, &addr6, 16);
+    if (scope && *scope) {
+        char* end = nullptr;
+        unsigned long numeric = strtoul(scope, &end, 10);
+        out.scopeId = (end && *end == '\0') ? (uint32_t)numeric : if_nametoindex(scope);
+    }
+    return true;
+}
+
+socklen_t UDPSocketAddress::toSockaddr(struct sockaddr_storage& out) const {
+    memset(&out, 0, sizeof(out));
+    if (family == AF_INET) {
+        sockaddr_in* in4 = reinterpret_cast<sockaddr_in*>(&out);
+#ifdef __APPLE__
+        in4->sin_len = sizeof(sockaddr_in);
+#endif
+        in4->sin_family = AF_INET;
+        in4->sin_port = htons(port);
+        memcpy(&in4->sin_addr, bytes, 4);
+        return sizeof(sockaddr_in);
+    }
+    if (family == AF_INET6) {
+        sockaddr_in6* in6 = reinterpret_cast<sockaddr_in6*>(&out);
+#ifdef __APPLE__
+        in6->sin6_len = sizeof(sockaddr_in6);
+#endif
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port = htons(port);
+        in6->sin6_scope_id = scopeId;
+        memcpy(&in6->sin6_addr, bytes, 16);
+        return sizeof(sockaddr_in6);
+    }
+    return 0;
+}
+
+std::string UDPSocketAddress::hostString() const {
+    char buffer[INET6_ADDRSTRLEN];
+    if (family == AF_INET && inet_ntop(AF_INET, bytes, buffer, sizeof(buffer))) {
+        return buffer;
+    }
+    if (family == AF_INET6 && inet_ntop(AF_INET6, bytes, buffer, sizeof(buffer))) {
+        return buffer;
+    }
+    return std::string();
+}
+
+uint64_t UDPSocketAddress::hash() const {
+    // FNV-1a over the significant bytes
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](uint8_t byte) {
+        h ^= byte;
+        h *= 1099511628211ull;
+    };
+    mix(family);
+    mix((uint8_t)(port >> 8));
+    mix((uint8_t)port);
+    size_t length = family == AF_INET6 ? 16 : 4;
+    for (size_t i = 0; i < length; i++) {
+        mix(bytes[i]);
+    }
+    return h;
+}
+
+} // namespace udpdirect
@@ -0,0 +1,54 @@
+#pragma once
+
+// UDPSocketAddress - compact binary IPv4/IPv6 address + port that can be copied
+// through queues without touching the heap.
+
+#include <cstdint>
+#include <string>
+#include <sys/socket.h>
+
+namespace udpdirect {
+
+struct UDPSocketAddress {
+    uint8_t family = 0;      // AF_INET, AF_INET6 or 0 when unset
+    uint16_t port = 0;       // host byte order
+    uint32_t scopeId = 0;    // IPv6 scope (interface index)
+    uint8_t bytes[16] = {};  // IPv4 uses the first 4 bytes
+
+    bool isIPv6() const { return family == AF_INET6; }
+    explicit operator bool() const { return family != 0; }
+
+    bool operator==(const UDPSocketAddress& other) const;
+    bool operator!=(const UDPSocketAddress& other) const { return !(*this == other); }
+
+    /**
+     * Decode a kernel sockaddr. Returns false for families other than
+     * AF_INET/AF_INET6.
+     */
+    static bool fromSockaddr(const struct sockaddr* addr, socklen_t length, UDPSocketAddress& out);
+
+    /**
+     * Parse a numeric host ("192.168.1.10", "fe80::1%2"). Hostnames are not
+     * resolved here.
+     */
+    static bool fromNumericHost(const char* host, uint16_t port, UDPSocketAddress& out);
+
+    /**
+     * Encode as a kernel sockaddr.
+     *
+     * @return The sockaddr length, or 0 if the address is unset.
+     */
+    socklen_t toSockaddr(struct sockaddr_storage& out) const;
+
+    /**
+     * Numeric host string without the port.
+     */
+    std::string hostString() const;
+
+    /**
+     * Stable hash of family, bytes and port, for interning tables.
+     */
+    uint64_t hash() const;
+};
+
+} // namespace udpdirect
@@ -0,0 +1,87 @@
+#include "UDPSocketStats.h"
+
+#include <chrono>
+
+namespace udpdirect {
+
+static constexpr uint32_t kHandleIndexMask = 0xFFFF;
+
+uint64_t UDPMonotonicNowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t UDPRealtimeNowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static void loadCounters(const UDPSocketCounters& counters, UDPSocketCountersSnapshot& out) {
+    out.rxPackets = counters.rxPackets.load(std::memory_order_relaxed);
+    out.rxBytes = counters.rxBytes.load(std::memory_order_relaxed);
+    out.txPackets = counters.txPackets.load(std::memory_order_relaxed);
+    out.txBytes = counters.txBytes.load(std::memory_order_relaxed);
+    out.sendFailures = counters.sendFailures.load(std::memory_order_relaxed);
+    out.drops = counters.drops.load(std::memory_order_relaxed);
+    out.queueDepth = counters.queueDepth.load(std::memory_order_relaxed);
+}
+
+UDPSocketStats::UDPSocketStats(uint32_t capacity)
+    : slots_(new Slot[capacity == 0 ? 1 : capacity]), capacity_(capacity == 0 ? 1 : capacity) {}
+
+UDPSocketCounters* UDPSocketStats::attach(uint32_t socketId) {
+    uint32_t index = socketId & kHandleIndexMask;
+    if (socketId == 0 || index >= capacity_) {
+        return nullptr;
+    }
+    Slot& slot = slots_[index];
+    UDPSocketCounters& counters = slot.counters;
+    counters.rxPackets.store(0, std::memory_order_relaxed);
+    counters.rxBytes.store(0, std::memory_order_relaxed);
+    counters.txPackets.store(0, std::memory_order_relaxed);
+    counters.txBytes.store(0, std::memory_order_relaxed);
+    counters.sendFailures.store(0, std::memory_order_relaxed);
+    counters.drops.store(0, std::memory_order_relaxed);
+    counters.queueDepth.store(0, std::memory_order_relaxed);
+    slot.socketId.store(socketId, std::memory_order_release);
+    return &counters;
+}
+
+UDPSocketCounters* UDPSocketStats::find(uint32_t socketId) const {
+    uint32_t index = socketId & kHandleIndexMask;
+    if (socketId == 0 || index >= capacity_) {
+        return nullptr;
+    }
+    Slot& slot = slots_[index];
+    return slot.socketId.load(std::memory_order_acquire) == socketId ? &slot.counters : nullptr;
+}
+
+bool UDPSocketStats::snapshot(uint32_t socketId, UDPSocketCountersSnapshot& out) const {
+    UDPSocketCounters* counters = find(socketId);
+    if (!counters) {
+        return false;
+    }
+    loadCounters(*counters, out);
+    return true;
+}
+
+UDPSocketCountersSnapshot UDPSocketStats::totals() const {
+    UDPSocketCountersSnapshot totals;
+    for (uint32_t i = 0; i < capacity_; i++) {
+        if (slots_[i].socketId.load(std::memory_order_acquire) == 0) {
+            continue;
+        }
+        UDPSocketCountersSnapshot socket;
+        loadCounters(slots_[i].counters, socket);
+        totals.rxPackets += socket.rxPackets;
+        totals.rxBytes += socket.rxBytes;
+        totals.txPackets += socket.txPackets;
+        totals.txBytes += socket.txBytes;
+        totals.sendFailures += socket.sendFailures;
+        totals.drops += socket.drops;
+        totals.queueDepth += socket.queueDepth;
+    }
+    return totals;
+}
+
+} // namespace udpdirect
@@ -0,0 +1,111 @@
+#pragma once
+
+// UDPSocketStats - lock-free per-socket traffic counters plus the manager-wide
+// receive and send latency histograms.
+
+#include "UDPLatencyHistogram.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace udpdirect {
+
+/**
+ * Monotonic clock used for every latency measurement, in nanoseconds.
+ */
+uint64_t UDPMonotonicNowNs();
+
+/**
+ * Wall clock in nanoseconds since the epoch; the clock kernel receive
+ * timestamps are taken on.
+ */
+uint64_t UDPRealtimeNowNs();
+
+/**
+ * Live counters for one socket. Updated with relaxed atomics from whichever
+ * thread sees the event.
+ */
+struct UDPSocketCounters {
+    std::atomic<uint64_t> rxPackets{0};
+    std::atomic<uint64_t> rxBytes{0};
+    std::atomic<uint64_t> txPackets{0};
+    std::atomic<uint64_t> txBytes{0};
+    std::atomic<uint64_t> sendFailures{0};
+    std::atomic<uint64_t> drops{0};       // received datagrams discarded natively
+    std::atomic<int64_t> queueDepth{0};   // sends queued through GCDAsyncUdpSocket, not yet completed
+
+    void countReceived(size_t bytes) {
+        rxPackets.fetch_add(1, std::memory_order_relaxed);
+        rxBytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    void countSent(size_t bytes) {
+        txPackets.fetch_add(1, std::memory_order_relaxed);
+        txBytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+};
+
+struct UDPSocketCountersSnapshot {
+    uint64_t rxPackets = 0;
+    uint64_t rxBytes = 0;
+    uint64_t txPackets = 0;
+    uint64_t txBytes = 0;
+    uint64_t sendFailures = 0;
+    uint64_t drops = 0;
+    int64_t queueDepth = 0;
+};
+
+/**
+ * UDPSocketStats
+ *
+ * Counters are stored in a flat array indexed by the low 16 bits of the
+ * socket handle (see UDPHandleTable), so lookups take no lock. A slot
+ * remembers which handle it was attached for; lookups with a stale handle
+ * return null, and a closed socket's counters stay readable until its slot
+ * is reused.
+ */
+class UDPSocketStats {
+public:
+    explicit UDPSocketStats(uint32_t capacity = 4096);
+
+    UDPSocketStats(const UDPSocketStats&) = delete;
+    UDPSocketStats& operator=(const UDPSocketStats&) = delete;
+
+    /**
+     * Zero the slot for a newly allocated socket handle and claim it.
+     */
+    UDPSocketCounters* attach(uint32_t socketId);
+
+    /**
+     * @return The socket's counters, or null for unknown/stale handles
+     */
+    UDPSocketCounters* find(uint32_t socketId) const;
+
+    bool snapshot(uint32_t socketId, UDPSocketCountersSnapshot& out) const;
+
+    /**
+     * Sum over every attached slot, including closed sockets not yet reused.
+     */
+    UDPSocketCountersSnapshot totals() const;
+
+    // Datagram read from the socket -> JS handler invoked
+    UDPLatencyHistogram& receiveLatency() { return receiveLatency_; }
+    // sendData: called -> didSendDataWithTag:
+    UDPLatencyHistogram& sendLatency() { return sendLatency_; }
+    const UDPLatencyHistogram& receiveLatency() const { return receiveLatency_; }
+    const UDPLatencyHistogram& sendLatency() const { return sendLatency_; }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> socketId{0};
+        UDPSocketCounters counters;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    uint32_t capacity_;
+    UDPLatencyHistogram receiveLatency_;
+    UDPLatencyHistogram sendLatency_;
+};
+
+} // namespace udpdirect
@@ -0,0 +1,90 @@
+#include "UDPTrace.h"
+
+#include <chrono>
+
+namespace udpdirect {
+
+static size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+const char* UDPTraceEventName(UDPTraceEvent event) {
+    switch (event) {
+        case UDPTraceEvent::Receive: return "receive";
+        case UDPTraceEvent::Deliver: return "deliver";
+        case UDPTraceEvent::SendDirect: return "sendDirect";
+        case UDPTraceEvent::SendQueued: return "sendQueued";
+        case UDPTraceEvent::SendComplete: return "sendComplete";
+        case UDPTraceEvent::SendFailed: return "sendFailed";
+        case UDPTraceEvent::Drop: return "drop";
+        case UDPTraceEvent::Close: return "close";
+        case UDPTraceEvent::Filtered: return "filtered";
+    }
+    return "unknown";
+}
+
+UDPTrace::UDPTrace(size_t capacity) {
+    size_t size = roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity);
+    slots_.reset(new Slot[size]);
+    mask_ = size - 1;
+}
+
+uint64_t UDPTrace::nowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void UDPTrace::record(UDPTraceEvent event, uint32_t socketId, uint32_t bytes) {
+    uint64_t position = head_.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots_[position & mask_];
+
+    // Sequence 2p+1 while writing record p, 2p+2 once it is complete
+    slot.sequence.store(2 * position + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timestampNs.store(nowNs(), std::memory_order_relaxed);
+    slot.socketAndBytes.store(((uint64_t)socketId << 32) | bytes, std::memory_order_relaxed);
+    slot.event.store((uint16_t)event, std::memory_order_relaxed);
+    slot.sequence.store(2 * position + 2, std::memory_order_release);
+}
+
+std::vector<UDPTraceRecord> UDPTrace::snapshot() const {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t first = head > capacity() ? head - capacity() : 0;
+
+    std::vector<UDPTraceRecord> records;
+    records.reserve((size_t)(head - first));
+    for (uint64_t position = first; position < head; position++) {
+        const Slot& slot = slots_[position & mask_];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * position + 2) {
+            continue;  // still being written, or already overwritten
+        }
+
+        UDPTraceRecord record;
+        record.timestampNs = slot.timestampNs.load(std::memory_order_relaxed);
+        uint64_t socketAndBytes = slot.socketAndBytes.load(std::memory_order_relaxed);
+        record.event = (UDPTraceEvent)slot.event.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+        record.socketId = (uint32_t)(socketAndBytes >> 32);
+        record.bytes = (uint32_t)socketAndBytes;
+        records.push_back(record);
+    }
+    return records;
+}
+
+void UDPTrace::clear() {
+    for (size_t i = 0; i <= mask_; i++) {
+        slots_[i].sequence.store(0, std::memory_order_relaxed);
+    }
+    head_.store(0, std::memory_order_release);
+}
+
+} // namespace udpdirect
@@ -0,0 +1,107 @@
+#pragma once
+
+// UDPTrace - fixed-size binary trace records in a lock-free overwrite ring.
+// Cheap enough to leave in hot paths: recording is one fetch_add and four
+// relaxed stores, and a disabled trace costs one relaxed load.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Define as 0 to compile every UDP_TRACE() out
+#ifndef UDP_TRACE_ENABLED
+#define UDP_TRACE_ENABLED 1
+#endif
+
+namespace udpdirect {
+
+enum class UDPTraceEvent : uint16_t {
+    Receive = 1,      // datagram read from a socket
+    Deliver = 2,      // datagram handed to JS
+    SendDirect = 3,   // datagram sent straight from the caller's buffer
+    SendQueued = 4,   // datagram copied and queued for GCDAsyncUdpSocket
+    SendComplete = 5, // queued send finished
+    SendFailed = 6,
+    Drop = 7,         // datagram discarded (pool exhausted, truncated, no handler)
+    Close = 8,
+    Filtered = 9,     // datagram dropped by the socket's packet filter
+};
+
+const char* UDPTraceEventName(UDPTraceEvent event);
+
+struct UDPTraceRecord {
+    uint64_t timestampNs = 0;  // steady clock
+    uint32_t socketId = 0;
+    uint32_t bytes = 0;
+    UDPTraceEvent event = UDPTraceEvent::Receive;
+};
+
+/**
+ * UDPTrace
+ *
+ * Any number of threads may record concurrently; once the ring is full the
+ * oldest records are overwritten. snapshot() may run at the same time as
+ * writers and skips records that are being overwritten while it reads them.
+ *
+ * Starts disabled.
+ */
+class UDPTrace {
+public:
+    /**
+     * @param capacity Record count, rounded up to a power of two
+     */
+    explicit UDPTrace(size_t capacity = 4096);
+
+    UDPTrace(const UDPTrace&) = delete;
+    UDPTrace& operator=(const UDPTrace&) = delete;
+
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    void record(UDPTraceEvent event, uint32_t socketId, uint32_t bytes);
+
+    /**
+     * Copy out the records still in the ring, oldest first.
+     */
+    std::vector<UDPTraceRecord> snapshot() const;
+
+    /**
+     * Forget all records. Not safe against concurrent record().
+     */
+    void clear();
+
+    size_t capacity() const { return mask_ + 1; }
+    uint64_t recorded() const { return head_.load(std::memory_order_relaxed); }
+
+    static uint64_t nowNs();
+
+private:
+    // Each word is atomic so concurrent snapshot() reads are race-free; the
+    // sequence word makes torn records detectable (odd = being written).
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint64_t> timestampNs{0};
+        std::atomic<uint64_t> socketAndBytes{0};
+        std::atomic<uint16_t> event{0};
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    std::atomic<uint64_t> head_{0};
+    std::atomic<bool> enabled_{false};
+};
+
+} // namespace udpdirect
+
+#if UDP_TRACE_ENABLED
+#define UDP_TRACE(trace, event, socketId, bytes)                                              \
+    do {                                                                                      \
+        if ((trace).enabled()) {                                                              \
+            (trace).record(udpdirect::UDPTraceEvent::event, (uint32_t)(socketId), (uint32_t)(bytes)); \
+        }                                                                                     \
+    } while (0)
+#else
+#define UDP_TRACE(trace, event, socketId, bytes) do { } while (0)
+#endif
@@ -0,0 +1,143 @@
+#include "UDPTxArena.h"
+
+#include <cstring>
+
+namespace udpdirect {
+
+// Single-writer counter bump: a relaxed load and store, no locked instruction
+static void bump(std::atomic<uint64_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+std::string UDPTxArena::validate(uint32_t slotSize, uint32_t slotCount) {
+    if (slotSize == 0 || slotSize > kMaxSlotSize) {
+        return "slotSize must be 1 to " + std::to_string(kMaxSlotSize) + " bytes";
+    }
+    if (slotCount == 0) {
+        return "slotCount must be at least 1";
+    }
+    uint64_t stride = ((uint64_t)slotSize + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+    if (stride * slotCount > kMaxBytes) {
+        return "arena larger than " + std::to_string(kMaxBytes / (1024 * 1024)) + " MB";
+    }
+    return std::string();
+}
+
+UDPTxArena::UDPTxArena(uint32_t slotSize, uint32_t slotCount)
+    : slotSize_(slotSize),
+      slotCount_(slotCount),
+      stride_((slotSize + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment),
+      data_(new uint8_t[(size_t)stride_ * slotCount]),
+      states_(new std::atomic<uint32_t>[slotCount]),
+      next_(new std::atomic<uint32_t>[slotCount]) {
+    memset(data_.get(), 0, byteLength());
+    for (uint32_t i = 0; i < slotCount_; i++) {
+        states_[i].store(word(1, Free), std::memory_order_relaxed);
+        next_[i].store(i + 1 < slotCount_ ? i + 1 : kNil, std::memory_order_relaxed);
+    }
+    head_.store(0, std::memory_order_relaxed);
+}
+
+bool UDPTxArena::pop(uint32_t& slot) {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    for (;;) {
+        uint32_t top = (uint32_t)head;
+        if (top == kNil) {
+            return false;
+        }
+        uint32_t next = next_[top].load(std::memory_order_relaxed);
+        uint64_t replacement = (((head >> 32) + 1) << 32) | next;
+        if (head_.compare_exchange_weak(head, replacement, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            slot = top;
+            return true;
+        }
+    }
+}
+
+void UDPTxArena::push(uint32_t slot) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    for (;;) {
+        next_[slot].store((uint32_t)head, std::memory_order_relaxed);
+        uint64_t replacement = (((head >> 32) + 1) << 32) | slot;
+        if (head_.compare_exchange_weak(head, replacement, std::memory_order_release, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+uint32_t UDPTxArena::acquire() {
+    uint32_t slot;
+    if (!pop(slot)) {
+        bump(exhausted_);
+        return kInvalidSlot;
+    }
+    // Off the free list the slot is ours, so no other thread races this store
+    uint32_t current = states_[slot].load(std::memory_order_relaxed);
+    states_[slot].store(word(current >> kStateBits, Writing), std::memory_order_relaxed);
+    bump(acquired_);
+    return slot;
+}
+
+uint32_t UDPTxArena::submit(uint32_t slot, size_t length) {
+    if (slot >= slotCount_ || length > slotSize_) {
+        return 0;
+    }
+    // Only this thread moves a slot out of Writing, so a plain store publishes the hand-over
+    uint32_t current = states_[slot].load(std::memory_order_relaxed);
+    if ((current & kStateMask) != Writing) {
+        return 0;
+    }
+    uint32_t ticket = word(current >> kStateBits, InFlight);
+    states_[slot].store(ticket, std::memory_order_release);
+    bump(submitted_);
+    uint32_t inFlight = (uint32_t)(submitted_.load(std::memory_order_relaxed) - completed_.load(std::memory_order_relaxed));
+    if (inFlight > highWaterInFlight_.load(std::memory_order_relaxed)) {
+        highWaterInFlight_.store(inFlight, std::memory_order_relaxed);
+    }
+    return ticket;
+}
+
+bool UDPTxArena::complete(uint32_t slot, uint32_t ticket) {
+    if (slot >= slotCount_ || (ticket & kStateMask) != InFlight) {
+        return false;
+    }
+    uint32_t expected = ticket;
+    if (!states_[slot].compare_exchange_strong(expected, nextFree(ticket), std::memory_order_acq_rel)) {
+        return false;
+    }
+    completed_.fetch_add(1, std::memory_order_relaxed);
+    push(slot);
+    return true;
+}
+
+bool UDPTxArena::release(uint32_t slot) {
+    if (slot >= slotCount_) {
+        return false;
+    }
+    uint32_t current = states_[slot].load(std::memory_order_relaxed);
+    if ((current & kStateMask) != Writing) {
+        return false;
+    }
+    states_[slot].store(nextFree(current), std::memory_order_relaxed);
+    bump(released_);
+    push(slot);
+    return true;
+}
+
+UDPTxArenaStats UDPTxArena::stats() const {
+    UDPTxArenaStats stats;
+    stats.slotSize = slotSize_;
+    stats.slotCount = slotCount_;
+    // Read in the order the counters advance for a slot, so neither difference can go negative
+    stats.completed = completed_.load(std::memory_order_relaxed);
+    stats.submitted = submitted_.load(std::memory_order_relaxed);
+    uint64_t released = released_.load(std::memory_order_relaxed);
+    stats.acquired = acquired_.load(std::memory_order_relaxed);
+    stats.inFlight = (uint32_t)(stats.submitted - stats.completed);
+    stats.writing = (uint32_t)(stats.acquired - stats.submitted - released);
+    stats.highWaterInFlight = highWaterInFlight_.load(std::memory_order_relaxed);
+    stats.exhausted = exhausted_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace udpdirect
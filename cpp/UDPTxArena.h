@@ -0,0 +1,137 @@
+#pragma once
+
+// UDPTxArena - one contiguous send buffer shared with JS and cut into fixed
+// slots. JS writes a datagram straight into a slot and submits it; the slot
+// is recycled once the kernel has the bytes, so sending from it needs no copy
+// and no allocation. Portable C++17, no Objective-C or JSI dependencies.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace udpdirect {
+
+struct UDPTxArenaStats {
+    uint32_t slotSize = 0;
+    uint32_t slotCount = 0;
+    uint32_t writing = 0;   // acquired by JS, not submitted yet
+    uint32_t inFlight = 0;  // submitted, waiting for the send to complete
+    uint32_t highWaterInFlight = 0;
+    uint64_t acquired = 0;
+    uint64_t exhausted = 0;  // acquire() found no free slot
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+};
+
+/**
+ * UDPTxArena
+ *
+ * Every slot is Free, Writing (owned by JS) or InFlight (owned by the send
+ * path). Each slot carries a generation that moves on whenever it becomes
+ * Free, and submit() hands out the InFlight state word as a ticket. complete()
+ * only acts on a matching ticket, so a send path that may report completion
+ * twice (the delegate callback and the buffer's deallocator) recycles the
+ * slot exactly once.
+ *
+ * The free list is a lock-free tagged stack as in UDPBufferPool: slots are
+ * acquired on the JS thread and completed on whichever queue sees the send
+ * finish. acquire(), submit() and release() must all be called from one
+ * thread; complete() and stats() from any.
+ */
+class UDPTxArena {
+public:
+    static constexpr uint32_t kInvalidSlot = UINT32_MAX;
+    static constexpr uint32_t kMaxSlotSize = 65507;
+    static constexpr size_t kMaxBytes = 64 * 1024 * 1024;
+    static constexpr uint32_t kSlotAlignment = 64;
+
+    /**
+     * Check the geometry before constructing an arena from it.
+     *
+     * @return Empty string if valid, otherwise what is wrong
+     */
+    static std::string validate(uint32_t slotSize, uint32_t slotCount);
+
+    UDPTxArena(uint32_t slotSize, uint32_t slotCount);
+
+    UDPTxArena(const UDPTxArena&) = delete;
+    UDPTxArena& operator=(const UDPTxArena&) = delete;
+
+    uint8_t* data() const { return data_.get(); }
+    size_t byteLength() const { return (size_t)stride_ * slotCount_; }
+    uint32_t slotSize() const { return slotSize_; }
+    uint32_t slotCount() const { return slotCount_; }
+
+    // Distance between slots: slotSize rounded up to kSlotAlignment
+    uint32_t slotStride() const { return stride_; }
+    uint8_t* slotData(uint32_t slot) const { return data_.get() + (size_t)slot * stride_; }
+
+    /**
+     * Take a free slot for writing.
+     *
+     * @return Slot index, or kInvalidSlot if every slot is taken
+     */
+    uint32_t acquire();
+
+    /**
+     * Hand a slot being written over to the send path.
+     *
+     * @return Ticket for complete(), or 0 if the slot is not being written or
+     *         `length` does not fit
+     */
+    uint32_t submit(uint32_t slot, size_t length);
+
+    /**
+     * Recycle a submitted slot. Safe to call from any thread, and more than
+     * once: only the first call with the slot's current ticket has an effect.
+     *
+     * @return true if this call recycled the slot
+     */
+    bool complete(uint32_t slot, uint32_t ticket);
+
+    /**
+     * Give back a slot that was acquired but will not be sent.
+     *
+     * @return false if the slot is not being written
+     */
+    bool release(uint32_t slot);
+
+    UDPTxArenaStats stats() const;
+
+private:
+    enum State : uint32_t {
+        Free = 0,
+        Writing = 1,
+        InFlight = 2,
+    };
+    static constexpr uint32_t kStateBits = 2;
+    static constexpr uint32_t kStateMask = (1u << kStateBits) - 1;
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    static uint32_t word(uint32_t generation, State state) { return (generation << kStateBits) | state; }
+    static uint32_t nextFree(uint32_t current) { return word((current >> kStateBits) + 1, Free); }
+
+    bool pop(uint32_t& slot);
+    void push(uint32_t slot);
+
+    uint32_t slotSize_;
+    uint32_t slotCount_;
+    uint32_t stride_;
+    std::unique_ptr<uint8_t[]> data_;
+    std::unique_ptr<std::atomic<uint32_t>[]> states_;
+    std::unique_ptr<std::atomic<uint32_t>[]> next_;
+    std::atomic<uint64_t> head_{0};  // (tag << 32) | slot index
+
+    // Written only by the thread that acquires and submits, so plain stores suffice;
+    // writing and in-flight counts are derived from them in stats()
+    std::atomic<uint64_t> acquired_{0};
+    std::atomic<uint64_t> released_{0};
+    std::atomic<uint64_t> exhausted_{0};
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint32_t> highWaterInFlight_{0};
+    std::atomic<uint64_t> completed_{0};  // any thread
+};
+
+} // namespace udpdirect
@@ -24,6 +24,125 @@ private:
         size_t count
     );
     
+    static jsi::Value sendBatch(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value resolveEndpoint(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value releaseEndpoint(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value sendTo(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value sendPaced(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value connectSocket(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value sendConnected(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value createTxArena(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value acquireTxSlot(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value submitTx(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value releaseTxSlot(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value destroyTxArena(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value getTxArenaStats(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value setPollMode(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value poll(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value pollAddress(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value getPollStats(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
     static jsi::Value createUdpSocket(
         jsi::Runtime& runtime,
         const jsi::Value& thisValue,
@@ -38,6 +157,20 @@ private:
         size_t count
     );
     
+    static jsi::Value configureSocket(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value socketAddress(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
     static jsi::Value closeSocket(
         jsi::Runtime& runtime,
         const jsi::Value& thisValue,
@@ -52,6 +185,174 @@ private:
         size_t count
     );
     
+    static jsi::Value setBackpressure(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value setMemoryBudget(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value setSendRate(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value getSchedulerStats(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value setFilter(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value getFilterStats(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value setChecksum(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value stampChecksum(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value getChecksumStats(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value setFraming(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value sendMessage(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value getFramingStats(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value getDroppedPackets(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value setTraceEnabled(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value getStats(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value now(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value getInterfaces(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value refreshInterfaces(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value setInterfaceChangeHandler(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value startCapture(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value stopCapture(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value getCaptureStats(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value replay(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
+    static jsi::Value stopReplay(
+        jsi::Runtime& runtime,
+        const jsi::Value& thisValue,
+        const jsi::Value* arguments,
+        size_t count
+    );
+    
     // Helper to get socket manager
     static void* getSocketManager(jsi::Runtime& runtime);
 };
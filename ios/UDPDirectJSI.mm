@@ -2,20 +2,140 @@
 #import "UDPSocketManager.h"
 #import <React/RCTLog.h>
 #import <jsi/jsi.h>
+#include "UDPAddressInterner.h"
+#include "UDPBatchIO.h"
+#include "UDPBlockCache.h"
+#include "UDPChecksum.h"
+#include "UDPEndpointTable.h"
+#include "UDPFragmenter.h"
+#include "UDPInterfaceMonitor.h"
+#include "UDPMessageBatcher.h"
+#include "UDPPacketFilter.h"
+#include "UDPPacketRing.h"
+#include "UDPPollRing.h"
+#include "UDPReceiveDrain.h"
+#include "UDPSocketAddress.h"
+#include "UDPSocketStats.h"
+#include "UDPLog.h"
+#include "UDPTrace.h"
+#include "UDPTxArena.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <netdb.h>
 #include <unordered_map>
+#include <vector>
 
 namespace facebook {
 namespace react {
 
 using namespace facebook::jsi;
 
+#if UDP_LOG_ENABLED(UDP_LOG_LEVEL_INFO)
+#define UDP_JSI_LOG(fmt, ...) NSLog(@"[UDPDirectJSI] " fmt, ##__VA_ARGS__)
+#else
+#define UDP_JSI_LOG(fmt, ...) do { } while (0)
+#endif
+
 // Global weak references
 static void* g_socketManager = nullptr;
 static std::weak_ptr<CallInvoker> g_jsInvoker;
 static Runtime* g_runtime = nullptr;  // Store runtime pointer for async callbacks
 
+// Receive rings between the manager's receive queues and the JS thread, one per queue so
+// each ring keeps a single producer. A socket always lands in the ring of its queue.
+static const size_t kReceiveRingCapacity = 4096;
+static std::vector<std::shared_ptr<udpdirect::UDPPacketRing>> g_receiveRings;
+static std::shared_ptr<udpdirect::UDPTrace> g_trace;  // The manager's trace ring
+static std::shared_ptr<udpdirect::UDPSocketStats> g_stats;  // The manager's counters and histograms
+
+// Per-socket JS handlers. JS thread only.
+struct SocketHandlers {
+    std::shared_ptr<Function> onMessage;
+    std::shared_ptr<Function> onError;
+    std::shared_ptr<Function> onClose;
+    std::shared_ptr<Function> onMessageBatch;
+    std::shared_ptr<Function> onSent;  // send completions of sockets created with `timestamps`
+    std::vector<std::shared_ptr<Function>> routes;  // targets of packet filter 'route' actions
+};
+static std::unordered_map<uint32_t, SocketHandlers> g_socketHandlers;
+static uint64_t g_socketHandlersVersion = 0;  // bumped on every change so drains re-resolve cached handlers
+
+// Batchers for sockets with an onMessageBatch handler, indexed by receive queue. Each map
+// belongs to its receive queue.
+static std::unordered_map<uint32_t, std::shared_ptr<udpdirect::UDPMessageBatcher>> g_batchers[kUDPMaxReceiveQueues];
+static std::vector<udpdirect::UDPBatchSendItem> g_batchSendItems;  // JS thread only, reused by sendBatch
+
+// Packet filters installed through _udpJSI.setFilter, kept for getFilterStats. JS thread only;
+// the manager holds its own reference for the receive queue.
+static std::unordered_map<uint32_t, std::shared_ptr<udpdirect::UDPPacketFilter>> g_filters;
+
+// Checksum verifiers installed through _udpJSI.setChecksum, for stampChecksum and
+// getChecksumStats. JS thread only; the manager holds its own reference for the receive queue.
+static std::unordered_map<uint32_t, std::shared_ptr<udpdirect::UDPChecksumVerifier>> g_checksums;
+
+// Message framing installed through _udpJSI.setFraming. JS thread only; the manager holds
+// its own reference to the reassembler for the receive queue.
+struct FramingState {
+    size_t maxDatagramSize = 0;
+    std::shared_ptr<udpdirect::UDPReassembler> reassembler;
+    uint64_t messagesSent = 0;
+    uint64_t fragmentsSent = 0;
+};
+static std::unordered_map<uint32_t, FramingState> g_framing;
+static udpdirect::UDPFragmentBatch g_fragmentBatch;  // JS thread only, reused by sendMessage
+static uint32_t g_nextMessageId = 0;
+
+// Endpoints returned by _udpJSI.resolve. JS thread only.
+static const uint32_t kMaxEndpoints = 4096;
+static std::unique_ptr<udpdirect::UDPEndpointTable> g_endpoints;
+
+// TX arenas created through _udpJSI.createTxArena. JS thread only; in-flight sends and the
+// arena's ArrayBuffer hold their own references, so destroying one here is always safe.
+static std::unordered_map<uint32_t, std::shared_ptr<udpdirect::UDPTxArena>> g_txArenas;
+static uint32_t g_nextTxArenaId = 1;
+
+// Property names of message and message batch events, created once per runtime. A reload leaves
+// the old set behind on purpose: its runtime is already gone, so its PropNameIDs cannot be released.
+struct MessageEventProps {
+    PropNameID socketId;
+    PropNameID data;
+    PropNameID address;
+    PropNameID port;
+    PropNameID kernelTime;
+    PropNameID receiveTime;
+    PropNameID count;
+    PropNameID index;
+    PropNameID addresses;
+    PropNameID datagrams;
+};
+static MessageEventProps* g_messageProps = nullptr;
+
+// Sender host strings for message events, keyed by binary address. JS thread only.
+static udpdirect::UDPAddressInterner g_senderHosts;
+
+// Recycled blocks for each datagram's MessageEventHostObject and PooledSlotBuffer, so steady
+// receive traffic does not allocate once the engine has collected the first few thousand events.
+// Sized for either object plus its shared_ptr control block; larger ones bypass the cache.
+static const size_t kEventBlockSize = 192;
+static const size_t kMaxCachedEventBlocks = 2 * kReceiveRingCapacity;
+static const auto g_eventBlocks = std::make_shared<udpdirect::UDPBlockCache>(kEventBlockSize, kMaxCachedEventBlocks);
+
+// Handler installed through _udpJSI.setInterfaceChangeHandler. JS thread only.
+static std::shared_ptr<Function> g_interfaceChangeHandler;
+
+// Poll rings installed through _udpJSI.setPollMode, for poll(). JS thread only; the ring's
+// ArrayBuffer holds its own reference, so dropping one here never frees memory JS can see.
+static std::unordered_map<uint32_t, std::shared_ptr<udpdirect::UDPPollRing>> g_pollRings;
+
+// The same rings indexed by receive queue, for the receive callback. Each map belongs to
+// its receive queue.
+static std::unordered_map<uint32_t, std::shared_ptr<udpdirect::UDPPollRing>> g_pollWriters[kUDPMaxReceiveQueues];
+
 // MutableBuffer implementation for NSData
 class NSDataBuffer : public MutableBuffer {
 public:
@@ -35,13 +155,717 @@ private:
     NSMutableData* data_;
 };
 
+// MutableBuffer over a receive pool slot; the slot goes back to the pool when
+// the ArrayBuffer is collected and this buffer is destroyed.
+class PooledSlotBuffer : public MutableBuffer {
+public:
+    PooledSlotBuffer(std::shared_ptr<udpdirect::UDPBufferPool> pool, udpdirect::UDPBufferSlot slot)
+        : pool_(std::move(pool)), slot_(slot) {}
+
+    ~PooledSlotBuffer() override {
+        pool_->release(slot_);
+    }
+
+    size_t size() const override {
+        return slot_.length;
+    }
+
+    uint8_t* data() override {
+        return slot_.data;
+    }
+
+private:
+    std::shared_ptr<udpdirect::UDPBufferPool> pool_;
+    udpdirect::UDPBufferSlot slot_;
+};
+
+// MutableBuffer over the whole of a TX arena; keeps the arena alive while JS holds it
+class TxArenaBuffer : public MutableBuffer {
+public:
+    explicit TxArenaBuffer(std::shared_ptr<udpdirect::UDPTxArena> arena) : arena_(std::move(arena)) {}
+
+    size_t size() const override {
+        return arena_->byteLength();
+    }
+
+    uint8_t* data() override {
+        return arena_->data();
+    }
+
+private:
+    std::shared_ptr<udpdirect::UDPTxArena> arena_;
+};
+
+// MutableBuffer over the whole of a poll ring, control block included
+class PollRingBuffer : public MutableBuffer {
+public:
+    explicit PollRingBuffer(std::shared_ptr<udpdirect::UDPPollRing> ring) : ring_(std::move(ring)) {}
+
+    size_t size() const override {
+        return ring_->byteLength();
+    }
+
+    uint8_t* data() override {
+        return ring_->data();
+    }
+
+private:
+    std::shared_ptr<udpdirect::UDPPollRing> ring_;
+};
+
+// MutableBuffer over part of a flushed message batch; keeps the batch, and the
+// slots it still holds, alive until the ArrayBuffer is collected.
+class MessageBatchBuffer : public MutableBuffer {
+public:
+    MessageBatchBuffer(std::shared_ptr<udpdirect::UDPMessageBatch> batch, uint8_t* data, size_t size)
+        : batch_(std::move(batch)), data_(data), size_(size) {}
+
+    size_t size() const override {
+        return size_;
+    }
+
+    uint8_t* data() override {
+        return data_;
+    }
+
+private:
+    std::shared_ptr<udpdirect::UDPMessageBatch> batch_;
+    uint8_t* data_;
+    size_t size_;
+};
+
+// MutableBuffer over a reassembled message; the message is freed when the
+// ArrayBuffer is collected.
+class ReassembledMessageBuffer : public MutableBuffer {
+public:
+    explicit ReassembledMessageBuffer(std::shared_ptr<std::vector<uint8_t>> message)
+        : message_(std::move(message)) {}
+
+    size_t size() const override {
+        return message_->size();
+    }
+
+    uint8_t* data() override {
+        return message_->data();
+    }
+
+private:
+    std::shared_ptr<std::vector<uint8_t>> message_;
+};
+
+static double nsToMs(uint64_t ns) {
+    return (double)ns / 1e6;
+}
+
+// Message event passed to onMessage and route handlers. Fields are made only when JS reads
+// them: most handlers look at `data` alone, so the address string is usually never built.
+class MessageEventHostObject : public HostObject {
+public:
+    MessageEventHostObject(uint32_t socketId, std::shared_ptr<MutableBuffer> data,
+                           const udpdirect::UDPSocketAddress& source, uint64_t receivedNs, uint64_t kernelNs)
+        : socketId_(socketId), data_(std::move(data)), source_(source), receivedNs_(receivedNs), kernelNs_(kernelNs) {}
+
+    Value get(Runtime& rt, const PropNameID& name) override {
+        const MessageEventProps& props = *g_messageProps;
+        if (PropNameID::compare(rt, name, props.data)) {
+            // Each read wraps the same bytes; they are freed once the event and every wrapper are collected
+            return ArrayBuffer(rt, data_);
+        }
+        if (PropNameID::compare(rt, name, props.address)) {
+            return String::createFromUtf8(rt, g_senderHosts.host(source_));
+        }
+        if (PropNameID::compare(rt, name, props.port)) {
+            return Value((double)source_.port);
+        }
+        if (PropNameID::compare(rt, name, props.socketId)) {
+            return Value((double)socketId_);
+        }
+        if (kernelNs_ != 0) {
+            // Milliseconds on the _udpJSI.now() clock, so JS can split the latency by stage
+            if (PropNameID::compare(rt, name, props.kernelTime)) {
+                return Value(nsToMs(kernelNs_));
+            }
+            if (PropNameID::compare(rt, name, props.receiveTime)) {
+                return Value(nsToMs(receivedNs_));
+            }
+        }
+        return Value::undefined();
+    }
+
+    std::vector<PropNameID> getPropertyNames(Runtime& rt) override {
+        const MessageEventProps& props = *g_messageProps;
+        std::vector<PropNameID> names;
+        names.reserve(6);
+        names.emplace_back(rt, props.socketId);
+        names.emplace_back(rt, props.data);
+        names.emplace_back(rt, props.address);
+        names.emplace_back(rt, props.port);
+        if (kernelNs_ != 0) {
+            names.emplace_back(rt, props.kernelTime);
+            names.emplace_back(rt, props.receiveTime);
+        }
+        return names;
+    }
+
+private:
+    uint32_t socketId_;
+    std::shared_ptr<MutableBuffer> data_;
+    udpdirect::UDPSocketAddress source_;
+    uint64_t receivedNs_;
+    uint64_t kernelNs_;
+};
+
+// Message batch event passed to onMessageBatch. The datagrams stay in their pool slots until JS
+// reads `data`, which packs them into one buffer and hands the slots back; `datagrams` wraps each
+// slot without a copy. Sender addresses are formatted on first read of `addresses`. JS thread only.
+class MessageBatchHostObject : public HostObject {
+public:
+    explicit MessageBatchHostObject(std::shared_ptr<udpdirect::UDPMessageBatch> batch) : batch_(std::move(batch)) {}
+
+    Value get(Runtime& rt, const PropNameID& name) override {
+        const MessageEventProps& props = *g_messageProps;
+        udpdirect::UDPMessageBatch& batch = *batch_;
+        if (PropNameID::compare(rt, name, props.count)) {
+            return Value((double)batch.count());
+        }
+        if (PropNameID::compare(rt, name, props.index)) {
+            return ArrayBuffer(rt, std::make_shared<MessageBatchBuffer>(
+                batch_, reinterpret_cast<uint8_t*>(batch.index.data()), batch.index.size() * sizeof(uint32_t)));
+        }
+        if (PropNameID::compare(rt, name, props.data)) {
+            batch.pack();
+            // Slot buffers already handed to JS keep pointing at their slots
+            if (!slotsShared_) {
+                batch.releaseSlots();
+            }
+            return ArrayBuffer(rt, std::make_shared<MessageBatchBuffer>(batch_, batch.payload.data(), batch.payload.size()));
+        }
+        if (PropNameID::compare(rt, name, props.datagrams)) {
+            slotsShared_ = !batch.slots.empty();
+            auto datagrams = Array(rt, batch.count());
+            for (size_t i = 0; i < batch.count(); i++) {
+                datagrams.setValueAtIndex(rt, i, ArrayBuffer(rt, std::make_shared<MessageBatchBuffer>(
+                    batch_, const_cast<uint8_t*>(batch.datagram(i)), batch.length(i))));
+            }
+            return datagrams;
+        }
+        if (PropNameID::compare(rt, name, props.addresses)) {
+            auto addresses = Array(rt, batch.sources.size());
+            for (size_t i = 0; i < batch.sources.size(); i++) {
+                addresses.setValueAtIndex(rt, i, String::createFromUtf8(rt, g_senderHosts.host(batch.sources[i])));
+            }
+            return addresses;
+        }
+        return Value::undefined();
+    }
+
+    std::vector<PropNameID> getPropertyNames(Runtime& rt) override {
+        const MessageEventProps& props = *g_messageProps;
+        std::vector<PropNameID> names;
+        names.reserve(5);
+        names.emplace_back(rt, props.count);
+        names.emplace_back(rt, props.data);
+        names.emplace_back(rt, props.index);
+        names.emplace_back(rt, props.addresses);
+        names.emplace_back(rt, props.datagrams);
+        return names;
+    }
+
+private:
+    std::shared_ptr<udpdirect::UDPMessageBatch> batch_;
+    bool slotsShared_ = false;  // `datagrams` was read while the bytes were still in their slots
+};
+
+// Socket ids are numeric handles. Numeric strings are still accepted from older callers.
+static bool isSocketIdValue(const Value& value) {
+    return value.isNumber() || value.isString();
+}
+
+// A byte offset or length from JS: a finite, non-negative integer no larger than `limit`.
+// Casting anything else to size_t could wrap past the bounds checks that follow.
+static bool byteCountFromValue(const Value& value, size_t limit, size_t& out) {
+    if (!value.isNumber()) {
+        return false;
+    }
+    double number = value.asNumber();
+    if (!std::isfinite(number) || number < 0 || number > (double)limit || number != std::floor(number)) {
+        return false;
+    }
+    out = (size_t)number;
+    return true;
+}
+
+static uint32_t socketIdFromValue(Runtime& runtime, const Value& value) {
+    if (value.isNumber()) {
+        return (uint32_t)value.asNumber();
+    }
+    if (value.isString()) {
+        std::string text = value.getString(runtime).utf8(runtime);
+        char* end = nullptr;
+        unsigned long parsed = strtoul(text.c_str(), &end, 10);
+        if (end != text.c_str() && *end == '\0') {
+            return (uint32_t)parsed;
+        }
+    }
+    throw JSError(runtime, "socketId must be a number");
+}
+
+static const udpdirect::UDPEndpoint& endpointFromValue(Runtime& runtime, const Value& value) {
+    const udpdirect::UDPEndpoint* endpoint = nullptr;
+    if (value.isNumber() && g_endpoints) {
+        endpoint = g_endpoints->get((udpdirect::UDPEndpointTable::Handle)value.asNumber());
+    }
+    if (!endpoint) {
+        throw JSError(runtime, "endpoint must be a live handle from _udpJSI.resolve");
+    }
+    return *endpoint;
+}
+
+// Validates (buffer, offset, length) starting at arguments[first]; the pointer is valid for
+// the rest of the host function call.
+static uint8_t* bufferSliceFromArguments(Runtime& runtime, const Value* arguments, size_t first, size_t& length) {
+    if (!arguments[first].isObject() || !arguments[first].asObject(runtime).isArrayBuffer(runtime)) {
+        throw JSError(runtime, "buffer must be an ArrayBuffer");
+    }
+    if (!arguments[first + 1].isNumber() || !arguments[first + 2].isNumber()) {
+        throw JSError(runtime, "offset and length must be numbers");
+    }
+    auto arrayBuffer = arguments[first].asObject(runtime).getArrayBuffer(runtime);
+    size_t bufferSize = arrayBuffer.size(runtime);
+    size_t offset = 0;
+    if (!byteCountFromValue(arguments[first + 1], bufferSize, offset) ||
+        !byteCountFromValue(arguments[first + 2], bufferSize, length)) {
+        throw JSError(runtime, "offset and length must be integers within the buffer");
+    }
+    if (length > bufferSize - offset) {
+        throw JSError(runtime, "offset + length exceeds buffer size");
+    }
+    return arrayBuffer.data(runtime) + offset;
+}
+
+// A JS Promise settled later from native code. Control calls return one of these instead of
+// waiting on the manager's queue.
+struct PendingPromise {
+    Runtime* runtime = nullptr;
+    std::shared_ptr<Function> resolve;
+    std::shared_ptr<Function> reject;
+};
+
+static Value createPromise(Runtime& runtime, std::shared_ptr<PendingPromise>& pending) {
+    pending = std::make_shared<PendingPromise>();
+    pending->runtime = &runtime;
+    auto executor = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "executor"),
+        2,
+        [pending](Runtime& rt, const Value& thisValue, const Value* arguments, size_t count) -> Value {
+            pending->resolve = std::make_shared<Function>(arguments[0].asObject(rt).asFunction(rt));
+            pending->reject = std::make_shared<Function>(arguments[1].asObject(rt).asFunction(rt));
+            return Value::undefined();
+        }
+    );
+    return runtime.global().getPropertyAsFunction(runtime, "Promise").callAsConstructor(runtime, executor);
+}
+
+// Callable from any thread; the settling itself happens on the JS thread. An empty `error`
+// resolves with `result` (undefined if null), anything else rejects with an Error. Promises
+// from a runtime that has since been replaced are left pending.
+static void settlePromise(const std::shared_ptr<PendingPromise>& pending, std::string error,
+                          std::function<Value(Runtime&)> result) {
+    auto jsInvoker = g_jsInvoker.lock();
+    if (!jsInvoker) {
+        return;
+    }
+    jsInvoker->invokeAsync([pending, error = std::move(error), result = std::move(result)]() {
+        if (g_runtime != pending->runtime || !pending->resolve) {
+            return;
+        }
+        Runtime& rt = *pending->runtime;
+        auto resolve = std::move(pending->resolve);
+        auto reject = std::move(pending->reject);
+        try {
+            if (error.empty()) {
+                resolve->call(rt, result ? result(rt) : Value::undefined());
+            } else {
+                reject->call(rt, rt.global().getPropertyAsFunction(rt, "Error").callAsConstructor(rt, String::createFromUtf8(rt, error)));
+            }
+        } catch (const std::exception& e) {
+            NSLog(@"[UDPDirectJSI] Error settling promise: %s", e.what());
+        }
+    });
+}
+
+static std::string errorMessage(const char* what, NSError* error) {
+    std::string message = what;
+    if (error) {
+        message += ": " + std::string([[error localizedDescription] UTF8String]);
+    }
+    return message;
+}
+
+// { address, port, family } from the manager's address dictionary, copied so it can cross threads
+struct SocketAddressInfo {
+    bool valid = false;
+    std::string address;
+    uint16_t port = 0;
+    std::string family;
+
+    explicit SocketAddressInfo(NSDictionary* info) {
+        if (!info) {
+            return;
+        }
+        valid = true;
+        address = [info[@"address"] UTF8String] ?: "";
+        port = [info[@"port"] unsignedShortValue];
+        family = [info[@"family"] UTF8String] ?: "";
+    }
+
+    Value toValue(Runtime& rt) const {
+        if (!valid) {
+            return Value::null();
+        }
+        auto result = Object(rt);
+        result.setProperty(rt, "address", String::createFromUtf8(rt, address));
+        result.setProperty(rt, "port", Value((double)port));
+        result.setProperty(rt, "family", String::createFromUtf8(rt, family));
+        return result;
+    }
+};
+
+// Hands the pending batch to JS with a single invokeAsync. Runs on the socket's receive queue.
+static void flushMessageBatch(const std::shared_ptr<udpdirect::UDPMessageBatcher>& batcher, uint32_t socketId) {
+    if (batcher->empty()) {
+        return;
+    }
+    std::shared_ptr<udpdirect::UDPMessageBatch> batch = batcher->take();
+
+    auto jsInvoker = g_jsInvoker.lock();
+    if (!jsInvoker) {
+        NSLog(@"[UDPDirectJSI] JS invoker no longer available, dropping batch of %zu", batch->count());
+        return;
+    }
+
+    jsInvoker->invokeAsync([socketId, batch]() {
+        auto handlers = g_socketHandlers.find(socketId);
+        if (!g_runtime || handlers == g_socketHandlers.end() || !handlers->second.onMessageBatch) {
+            return;
+        }
+        auto batchHandler = handlers->second.onMessageBatch;
+        if (g_stats && batch->firstReceivedNs != 0) {
+            g_stats->receiveLatency().record(udpdirect::UDPMonotonicNowNs() - batch->firstReceivedNs);
+        }
+        if (g_trace) {
+            UDP_TRACE(*g_trace, Deliver, socketId, batch->payloadBytes);
+        }
+        try {
+            Runtime& rt = *g_runtime;
+            auto event = Object::createFromHostObject(rt, std::make_shared<MessageBatchHostObject>(batch));
+            batchHandler->call(rt, event);
+        } catch (const std::exception& e) {
+            NSLog(@"[UDPDirectJSI] Error in message batch handler: %s", e.what());
+        }
+    });
+}
+
+// Delivers everything queued in the receive ring to each socket's onMessage. Runs on the JS thread.
+static void drainReceiveRing(const std::shared_ptr<udpdirect::UDPPacketRing>& ring) {
+    const auto& pool = ring->pool();
+    udpdirect::UDPDrainReceiveRing(*ring, g_socketHandlers, g_socketHandlersVersion, g_trace.get(),
+        g_stats ? &g_stats->receiveLatency() : nullptr,
+        [](const SocketHandlers& handlers, const udpdirect::UDPPacketDescriptor& descriptor) -> Function* {
+            if (!g_runtime) {
+                return nullptr;
+            }
+            if (descriptor.route == 0) {
+                return handlers.onMessage.get();
+            }
+            return descriptor.route <= handlers.routes.size() ? handlers.routes[descriptor.route - 1].get() : nullptr;
+        },
+        [&pool](Function& messageHandler, const udpdirect::UDPPacketDescriptor& descriptor) {
+            try {
+                Runtime& rt = *g_runtime;
+
+                // The slot now belongs to the event and returns to the pool on GC
+                auto event = Object::createFromHostObject(rt, udpdirect::UDPMakeRecycled<MessageEventHostObject>(
+                    g_eventBlocks, descriptor.socketId,
+                    udpdirect::UDPMakeRecycled<PooledSlotBuffer>(g_eventBlocks, pool, descriptor.slot),
+                    descriptor.source, descriptor.receivedNs, descriptor.kernelNs));
+
+                messageHandler.call(rt, event);
+            } catch (const std::exception& e) {
+                NSLog(@"[UDPDirectJSI] Error in message handler: %s", e.what());
+            }
+        });
+}
+
+// Routes manager callbacks to the per-socket handler table. The blocks are the same for
+// every socket, so installing them again is harmless.
+static void installManagerCallbacks(UDPSocketManager* manager) {
+    auto rings = g_receiveRings;
+    auto pool = [manager receivePool];
+    // Captured rather than read from g_trace, which the JS thread reassigns on reload
+    auto trace = [manager trace];
+    dispatch_queue_t delegateQueue = manager.delegateQueue;
+    std::vector<dispatch_queue_t> receiveQueues;
+    for (NSUInteger i = 0; i < [manager receiveQueueCount]; i++) {
+        receiveQueues.push_back([manager receiveQueueAtIndex:i]);
+    }
+    __weak UDPSocketManager* weakManager = manager;
+
+    // Receive queue: batch the datagram if the socket asked for it, otherwise publish the
+    // descriptor and wake JS only if no drain is pending. The slot is owned by the ring from here on.
+    manager.onSlotReceived = ^(NSNumber* sockId, udpdirect::UDPBufferSlot slot, const udpdirect::UDPSocketAddress& source, uint32_t route, uint64_t kernelTimestampNs) {
+        uint32_t socketId = [sockId unsignedIntValue];
+        NSUInteger queueIndex = [weakManager currentReceiveQueueIndex];
+        if (queueIndex >= rings.size()) {
+            pool->release(slot);
+            return;
+        }
+        auto& batchers = g_batchers[queueIndex];
+
+        // Polling sockets: copy into the shared ring and stop there; JS picks it up on its next poll
+        if (route == 0) {
+            auto writer = g_pollWriters[queueIndex].find(socketId);
+            if (writer != g_pollWriters[queueIndex].end()) {
+                bool written = writer->second->write(slot.data, slot.length, source);
+                if (trace && written) {
+                    UDP_TRACE(*trace, Deliver, socketId, slot.length);
+                } else if (trace) {
+                    UDP_TRACE(*trace, Drop, socketId, slot.length);
+                }
+                pool->release(slot);
+                return;
+            }
+        }
+
+        // Routed datagrams always go to their route handler one by one, never into a batch
+        auto batcherIt = route == 0 ? batchers.find(socketId) : batchers.end();
+        if (batcherIt != batchers.end()) {
+            auto batcher = batcherIt->second;
+            // The batch keeps the slot; JS reads it in place or packs the batch on first access
+            auto result = batcher->append(socketId, slot, source, udpdirect::UDPMonotonicNowNs());
+
+            if (result == udpdirect::UDPMessageBatcher::AppendResult::FlushNow) {
+                flushMessageBatch(batcher, socketId);
+            } else if (result == udpdirect::UDPMessageBatcher::AppendResult::StartTimer) {
+                uint64_t generation = batcher->generation();
+                int64_t delayNs = (int64_t)batcher->config().maxDelayUs * (int64_t)NSEC_PER_USEC;
+                dispatch_after(dispatch_time(DISPATCH_TIME_NOW, delayNs), receiveQueues[queueIndex], ^{
+                    if (batcher->generation() == generation) {
+                        flushMessageBatch(batcher, socketId);
+                    }
+                });
+            }
+            return;
+        }
+
+        udpdirect::UDPPacketDescriptor descriptor;
+        descriptor.slot = slot;
+        descriptor.source = source;
+        descriptor.socketId = socketId;
+        descriptor.receivedNs = udpdirect::UDPMonotonicNowNs();
+        descriptor.kernelNs = kernelTimestampNs;
+        descriptor.route = route;
+        const auto& ring = rings[queueIndex];
+        ring->push(descriptor);
+
+        if (ring->requestWake()) {
+            auto jsInvoker = g_jsInvoker.lock();
+            if (!jsInvoker) {
+                NSLog(@"[UDPDirectJSI] JS invoker no longer available");
+                return;
+            }
+            jsInvoker->invokeAsync([ring]() {
+                drainReceiveRing(ring);
+            });
+        }
+    };
+
+    // Receive queue: a reassembled message is rare next to single datagrams, so it skips the
+    // ring and goes to the JS thread on its own. Batching sockets get it through onMessage too.
+    manager.onMessageReassembled = ^(NSNumber* sockId, std::shared_ptr<std::vector<uint8_t>> message, const udpdirect::UDPSocketAddress& source, uint32_t route) {
+        uint32_t socketId = [sockId unsignedIntValue];
+        auto jsInvoker = g_jsInvoker.lock();
+        if (!jsInvoker) {
+            NSLog(@"[UDPDirectJSI] JS invoker no longer available, dropping %zu byte message", message->size());
+            return;
+        }
+        uint64_t completedNs = udpdirect::UDPMonotonicNowNs();
+        jsInvoker->invokeAsync([socketId, message, source, route, completedNs]() {
+            auto handlers = g_socketHandlers.find(socketId);
+            Function* messageHandler = nullptr;
+            if (handlers != g_socketHandlers.end()) {
+                if (route == 0) {
+                    messageHandler = handlers->second.onMessage.get();
+                } else if (route <= handlers->second.routes.size()) {
+                    messageHandler = handlers->second.routes[route - 1].get();
+                }
+            }
+            if (!g_runtime || !messageHandler) {
+                if (g_trace) {
+                    UDP_TRACE(*g_trace, Drop, socketId, message->size());
+                }
+                return;
+            }
+            if (g_trace) {
+                UDP_TRACE(*g_trace, Deliver, socketId, message->size());
+            }
+            if (g_stats) {
+                g_stats->receiveLatency().record(udpdirect::UDPMonotonicNowNs() - completedNs);
+            }
+            try {
+                Runtime& rt = *g_runtime;
+                auto event = Object::createFromHostObject(rt, std::make_shared<MessageEventHostObject>(
+                    socketId, std::make_shared<ReassembledMessageBuffer>(message), source, completedNs, 0));
+                messageHandler->call(rt, event);
+            } catch (const std::exception& e) {
+                NSLog(@"[UDPDirectJSI] Error in message handler: %s", e.what());
+            }
+        });
+    };
+
+    // Error and close events hop to the JS thread; the handlers are only called there.
+    manager.onSendFailure = ^(NSNumber* sockId, long tag, NSError* error) {
+        uint32_t socketId = [sockId unsignedIntValue];
+        std::string message = [[error localizedDescription] UTF8String];
+        auto jsInvoker = g_jsInvoker.lock();
+        if (!jsInvoker) return;
+        jsInvoker->invokeAsync([socketId, message]() {
+            auto handlers = g_socketHandlers.find(socketId);
+            if (!g_runtime || handlers == g_socketHandlers.end() || !handlers->second.onError) return;
+            auto onError = handlers->second.onError;
+            try {
+                Runtime& rt = *g_runtime;
+                auto event = Object(rt);
+                event.setProperty(rt, "socketId", Value((double)socketId));
+                event.setProperty(rt, "error", String::createFromUtf8(rt, message));
+                onError->call(rt, event);
+            } catch (const std::exception& e) {
+                NSLog(@"[UDPDirectJSI] Error in error handler: %s", e.what());
+            }
+        });
+    };
+
+    manager.onSendCompleted = ^(NSNumber* sockId, long tag, size_t bytes, uint64_t enqueuedNs, uint64_t completedNs) {
+        uint32_t socketId = [sockId unsignedIntValue];
+        auto jsInvoker = g_jsInvoker.lock();
+        if (!jsInvoker) return;
+        jsInvoker->invokeAsync([socketId, bytes, enqueuedNs, completedNs]() {
+            auto handlers = g_socketHandlers.find(socketId);
+            if (!g_runtime || handlers == g_socketHandlers.end() || !handlers->second.onSent) return;
+            auto onSent = handlers->second.onSent;
+            try {
+                Runtime& rt = *g_runtime;
+                auto event = Object(rt);
+                event.setProperty(rt, "socketId", Value((double)socketId));
+                event.setProperty(rt, "bytes", Value((double)bytes));
+                event.setProperty(rt, "queuedTime", Value(nsToMs(enqueuedNs)));
+                event.setProperty(rt, "sentTime", Value(nsToMs(completedNs)));
+                onSent->call(rt, event);
+            } catch (const std::exception& e) {
+                NSLog(@"[UDPDirectJSI] Error in send handler: %s", e.what());
+            }
+        });
+    };
+
+    manager.onSocketClosed = ^(NSNumber* sockId, NSError* _Nullable error) {
+        uint32_t socketId = [sockId unsignedIntValue];
+
+        // Hand over whatever is still batched and drop the batcher on its receive queue. The
+        // socket has already left the manager, so the close event is posted once all are done.
+        dispatch_group_t flushed = dispatch_group_create();
+        for (size_t i = 0; i < receiveQueues.size(); i++) {
+            dispatch_group_async(flushed, receiveQueues[i], ^{
+                auto batcherIt = g_batchers[i].find(socketId);
+                if (batcherIt != g_batchers[i].end()) {
+                    flushMessageBatch(batcherIt->second, socketId);
+                    g_batchers[i].erase(batcherIt);
+                }
+                g_pollWriters[i].erase(socketId);
+            });
+        }
+
+        bool hasError = error != nil;
+        std::string message = error ? [[error localizedDescription] UTF8String] : "";
+        dispatch_group_notify(flushed, delegateQueue, ^{
+            auto jsInvoker = g_jsInvoker.lock();
+            if (!jsInvoker) return;
+            jsInvoker->invokeAsync([socketId, hasError, message]() {
+                // The socket is gone: remove its handlers before calling onClose
+                auto handlers = g_socketHandlers.find(socketId);
+                if (handlers == g_socketHandlers.end()) return;
+                auto onClose = handlers->second.onClose;
+                g_socketHandlers.erase(handlers);
+                g_socketHandlersVersion++;
+                g_filters.erase(socketId);
+                g_checksums.erase(socketId);
+                g_framing.erase(socketId);
+                g_pollRings.erase(socketId);
+                for (const auto& ring : g_receiveRings) {
+                    ring->forgetSocket(socketId);
+                }
+
+                if (!g_runtime || !onClose) return;
+                try {
+                    Runtime& rt = *g_runtime;
+                    auto event = Object(rt);
+                    event.setProperty(rt, "socketId", Value((double)socketId));
+                    if (hasError) {
+                        event.setProperty(rt, "error", String::createFromUtf8(rt, message));
+                    }
+                    onClose->call(rt, event);
+                } catch (const std::exception& e) {
+                    NSLog(@"[UDPDirectJSI] Error in close handler: %s", e.what());
+                }
+            });
+        });
+    };
+}
+
 void UDPDirectJSI::install(Runtime& runtime, void* socketManager, std::shared_ptr<CallInvoker> jsInvoker) {
-    NSLog(@"[UDPDirectJSI] Installing JSI bindings with CallInvoker");
+    UDP_JSI_LOG(@"Installing JSI bindings with CallInvoker");
 
     // Store references
     g_socketManager = socketManager;
     g_jsInvoker = jsInvoker;
     g_runtime = &runtime;  // Store runtime pointer for async callbacks
+    g_socketHandlers.clear();
+    g_socketHandlersVersion++;
+    g_filters.clear();
+    g_checksums.clear();
+    g_framing.clear();
+    g_txArenas.clear();
+    g_pollRings.clear();
+    g_interfaceChangeHandler.reset();
+    g_messageProps = new MessageEventProps{
+        PropNameID::forAscii(runtime, "socketId"),
+        PropNameID::forAscii(runtime, "data"),
+        PropNameID::forAscii(runtime, "address"),
+        PropNameID::forAscii(runtime, "port"),
+        PropNameID::forAscii(runtime, "kernelTime"),
+        PropNameID::forAscii(runtime, "receiveTime"),
+        PropNameID::forAscii(runtime, "count"),
+        PropNameID::forAscii(runtime, "index"),
+        PropNameID::forAscii(runtime, "addresses"),
+        PropNameID::forAscii(runtime, "datagrams"),
+    };
+    // Seeded from the clock so endpoint handles kept across a reload stay dead
+    uint16_t endpointSeed = (uint16_t)((uint64_t)([[NSDate date] timeIntervalSince1970] * 1000) % 0xFFFF) + 1;
+    g_endpoints = std::make_unique<udpdirect::UDPEndpointTable>(kMaxEndpoints, endpointSeed);
+    // Likewise for message ids, so a peer still holding fragments from before a reload does not
+    // complete them with ours
+    g_nextMessageId = (uint32_t)udpdirect::UDPMonotonicNowNs();
+    
+    UDPSocketManager *manager = (__bridge UDPSocketManager *)socketManager;
+    g_receiveRings.clear();
+    for (NSUInteger i = 0; i < [manager receiveQueueCount]; i++) {
+        g_receiveRings.push_back(std::make_shared<udpdirect::UDPPacketRing>([manager receivePool], kReceiveRingCapacity));
+        dispatch_async([manager receiveQueueAtIndex:i], ^{
+            g_batchers[i].clear();
+        });
+    }
+    g_trace = [manager trace];
+    g_stats = [manager stats];
     
     // Install udpSendDirect function
     auto udpSendDirectFunc = Function::createFromHostFunction(
@@ -64,117 +888,1852 @@ void UDPDirectJSI::install(Runtime& runtime, void* socketManager, std::shared_pt
     );
     udpNamespace.setProperty(runtime, "createSocket", std::move(createSocketFunc));
     
-    // Bind socket function
-    auto bindSocketFunc = Function::createFromHostFunction(
+    // Batched send: one ArrayBuffer, many datagrams
+    auto sendBatchFunc = Function::createFromHostFunction(
         runtime,
-        PropNameID::forAscii(runtime, "bind"),
-        3, // socketId, port, address
-        UDPDirectJSI::bindSocket
+        PropNameID::forAscii(runtime, "sendBatch"),
+        3, // socketId, buffer, packets
+        UDPDirectJSI::sendBatch
     );
-    udpNamespace.setProperty(runtime, "bind", std::move(bindSocketFunc));
+    udpNamespace.setProperty(runtime, "sendBatch", std::move(sendBatchFunc));
     
-    // Close socket function
-    auto closeSocketFunc = Function::createFromHostFunction(
+    // Pre-resolved destinations
+    auto resolveFunc = Function::createFromHostFunction(
         runtime,
-        PropNameID::forAscii(runtime, "close"),
-        1, // socketId
-        UDPDirectJSI::closeSocket
+        PropNameID::forAscii(runtime, "resolve"),
+        2, // address, port
+        UDPDirectJSI::resolveEndpoint
     );
-    udpNamespace.setProperty(runtime, "close", std::move(closeSocketFunc));
+    udpNamespace.setProperty(runtime, "resolve", std::move(resolveFunc));
     
-    // Set event handler function
-    auto setEventHandlerFunc = Function::createFromHostFunction(
+    auto releaseEndpointFunc = Function::createFromHostFunction(
         runtime,
-        PropNameID::forAscii(runtime, "setEventHandler"),
-        2, // socketId, handler
-        UDPDirectJSI::setEventHandler
+        PropNameID::forAscii(runtime, "releaseEndpoint"),
+        1, // endpoint
+        UDPDirectJSI::releaseEndpoint
     );
-    udpNamespace.setProperty(runtime, "setEventHandler", std::move(setEventHandlerFunc));
+    udpNamespace.setProperty(runtime, "releaseEndpoint", std::move(releaseEndpointFunc));
     
-    // Install UDP namespace globally
-    runtime.global().setProperty(runtime, "_udpJSI", std::move(udpNamespace));
+    auto sendToFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "sendTo"),
+        5, // socketId, buffer, offset, length, endpoint
+        UDPDirectJSI::sendTo
+    );
+    udpNamespace.setProperty(runtime, "sendTo", std::move(sendToFunc));
     
-    NSLog(@"[UDPDirectJSI] JSI bindings installed successfully");
-}
-
-void* UDPDirectJSI::getSocketManager(Runtime& runtime) {
-    if (!g_socketManager) {
-        throw JSError(runtime, "UDP socket manager not initialized");
+    // Paced sends through the native send scheduler
+    auto sendPacedFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "sendPaced"),
+        6, // socketId, buffer, offset, length, endpoint, priority
+        UDPDirectJSI::sendPaced
+    );
+    udpNamespace.setProperty(runtime, "sendPaced", std::move(sendPacedFunc));
+    
+    auto setSendRateFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "setSendRate"),
+        2, // socketId, { bytesPerSecond, packetsPerSecond, burstBytes, burstPackets, perDestination }
+        UDPDirectJSI::setSendRate
+    );
+    udpNamespace.setProperty(runtime, "setSendRate", std::move(setSendRateFunc));
+    
+    auto getSchedulerStatsFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "getSchedulerStats"),
+        0,
+        UDPDirectJSI::getSchedulerStats
+    );
+    udpNamespace.setProperty(runtime, "getSchedulerStats", std::move(getSchedulerStatsFunc));
+    
+    // TX arena: JS builds datagrams in place in native slots and submits them without a copy
+    auto createTxArenaFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "createTxArena"),
+        2, // slotSize, slotCount
+        UDPDirectJSI::createTxArena
+    );
+    udpNamespace.setProperty(runtime, "createTxArena", std::move(createTxArenaFunc));
+    
+    auto acquireTxSlotFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "acquireTxSlot"),
+        1, // arena
+        UDPDirectJSI::acquireTxSlot
+    );
+    udpNamespace.setProperty(runtime, "acquireTxSlot", std::move(acquireTxSlotFunc));
+    
+    auto submitTxFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "submitTx"),
+        5, // socketId, arena, slot, length, endpoint
+        UDPDirectJSI::submitTx
+    );
+    udpNamespace.setProperty(runtime, "submitTx", std::move(submitTxFunc));
+    
+    auto releaseTxSlotFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "releaseTxSlot"),
+        2, // arena, slot
+        UDPDirectJSI::releaseTxSlot
+    );
+    udpNamespace.setProperty(runtime, "releaseTxSlot", std::move(releaseTxSlotFunc));
+    
+    auto destroyTxArenaFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "destroyTxArena"),
+        1, // arena
+        UDPDirectJSI::destroyTxArena
+    );
+    udpNamespace.setProperty(runtime, "destroyTxArena", std::move(destroyTxArenaFunc));
+    
+    auto getTxArenaStatsFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "getTxArenaStats"),
+        1, // arena
+        UDPDirectJSI::getTxArenaStats
+    );
+    udpNamespace.setProperty(runtime, "getTxArenaStats", std::move(getTxArenaStatsFunc));
+    
+    // Polling receive: datagrams land in a shared ring that JS reads from its own loop
+    auto setPollModeFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "setPollMode"),
+        2, // socketId, options or null
+        UDPDirectJSI::setPollMode
+    );
+    udpNamespace.setProperty(runtime, "setPollMode", std::move(setPollModeFunc));
+    
+    auto pollFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "poll"),
+        1, // socketId
+        UDPDirectJSI::poll
+    );
+    udpNamespace.setProperty(runtime, "poll", std::move(pollFunc));
+    
+    auto pollAddressFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "pollAddress"),
+        2, // socketId, addressIndex
+        UDPDirectJSI::pollAddress
+    );
+    udpNamespace.setProperty(runtime, "pollAddress", std::move(pollAddressFunc));
+    
+    auto getPollStatsFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "getPollStats"),
+        1, // socketId
+        UDPDirectJSI::getPollStats
+    );
+    udpNamespace.setProperty(runtime, "getPollStats", std::move(getPollStatsFunc));
+    
+    // Connected-socket mode
+    auto connectFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "connect"),
+        2, // socketId, endpoint
+        UDPDirectJSI::connectSocket
+    );
+    udpNamespace.setProperty(runtime, "connect", std::move(connectFunc));
+    
+    auto sendFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "send"),
+        4, // socketId, buffer, offset, length
+        UDPDirectJSI::sendConnected
+    );
+    udpNamespace.setProperty(runtime, "send", std::move(sendFunc));
+    
+    // Bind socket function
+    auto bindSocketFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "bind"),
+        3, // socketId, port, address
+        UDPDirectJSI::bindSocket
+    );
+    udpNamespace.setProperty(runtime, "bind", std::move(bindSocketFunc));
+    
+    // Batched socket options and address lookup; both return Promises
+    auto configureFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "configure"),
+        2, // socketId, options
+        UDPDirectJSI::configureSocket
+    );
+    udpNamespace.setProperty(runtime, "configure", std::move(configureFunc));
+    
+    auto addressFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "address"),
+        1, // socketId
+        UDPDirectJSI::socketAddress
+    );
+    udpNamespace.setProperty(runtime, "address", std::move(addressFunc));
+    
+    // Close socket function
+    auto closeSocketFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "close"),
+        1, // socketId
+        UDPDirectJSI::closeSocket
+    );
+    udpNamespace.setProperty(runtime, "close", std::move(closeSocketFunc));
+    
+    // Set event handler function
+    auto setEventHandlerFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "setEventHandler"),
+        2, // socketId, handler
+        UDPDirectJSI::setEventHandler
+    );
+    udpNamespace.setProperty(runtime, "setEventHandler", std::move(setEventHandlerFunc));
+    
+    // Backpressure policy for the receive ring
+    auto setBackpressureFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "setBackpressure"),
+        1, // { policy, blockTimeoutUs }
+        UDPDirectJSI::setBackpressure
+    );
+    udpNamespace.setProperty(runtime, "setBackpressure", std::move(setBackpressureFunc));
+    
+    // Byte budget for received data held in pool slots
+    auto setMemoryBudgetFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "setMemoryBudget"),
+        1, // { bytes, overflow }
+        UDPDirectJSI::setMemoryBudget
+    );
+    udpNamespace.setProperty(runtime, "setMemoryBudget", std::move(setMemoryBudgetFunc));
+    
+    // Native packet classification ahead of delivery
+    auto setFilterFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "setFilter"),
+        2, // socketId, { rules, defaultAction, defaultRoute } | null
+        UDPDirectJSI::setFilter
+    );
+    udpNamespace.setProperty(runtime, "setFilter", std::move(setFilterFunc));
+    
+    auto getFilterStatsFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "getFilterStats"),
+        1, // socketId
+        UDPDirectJSI::getFilterStats
+    );
+    udpNamespace.setProperty(runtime, "getFilterStats", std::move(getFilterStatsFunc));
+    
+    // Native checksum trailers: verified on receive, stamped in place before send
+    auto setChecksumFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "setChecksum"),
+        2, // socketId, { kind, offset, byteOrder, seed, strip, onFailure, route } | null
+        UDPDirectJSI::setChecksum
+    );
+    udpNamespace.setProperty(runtime, "setChecksum", std::move(setChecksumFunc));
+    
+    auto stampChecksumFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "stampChecksum"),
+        4, // socketId, buffer, offset, length
+        UDPDirectJSI::stampChecksum
+    );
+    udpNamespace.setProperty(runtime, "stampChecksum", std::move(stampChecksumFunc));
+    
+    auto getChecksumStatsFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "getChecksumStats"),
+        1, // socketId
+        UDPDirectJSI::getChecksumStats
+    );
+    udpNamespace.setProperty(runtime, "getChecksumStats", std::move(getChecksumStatsFunc));
+    
+    // Native fragmentation and reassembly of messages larger than one datagram
+    auto setFramingFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "setFraming"),
+        2, // socketId, { maxDatagramSize, maxMessageSize, maxPendingMessages, maxPendingBytes, timeoutMs } | null
+        UDPDirectJSI::setFraming
+    );
+    udpNamespace.setProperty(runtime, "setFraming", std::move(setFramingFunc));
+    
+    auto sendMessageFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "sendMessage"),
+        5, // socketId, buffer, offset, length, endpoint
+        UDPDirectJSI::sendMessage
+    );
+    udpNamespace.setProperty(runtime, "sendMessage", std::move(sendMessageFunc));
+    
+    auto getFramingStatsFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "getFramingStats"),
+        1, // socketId
+        UDPDirectJSI::getFramingStats
+    );
+    udpNamespace.setProperty(runtime, "getFramingStats", std::move(getFramingStatsFunc));
+    
+    // Per-socket receive drop counter
+    auto getDroppedPacketsFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "getDroppedPackets"),
+        1, // socketId
+        UDPDirectJSI::getDroppedPackets
+    );
+    udpNamespace.setProperty(runtime, "getDroppedPackets", std::move(getDroppedPacketsFunc));
+    
+    // Per-packet trace ring, dumped through the manager diagnostics
+    auto setTraceEnabledFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "setTraceEnabled"),
+        1, // enabled
+        UDPDirectJSI::setTraceEnabled
+    );
+    udpNamespace.setProperty(runtime, "setTraceEnabled", std::move(setTraceEnabledFunc));
+    
+    // Counters and latency percentiles as a Float64Array
+    auto getStatsFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "getStats"),
+        2, // socketId, out
+        UDPDirectJSI::getStats
+    );
+    udpNamespace.setProperty(runtime, "getStats", std::move(getStatsFunc));
+    
+    // Clock of the receive and send timestamps, in milliseconds
+    auto nowFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "now"),
+        0,
+        UDPDirectJSI::now
+    );
+    udpNamespace.setProperty(runtime, "now", std::move(nowFunc));
+    
+    // Cached network interface table and its change notifications
+    auto getInterfacesFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "getInterfaces"),
+        1, // sinceVersion?
+        UDPDirectJSI::getInterfaces
+    );
+    udpNamespace.setProperty(runtime, "getInterfaces", std::move(getInterfacesFunc));
+    
+    auto refreshInterfacesFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "refreshInterfaces"),
+        0,
+        UDPDirectJSI::refreshInterfaces
+    );
+    udpNamespace.setProperty(runtime, "refreshInterfaces", std::move(refreshInterfacesFunc));
+    
+    auto setInterfaceChangeHandlerFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "setInterfaceChangeHandler"),
+        1, // handler | null
+        UDPDirectJSI::setInterfaceChangeHandler
+    );
+    udpNamespace.setProperty(runtime, "setInterfaceChangeHandler", std::move(setInterfaceChangeHandlerFunc));
+    
+    // pcapng capture of received and sent datagrams, and replay of captures into a socket
+    auto startCaptureFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "startCapture"),
+        2, // path, { snapLength, ringBytes }?
+        UDPDirectJSI::startCapture
+    );
+    udpNamespace.setProperty(runtime, "startCapture", std::move(startCaptureFunc));
+    
+    auto stopCaptureFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "stopCapture"),
+        0,
+        UDPDirectJSI::stopCapture
+    );
+    udpNamespace.setProperty(runtime, "stopCapture", std::move(stopCaptureFunc));
+    
+    auto getCaptureStatsFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "getCaptureStats"),
+        0,
+        UDPDirectJSI::getCaptureStats
+    );
+    udpNamespace.setProperty(runtime, "getCaptureStats", std::move(getCaptureStatsFunc));
+    
+    auto replayFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "replay"),
+        3, // socketId, path, { speed, recordedSocketId }?
+        UDPDirectJSI::replay
+    );
+    udpNamespace.setProperty(runtime, "replay", std::move(replayFunc));
+    
+    auto stopReplayFunc = Function::createFromHostFunction(
+        runtime,
+        PropNameID::forAscii(runtime, "stopReplay"),
+        1, // socketId
+        UDPDirectJSI::stopReplay
+    );
+    udpNamespace.setProperty(runtime, "stopReplay", std::move(stopReplayFunc));
+    
+    // Install UDP namespace globally
+    runtime.global().setProperty(runtime, "_udpJSI", std::move(udpNamespace));
+    
+    UDP_JSI_LOG(@"JSI bindings installed successfully");
+}
+
+void* UDPDirectJSI::getSocketManager(Runtime& runtime) {
+    if (!g_socketManager) {
+        throw JSError(runtime, "UDP socket manager not initialized");
+    }
+    return g_socketManager;
+}
+
+Value UDPDirectJSI::udpSendDirect(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 6) {
+        throw JSError(runtime, "udpSendDirect expects 6 arguments: socketId, buffer, offset, length, port, address");
+    }
+    
+    @try {
+        // Extract arguments
+        NSNumber *socketId = @(socketIdFromValue(runtime, arguments[0]));
+        
+        // Handle ArrayBuffer
+        if (!arguments[1].isObject()) {
+            throw JSError(runtime, "buffer must be an ArrayBuffer");
+        }
+        
+        auto bufferObj = arguments[1].asObject(runtime);
+        if (!bufferObj.isArrayBuffer(runtime)) {
+            throw JSError(runtime, "buffer must be an ArrayBuffer");
+        }
+        
+        auto arrayBuffer = bufferObj.getArrayBuffer(runtime);
+        
+        // Extract offset and length
+        if (!arguments[2].isNumber()) {
+            throw JSError(runtime, "offset must be a number");
+        }
+        size_t offset = (size_t)arguments[2].asNumber();
+        
+        if (!arguments[3].isNumber()) {
+            throw JSError(runtime, "length must be a number");
+        }
+        size_t length = (size_t)arguments[3].asNumber();
+        
+        // Validate offset and length
+        if (offset + length > arrayBuffer.size(runtime)) {
+            throw JSError(runtime, "offset + length exceeds buffer size");
+        }
+        
+        uint8_t* dataPtr = arrayBuffer.data(runtime) + offset;
+        
+        // Extract port and address
+        if (!arguments[4].isNumber()) {
+            throw JSError(runtime, "port must be a number");
+        }
+        uint16_t port = (uint16_t)arguments[4].asNumber();
+        
+        if (!arguments[5].isString()) {
+            throw JSError(runtime, "address must be a string");
+        }
+        std::string addressStr = arguments[5].getString(runtime).utf8(runtime);
+        
+        UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+        long tag = [manager nextSendTag];
+        
+        // Fast path: sendto straight out of the ArrayBuffer on this thread. The
+        // buffer cannot be collected while we are inside this call, so no copy
+        // and no retention are needed.
+        udpdirect::UDPSocketAddress destination;
+        if (udpdirect::UDPSocketAddress::fromNumericHost(addressStr.c_str(), port, destination)) {
+            UDPImmediateSendResult result = [manager sendBytesImmediately:dataPtr length:length onSocket:socketId toAddress:destination tag:tag];
+            if (result == UDPImmediateSendSent) {
+                return Value(true);
+            }
+            if (result == UDPImmediateSendFailed) {
+                return Value(false);
+            }
+        }
+        
+        // Slow path (hostname, socket not bound yet, would block, broadcast not yet
+        // enabled): sendData dispatches async, so the payload must be copied
+        // before the ArrayBuffer can be collected.
+        NSData *data = [NSData dataWithBytes:dataPtr length:length];
+        NSString *address = [NSString stringWithUTF8String:addressStr.c_str()];
+        [manager sendData:data onSocket:socketId toHost:address port:port tag:tag];
+        
+        return Value(false);
+        
+    } @catch (NSException *exception) {
+        std::string error = "Native exception: " + std::string([exception.reason UTF8String]);
+        throw JSError(runtime, error);
+    }
+}
+
+Value UDPDirectJSI::sendBatch(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 3 || !isSocketIdValue(arguments[0]) || !arguments[1].isObject() || !arguments[2].isObject()) {
+        throw JSError(runtime, "sendBatch expects 3 arguments: socketId, buffer, packets");
+    }
+    
+    @try {
+        NSNumber *socketId = @(socketIdFromValue(runtime, arguments[0]));
+        
+        auto bufferObj = arguments[1].asObject(runtime);
+        if (!bufferObj.isArrayBuffer(runtime)) {
+            throw JSError(runtime, "buffer must be an ArrayBuffer");
+        }
+        auto arrayBuffer = bufferObj.getArrayBuffer(runtime);
+        uint8_t* base = arrayBuffer.data(runtime);
+        size_t bufferSize = arrayBuffer.size(runtime);
+        
+        auto packetsObj = arguments[2].asObject(runtime);
+        if (!packetsObj.isArray(runtime)) {
+            throw JSError(runtime, "packets must be an array of { offset, length, port, address }");
+        }
+        auto packets = packetsObj.asArray(runtime);
+        size_t packetCount = packets.size(runtime);
+        
+        // Validate everything before sending anything
+        struct PacketRange {
+            size_t offset;
+            size_t length;
+            uint16_t port;
+            const udpdirect::UDPEndpoint* endpoint;  // set when the packet names an endpoint handle
+        };
+        std::vector<PacketRange> ranges(packetCount);
+        for (size_t i = 0; i < packetCount; i++) {
+            auto packet = packets.getValueAtIndex(runtime, i).asObject(runtime);
+            ranges[i] = {0, 0, 0, nullptr};
+            if (!byteCountFromValue(packet.getProperty(runtime, "offset"), bufferSize, ranges[i].offset) ||
+                !byteCountFromValue(packet.getProperty(runtime, "length"), bufferSize, ranges[i].length)) {
+                throw JSError(runtime, "each packet needs an integer offset and length within the buffer");
+            }
+            auto endpoint = packet.getProperty(runtime, "endpoint");
+            if (!endpoint.isUndefined()) {
+                ranges[i].endpoint = &endpointFromValue(runtime, endpoint);
+            } else {
+                auto port = packet.getProperty(runtime, "port");
+                if (!port.isNumber() || !packet.getProperty(runtime, "address").isString()) {
+                    throw JSError(runtime, "each packet needs an endpoint, or a numeric port and a string address");
+                }
+                ranges[i].port = (uint16_t)port.asNumber();
+            }
+            if (ranges[i].length > bufferSize - ranges[i].offset) {
+                throw JSError(runtime, "packet offset + length exceeds buffer size");
+            }
+        }
+        
+        auto addressAt = [&](size_t i) {
+            return packets.getValueAtIndex(runtime, i).asObject(runtime).getProperty(runtime, "address").getString(runtime).utf8(runtime);
+        };
+        
+        // The leading run of numeric destinations goes out in as few syscalls as possible
+        g_batchSendItems.clear();
+        for (size_t i = 0; i < packetCount; i++) {
+            udpdirect::UDPBatchSendItem item;
+            if (ranges[i].endpoint) {
+                item.destination = ranges[i].endpoint->address;
+            } else if (!udpdirect::UDPSocketAddress::fromNumericHost(addressAt(i).c_str(), ranges[i].port, item.destination)) {
+                break;
+            }
+            item.data = base + ranges[i].offset;
+            item.length = ranges[i].length;
+            g_batchSendItems.push_back(item);
+        }
+        
+        UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+        size_t sent = 0;
+        if (!g_batchSendItems.empty()) {
+            sent = [manager sendBatchImmediately:g_batchSendItems.data() count:g_batchSendItems.size() onSocket:socketId];
+        }
+        
+        // Whatever the kernel did not take (or could not be sent directly) is copied and queued
+        for (size_t i = sent; i < packetCount; i++) {
+            NSData *data = [NSData dataWithBytes:base + ranges[i].offset length:ranges[i].length];
+            if (ranges[i].endpoint) {
+                [manager sendData:data onSocket:socketId toEndpoint:*ranges[i].endpoint tag:[manager nextSendTag]];
+                continue;
+            }
+            NSString *address = [NSString stringWithUTF8String:addressAt(i).c_str()];
+            [manager sendData:data onSocket:socketId toHost:address port:ranges[i].port tag:[manager nextSendTag]];
+        }
+        
+        return Value((double)sent);
+        
+    } @catch (NSException *exception) {
+        std::string error = "Native exception: " + std::string([exception.reason UTF8String]);
+        throw JSError(runtime, error);
+    }
+}
+
+Value UDPDirectJSI::resolveEndpoint(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 2 || !arguments[0].isString() || !arguments[1].isNumber()) {
+        throw JSError(runtime, "resolve expects 2 arguments: address, port");
+    }
+    std::string address = arguments[0].getString(runtime).utf8(runtime);
+    int error = 0;
+    udpdirect::UDPEndpointTable::Handle handle = g_endpoints->resolve(address.c_str(), (uint16_t)arguments[1].asNumber(), error);
+    if (handle == udpdirect::UDPEndpointTable::kInvalidHandle) {
+        std::string reason = error == ENOSPC ? "too many endpoints" : gai_strerror(error);
+        throw JSError(runtime, "Cannot resolve " + address + ": " + reason);
+    }
+    return Value((double)handle);
+}
+
+Value UDPDirectJSI::releaseEndpoint(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 1 || !arguments[0].isNumber()) {
+        throw JSError(runtime, "releaseEndpoint expects 1 argument: endpoint");
+    }
+    return Value(g_endpoints->release((udpdirect::UDPEndpointTable::Handle)arguments[0].asNumber()));
+}
+
+Value UDPDirectJSI::sendTo(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 5 || !isSocketIdValue(arguments[0])) {
+        throw JSError(runtime, "sendTo expects 5 arguments: socketId, buffer, offset, length, endpoint");
+    }
+    
+    @try {
+        NSNumber *socketId = @(socketIdFromValue(runtime, arguments[0]));
+        size_t length = 0;
+        uint8_t* dataPtr = bufferSliceFromArguments(runtime, arguments, 1, length);
+        const udpdirect::UDPEndpoint& endpoint = endpointFromValue(runtime, arguments[4]);
+        
+        UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+        long tag = [manager nextSendTag];
+        UDPImmediateSendResult result = [manager sendBytesImmediately:dataPtr length:length onSocket:socketId toEndpoint:endpoint tag:tag];
+        if (result != UDPImmediateSendDeferred) {
+            return Value(result == UDPImmediateSendSent);
+        }
+        
+        [manager sendData:[NSData dataWithBytes:dataPtr length:length] onSocket:socketId toEndpoint:endpoint tag:tag];
+        return Value(false);
+        
+    } @catch (NSException *exception) {
+        std::string error = "Native exception: " + std::string([exception.reason UTF8String]);
+        throw JSError(runtime, error);
+    }
+}
+
+Value UDPDirectJSI::sendPaced(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count < 5 || count > 6 || !isSocketIdValue(arguments[0])) {
+        throw JSError(runtime, "sendPaced expects socketId, buffer, offset, length, endpoint and an optional priority");
+    }
+    
+    NSNumber *socketId = @(socketIdFromValue(runtime, arguments[0]));
+    size_t length = 0;
+    uint8_t* dataPtr = bufferSliceFromArguments(runtime, arguments, 1, length);
+    const udpdirect::UDPEndpoint& endpoint = endpointFromValue(runtime, arguments[4]);
+    
+    udpdirect::UDPSendPriority priority = udpdirect::UDPSendPriority::Normal;
+    if (count == 6 && !arguments[5].isUndefined()) {
+        std::string name = arguments[5].isString() ? arguments[5].getString(runtime).utf8(runtime) : "";
+        if (name == "high") {
+            priority = udpdirect::UDPSendPriority::High;
+        } else if (name == "bulk") {
+            priority = udpdirect::UDPSendPriority::Bulk;
+        } else if (name != "normal") {
+            throw JSError(runtime, "priority must be 'high', 'normal' or 'bulk'");
+        }
+    }
+    
+    UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+    long tag = [manager nextSendTag];
+    return Value((bool)[manager schedulePacedSend:dataPtr length:length onSocket:socketId toEndpoint:endpoint priority:priority tag:tag]);
+}
+
+Value UDPDirectJSI::connectSocket(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 2 || !isSocketIdValue(arguments[0])) {
+        throw JSError(runtime, "connect expects 2 arguments: socketId, endpoint");
+    }
+    
+    NSNumber *socketId = @(socketIdFromValue(runtime, arguments[0]));
+    const udpdirect::UDPEndpoint& endpoint = endpointFromValue(runtime, arguments[1]);
+    UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+    std::shared_ptr<PendingPromise> pending;
+    Value promise = createPromise(runtime, pending);
+    [manager connectSocket:socketId toEndpoint:endpoint completion:^(NSError* error) {
+        settlePromise(pending, error ? errorMessage("Failed to connect socket", error) : std::string(), nullptr);
+    }];
+    return promise;
+}
+
+Value UDPDirectJSI::sendConnected(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 4 || !isSocketIdValue(arguments[0])) {
+        throw JSError(runtime, "send expects 4 arguments: socketId, buffer, offset, length");
+    }
+    
+    @try {
+        NSNumber *socketId = @(socketIdFromValue(runtime, arguments[0]));
+        size_t length = 0;
+        uint8_t* dataPtr = bufferSliceFromArguments(runtime, arguments, 1, length);
+        
+        UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+        long tag = [manager nextSendTag];
+        UDPImmediateSendResult result = [manager sendBytesImmediately:dataPtr length:length onConnectedSocket:socketId tag:tag];
+        if (result != UDPImmediateSendDeferred) {
+            return Value(result == UDPImmediateSendSent);
+        }
+        
+        [manager sendData:[NSData dataWithBytes:dataPtr length:length] onConnectedSocket:socketId tag:tag];
+        return Value(false);
+        
+    } @catch (NSException *exception) {
+        std::string error = "Native exception: " + std::string([exception.reason UTF8String]);
+        throw JSError(runtime, error);
+    }
+}
+
+static std::shared_ptr<udpdirect::UDPTxArena> txArenaFromValue(Runtime& runtime, const Value& value) {
+    if (value.isNumber()) {
+        auto found = g_txArenas.find((uint32_t)value.asNumber());
+        if (found != g_txArenas.end()) {
+            return found->second;
+        }
+    }
+    throw JSError(runtime, "Unknown TX arena");
+}
+
+static uint32_t txSlotFromValue(Runtime& runtime, const Value& value, const udpdirect::UDPTxArena& arena) {
+    if (!value.isNumber() || value.asNumber() < 0 || value.asNumber() >= arena.slotCount()) {
+        throw JSError(runtime, "TX slot out of range");
+    }
+    return (uint32_t)value.asNumber();
+}
+
+Value UDPDirectJSI::createTxArena(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 2 || !arguments[0].isNumber() || !arguments[1].isNumber() ||
+        arguments[0].asNumber() < 0 || arguments[1].asNumber() < 0) {
+        throw JSError(runtime, "createTxArena expects 2 arguments: slotSize, slotCount");
+    }
+    uint32_t slotSize = (uint32_t)std::min(arguments[0].asNumber(), (double)UINT32_MAX);
+    uint32_t slotCount = (uint32_t)std::min(arguments[1].asNumber(), (double)UINT32_MAX);
+    std::string invalid = udpdirect::UDPTxArena::validate(slotSize, slotCount);
+    if (!invalid.empty()) {
+        throw JSError(runtime, "createTxArena: " + invalid);
+    }
+
+    auto arena = std::make_shared<udpdirect::UDPTxArena>(slotSize, slotCount);
+    uint32_t arenaId = g_nextTxArenaId++;
+    g_txArenas[arenaId] = arena;
+
+    auto result = Object(runtime);
+    result.setProperty(runtime, "arena", Value((double)arenaId));
+    result.setProperty(runtime, "buffer", ArrayBuffer(runtime, std::make_shared<TxArenaBuffer>(arena)));
+    result.setProperty(runtime, "slotSize", Value((double)arena->slotSize()));
+    result.setProperty(runtime, "slotStride", Value((double)arena->slotStride()));
+    result.setProperty(runtime, "slotCount", Value((double)arena->slotCount()));
+    return result;
+}
+
+Value UDPDirectJSI::acquireTxSlot(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 1) {
+        throw JSError(runtime, "acquireTxSlot expects 1 argument: arena");
+    }
+    uint32_t slot = txArenaFromValue(runtime, arguments[0])->acquire();
+    return Value(slot == udpdirect::UDPTxArena::kInvalidSlot ? -1.0 : (double)slot);
+}
+
+Value UDPDirectJSI::submitTx(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 5 || !isSocketIdValue(arguments[0]) || !arguments[3].isNumber() || arguments[3].asNumber() < 0) {
+        throw JSError(runtime, "submitTx expects 5 arguments: socketId, arena, slot, length, endpoint");
+    }
+
+    @try {
+        NSNumber *socketId = @(socketIdFromValue(runtime, arguments[0]));
+        auto arena = txArenaFromValue(runtime, arguments[1]);
+        uint32_t slot = txSlotFromValue(runtime, arguments[2], *arena);
+        size_t length = (size_t)arguments[3].asNumber();
+        const udpdirect::UDPEndpoint& endpoint = endpointFromValue(runtime, arguments[4]);
+
+        uint32_t ticket = arena->submit(slot, length);
+        if (ticket == 0) {
+            throw JSError(runtime, length > arena->slotSize()
+                ? "submitTx: length exceeds the slot size"
+                : "submitTx: slot is not acquired");
+        }
+
+        UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+        UDPImmediateSendResult result = [manager sendTxSlot:slot ticket:ticket length:length arena:arena onSocket:socketId toEndpoint:endpoint];
+        return Value(result == UDPImmediateSendSent);
+
+    } @catch (NSException *exception) {
+        std::string error = "Native exception: " + std::string([exception.reason UTF8String]);
+        throw JSError(runtime, error);
+    }
+}
+
+Value UDPDirectJSI::releaseTxSlot(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 2) {
+        throw JSError(runtime, "releaseTxSlot expects 2 arguments: arena, slot");
+    }
+    auto arena = txArenaFromValue(runtime, arguments[0]);
+    return Value(arena->release(txSlotFromValue(runtime, arguments[1], *arena)));
+}
+
+Value UDPDirectJSI::destroyTxArena(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 1 || !arguments[0].isNumber()) {
+        throw JSError(runtime, "destroyTxArena expects 1 argument: arena");
+    }
+    return Value(g_txArenas.erase((uint32_t)arguments[0].asNumber()) > 0);
+}
+
+Value UDPDirectJSI::getTxArenaStats(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 1) {
+        throw JSError(runtime, "getTxArenaStats expects 1 argument: arena");
+    }
+    udpdirect::UDPTxArenaStats stats = txArenaFromValue(runtime, arguments[0])->stats();
+
+    auto result = Object(runtime);
+    result.setProperty(runtime, "slotSize", Value((double)stats.slotSize));
+    result.setProperty(runtime, "slotCount", Value((double)stats.slotCount));
+    result.setProperty(runtime, "writing", Value((double)stats.writing));
+    result.setProperty(runtime, "inFlight", Value((double)stats.inFlight));
+    result.setProperty(runtime, "highWaterInFlight", Value((double)stats.highWaterInFlight));
+    result.setProperty(runtime, "acquired", Value((double)stats.acquired));
+    result.setProperty(runtime, "exhausted", Value((double)stats.exhausted));
+    result.setProperty(runtime, "submitted", Value((double)stats.submitted));
+    result.setProperty(runtime, "completed", Value((double)stats.completed));
+    return result;
+}
+
+static uint32_t optionalUint32(Runtime& runtime, const Object& object, const char* name, uint32_t fallback) {
+    auto value = object.getProperty(runtime, name);
+    if (value.isUndefined()) {
+        return fallback;
+    }
+    if (!value.isNumber() || value.asNumber() < 0 || value.asNumber() > UINT32_MAX) {
+        throw JSError(runtime, std::string(name) + " must be a non-negative integer");
+    }
+    return (uint32_t)value.asNumber();
+}
+
+static std::shared_ptr<udpdirect::UDPPollRing> pollRingFromValue(Runtime& runtime, const Value& value) {
+    if (isSocketIdValue(value)) {
+        auto found = g_pollRings.find(socketIdFromValue(runtime, value));
+        if (found != g_pollRings.end()) {
+            return found->second;
+        }
+    }
+    throw JSError(runtime, "Socket is not in poll mode");
+}
+
+Value UDPDirectJSI::setPollMode(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 2 || !isSocketIdValue(arguments[0]) || !(arguments[1].isObject() || arguments[1].isNull() || arguments[1].isUndefined())) {
+        throw JSError(runtime, "setPollMode expects socketId and { capacity, maxPayload, maxAddresses } or null");
+    }
+
+    @try {
+        uint32_t socketId = socketIdFromValue(runtime, arguments[0]);
+        UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+        NSUInteger queueIndex = [manager receiveQueueIndexForSocket:@(socketId)];
+        if (queueIndex == NSNotFound) {
+            throw JSError(runtime, "Socket " + std::to_string(socketId) + " not found");
+        }
+
+        std::shared_ptr<udpdirect::UDPPollRing> ring;
+        if (arguments[1].isObject()) {
+            auto options = arguments[1].asObject(runtime);
+            uint32_t capacity = optionalUint32(runtime, options, "capacity", 1024);
+            uint32_t maxPayload = optionalUint32(runtime, options, "maxPayload", 1472);
+            uint32_t maxAddresses = optionalUint32(runtime, options, "maxAddresses", 1024);
+            std::string invalid = udpdirect::UDPPollRing::validate(capacity, maxPayload);
+            if (!invalid.empty()) {
+                throw JSError(runtime, "setPollMode: " + invalid);
+            }
+            ring = std::make_shared<udpdirect::UDPPollRing>(capacity, maxPayload, maxAddresses);
+            g_pollRings[socketId] = ring;
+        } else {
+            g_pollRings.erase(socketId);
+        }
+
+        // The writer side lives on the socket's receive queue with the receive callback
+        dispatch_async([manager receiveQueueAtIndex:queueIndex], ^{
+            if (ring) {
+                g_pollWriters[queueIndex][socketId] = ring;
+            } else {
+                g_pollWriters[queueIndex].erase(socketId);
+            }
+        });
+        if (!ring) {
+            return Value::undefined();
+        }
+
+        installManagerCallbacks(manager);
+        [manager startReceivingOnBoundSockets];
+
+        auto result = Object(runtime);
+        result.setProperty(runtime, "buffer", ArrayBuffer(runtime, std::make_shared<PollRingBuffer>(ring)));
+        result.setProperty(runtime, "capacity", Value((double)ring->capacity()));
+        result.setProperty(runtime, "entryStride", Value((double)ring->entryStride()));
+        result.setProperty(runtime, "maxPayload", Value((double)ring->maxPayload()));
+        result.setProperty(runtime, "controlSize", Value((double)udpdirect::UDPPollRing::kControlSize));
+        result.setProperty(runtime, "headerSize", Value((double)udpdirect::UDPPollRing::kEntryHeaderSize));
+        return result;
+
+    } @catch (NSException *exception) {
+        std::string error = "Native exception: " + std::string([exception.reason UTF8String]);
+        throw JSError(runtime, error);
+    }
+}
+
+Value UDPDirectJSI::poll(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 1) {
+        throw JSError(runtime, "poll expects 1 argument: socketId");
+    }
+    return Value((double)pollRingFromValue(runtime, arguments[0])->poll());
+}
+
+Value UDPDirectJSI::pollAddress(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 2 || !arguments[1].isNumber()) {
+        throw JSError(runtime, "pollAddress expects 2 arguments: socketId, addressIndex");
+    }
+    auto ring = pollRingFromValue(runtime, arguments[0]);
+    udpdirect::UDPSocketAddress address;
+    if (arguments[1].asNumber() < 0 || !ring->address((uint32_t)arguments[1].asNumber(), address)) {
+        return Value::null();
+    }
+    return String::createFromUtf8(runtime, address.hostString());
+}
+
+Value UDPDirectJSI::getPollStats(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 1) {
+        throw JSError(runtime, "getPollStats expects 1 argument: socketId");
+    }
+    udpdirect::UDPPollRingStats stats = pollRingFromValue(runtime, arguments[0])->stats();
+
+    auto result = Object(runtime);
+    result.setProperty(runtime, "capacity", Value((double)stats.capacity));
+    result.setProperty(runtime, "maxPayload", Value((double)stats.maxPayload));
+    result.setProperty(runtime, "ready", Value((double)stats.ready));
+    result.setProperty(runtime, "written", Value((double)stats.written));
+    result.setProperty(runtime, "overruns", Value((double)stats.overruns));
+    result.setProperty(runtime, "truncated", Value((double)stats.truncated));
+    result.setProperty(runtime, "addresses", Value((double)stats.addresses));
+    result.setProperty(runtime, "addressEvictions", Value((double)stats.addressEvictions));
+    result.setProperty(runtime, "addressOverflow", Value((double)stats.addressOverflow));
+    return result;
+}
+
+Value UDPDirectJSI::createUdpSocket(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 1 || !arguments[0].isObject()) {
+        throw JSError(runtime, "createSocket expects 1 object argument");
+    }
+    
+    @try {
+        auto options = arguments[0].asObject(runtime);
+        NSMutableDictionary *nsOptions = [NSMutableDictionary dictionary];
+        
+        // Extract options
+        if (options.hasProperty(runtime, "type")) {
+            auto type = options.getProperty(runtime, "type").getString(runtime).utf8(runtime);
+            nsOptions[@"type"] = [NSString stringWithUTF8String:type.c_str()];
+        } else {
+            nsOptions[@"type"] = @"udp4"; // Default
+        }
+        
+        if (options.hasProperty(runtime, "reuseAddr")) {
+            nsOptions[@"reuseAddr"] = @(options.getProperty(runtime, "reuseAddr").getBool());
+        }
+        
+        if (options.hasProperty(runtime, "reusePort")) {
+            nsOptions[@"reusePort"] = @(options.getProperty(runtime, "reusePort").getBool());
+        }
+        
+        if (options.hasProperty(runtime, "broadcast")) {
+            nsOptions[@"broadcast"] = @(options.getProperty(runtime, "broadcast").getBool());
+        }
+        
+        if (options.hasProperty(runtime, "batchReceive")) {
+            nsOptions[@"batchReceive"] = @(options.getProperty(runtime, "batchReceive").getBool());
+        }
+        
+        if (options.hasProperty(runtime, "timestamps")) {
+            nsOptions[@"timestamps"] = @(options.getProperty(runtime, "timestamps").getBool());
+        }
+        
+        if (options.hasProperty(runtime, "receiveQueue")) {
+            auto receiveQueue = options.getProperty(runtime, "receiveQueue");
+            if (!receiveQueue.isNumber() || receiveQueue.asNumber() < 0) {
+                throw JSError(runtime, "receiveQueue must be a non-negative number");
+            }
+            nsOptions[@"receiveQueue"] = @((NSUInteger)receiveQueue.asNumber());
+        }
+        
+        auto maxDatagramSize = options.getProperty(runtime, "maxDatagramSize");
+        if (maxDatagramSize.isNumber() && maxDatagramSize.asNumber() > 0) {
+            nsOptions[@"maxDatagramSize"] = @((NSUInteger)maxDatagramSize.asNumber());
+        }
+        
+        // Created on the manager's queue; socket ids are numeric handles
+        UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+        std::shared_ptr<PendingPromise> pending;
+        Value promise = createPromise(runtime, pending);
+        [manager createSocketWithOptions:nsOptions completion:^(NSNumber* socketId, NSError* error) {
+            if (!socketId) {
+                settlePromise(pending, errorMessage("Failed to create socket", error), nullptr);
+                return;
+            }
+            UDP_JSI_LOG(@"Created socket with ID: %@", socketId);
+            uint32_t handle = socketId.unsignedIntValue;
+            settlePromise(pending, std::string(), [handle](Runtime&) { return Value((double)handle); });
+        }];
+        return promise;
+        
+    } @catch (NSException *exception) {
+        std::string error = "Native exception: " + std::string([exception.reason UTF8String]);
+        throw JSError(runtime, error);
+    }
+}
+
+Value UDPDirectJSI::bindSocket(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 3) {
+        throw JSError(runtime, "bind expects 3 arguments: socketId, port, address");
+    }
+    
+    @try {
+        // Extract arguments
+        NSNumber *socketId = @(socketIdFromValue(runtime, arguments[0]));
+        uint16_t port = (uint16_t)arguments[1].asNumber();
+        NSString *address = [NSString stringWithUTF8String:arguments[2].getString(runtime).utf8(runtime).c_str()];
+        
+        // Resolves with the bound address, so port 0 callers learn the port
+        UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+        std::shared_ptr<PendingPromise> pending;
+        Value promise = createPromise(runtime, pending);
+        [manager bindSocket:socketId toPort:port address:address completion:^(NSDictionary* addressInfo, NSError* error) {
+            if (error) {
+                settlePromise(pending, errorMessage("Failed to bind socket", error), nullptr);
+                return;
+            }
+            UDP_JSI_LOG(@"Bound socket %@ to %@:%d", socketId, address, port);
+            SocketAddressInfo bound(addressInfo);
+            settlePromise(pending, std::string(), [bound](Runtime& rt) { return bound.toValue(rt); });
+        }];
+        return promise;
+        
+    } @catch (NSException *exception) {
+        std::string error = "Native exception: " + std::string([exception.reason UTF8String]);
+        throw JSError(runtime, error);
+    }
+}
+
+Value UDPDirectJSI::configureSocket(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 2 || !isSocketIdValue(arguments[0]) || !arguments[1].isObject()) {
+        throw JSError(runtime, "configure expects 2 arguments: socketId, { ttl, multicastTTL, loopback, broadcast, multicastInterface, groups }");
+    }
+    
+    NSNumber *socketId = @(socketIdFromValue(runtime, arguments[0]));
+    auto options = arguments[1].asObject(runtime);
+    NSMutableDictionary *nsOptions = [NSMutableDictionary dictionary];
+    for (const char* name : {"ttl", "multicastTTL"}) {
+        auto value = options.getProperty(runtime, name);
+        if (value.isUndefined()) continue;
+        if (!value.isNumber() || value.asNumber() < 0 || value.asNumber() > 255) {
+            throw JSError(runtime, std::string(name) + " must be a number from 0 to 255");
+        }
+        nsOptions[@(name)] = @((int)value.asNumber());
+    }
+    for (const char* name : {"loopback", "broadcast"}) {
+        auto value = options.getProperty(runtime, name);
+        if (value.isUndefined()) continue;
+        if (!value.isBool()) {
+            throw JSError(runtime, std::string(name) + " must be a boolean");
+        }
+        nsOptions[@(name)] = @(value.getBool());
+    }
+    auto multicastInterface = options.getProperty(runtime, "multicastInterface");
+    if (multicastInterface.isNumber()) {
+        nsOptions[@"multicastInterface"] = [NSString stringWithFormat:@"%u", (unsigned)multicastInterface.asNumber()];
+    } else if (multicastInterface.isString()) {
+        nsOptions[@"multicastInterface"] = @(multicastInterface.getString(runtime).utf8(runtime).c_str());
+    } else if (!multicastInterface.isUndefined()) {
+        throw JSError(runtime, "multicastInterface must be an interface name, index or address");
+    }
+    auto groups = options.getProperty(runtime, "groups");
+    if (!groups.isUndefined()) {
+        if (!groups.isObject() || !groups.asObject(runtime).isArray(runtime)) {
+            throw JSError(runtime, "groups must be an array of multicast addresses");
+        }
+        auto groupArray = groups.asObject(runtime).asArray(runtime);
+        NSMutableArray<NSString *> *nsGroups = [NSMutableArray arrayWithCapacity:groupArray.size(runtime)];
+        for (size_t i = 0; i < groupArray.size(runtime); i++) {
+            auto group = groupArray.getValueAtIndex(runtime, i);
+            if (!group.isString()) {
+                throw JSError(runtime, "groups must be an array of multicast addresses");
+            }
+            [nsGroups addObject:@(group.getString(runtime).utf8(runtime).c_str())];
+        }
+        nsOptions[@"groups"] = nsGroups;
+    }
+    
+    UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+    std::shared_ptr<PendingPromise> pending;
+    Value promise = createPromise(runtime, pending);
+    [manager configureSocket:socketId options:nsOptions completion:^(NSError* error) {
+        settlePromise(pending, error ? errorMessage("Failed to configure socket", error) : std::string(), nullptr);
+    }];
+    return promise;
+}
+
+Value UDPDirectJSI::socketAddress(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 1 || !isSocketIdValue(arguments[0])) {
+        throw JSError(runtime, "address expects 1 argument: socketId");
+    }
+    
+    NSNumber *socketId = @(socketIdFromValue(runtime, arguments[0]));
+    UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+    std::shared_ptr<PendingPromise> pending;
+    Value promise = createPromise(runtime, pending);
+    [manager getSocketAddress:socketId completion:^(NSDictionary* addressInfo, NSError* error) {
+        SocketAddressInfo info(addressInfo);
+        settlePromise(pending, std::string(), [info](Runtime& rt) { return info.toValue(rt); });
+    }];
+    return promise;
+}
+
+Value UDPDirectJSI::closeSocket(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 1 || !isSocketIdValue(arguments[0])) {
+        throw JSError(runtime, "close expects 1 argument: socketId");
+    }
+    
+    @try {
+        NSNumber *socketId = @(socketIdFromValue(runtime, arguments[0]));
+        
+        UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+        [manager closeSocket:socketId];
+        
+        UDP_JSI_LOG(@"Closed socket %@", socketId);
+        return Value::undefined();
+        
+    } @catch (NSException *exception) {
+        std::string error = "Native exception: " + std::string([exception.reason UTF8String]);
+        throw JSError(runtime, error);
+    }
+}
+
+Value UDPDirectJSI::setEventHandler(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 2 || !isSocketIdValue(arguments[0]) || !arguments[1].isObject()) {
+        throw JSError(runtime, "setEventHandler expects socketId and handler object");
+    }
+    
+    @try {
+        uint32_t socketId = socketIdFromValue(runtime, arguments[0]);
+        
+        auto handlerObj = arguments[1].asObject(runtime);
+        
+        // Store handlers as shared pointers to keep them alive
+        SocketHandlers handlers;
+        udpdirect::UDPMessageBatcher::Config batchConfig;
+        
+        auto functionProperty = [&](const char* name) -> std::shared_ptr<Function> {
+            if (!handlerObj.hasProperty(runtime, name)) {
+                return nullptr;
+            }
+            auto value = handlerObj.getProperty(runtime, name);
+            if (value.isObject() && value.asObject(runtime).isFunction(runtime)) {
+                return std::make_shared<Function>(value.asObject(runtime).asFunction(runtime));
+            }
+            return nullptr;
+        };
+        handlers.onMessage = functionProperty("onMessage");
+        handlers.onError = functionProperty("onError");
+        handlers.onClose = functionProperty("onClose");
+        handlers.onSent = functionProperty("onSent");
+        
+        // Route handlers for the socket's packet filter, by index
+        if (handlerObj.hasProperty(runtime, "routes")) {
+            auto routesValue = handlerObj.getProperty(runtime, "routes");
+            if (!routesValue.isObject() || !routesValue.asObject(runtime).isArray(runtime)) {
+                throw JSError(runtime, "routes must be an array of functions");
+            }
+            auto routes = routesValue.asObject(runtime).asArray(runtime);
+            for (size_t i = 0; i < routes.size(runtime); i++) {
+                auto route = routes.getValueAtIndex(runtime, i);
+                if (!route.isObject() || !route.asObject(runtime).isFunction(runtime)) {
+                    throw JSError(runtime, "routes must be an array of functions");
+                }
+                handlers.routes.push_back(std::make_shared<Function>(route.asObject(runtime).asFunction(runtime)));
+            }
+        }
+        
+        // Opt-in batching: one invokeAsync per flush instead of one per datagram
+        handlers.onMessageBatch = functionProperty("onMessageBatch");
+        if (handlers.onMessageBatch) {
+            auto maxBatch = handlerObj.getProperty(runtime, "maxBatch");
+            if (maxBatch.isNumber() && maxBatch.asNumber() >= 1) {
+                batchConfig.maxBatch = (uint32_t)maxBatch.asNumber();
+            }
+            auto maxDelayUs = handlerObj.getProperty(runtime, "maxDelayUs");
+            if (maxDelayUs.isNumber() && maxDelayUs.asNumber() >= 0) {
+                batchConfig.maxDelayUs = (uint32_t)maxDelayUs.asNumber();
+            }
+        }
+        
+        // Replaces this socket's handlers only; other sockets keep theirs
+        bool batching = handlers.onMessageBatch != nullptr;
+        g_socketHandlers[socketId] = std::move(handlers);
+        g_socketHandlersVersion++;
+        
+        UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+        installManagerCallbacks(manager);
+        
+        // Batchers live on the socket's receive queue with the receive callback
+        NSUInteger queueIndex = [manager receiveQueueIndexForSocket:@(socketId)];
+        if (queueIndex == NSNotFound) {
+            throw JSError(runtime, "Socket " + std::to_string(socketId) + " not found");
+        }
+        dispatch_async([manager receiveQueueAtIndex:queueIndex], ^{
+            auto& batchers = g_batchers[queueIndex];
+            if (!batching) {
+                batchers.erase(socketId);
+                return;
+            }
+            auto& batcher = batchers[socketId];
+            if (!batcher || batcher->config().maxBatch != batchConfig.maxBatch || batcher->config().maxDelayUs != batchConfig.maxDelayUs) {
+                batcher = std::make_shared<udpdirect::UDPMessageBatcher>(batchConfig, [manager receivePool]);
+            }
+        });
+        
+        // Start receiving
+        [manager startReceivingOnBoundSockets];
+        
+        UDP_JSI_LOG(@"Event handlers set for socket %u", socketId);
+        return Value::undefined();
+        
+    } @catch (NSException *exception) {
+        std::string error = "Native exception: " + std::string([exception.reason UTF8String]);
+        throw JSError(runtime, error);
+    }
+}
+
+Value UDPDirectJSI::setBackpressure(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 1 || !arguments[0].isObject()) {
+        throw JSError(runtime, "setBackpressure expects 1 object argument: { policy, blockTimeoutUs }");
+    }
+    if (g_receiveRings.empty()) {
+        throw JSError(runtime, "UDP receive ring not initialized");
+    }
+    
+    auto options = arguments[0].asObject(runtime);
+    auto policy = options.getProperty(runtime, "policy");
+    if (policy.isString()) {
+        std::string name = policy.getString(runtime).utf8(runtime);
+        udpdirect::UDPBackpressurePolicy ringPolicy;
+        if (name == "dropOldest") {
+            ringPolicy = udpdirect::UDPBackpressurePolicy::DropOldest;
+        } else if (name == "dropNewest") {
+            ringPolicy = udpdirect::UDPBackpressurePolicy::DropNewest;
+        } else if (name == "block") {
+            ringPolicy = udpdirect::UDPBackpressurePolicy::Block;
+        } else {
+            throw JSError(runtime, "policy must be 'dropOldest', 'dropNewest' or 'block'");
+        }
+        for (const auto& ring : g_receiveRings) {
+            ring->setPolicy(ringPolicy);
+        }
+    }
+    
+    auto blockTimeoutUs = options.getProperty(runtime, "blockTimeoutUs");
+    if (blockTimeoutUs.isNumber() && blockTimeoutUs.asNumber() >= 0) {
+        for (const auto& ring : g_receiveRings) {
+            ring->setBlockTimeoutUs((uint32_t)blockTimeoutUs.asNumber());
+        }
+    }
+    
+    return Value::undefined();
+}
+
+Value UDPDirectJSI::setMemoryBudget(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 1 || !arguments[0].isObject()) {
+        throw JSError(runtime, "setMemoryBudget expects 1 object argument: { bytes, overflow }");
+    }
+    
+    UDPSocketManager* manager = (__bridge UDPSocketManager*)getSocketManager(runtime);
+    auto pool = [manager receivePool];
+    udpdirect::UDPBufferPoolBudgetStats current = pool->budgetStats();
+    
+    auto options = arguments[0].asObject(runtime);
+    // A default budget stays default, so it follows the overflow policy (heap adds headroom)
+    uint64_t bytes = current.defaultBudget ? 0 : current.budgetBytes;
+    auto bytesValue = options.getProperty(runtime, "bytes");
+    if (bytesValue.isNumber()) {
+        if (bytesValue.asNumber() < 0) {
+            throw JSError(runtime, "bytes must be >= 0 (0 restores the preallocated size)");
+        }
+        bytes = (uint64_t)bytesValue.asNumber();
+    }
+    
+    // Policy is not readable back from the stats, so it defaults to 'drop' when omitted
+    udpdirect::UDPPoolOverflowPolicy overflow = udpdirect::UDPPoolOverflowPolicy::Drop;
+    auto overflowValue = options.getProperty(runtime, "overflow");
+    if (overflowValue.isString()) {
+        std::string name = overflowValue.getString(runtime).utf8(runtime);
+        if (name == "heap") {
+            overflow = udpdirect::UDPPoolOverflowPolicy::Heap;
+        } else if (name != "drop") {
+            throw JSError(runtime, "overflow must be 'drop' or 'heap'");
+        }
+    }
+    
+    pool->setBudget(bytes, overflow);
+    return Value::undefined();
+}
+
+static udpdirect::UDPRateLimit rateLimitFromObject(Runtime& runtime, const Object& object) {
+    auto field = [&](const char* name) -> uint64_t {
+        auto value = object.getProperty(runtime, name);
+        if (value.isUndefined()) {
+            return 0;
+        }
+        if (!value.isNumber() || value.asNumber() < 0) {
+            throw JSError(runtime, std::string(name) + " must be a number >= 0");
+        }
+        return (uint64_t)value.asNumber();
+    };
+    udpdirect::UDPRateLimit limit;
+    limit.bytesPerSecond = field("bytesPerSecond");
+    limit.packetsPerSecond = field("packetsPerSecond");
+    limit.burstBytes = field("burstBytes");
+    limit.burstPackets = field("burstPackets");
+    return limit;
+}
+
+Value UDPDirectJSI::setSendRate(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 2 || !isSocketIdValue(arguments[0]) || !arguments[1].isObject()) {
+        throw JSError(runtime, "setSendRate expects socketId and { bytesPerSecond, packetsPerSecond, burstBytes, burstPackets, perDestination }");
+    }
+    
+    auto options = arguments[1].asObject(runtime);
+    udpdirect::UDPRateLimit socketLimit = rateLimitFromObject(runtime, options);
+    udpdirect::UDPRateLimit destinationLimit;
+    auto perDestination = options.getProperty(runtime, "perDestination");
+    if (perDestination.isObject()) {
+        destinationLimit = rateLimitFromObject(runtime, perDestination.asObject(runtime));
+    }
+    
+    UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+    [manager setSendRateLimit:socketLimit perDestination:destinationLimit forSocket:@(socketIdFromValue(runtime, arguments[0]))];
+    return Value::undefined();
+}
+
+Value UDPDirectJSI::getSchedulerStats(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+    udpdirect::UDPSendSchedulerStats stats = [manager sendSchedulerStats];
+    udpdirect::UDPLatencySummary latency = [manager pacedSendLatency];
+    
+    auto result = Object(runtime);
+    result.setProperty(runtime, "queuedPackets", Value((double)stats.queuedPackets));
+    result.setProperty(runtime, "queuedBytes", Value((double)stats.queuedBytes));
+    result.setProperty(runtime, "highWaterPackets", Value((double)stats.highWaterPackets));
+    result.setProperty(runtime, "enqueued", Value((double)stats.enqueued));
+    result.setProperty(runtime, "dispatched", Value((double)stats.dispatched));
+    result.setProperty(runtime, "shaped", Value((double)stats.shaped));
+    result.setProperty(runtime, "rejected", Value((double)stats.rejected));
+    result.setProperty(runtime, "discarded", Value((double)stats.discarded));
+    result.setProperty(runtime, "latencyP50Us", Value(latency.p50Ns / 1000.0));
+    result.setProperty(runtime, "latencyP99Us", Value(latency.p99Ns / 1000.0));
+    result.setProperty(runtime, "latencyMaxUs", Value(latency.maxNs / 1000.0));
+    return result;
+}
+
+static udpdirect::UDPFilterAction filterActionFromValue(Runtime& runtime, const Value& value) {
+    std::string name = value.isString() ? value.getString(runtime).utf8(runtime) : "";
+    if (name == "drop") {
+        return udpdirect::UDPFilterAction::Drop;
+    }
+    if (name == "deliver") {
+        return udpdirect::UDPFilterAction::Deliver;
+    }
+    if (name == "route") {
+        return udpdirect::UDPFilterAction::Route;
+    }
+    throw JSError(runtime, "filter action must be 'drop', 'deliver' or 'route'");
+}
+
+static udpdirect::UDPFilterRule filterRuleFromValue(Runtime& runtime, const Value& value) {
+    if (!value.isObject()) {
+        throw JSError(runtime, "filter rules must be objects");
+    }
+    auto object = value.asObject(runtime);
+    udpdirect::UDPFilterRule rule;
+
+    auto match = object.getProperty(runtime, "match");
+    std::string kind = match.isString() ? match.getString(runtime).utf8(runtime) : "";
+    if (kind == "magic") {
+        rule.match = udpdirect::UDPFilterMatch::Magic;
+        auto bytes = object.getProperty(runtime, "bytes");
+        if (bytes.isObject() && bytes.asObject(runtime).isArrayBuffer(runtime)) {
+            auto buffer = bytes.asObject(runtime).getArrayBuffer(runtime);
+            rule.bytes.assign(buffer.data(runtime), buffer.data(runtime) + buffer.size(runtime));
+        } else if (bytes.isObject() && bytes.asObject(runtime).isArray(runtime)) {
+            auto array = bytes.asObject(runtime).asArray(runtime);
+            for (size_t i = 0; i < array.size(runtime); i++) {
+                auto byte = array.getValueAtIndex(runtime, i);
+                if (!byte.isNumber() || byte.asNumber() < 0 || byte.asNumber() > 255) {
+                    throw JSError(runtime, "magic bytes must be numbers from 0 to 255");
+                }
+                rule.bytes.push_back((uint8_t)byte.asNumber());
+            }
+        } else {
+            throw JSError(runtime, "magic rule needs bytes as an array or ArrayBuffer");
+        }
+    } else if (kind == "source") {
+        rule.match = udpdirect::UDPFilterMatch::Source;
+        auto sources = object.getProperty(runtime, "sources");
+        if (!sources.isObject() || !sources.asObject(runtime).isArray(runtime)) {
+            throw JSError(runtime, "source rule needs sources: [{ address?, port? }]");
+        }
+        auto array = sources.asObject(runtime).asArray(runtime);
+        for (size_t i = 0; i < array.size(runtime); i++) {
+            auto entry = array.getValueAtIndex(runtime, i);
+            if (!entry.isObject()) {
+                throw JSError(runtime, "source rule needs sources: [{ address?, port? }]");
+            }
+            auto entryObject = entry.asObject(runtime);
+            udpdirect::UDPSocketAddress allowed;
+            uint32_t port = optionalUint32(runtime, entryObject, "port", 0);
+            auto address = entryObject.getProperty(runtime, "address");
+            if (address.isString()) {
+                std::string host = address.getString(runtime).utf8(runtime);
+                if (!udpdirect::UDPSocketAddress::fromNumericHost(host.c_str(), 0, allowed)) {
+                    throw JSError(runtime, "source addresses must be numeric IPv4 or IPv6: " + host);
+                }
+            }
+            allowed.port = (uint16_t)port;
+            rule.sources.push_back(allowed);
+        }
+    } else if (kind == "selfEcho") {
+        rule.match = udpdirect::UDPFilterMatch::SelfEcho;
+    } else if (kind == "length") {
+        rule.match = udpdirect::UDPFilterMatch::Length;
+        rule.minLength = optionalUint32(runtime, object, "min", 0);
+        rule.maxLength = optionalUint32(runtime, object, "max", UINT32_MAX);
+    } else if (kind == "duplicate") {
+        rule.match = udpdirect::UDPFilterMatch::Duplicate;
+        rule.width = optionalUint32(runtime, object, "width", rule.width);
+        rule.windowNs = (uint64_t)optionalUint32(runtime, object, "windowMs", 1000) * 1000000ull;
+    } else {
+        throw JSError(runtime, "filter match must be 'magic', 'source', 'selfEcho', 'length' or 'duplicate'");
+    }
+
+    rule.offset = optionalUint32(runtime, object, "offset", 0);
+    auto invert = object.getProperty(runtime, "invert");
+    rule.invert = invert.isBool() && invert.getBool();
+    rule.action = filterActionFromValue(runtime, object.getProperty(runtime, "action"));
+    rule.route = optionalUint32(runtime, object, "route", 0);
+    return rule;
+}
+
+Value UDPDirectJSI::setFilter(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 2 || !isSocketIdValue(arguments[0]) || !(arguments[1].isObject() || arguments[1].isNull())) {
+        throw JSError(runtime, "setFilter expects socketId and { rules, defaultAction, defaultRoute } or null");
+    }
+    uint32_t socketId = socketIdFromValue(runtime, arguments[0]);
+    UDPSocketManager* manager = (__bridge UDPSocketManager*)getSocketManager(runtime);
+    
+    if (arguments[1].isNull()) {
+        g_filters.erase(socketId);
+        [manager setPacketFilter:nullptr forSocket:@(socketId)];
+        return Value::undefined();
+    }
+    
+    auto options = arguments[1].asObject(runtime);
+    auto rulesValue = options.getProperty(runtime, "rules");
+    if (!rulesValue.isObject() || !rulesValue.asObject(runtime).isArray(runtime)) {
+        throw JSError(runtime, "setFilter options need a rules array");
+    }
+    auto rulesArray = rulesValue.asObject(runtime).asArray(runtime);
+    std::vector<udpdirect::UDPFilterRule> rules;
+    for (size_t i = 0; i < rulesArray.size(runtime); i++) {
+        rules.push_back(filterRuleFromValue(runtime, rulesArray.getValueAtIndex(runtime, i)));
+    }
+    std::string invalid = udpdirect::UDPPacketFilter::validate(rules);
+    if (!invalid.empty()) {
+        throw JSError(runtime, "Invalid filter: " + invalid);
+    }
+    
+    udpdirect::UDPFilterDecision fallback;
+    auto defaultAction = options.getProperty(runtime, "defaultAction");
+    if (!defaultAction.isUndefined()) {
+        fallback.action = filterActionFromValue(runtime, defaultAction);
+    }
+    fallback.route = optionalUint32(runtime, options, "defaultRoute", 0);
+    
+    auto filter = std::make_shared<udpdirect::UDPPacketFilter>(std::move(rules), fallback);
+    g_filters[socketId] = filter;
+    [manager setPacketFilter:filter forSocket:@(socketId)];
+    return Value::undefined();
+}
+
+Value UDPDirectJSI::getFilterStats(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 1 || !isSocketIdValue(arguments[0])) {
+        throw JSError(runtime, "getFilterStats expects socketId");
+    }
+    auto found = g_filters.find(socketIdFromValue(runtime, arguments[0]));
+    if (found == g_filters.end()) {
+        return Value::null();
+    }
+    const auto& filter = found->second;
+    
+    auto hits = Array(runtime, filter->ruleCount());
+    for (size_t i = 0; i < filter->ruleCount(); i++) {
+        hits.setValueAtIndex(runtime, i, Value((double)filter->hits(i)));
+    }
+    auto stats = Object(runtime);
+    stats.setProperty(runtime, "hits", std::move(hits));
+    stats.setProperty(runtime, "defaultHits", Value((double)filter->fallbackHits()));
+    return stats;
+}
+
+Value UDPDirectJSI::setChecksum(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 2 || !isSocketIdValue(arguments[0]) || !(arguments[1].isObject() || arguments[1].isNull())) {
+        throw JSError(runtime, "setChecksum expects socketId and { kind, offset, byteOrder, seed, strip, onFailure, route } or null");
+    }
+    uint32_t socketId = socketIdFromValue(runtime, arguments[0]);
+    UDPSocketManager* manager = (__bridge UDPSocketManager*)getSocketManager(runtime);
+    
+    if (arguments[1].isNull()) {
+        g_checksums.erase(socketId);
+        [manager setChecksumVerifier:nullptr forSocket:@(socketId)];
+        return Value::undefined();
+    }
+    
+    auto options = arguments[1].asObject(runtime);
+    udpdirect::UDPChecksumConfig config;
+    auto kind = options.getProperty(runtime, "kind");
+    std::string kindName = kind.isString() ? kind.getString(runtime).utf8(runtime) : "crc32c";
+    if (kindName == "crc32c") {
+        config.kind = udpdirect::UDPChecksumKind::CRC32C;
+    } else if (kindName == "xxh64") {
+        config.kind = udpdirect::UDPChecksumKind::XXH64;
+    } else {
+        throw JSError(runtime, "checksum kind must be 'crc32c' or 'xxh64'");
+    }
+    config.offset = optionalUint32(runtime, options, "offset", 0);
+    auto byteOrder = options.getProperty(runtime, "byteOrder");
+    if (byteOrder.isString()) {
+        std::string order = byteOrder.getString(runtime).utf8(runtime);
+        if (order != "big" && order != "little") {
+            throw JSError(runtime, "checksum byteOrder must be 'big' or 'little'");
+        }
+        config.bigEndian = order == "big";
+    }
+    auto seed = options.getProperty(runtime, "seed");
+    if (seed.isNumber()) {
+        if (seed.asNumber() < 0 || seed.asNumber() > 9007199254740991.0) {
+            throw JSError(runtime, "checksum seed must be a non-negative safe integer");
+        }
+        config.seed = (uint64_t)seed.asNumber();
+    }
+    auto strip = options.getProperty(runtime, "strip");
+    config.strip = !strip.isBool() || strip.getBool();
+    auto onFailure = options.getProperty(runtime, "onFailure");
+    if (!onFailure.isUndefined()) {
+        config.onFailure.action = filterActionFromValue(runtime, onFailure);
+    }
+    config.onFailure.route = optionalUint32(runtime, options, "route", 0);
+    
+    auto verifier = std::make_shared<udpdirect::UDPChecksumVerifier>(config);
+    g_checksums[socketId] = verifier;
+    [manager setChecksumVerifier:verifier forSocket:@(socketId)];
+    return Value::undefined();
+}
+
+Value UDPDirectJSI::stampChecksum(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 4 || !isSocketIdValue(arguments[0])) {
+        throw JSError(runtime, "stampChecksum expects 4 arguments: socketId, buffer, offset, length");
+    }
+    auto found = g_checksums.find(socketIdFromValue(runtime, arguments[0]));
+    if (found == g_checksums.end()) {
+        throw JSError(runtime, "stampChecksum needs a checksum set with _udpJSI.setChecksum");
+    }
+    size_t length = 0;
+    uint8_t* dataPtr = bufferSliceFromArguments(runtime, arguments, 1, length);
+    size_t capacity = arguments[1].asObject(runtime).getArrayBuffer(runtime).size(runtime) - (size_t)arguments[2].asNumber();
+    size_t stamped = found->second->stamp(dataPtr, length, capacity);
+    if (stamped == 0) {
+        throw JSError(runtime, "no room for the checksum trailer after offset + length");
+    }
+    return Value((double)stamped);
+}
+
+Value UDPDirectJSI::getChecksumStats(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 1 || !isSocketIdValue(arguments[0])) {
+        throw JSError(runtime, "getChecksumStats expects socketId");
+    }
+    auto found = g_checksums.find(socketIdFromValue(runtime, arguments[0]));
+    if (found == g_checksums.end()) {
+        return Value::null();
+    }
+    udpdirect::UDPChecksumStats stats = found->second->stats();
+    bool crc = found->second->config().kind == udpdirect::UDPChecksumKind::CRC32C;
+    
+    auto result = Object(runtime);
+    result.setProperty(runtime, "kernel", String::createFromAscii(runtime, crc ? udpdirect::UDPCrc32cKernels().front().name : "scalar"));
+    result.setProperty(runtime, "verified", Value((double)stats.verified));
+    result.setProperty(runtime, "failed", Value((double)stats.failed));
+    result.setProperty(runtime, "tooShort", Value((double)stats.tooShort));
+    result.setProperty(runtime, "stamped", Value((double)stats.stamped));
+    return result;
+}
+
+Value UDPDirectJSI::setFraming(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 2 || !isSocketIdValue(arguments[0]) || !(arguments[1].isObject() || arguments[1].isNull())) {
+        throw JSError(runtime, "setFraming expects socketId and { maxDatagramSize, maxMessageSize, maxPendingMessages, maxPendingBytes, timeoutMs } or null");
+    }
+    uint32_t socketId = socketIdFromValue(runtime, arguments[0]);
+    UDPSocketManager* manager = (__bridge UDPSocketManager*)getSocketManager(runtime);
+    
+    if (arguments[1].isNull()) {
+        g_framing.erase(socketId);
+        [manager setReassembler:nullptr forSocket:@(socketId)];
+        return Value::undefined();
+    }
+    
+    auto options = arguments[1].asObject(runtime);
+    auto field = [&](const char* name, double fallback, double minimum) -> double {
+        auto value = options.getProperty(runtime, name);
+        if (value.isUndefined()) {
+            return fallback;
+        }
+        if (!value.isNumber() || value.asNumber() < minimum) {
+            throw JSError(runtime, std::string(name) + " must be a number >= " + std::to_string((long long)minimum));
+        }
+        return value.asNumber();
+    };
+    udpdirect::UDPReassembler::Config config;
+    FramingState state;
+    state.maxDatagramSize = (size_t)field("maxDatagramSize", 1200, udpdirect::UDPFragmentHeader::kSize + 1);
+    config.maxMessageSize = (size_t)field("maxMessageSize", (double)config.maxMessageSize, 1);
+    config.maxPendingMessages = (size_t)field("maxPendingMessages", (double)config.maxPendingMessages, 1);
+    config.maxPendingBytes = (size_t)field("maxPendingBytes", (double)config.maxPendingBytes, 1);
+    config.timeoutNs = (uint64_t)(field("timeoutMs", config.timeoutNs / 1e6, 1) * 1e6);
+    if (state.maxDatagramSize > 65507) {
+        throw JSError(runtime, "maxDatagramSize must be at most 65507");
     }
-    return g_socketManager;
+    
+    state.reassembler = std::make_shared<udpdirect::UDPReassembler>(config);
+    [manager setReassembler:state.reassembler forSocket:@(socketId)];
+    g_framing[socketId] = std::move(state);
+    return Value::undefined();
 }
 
-Value UDPDirectJSI::udpSendDirect(
+Value UDPDirectJSI::sendMessage(
     Runtime& runtime,
     const Value& thisValue,
     const Value* arguments,
     size_t count
 ) {
-    if (count != 6) {
-        throw JSError(runtime, "udpSendDirect expects 6 arguments: socketId, buffer, offset, length, port, address");
+    if (count != 5 || !isSocketIdValue(arguments[0])) {
+        throw JSError(runtime, "sendMessage expects 5 arguments: socketId, buffer, offset, length, endpoint");
+    }
+    uint32_t handle = socketIdFromValue(runtime, arguments[0]);
+    auto framing = g_framing.find(handle);
+    if (framing == g_framing.end()) {
+        throw JSError(runtime, "sendMessage needs framing enabled with _udpJSI.setFraming");
+    }
+    size_t length = 0;
+    uint8_t* dataPtr = bufferSliceFromArguments(runtime, arguments, 1, length);
+    const udpdirect::UDPEndpoint& endpoint = endpointFromValue(runtime, arguments[4]);
+    
+    if (!udpdirect::UDPFragmenter::fragment(dataPtr, length, g_nextMessageId++, framing->second.maxDatagramSize, g_fragmentBatch)) {
+        throw JSError(runtime, "message too large for maxDatagramSize (at most 65535 fragments)");
     }
     
     @try {
-        // Extract arguments
-        if (!arguments[0].isString()) {
-            throw JSError(runtime, "socketId must be a string");
-        }
-        std::string socketIdStr = arguments[0].getString(runtime).utf8(runtime);
-        NSNumber *socketId = @(std::stoi(socketIdStr));
-        
-        // Handle ArrayBuffer
-        if (!arguments[1].isObject()) {
-            throw JSError(runtime, "buffer must be an ArrayBuffer");
-        }
-        
-        auto bufferObj = arguments[1].asObject(runtime);
-        if (!bufferObj.isArrayBuffer(runtime)) {
-            throw JSError(runtime, "buffer must be an ArrayBuffer");
-        }
-        
-        auto arrayBuffer = bufferObj.getArrayBuffer(runtime);
-        
-        // Extract offset and length
-        if (!arguments[2].isNumber()) {
-            throw JSError(runtime, "offset must be a number");
-        }
-        size_t offset = (size_t)arguments[2].asNumber();
-        
-        if (!arguments[3].isNumber()) {
-            throw JSError(runtime, "length must be a number");
-        }
-        size_t length = (size_t)arguments[3].asNumber();
-        
-        // Validate offset and length
-        if (offset + length > arrayBuffer.size(runtime)) {
-            throw JSError(runtime, "offset + length exceeds buffer size");
-        }
-        
-        // Create NSData with a COPY of the specified range
-        // IMPORTANT: We must copy because sendData dispatches async and the
-        // ArrayBuffer could be garbage collected before the send completes
-        uint8_t* dataPtr = arrayBuffer.data(runtime) + offset;
-        NSData *data = [NSData dataWithBytes:dataPtr length:length];
-        
-        // Extract port and address
-        if (!arguments[4].isNumber()) {
-            throw JSError(runtime, "port must be a number");
+        NSNumber *socketId = @(handle);
+        g_batchSendItems.clear();
+        for (size_t i = 0; i < g_fragmentBatch.count(); i++) {
+            udpdirect::UDPBatchSendItem item;
+            item.destination = endpoint.address;
+            item.data = g_fragmentBatch.datagrams.data() + g_fragmentBatch.offsets[i];
+            item.length = g_fragmentBatch.lengths[i];
+            g_batchSendItems.push_back(item);
         }
-        uint16_t port = (uint16_t)arguments[4].asNumber();
-        
-        if (!arguments[5].isString()) {
-            throw JSError(runtime, "address must be a string");
-        }
-        NSString *address = [NSString stringWithUTF8String:arguments[5].getString(runtime).utf8(runtime).c_str()];
         
-        // Get socket manager and send
+        // One sendmmsg for as many fragments as the kernel takes; the rest are copied and queued
         UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
-        [manager sendData:data onSocket:socketId toHost:address port:port tag:0];
-        
-        NSLog(@"[UDPDirectJSI] Zero-copy send %zu bytes (offset=%zu) from socket %@ to %@:%d", 
-              data.length, offset, socketId, address, port);
+        size_t sent = [manager sendBatchImmediately:g_batchSendItems.data() count:g_batchSendItems.size() onSocket:socketId];
+        for (size_t i = sent; i < g_batchSendItems.size(); i++) {
+            NSData *data = [NSData dataWithBytes:g_batchSendItems[i].data length:g_batchSendItems[i].length];
+            [manager sendData:data onSocket:socketId toEndpoint:endpoint tag:[manager nextSendTag]];
+        }
         
-        return Value::undefined();
+        framing->second.messagesSent++;
+        framing->second.fragmentsSent += g_batchSendItems.size();
+        return Value(sent == g_batchSendItems.size());
         
     } @catch (NSException *exception) {
         std::string error = "Native exception: " + std::string([exception.reason UTF8String]);
@@ -182,268 +2741,385 @@ Value UDPDirectJSI::udpSendDirect(
     }
 }
 
-Value UDPDirectJSI::createUdpSocket(
+Value UDPDirectJSI::getFramingStats(
     Runtime& runtime,
     const Value& thisValue,
     const Value* arguments,
     size_t count
 ) {
-    if (count != 1 || !arguments[0].isObject()) {
-        throw JSError(runtime, "createSocket expects 1 object argument");
+    if (count != 1 || !isSocketIdValue(arguments[0])) {
+        throw JSError(runtime, "getFramingStats expects socketId");
+    }
+    auto found = g_framing.find(socketIdFromValue(runtime, arguments[0]));
+    if (found == g_framing.end()) {
+        return Value::null();
     }
+    udpdirect::UDPReassemblerStats stats = found->second.reassembler->stats();
     
-    @try {
-        auto options = arguments[0].asObject(runtime);
-        NSMutableDictionary *nsOptions = [NSMutableDictionary dictionary];
-        
-        // Extract options
-        if (options.hasProperty(runtime, "type")) {
-            auto type = options.getProperty(runtime, "type").getString(runtime).utf8(runtime);
-            nsOptions[@"type"] = [NSString stringWithUTF8String:type.c_str()];
-        } else {
-            nsOptions[@"type"] = @"udp4"; // Default
-        }
-        
-        if (options.hasProperty(runtime, "reuseAddr")) {
-            nsOptions[@"reuseAddr"] = @(options.getProperty(runtime, "reuseAddr").getBool());
-        }
-        
-        if (options.hasProperty(runtime, "reusePort")) {
-            nsOptions[@"reusePort"] = @(options.getProperty(runtime, "reusePort").getBool());
-        }
-        
-        if (options.hasProperty(runtime, "broadcast")) {
-            nsOptions[@"broadcast"] = @(options.getProperty(runtime, "broadcast").getBool());
-        }
-        
-        // Create socket
-        UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
-        NSError *error = nil;
-        NSNumber *socketId = [manager createSocketWithOptions:nsOptions error:&error];
-        
-        if (!socketId) {
-            std::string errorMsg = "Failed to create socket";
-            if (error) {
-                errorMsg += ": " + std::string([[error localizedDescription] UTF8String]);
-            }
-            throw JSError(runtime, errorMsg);
-        }
-        
-        NSLog(@"[UDPDirectJSI] Created socket with ID: %@", socketId);
-        
-        // Return socket ID as string
-        return String::createFromUtf8(runtime, [[socketId stringValue] UTF8String]);
-        
-    } @catch (NSException *exception) {
-        std::string error = "Native exception: " + std::string([exception.reason UTF8String]);
-        throw JSError(runtime, error);
+    auto result = Object(runtime);
+    result.setProperty(runtime, "messagesSent", Value((double)found->second.messagesSent));
+    result.setProperty(runtime, "fragmentsSent", Value((double)found->second.fragmentsSent));
+    result.setProperty(runtime, "fragmentsReceived", Value((double)stats.fragmentsReceived));
+    result.setProperty(runtime, "duplicateFragments", Value((double)stats.duplicateFragments));
+    result.setProperty(runtime, "invalidFragments", Value((double)stats.invalidFragments));
+    result.setProperty(runtime, "messagesReceived", Value((double)stats.messagesCompleted));
+    result.setProperty(runtime, "messagesTimedOut", Value((double)stats.messagesTimedOut));
+    result.setProperty(runtime, "messagesEvicted", Value((double)stats.messagesEvicted));
+    result.setProperty(runtime, "pendingMessages", Value((double)stats.pendingMessages));
+    result.setProperty(runtime, "pendingBytes", Value((double)stats.pendingBytes));
+    return result;
+}
+
+// Over all receive rings; a socket only ever drops in the ring of its receive queue
+static uint64_t receiveRingDrops(const uint32_t* socketId) {
+    uint64_t dropped = 0;
+    for (const auto& ring : g_receiveRings) {
+        dropped += socketId ? ring->droppedForSocket(*socketId) : ring->droppedTotal();
     }
+    return dropped;
 }
 
-Value UDPDirectJSI::bindSocket(
+Value UDPDirectJSI::getDroppedPackets(
     Runtime& runtime,
     const Value& thisValue,
     const Value* arguments,
     size_t count
 ) {
-    if (count != 3) {
-        throw JSError(runtime, "bind expects 3 arguments: socketId, port, address");
+    if (count == 0 || arguments[0].isUndefined()) {
+        return Value((double)receiveRingDrops(nullptr));
+    }
+    uint32_t socketId = socketIdFromValue(runtime, arguments[0]);
+    return Value((double)receiveRingDrops(&socketId));
+}
+
+Value UDPDirectJSI::setTraceEnabled(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 1 || !arguments[0].isBool()) {
+        throw JSError(runtime, "setTraceEnabled expects 1 boolean argument");
+    }
+    if (!g_trace) {
+        throw JSError(runtime, "UDP trace not initialized");
+    }
+    g_trace->setEnabled(arguments[0].getBool());
+    return Value::undefined();
+}
+
+// getStats layout, mirrored by UDPStatsField in src/jsi-wrapper.ts: socket counters,
+// then receive latency, then send latency. Latencies are in microseconds.
+static const size_t kSocketStatsFields = 7;
+static const size_t kLatencyStatsFields = 8;
+static const size_t kStatsFieldCount = kSocketStatsFields + 2 * kLatencyStatsFields;
+
+static void writeLatencySummary(double* out, const udpdirect::UDPLatencySummary& summary) {
+    out[0] = (double)summary.count;
+    out[1] = summary.minNs / 1000.0;
+    out[2] = summary.meanNs / 1000.0;
+    out[3] = summary.p50Ns / 1000.0;
+    out[4] = summary.p90Ns / 1000.0;
+    out[5] = summary.p99Ns / 1000.0;
+    out[6] = summary.p999Ns / 1000.0;
+    out[7] = summary.maxNs / 1000.0;
+}
+
+Value UDPDirectJSI::getStats(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (!g_stats) {
+        throw JSError(runtime, "UDP stats not initialized");
     }
     
-    @try {
-        // Extract arguments
-        std::string socketIdStr = arguments[0].getString(runtime).utf8(runtime);
-        NSNumber *socketId = @(std::stoi(socketIdStr));
-        uint16_t port = (uint16_t)arguments[1].asNumber();
-        NSString *address = [NSString stringWithUTF8String:arguments[2].getString(runtime).utf8(runtime).c_str()];
-        
-        // Bind socket
-        UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
-        NSError *error = nil;
-        BOOL success = [manager bindSocket:socketId toPort:port address:address error:&error];
-        
-        if (!success) {
-            std::string errorMsg = "Failed to bind socket";
-            if (error) {
-                errorMsg += ": " + std::string([[error localizedDescription] UTF8String]);
-            }
-            throw JSError(runtime, errorMsg);
+    // No socket id: totals over all sockets
+    udpdirect::UDPSocketCountersSnapshot counters;
+    uint64_t ringDrops = 0;
+    if (count == 0 || arguments[0].isUndefined() || arguments[0].isNull()) {
+        counters = g_stats->totals();
+        ringDrops = receiveRingDrops(nullptr);
+    } else {
+        uint32_t socketId = socketIdFromValue(runtime, arguments[0]);
+        g_stats->snapshot(socketId, counters);  // unknown sockets read as zeros
+        ringDrops = receiveRingDrops(&socketId);
+    }
+    
+    // Fill the caller's Float64Array when given one, so polling allocates nothing
+    Object out = count >= 2 && arguments[1].isObject()
+        ? arguments[1].asObject(runtime)
+        : runtime.global().getPropertyAsFunction(runtime, "Float64Array").callAsConstructor(runtime, (double)kStatsFieldCount).asObject(runtime);
+    auto length = out.getProperty(runtime, "length");
+    auto bytesPerElement = out.getProperty(runtime, "BYTES_PER_ELEMENT");
+    auto buffer = out.getProperty(runtime, "buffer");
+    const std::string badOutput = "getStats output must be a Float64Array of at least " + std::to_string(kStatsFieldCount) + " elements";
+    if (!length.isNumber() || length.asNumber() < kStatsFieldCount ||
+        !bytesPerElement.isNumber() || bytesPerElement.asNumber() != sizeof(double) ||
+        !buffer.isObject() || !buffer.asObject(runtime).isArrayBuffer(runtime)) {
+        throw JSError(runtime, badOutput);
+    }
+    // The fields above are only duck-typed, so the write itself must fit the buffer
+    auto arrayBuffer = buffer.asObject(runtime).getArrayBuffer(runtime);
+    size_t bufferSize = arrayBuffer.size(runtime);
+    size_t byteOffset = 0;
+    if (!byteCountFromValue(out.getProperty(runtime, "byteOffset"), bufferSize, byteOffset) ||
+        kStatsFieldCount * sizeof(double) > bufferSize - byteOffset) {
+        throw JSError(runtime, badOutput);
+    }
+    
+    // Filled locally and copied, so the destination needs no particular alignment
+    double fields[kStatsFieldCount];
+    fields[0] = (double)counters.rxPackets;
+    fields[1] = (double)counters.rxBytes;
+    fields[2] = (double)counters.txPackets;
+    fields[3] = (double)counters.txBytes;
+    fields[4] = (double)counters.sendFailures;
+    fields[5] = (double)(counters.drops + ringDrops);
+    fields[6] = (double)counters.queueDepth;
+    writeLatencySummary(fields + kSocketStatsFields, g_stats->receiveLatency().summary());
+    writeLatencySummary(fields + kSocketStatsFields + kLatencyStatsFields, g_stats->sendLatency().summary());
+    memcpy(arrayBuffer.data(runtime) + byteOffset, fields, sizeof(fields));
+    
+    return Value(runtime, out);
+}
+
+Value UDPDirectJSI::now(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    return Value(nsToMs(udpdirect::UDPMonotonicNowNs()));
+}
+
+static Value interfaceTableToValue(Runtime& runtime, const udpdirect::UDPInterfaceTable& table) {
+    auto interfaces = Array(runtime, table.interfaces.size());
+    for (size_t i = 0; i < table.interfaces.size(); i++) {
+        const udpdirect::UDPInterface& interface = table.interfaces[i];
+        auto addresses = Array(runtime, interface.addresses.size());
+        for (size_t j = 0; j < interface.addresses.size(); j++) {
+            const udpdirect::UDPSocketAddress& address = interface.addresses[j];
+            auto entry = Object(runtime);
+            entry.setProperty(runtime, "address", String::createFromUtf8(runtime, address.hostString()));
+            entry.setProperty(runtime, "family", String::createFromAscii(runtime, address.isIPv6() ? "IPv6" : "IPv4"));
+            addresses.setValueAtIndex(runtime, j, std::move(entry));
         }
-        
-        NSLog(@"[UDPDirectJSI] Bound socket %@ to %@:%d", socketId, address, port);
-        return Value::undefined();
-        
-    } @catch (NSException *exception) {
-        std::string error = "Native exception: " + std::string([exception.reason UTF8String]);
-        throw JSError(runtime, error);
+        auto entry = Object(runtime);
+        entry.setProperty(runtime, "index", Value((double)interface.index));
+        entry.setProperty(runtime, "name", String::createFromUtf8(runtime, interface.name));
+        entry.setProperty(runtime, "mtu", Value((double)interface.mtu));
+        entry.setProperty(runtime, "up", Value(interface.isUp()));
+        entry.setProperty(runtime, "loopback", Value(interface.isLoopback()));
+        entry.setProperty(runtime, "multicast", Value(interface.supportsMulticast()));
+        entry.setProperty(runtime, "addresses", std::move(addresses));
+        interfaces.setValueAtIndex(runtime, i, std::move(entry));
     }
+    auto result = Object(runtime);
+    result.setProperty(runtime, "version", Value((double)table.version));
+    result.setProperty(runtime, "interfaces", std::move(interfaces));
+    return result;
 }
 
-Value UDPDirectJSI::closeSocket(
+Value UDPDirectJSI::getInterfaces(
     Runtime& runtime,
     const Value& thisValue,
     const Value* arguments,
     size_t count
 ) {
-    if (count != 1 || !arguments[0].isString()) {
-        throw JSError(runtime, "close expects 1 string argument: socketId");
+    if (count > 1 || (count == 1 && !arguments[0].isNumber() && !arguments[0].isUndefined())) {
+        throw JSError(runtime, "getInterfaces expects an optional sinceVersion number");
     }
-    
-    @try {
-        std::string socketIdStr = arguments[0].getString(runtime).utf8(runtime);
-        NSNumber *socketId = @(std::stoi(socketIdStr));
-        
-        UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
-        [manager closeSocket:socketId];
-        
-        NSLog(@"[UDPDirectJSI] Closed socket %@", socketId);
-        return Value::undefined();
-        
-    } @catch (NSException *exception) {
-        std::string error = "Native exception: " + std::string([exception.reason UTF8String]);
-        throw JSError(runtime, error);
+    UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+    std::shared_ptr<const udpdirect::UDPInterfaceTable> table = [manager interfaceMonitor]->table();
+    // Cheap to poll: nothing is built while the caller's version is current
+    if (count == 1 && arguments[0].isNumber() && (uint64_t)arguments[0].asNumber() == table->version) {
+        return Value::null();
     }
+    return interfaceTableToValue(runtime, *table);
 }
 
-Value UDPDirectJSI::setEventHandler(
+Value UDPDirectJSI::refreshInterfaces(
     Runtime& runtime,
     const Value& thisValue,
     const Value* arguments,
     size_t count
 ) {
-    if (count != 2 || !arguments[0].isString() || !arguments[1].isObject()) {
-        throw JSError(runtime, "setEventHandler expects socketId and handler object");
+    UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+    std::shared_ptr<udpdirect::UDPInterfaceMonitor> monitor = [manager interfaceMonitor];
+    if (monitor->refresh()) {
+        [manager applyInterfaceTable];
     }
-    
-    @try {
-        std::string socketIdStr = arguments[0].getString(runtime).utf8(runtime);
-        NSNumber *socketId = @(std::stoi(socketIdStr));
-        
-        auto handlerObj = arguments[1].asObject(runtime);
-        
-        // Store handlers as shared pointers to keep them alive
-        std::shared_ptr<Function> onMessage;
-        std::shared_ptr<Function> onError;
-        std::shared_ptr<Function> onClose;
-        
-        if (handlerObj.hasProperty(runtime, "onMessage")) {
-            auto msgHandler = handlerObj.getProperty(runtime, "onMessage");
-            if (msgHandler.isObject() && msgHandler.asObject(runtime).isFunction(runtime)) {
-                onMessage = std::make_shared<Function>(msgHandler.asObject(runtime).asFunction(runtime));
-            }
-        }
-        
-        if (handlerObj.hasProperty(runtime, "onError")) {
-            auto errHandler = handlerObj.getProperty(runtime, "onError");
-            if (errHandler.isObject() && errHandler.asObject(runtime).isFunction(runtime)) {
-                onError = std::make_shared<Function>(errHandler.asObject(runtime).asFunction(runtime));
-            }
-        }
-        
-        if (handlerObj.hasProperty(runtime, "onClose")) {
-            auto closeHandler = handlerObj.getProperty(runtime, "onClose");
-            if (closeHandler.isObject() && closeHandler.asObject(runtime).isFunction(runtime)) {
-                onClose = std::make_shared<Function>(closeHandler.asObject(runtime).asFunction(runtime));
-            }
-        }
-        
-        // Set up native callbacks that invoke JSI functions
-        UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
-        
-        if (onMessage) {
-            // Capture the handler
-            auto messageHandler = onMessage;
-            
-            manager.onDataReceived = ^(NSNumber* sockId, NSData* data, NSString* host, uint16_t port, NSNumber* bufferId) {
-                // Capture the data we need
-                std::string socketIdStr = [[sockId stringValue] UTF8String];
-                std::string hostStr = [host UTF8String];
-                uint16_t portNum = port;
-                
-                // Create a mutable copy for the buffer
-                NSMutableData *mutableData = [data mutableCopy];
-                
-                // Get the JS invoker
-                auto jsInvoker = g_jsInvoker.lock();
-                if (!jsInvoker) {
-                    NSLog(@"[UDPDirectJSI] JS invoker no longer available");
-                    return;
-                }
-                
-                // Use the JS invoker to run on the JS thread
-                // IMPORTANT: Use g_runtime (global pointer) instead of &runtime (dangling reference)
-                jsInvoker->invokeAsync([messageHandler, socketIdStr, hostStr, portNum, mutableData]() {
-                    try {
-                        if (!g_runtime) {
-                            NSLog(@"[UDPDirectJSI] Runtime no longer available");
-                            return;
-                        }
-                        Runtime& rt = *g_runtime;
-
-                        // Create a MutableBuffer that wraps NSData
-                        auto buffer = std::make_shared<NSDataBuffer>(mutableData);
-
-                        // Create ArrayBuffer from the MutableBuffer
-                        auto arrayBuffer = ArrayBuffer(rt, buffer);
-
-                        // Create event object
-                        auto event = Object(rt);
-                        event.setProperty(rt, "socketId", String::createFromUtf8(rt, socketIdStr));
-                        event.setProperty(rt, "data", std::move(arrayBuffer));
-                        event.setProperty(rt, "address", String::createFromUtf8(rt, hostStr));
-                        event.setProperty(rt, "port", Value((double)portNum));
-
-                        // Call handler
-                        messageHandler->call(rt, event);
-
-                        NSLog(@"[UDPDirectJSI] Zero-copy message delivered: %zu bytes from %s:%d",
-                              mutableData.length, hostStr.c_str(), portNum);
-
-                        // The buffer will be automatically released when the ArrayBuffer is GC'd
-                    } catch (const std::exception& e) {
-                        NSLog(@"[UDPDirectJSI] Error in message handler: %s", e.what());
-                    }
-                });
-            };
-        }
-        
-        if (onError) {
-            manager.onSendFailure = ^(NSNumber* sockId, long tag, NSError* error) {
-                if (!g_runtime) return;
+    return interfaceTableToValue(runtime, *monitor->table());
+}
+
+Value UDPDirectJSI::setInterfaceChangeHandler(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 1 || !(arguments[0].isNull() || (arguments[0].isObject() && arguments[0].asObject(runtime).isFunction(runtime)))) {
+        throw JSError(runtime, "setInterfaceChangeHandler expects a function or null");
+    }
+    UDPSocketManager *manager = (__bridge UDPSocketManager *)getSocketManager(runtime);
+    if (arguments[0].isNull()) {
+        g_interfaceChangeHandler.reset();
+        manager.onInterfacesChanged = nil;
+        return Value::undefined();
+    }
+    g_interfaceChangeHandler = std::make_shared<Function>(arguments[0].asObject(runtime).asFunction(runtime));
+    manager.onInterfacesChanged = ^(uint64_t version) {
+        auto jsInvoker = g_jsInvoker.lock();
+        if (!jsInvoker) return;
+        jsInvoker->invokeAsync([version]() {
+            if (!g_runtime || !g_interfaceChangeHandler) return;
+            auto handler = g_interfaceChangeHandler;
+            try {
                 Runtime& rt = *g_runtime;
                 auto event = Object(rt);
-                event.setProperty(rt, "socketId", String::createFromUtf8(rt, [[sockId stringValue] UTF8String]));
-                event.setProperty(rt, "error", String::createFromUtf8(rt, [[error localizedDescription] UTF8String]));
+                event.setProperty(rt, "version", Value((double)version));
+                handler->call(rt, event);
+            } catch (const std::exception& e) {
+                NSLog(@"[UDPDirectJSI] Error in interface change handler: %s", e.what());
+            }
+        });
+    };
+    return Value::undefined();
+}
 
-                onError->call(rt, event);
-            };
-        }
+static Value captureStatsToValue(Runtime& runtime, const udpdirect::UDPCaptureStats& stats) {
+    auto result = Object(runtime);
+    result.setProperty(runtime, "active", Value(stats.active));
+    result.setProperty(runtime, "captured", Value((double)stats.captured));
+    result.setProperty(runtime, "dropped", Value((double)stats.dropped));
+    result.setProperty(runtime, "truncated", Value((double)stats.truncated));
+    result.setProperty(runtime, "bytesWritten", Value((double)stats.bytesWritten));
+    result.setProperty(runtime, "writeErrors", Value((double)stats.writeErrors));
+    result.setProperty(runtime, "ringBytes", Value((double)stats.ringBytes));
+    result.setProperty(runtime, "ringHighWater", Value((double)stats.ringHighWater));
+    return result;
+}
 
-        if (onClose) {
-            manager.onSocketClosed = ^(NSNumber* sockId, NSError* _Nullable error) {
-                if (!g_runtime) return;
-                Runtime& rt = *g_runtime;
-                auto event = Object(rt);
-                event.setProperty(rt, "socketId", String::createFromUtf8(rt, [[sockId stringValue] UTF8String]));
-                if (error) {
-                    event.setProperty(rt, "error", String::createFromUtf8(rt, [[error localizedDescription] UTF8String]));
-                }
+Value UDPDirectJSI::startCapture(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count < 1 || count > 2 || !arguments[0].isString() ||
+        (count == 2 && !arguments[1].isObject() && !arguments[1].isUndefined())) {
+        throw JSError(runtime, "startCapture expects a path and optional { snapLength, ringBytes }");
+    }
+    udpdirect::UDPCaptureConfig config;
+    if (count == 2 && arguments[1].isObject()) {
+        auto options = arguments[1].asObject(runtime);
+        config.snapLength = optionalUint32(runtime, options, "snapLength", config.snapLength);
+        config.ringBytes = optionalUint32(runtime, options, "ringBytes", (uint32_t)config.ringBytes);
+    }
+    UDPSocketManager* manager = (__bridge UDPSocketManager*)getSocketManager(runtime);
+    std::string error = [manager capture]->start(arguments[0].getString(runtime).utf8(runtime), config);
+    if (!error.empty()) {
+        throw JSError(runtime, "startCapture: " + error);
+    }
+    return Value::undefined();
+}
+
+Value UDPDirectJSI::stopCapture(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    UDPSocketManager* manager = (__bridge UDPSocketManager*)getSocketManager(runtime);
+    std::shared_ptr<udpdirect::UDPCapture> capture = [manager capture];
+    std::shared_ptr<PendingPromise> pending;
+    Value promise = createPromise(runtime, pending);
+    // Waits for the writer to empty the ring, which is disk-bound
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        capture->stop();
+        udpdirect::UDPCaptureStats stats = capture->stats();
+        settlePromise(pending, std::string(), [stats](Runtime& rt) { return captureStatsToValue(rt, stats); });
+    });
+    return promise;
+}
+
+Value UDPDirectJSI::getCaptureStats(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    UDPSocketManager* manager = (__bridge UDPSocketManager*)getSocketManager(runtime);
+    return captureStatsToValue(runtime, [manager capture]->stats());
+}
 
-                onClose->call(rt, event);
-            };
+Value UDPDirectJSI::replay(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count < 2 || count > 3 || !isSocketIdValue(arguments[0]) || !arguments[1].isString() ||
+        (count == 3 && !arguments[2].isObject() && !arguments[2].isUndefined())) {
+        throw JSError(runtime, "replay expects socketId, path and optional { speed, recordedSocketId }");
+    }
+    uint32_t socketId = socketIdFromValue(runtime, arguments[0]);
+    udpdirect::UDPCaptureReplay::Options options;
+    if (count == 3 && arguments[2].isObject()) {
+        auto object = arguments[2].asObject(runtime);
+        auto speed = object.getProperty(runtime, "speed");
+        if (!speed.isUndefined()) {
+            if (!speed.isNumber() || !(speed.asNumber() >= 0)) {
+                throw JSError(runtime, "replay speed must be a non-negative number, 0 for as fast as possible");
+            }
+            options.speed = speed.asNumber();
         }
-        
-        // Start receiving
-        [manager startReceivingOnBoundSockets];
-        
-        NSLog(@"[UDPDirectJSI] Event handlers set for socket %@", socketId);
-        return Value::undefined();
-        
-    } @catch (NSException *exception) {
-        std::string error = "Native exception: " + std::string([exception.reason UTF8String]);
-        throw JSError(runtime, error);
+        options.socketId = optionalUint32(runtime, object, "recordedSocketId", 0);
+    }
+    
+    auto reader = std::make_unique<udpdirect::UDPCaptureReader>();
+    std::string error = reader->open(arguments[1].getString(runtime).utf8(runtime));
+    if (!error.empty()) {
+        throw JSError(runtime, "replay: " + error);
+    }
+    auto replay = std::make_shared<udpdirect::UDPCaptureReplay>(std::move(reader), options);
+    
+    UDPSocketManager* manager = (__bridge UDPSocketManager*)getSocketManager(runtime);
+    std::shared_ptr<PendingPromise> pending;
+    Value promise = createPromise(runtime, pending);
+    uint64_t startedNs = udpdirect::UDPMonotonicNowNs();
+    [manager startReplay:replay onSocket:@(socketId) completion:^(uint64_t delivered, uint64_t skipped, NSError* _Nullable replayError) {
+        if (replayError) {
+            settlePromise(pending, errorMessage("Replay failed", replayError), nullptr);
+            return;
+        }
+        double durationMs = nsToMs(udpdirect::UDPMonotonicNowNs() - startedNs);
+        settlePromise(pending, std::string(), [delivered, skipped, durationMs](Runtime& rt) {
+            auto result = Object(rt);
+            result.setProperty(rt, "delivered", Value((double)delivered));
+            result.setProperty(rt, "skipped", Value((double)skipped));
+            result.setProperty(rt, "durationMs", Value(durationMs));
+            return Value(rt, result);
+        });
+    }];
+    return promise;
+}
+
+Value UDPDirectJSI::stopReplay(
+    Runtime& runtime,
+    const Value& thisValue,
+    const Value* arguments,
+    size_t count
+) {
+    if (count != 1 || !isSocketIdValue(arguments[0])) {
+        throw JSError(runtime, "stopReplay expects socketId");
     }
+    UDPSocketManager* manager = (__bridge UDPSocketManager*)getSocketManager(runtime);
+    [manager stopReplayOnSocket:@(socketIdFromValue(runtime, arguments[0]))];
+    return Value::undefined();
 }
 
 } // namespace react
-} // namespace facebook
\ No newline at end of file
+} // namespace facebook
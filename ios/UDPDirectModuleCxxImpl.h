@@ -1,9 +1,13 @@
 #pragma once
 
 // Standard C++ Headers
+#include <functional>
 #include <optional>
 #include <memory>
+#include <string>
 #include <map>
+#include <mutex>
+#include <unordered_map>
 
 // React Native / JSI / Codegen Headers
 #include <UDPDirectModuleSpecJSI.h>
@@ -33,6 +37,9 @@ public:
     jsi::Value close(jsi::Runtime &rt, jsi::String socketId);
     jsi::Value closeAllSockets(jsi::Runtime &rt);
     jsi::Value send(jsi::Runtime &rt, jsi::String socketId, jsi::String base64Data, double port, jsi::String address, std::optional<jsi::Object> options);
+    jsi::Value sendBinary(jsi::Runtime &rt, jsi::String socketId, jsi::Object data, double port, jsi::String address, std::optional<jsi::Object> options);
+    void setBinaryMessageHandler(jsi::Runtime &rt, jsi::String socketId, jsi::Function handler);
+    void removeBinaryMessageHandler(jsi::Runtime &rt, jsi::String socketId);
     /*
      * The following advanced zero-copy APIs are temporarily disabled while we
      * migrate to a dedicated JSI binding.  They are left here for future
@@ -41,7 +48,6 @@ public:
      * virtuals).
      */
 #if 0
-    jsi::Value sendBinary(jsi::Runtime &rt, jsi::String socketId, jsi::Object data, double port, jsi::String address, std::optional<jsi::Object> options);
     // Buffer management methods for zero-copy operations
     jsi::Value sendFromArrayBuffer(jsi::Runtime &rt, jsi::String socketId, double bufferId, double offset, double length, double port, jsi::String address, std::optional<jsi::Object> options);
     jsi::Value createSharedArrayBuffer(jsi::Runtime &rt, double size);
@@ -64,8 +70,8 @@ public:
     // Event emission method for TurboModule events  
     void emitDeviceEvent(const std::string& eventName, const std::function<void(jsi::Runtime& rt, jsi::Object& eventData)>& eventDataBuilder);
     
-    // Simplified event emission for testing - just logs events
-    void logEvent(const std::string& eventName, const std::string& data);
+    // Logs an event in debug builds (UDP_LOG_LEVEL_DEBUG); does nothing otherwise
+    static void logEvent(const std::string& eventName, const std::string& data);
     
     // Set socket manager and install JSI
     void setSocketManager(void* socketManager);
@@ -82,13 +88,47 @@ private:
     // Event listener registry
     std::map<std::string, int> eventListenerCounts_;
     
+    // Per-socket ArrayBuffer message handlers. The functions are only touched on the JS
+    // thread; the delegate queue only checks whether a socket has one, under the mutex.
+    // Callbacks hold this weakly rather than the module, so one that runs after the module
+    // is destroyed finds it gone instead of reaching through a dangling pointer.
+    struct BinaryHandlers {
+        std::mutex mutex;
+        std::unordered_map<uint32_t, std::shared_ptr<jsi::Function>> handlers;
+        jsi::Runtime* runtime = nullptr; // Runtime the handlers belong to
+    };
+    std::shared_ptr<BinaryHandlers> binaryHandlers_;
+    
+    // What a control call's completion needs to settle its promise. Completions hold this
+    // weakly, like BinaryHandlers, so one that lands after the module is destroyed drops
+    // its promise instead of reading members of a freed module.
+    struct PromiseContext {
+        jsi::Runtime* runtime = nullptr; // Runtime for promise results settled from invokeAsync
+    };
+    std::shared_ptr<PromiseContext> promiseContext_;
+    
     // Helper methods
 #ifdef __OBJC__
     UDPSocketManager* getSocketManager();
+    
+    // Hands a datagram to the socket's binary handler; false if it has none
+    static bool deliverBinaryMessage(const std::shared_ptr<BinaryHandlers>& binaryHandlers,
+                                     const std::shared_ptr<CallInvoker>& jsInvoker,
+                                     uint32_t socketId, NSData* data, NSString* host, uint16_t port);
 #endif
     
     // Install JSI bindings
     void installJSIBindings(jsi::Runtime& runtime);
+    
+    // Manager callbacks shared by setDataEventHandler and setBinaryMessageHandler
+    void installSocketCallbacks();
+
+    // Settles a control call's promise on the JS thread; an empty error resolves with `result`
+    static void settlePromise(const std::weak_ptr<PromiseContext>& context,
+                              const std::shared_ptr<CallInvoker>& jsInvoker,
+                              std::shared_ptr<Promise> promise, std::string error,
+                              std::function<jsi::Value(jsi::Runtime&)> result);
+
 };
 
 } // namespace react
@@ -8,19 +8,99 @@
 #import <ReactCommon/TurboModuleUtils.h>
 #include <memory>
 #include <functional>
+#include "UDPLog.h"
+#include "UDPSocketAddress.h"
+
+// Per-packet logging; compiled out unless UDP_LOG_LEVEL is UDP_LOG_LEVEL_DEBUG
+#if UDP_LOG_ENABLED(UDP_LOG_LEVEL_DEBUG)
+#define UDP_CXX_DEBUG(fmt, ...) NSLog(@"[UDPDirectModuleCxxImpl] " fmt, ##__VA_ARGS__)
+#else
+#define UDP_CXX_DEBUG(fmt, ...) do { } while (0)
+#endif
 
 namespace facebook {
 namespace react {
 
 using namespace facebook::jsi;
 
+// ArrayBuffer storage over a received NSData, kept alive until JS collects the buffer
+class NSDataArrayBuffer : public jsi::MutableBuffer {
+public:
+    explicit NSDataArrayBuffer(NSData* data) : data_(data) {}
+    
+    size_t size() const override {
+        return data_.length;
+    }
+    
+    uint8_t* data() override {
+        return (uint8_t*)data_.bytes;
+    }
+    
+private:
+    NSData* data_;
+};
+
+// Accepts an ArrayBuffer or any view over one (Uint8Array, DataView, ...)
+static bool binaryPayload(jsi::Runtime& rt, const jsi::Object& data, const uint8_t*& bytes, size_t& length) {
+    if (data.isArrayBuffer(rt)) {
+        auto buffer = data.getArrayBuffer(rt);
+        bytes = buffer.data(rt);
+        length = buffer.size(rt);
+        return true;
+    }
+    auto bufferValue = data.getProperty(rt, "buffer");
+    auto byteOffset = data.getProperty(rt, "byteOffset");
+    auto byteLength = data.getProperty(rt, "byteLength");
+    if (!bufferValue.isObject() || !byteOffset.isNumber() || !byteLength.isNumber()) {
+        return false;
+    }
+    auto bufferObject = bufferValue.asObject(rt);
+    if (!bufferObject.isArrayBuffer(rt)) {
+        return false;
+    }
+    auto buffer = bufferObject.getArrayBuffer(rt);
+    size_t offset = (size_t)byteOffset.asNumber();
+    length = (size_t)byteLength.asNumber();
+    if (offset + length > buffer.size(rt)) {
+        return false;
+    }
+    bytes = buffer.data(rt) + offset;
+    return true;
+}
+
+// Socket ids cross the spec as decimal strings; anything else is a JS error, not a C++ throw
+static uint32_t socketIdFromString(jsi::Runtime& rt, const jsi::String& socketId) {
+    std::string text = socketId.utf8(rt);
+    bool valid = !text.empty() && text.size() <= 10;
+    uint64_t value = 0;
+    for (size_t i = 0; valid && i < text.size(); i++) {
+        valid = text[i] >= '0' && text[i] <= '9';
+        value = value * 10 + (uint64_t)(text[i] - '0');
+    }
+    if (!valid || value > UINT32_MAX) {
+        throw jsi::JSError(rt, "Invalid socket id: '" + text + "'");
+    }
+    return (uint32_t)value;
+}
+
+// Sends complete on the delegate queue without a per-send callback, so their promise only
+// reports that the datagram was handed off; failures arrive as 'error' events
+static jsi::Value resolvedPromise(jsi::Runtime& rt) {
+    return createPromiseAsJSIValue(rt, [](jsi::Runtime& rt, std::shared_ptr<Promise> promise) {
+        promise->resolve(jsi::Value::undefined());
+        promise->allowRelease();
+    });
+}
+
 // Constructor - use the template base class constructor  
 UDPDirectModuleCxxImpl::UDPDirectModuleCxxImpl(std::shared_ptr<CallInvoker> jsInvoker)
   : NativeUDPDirectModuleCxxSpec<UDPDirectModuleCxxImpl>(jsInvoker),
     socketManager_(nullptr),
     isBeingDestroyed_(false),
     jsInvoker_(jsInvoker),
-    jsiInstalled_(false) {
+    jsiInstalled_(false),
+    binaryHandlers_(std::make_shared<BinaryHandlers>()),
+    promiseContext_(std::make_shared<PromiseContext>()) {
     
     NSLog(@"[UDPDirectModuleCxxImpl] Lightweight TurboModule initialization - deferring resource allocation");
     // Note: Socket manager will be created lazily when first needed
@@ -32,6 +112,15 @@ UDPDirectModuleCxxImpl::~UDPDirectModuleCxxImpl() {
     // Set destruction flag IMMEDIATELY to prevent any callback execution
     isBeingDestroyed_ = true;
     
+    // Callbacks still queued find the handlers expired; the functions go here, on the JS thread
+    {
+        std::lock_guard<std::mutex> lock(binaryHandlers_->mutex);
+        binaryHandlers_->handlers.clear();
+        binaryHandlers_->runtime = nullptr;
+    }
+    binaryHandlers_.reset();
+    promiseContext_.reset();
+    
     // Simple cleanup - socket manager may not even exist if never used
     if (socketManager_) {
         NSLog(@"[UDPDirectModuleCxxImpl] Releasing socket manager");
@@ -69,8 +158,8 @@ UDPSocketManager* UDPDirectModuleCxxImpl::getSocketManager() {
         UDPSocketManager *manager = [[UDPSocketManager alloc] initWithDelegateQueue:udpQueue];
         
         // Initialize with safe default callbacks
-        manager.onDataReceived = ^(NSNumber* socketId, NSData* data, NSString* host, uint16_t port, NSNumber* bufferId) {
-            NSLog(@"[UDPDirectModuleCxxImpl] Default data callback - socket %@", socketId);
+        manager.onDataReceived = ^(NSNumber* socketId, NSData* data, NSString* host, uint16_t port, NSNumber* _Nullable bufferId) {
+            UDP_CXX_DEBUG(@"Default data callback - socket %@", socketId);
         };
         
         manager.onSocketClosed = ^(NSNumber* socketId, NSError* _Nullable error) {
@@ -78,7 +167,7 @@ UDPSocketManager* UDPDirectModuleCxxImpl::getSocketManager() {
         };
         
         manager.onSendSuccess = ^(NSNumber* socketId, long tag) {
-            NSLog(@"[UDPDirectModuleCxxImpl] Default success callback - socket %@", socketId);
+            UDP_CXX_DEBUG(@"Default success callback - socket %@", socketId);
         };
         
         manager.onSendFailure = ^(NSNumber* socketId, long tag, NSError* error) {
@@ -129,6 +218,39 @@ void UDPDirectModuleCxxImpl::removeListeners(jsi::Runtime &rt, double count) {
 }
 
 // UDP SOCKET METHOD IMPLEMENTATIONS
+// Settles a promise from createPromiseAsJSIValue on the JS thread. Manager completions arrive on
+// its delegate queue, so control calls never wait for that queue on the JS thread. The context
+// is checked there too, where the module is destroyed, so a promise outliving it is dropped.
+void UDPDirectModuleCxxImpl::settlePromise(const std::weak_ptr<PromiseContext>& context,
+                                           const std::shared_ptr<CallInvoker>& jsInvoker,
+                                           std::shared_ptr<Promise> promise, std::string error,
+                                           std::function<jsi::Value(jsi::Runtime&)> result) {
+    if (!jsInvoker) {
+        return;
+    }
+    jsInvoker->invokeAsync([context, promise, error = std::move(error), result = std::move(result)]() {
+        std::shared_ptr<PromiseContext> liveContext = context.lock();
+        if (!liveContext) {
+            return;
+        }
+        if (error.empty()) {
+            jsi::Runtime* runtime = liveContext->runtime;
+            promise->resolve(result && runtime ? result(*runtime) : jsi::Value::undefined());
+        } else {
+            promise->reject(error);
+        }
+        promise->allowRelease();
+    });
+}
+
+static std::string managerErrorMessage(const char* what, NSError* error) {
+    std::string message = what;
+    if (error) {
+        message += ": " + std::string([[error localizedDescription] UTF8String]);
+    }
+    return message;
+}
+
 jsi::Value UDPDirectModuleCxxImpl::createSocket(jsi::Runtime &rt, jsi::Object options) {
     NSLog(@"[UDPDirectModuleCxxImpl] createSocket called - creating REAL socket");
     
@@ -179,6 +301,14 @@ jsi::Value UDPDirectModuleCxxImpl::createSocket(jsi::Runtime &rt, jsi::Object op
             }
         }
         
+        // Extract receiveQueue option
+        if (options.hasProperty(rt, "receiveQueue")) {
+            jsi::Value receiveQueueValue = options.getProperty(rt, "receiveQueue");
+            if (receiveQueueValue.isNumber() && receiveQueueValue.asNumber() >= 0) {
+                nsOptions[@"receiveQueue"] = @((NSUInteger)receiveQueueValue.asNumber());
+            }
+        }
+        
         // Extract broadcast option
         if (options.hasProperty(rt, "broadcast")) {
             jsi::Value broadcastValue = options.getProperty(rt, "broadcast");
@@ -190,27 +320,28 @@ jsi::Value UDPDirectModuleCxxImpl::createSocket(jsi::Runtime &rt, jsi::Object op
         
         NSLog(@"[UDPDirectModuleCxxImpl] Creating socket with options: %@", nsOptions);
         
-        // Create the actual socket using the manager
-        NSError *error = nil;
-        NSNumber *socketId = [manager createSocketWithOptions:nsOptions error:&error];
-        
-        if (!socketId) {
-            std::string errorMsg = "Failed to create UDP socket";
-            if (error) {
-                errorMsg += ": " + std::string([[error localizedDescription] UTF8String]);
-                NSLog(@"[UDPDirectModuleCxxImpl] Socket creation failed: %@", error);
-            }
-            throw jsi::JSError(rt, errorMsg);
-        }
-        
-        NSLog(@"[UDPDirectModuleCxxImpl] Socket created successfully with ID: %@", socketId);
-        
-        // Return socket object with the REAL socketId as string
-        auto socketObj = jsi::Object(rt);
-        socketObj.setProperty(rt, "socketId", jsi::String::createFromUtf8(rt, [[socketId stringValue] UTF8String]));
-        
-        NSLog(@"[UDPDirectModuleCxxImpl] Returning real socket object with ID: %@", socketId);
-        return socketObj;
+        // Create the actual socket using the manager, without waiting for its queue
+        promiseContext_->runtime = &rt;
+        std::weak_ptr<PromiseContext> context = promiseContext_;
+        std::shared_ptr<CallInvoker> jsInvoker = jsInvoker_;
+        return createPromiseAsJSIValue(rt, [context, jsInvoker, manager, nsOptions](jsi::Runtime &rt, std::shared_ptr<Promise> promise) {
+            [manager createSocketWithOptions:nsOptions completion:^(NSNumber* socketId, NSError* error) {
+                if (!socketId) {
+                    NSLog(@"[UDPDirectModuleCxxImpl] Socket creation failed: %@", error);
+                    settlePromise(context, jsInvoker, promise, managerErrorMessage("Failed to create UDP socket", error), nullptr);
+                    return;
+                }
+                NSLog(@"[UDPDirectModuleCxxImpl] Socket created successfully with ID: %@", socketId);
+                
+                // Resolve with the REAL socketId as string
+                std::string socketIdString = [[socketId stringValue] UTF8String];
+                settlePromise(context, jsInvoker, promise, std::string(), [socketIdString](jsi::Runtime &rt) -> jsi::Value {
+                    auto socketObj = jsi::Object(rt);
+                    socketObj.setProperty(rt, "socketId", jsi::String::createFromUtf8(rt, socketIdString));
+                    return socketObj;
+                });
+            }];
+        });
         
     } catch (const jsi::JSError& e) {
         NSLog(@"[UDPDirectModuleCxxImpl] JSI Error in createSocket: %s", e.getMessage().c_str());
@@ -232,26 +363,33 @@ jsi::Value UDPDirectModuleCxxImpl::bind(jsi::Runtime &rt, jsi::String socketId,
         }
         
         // Convert string socketId to NSNumber
-        std::string socketIdStr = socketId.utf8(rt);
-        NSNumber *nsSocketId = @(std::stoi(socketIdStr));
+        NSNumber *nsSocketId = @(socketIdFromString(rt, socketId));
         NSString *nsAddress = [NSString stringWithUTF8String:address.utf8(rt).c_str()];
         
         NSLog(@"[UDPDirectModuleCxxImpl] Binding socket %@ to %@:%d", nsSocketId, nsAddress, (int)port);
         
-        NSError *error = nil;
-        BOOL success = [manager bindSocket:nsSocketId toPort:(uint16_t)port address:nsAddress error:&error];
-        
-        if (success) {
-            NSLog(@"[UDPDirectModuleCxxImpl] Successfully bound socket %@ to %@:%d", nsSocketId, nsAddress, (int)port);
-            return jsi::Value::undefined();
-        } else {
-            std::string errorMsg = "Failed to bind socket";
-            if (error) {
-                errorMsg += ": " + std::string([[error localizedDescription] UTF8String]);
-                NSLog(@"[UDPDirectModuleCxxImpl] Bind failed: %@", error);
-            }
-            throw jsi::JSError(rt, errorMsg);
-        }
+        // Resolves with the bound address and port, per BindInfoSpec
+        promiseContext_->runtime = &rt;
+        std::weak_ptr<PromiseContext> context = promiseContext_;
+        std::shared_ptr<CallInvoker> jsInvoker = jsInvoker_;
+        return createPromiseAsJSIValue(rt, [context, jsInvoker, manager, nsSocketId, nsAddress, port](jsi::Runtime &rt, std::shared_ptr<Promise> promise) {
+            [manager bindSocket:nsSocketId toPort:(uint16_t)port address:nsAddress completion:^(NSDictionary* addressInfo, NSError* error) {
+                if (error) {
+                    NSLog(@"[UDPDirectModuleCxxImpl] Bind failed: %@", error);
+                    settlePromise(context, jsInvoker, promise, managerErrorMessage("Failed to bind socket", error), nullptr);
+                    return;
+                }
+                NSLog(@"[UDPDirectModuleCxxImpl] Successfully bound socket %@ to %@:%d", nsSocketId, nsAddress, (int)port);
+                std::string boundAddress = addressInfo[@"address"] ? [addressInfo[@"address"] UTF8String] : "";
+                double boundPort = [addressInfo[@"port"] doubleValue];
+                settlePromise(context, jsInvoker, promise, std::string(), [boundAddress, boundPort](jsi::Runtime &rt) -> jsi::Value {
+                    auto bindInfo = jsi::Object(rt);
+                    bindInfo.setProperty(rt, "address", jsi::String::createFromUtf8(rt, boundAddress));
+                    bindInfo.setProperty(rt, "port", jsi::Value(boundPort));
+                    return bindInfo;
+                });
+            }];
+        });
         
     } catch (const jsi::JSError& e) {
         NSLog(@"[UDPDirectModuleCxxImpl] JSI Error in bind: %s", e.getMessage().c_str());
@@ -270,8 +408,7 @@ jsi::Value UDPDirectModuleCxxImpl::close(jsi::Runtime &rt, jsi::String socketId)
         }
         
         // Convert string socketId to NSNumber
-        std::string socketIdStr = socketId.utf8(rt);
-        NSNumber *nsSocketId = @(std::stoi(socketIdStr));
+        NSNumber *nsSocketId = @(socketIdFromString(rt, socketId));
         [manager closeSocket:nsSocketId];
         
         NSLog(@"[UDPDirectModuleCxxImpl] Successfully closed socket %@", nsSocketId);
@@ -308,22 +445,23 @@ jsi::Value UDPDirectModuleCxxImpl::send(jsi::Runtime &rt, jsi::String socketId,
         }
         
         // Convert string socketId to NSNumber
-        std::string socketIdStr = socketId.utf8(rt);
-        NSNumber *nsSocketId = @(std::stoi(socketIdStr));
-        NSString *nsBase64Data = [NSString stringWithUTF8String:base64Data.utf8(rt).c_str()];
+        NSNumber *nsSocketId = @(socketIdFromString(rt, socketId));
+        std::string base64Str = base64Data.utf8(rt);
         NSString *nsAddress = [NSString stringWithUTF8String:address.utf8(rt).c_str()];
         
-        // Decode base64 data
-        NSData *nsData = [[NSData alloc] initWithBase64EncodedString:nsBase64Data options:0];
+        // Compatibility path; sendBinary avoids the encoding entirely. Decode straight from
+        // the UTF-8 bytes rather than through an NSString.
+        NSData *base64Bytes = [NSData dataWithBytesNoCopy:(void *)base64Str.data() length:base64Str.size() freeWhenDone:NO];
+        NSData *nsData = [[NSData alloc] initWithBase64EncodedData:base64Bytes options:0];
         if (!nsData) {
             throw jsi::JSError(rt, "Invalid base64 data");
         }
         
-        // Send data (this is async, so we use tag 0 for now)
-        [manager sendData:nsData onSocket:nsSocketId toHost:nsAddress port:(uint16_t)port tag:0];
+        // Send data (async; the tag matches the completion callback to this send)
+        [manager sendData:nsData onSocket:nsSocketId toHost:nsAddress port:(uint16_t)port tag:[manager nextSendTag]];
         
-        NSLog(@"[UDPDirectModuleCxxImpl] Initiated send from socket %@", nsSocketId);
-        return jsi::Value::undefined();
+        UDP_CXX_DEBUG(@"Initiated send from socket %@", nsSocketId);
+        return resolvedPromise(rt);
         
     } catch (const jsi::JSError& e) {
         throw;
@@ -332,7 +470,6 @@ jsi::Value UDPDirectModuleCxxImpl::send(jsi::Runtime &rt, jsi::String socketId,
     }
 }
 
-#if 0 // Temporarily disabled advanced zero-copy implementations (see header)
 jsi::Value UDPDirectModuleCxxImpl::sendBinary(jsi::Runtime &rt, jsi::String socketId, jsi::Object data, double port, jsi::String address, std::optional<jsi::Object> options) {
     try {
         UDPSocketManager *manager = getSocketManager();
@@ -340,32 +477,34 @@ jsi::Value UDPDirectModuleCxxImpl::sendBinary(jsi::Runtime &rt, jsi::String sock
             throw jsi::JSError(rt, "Socket manager not available");
         }
         
-        // Convert string socketId to NSNumber
-        std::string socketIdStr = socketId.utf8(rt);
-        NSNumber *nsSocketId = @(std::stoi(socketIdStr));
-        NSString *nsAddress = [NSString stringWithUTF8String:address.utf8(rt).c_str()];
-        
-        // Handle ArrayBuffer or similar binary data object
-        NSData *nsData = nil;
+        NSNumber *nsSocketId = @(socketIdFromString(rt, socketId));
+        std::string addressStr = address.utf8(rt);
         
-        // Check if it's an ArrayBuffer
-        if (data.isArrayBuffer(rt)) {
-            auto arrayBuffer = data.getArrayBuffer(rt);
-            nsData = [NSData dataWithBytes:arrayBuffer.data(rt) length:arrayBuffer.size(rt)];
-        } else {
-            // Try to get it as a typed array or other buffer type
-            throw jsi::JSError(rt, "sendBinary expects an ArrayBuffer");
+        const uint8_t* bytes = nullptr;
+        size_t length = 0;
+        if (!binaryPayload(rt, data, bytes, length)) {
+            throw jsi::JSError(rt, "sendBinary expects an ArrayBuffer or a view over one");
         }
         
-        if (!nsData) {
-            throw jsi::JSError(rt, "Failed to extract binary data");
+        long tag = [manager nextSendTag];
+        
+        // Numeric destinations go straight to the kernel from the JS buffer, as udpSendDirect does
+        udpdirect::UDPSocketAddress destination;
+        if (udpdirect::UDPSocketAddress::fromNumericHost(addressStr.c_str(), (uint16_t)port, destination)) {
+            UDPImmediateSendResult result = [manager sendBytesImmediately:bytes length:length onSocket:nsSocketId toAddress:destination tag:tag];
+            if (result != UDPImmediateSendDeferred) {
+                UDP_CXX_DEBUG(@"Binary send from socket %@ went out directly", nsSocketId);
+                return resolvedPromise(rt);
+            }
         }
         
-        // Send data (this is async, so we use tag 0 for now)
-        [manager sendData:nsData onSocket:nsSocketId toHost:nsAddress port:(uint16_t)port tag:0];
+        // Queued sends outlive this call, so the payload is copied once
+        NSData *nsData = [NSData dataWithBytes:bytes length:length];
+        NSString *nsAddress = [NSString stringWithUTF8String:addressStr.c_str()];
+        [manager sendData:nsData onSocket:nsSocketId toHost:nsAddress port:(uint16_t)port tag:tag];
         
-        NSLog(@"[UDPDirectModuleCxxImpl] Initiated binary send from socket %@", nsSocketId);
-        return jsi::Value::undefined();
+        UDP_CXX_DEBUG(@"Initiated binary send from socket %@", nsSocketId);
+        return resolvedPromise(rt);
         
     } catch (const jsi::JSError& e) {
         throw;
@@ -373,7 +512,74 @@ jsi::Value UDPDirectModuleCxxImpl::sendBinary(jsi::Runtime &rt, jsi::String sock
         throw jsi::JSError(rt, "Unknown error sending binary data");
     }
 }
-#endif
+
+void UDPDirectModuleCxxImpl::setBinaryMessageHandler(jsi::Runtime &rt, jsi::String socketId, jsi::Function handler) {
+    UDPSocketManager *manager = getSocketManager();
+    if (!manager) {
+        throw jsi::JSError(rt, "Socket manager not available");
+    }
+    
+    uint32_t nsSocketId = socketIdFromString(rt, socketId);
+    {
+        std::lock_guard<std::mutex> lock(binaryHandlers_->mutex);
+        binaryHandlers_->runtime = &rt;
+        binaryHandlers_->handlers[nsSocketId] = std::make_shared<jsi::Function>(std::move(handler));
+    }
+    
+    installSocketCallbacks();
+    [manager startReceivingOnBoundSockets];
+}
+
+void UDPDirectModuleCxxImpl::removeBinaryMessageHandler(jsi::Runtime &rt, jsi::String socketId) {
+    uint32_t nsSocketId = socketIdFromString(rt, socketId);
+    std::lock_guard<std::mutex> lock(binaryHandlers_->mutex);
+    binaryHandlers_->handlers.erase(nsSocketId);
+}
+
+bool UDPDirectModuleCxxImpl::deliverBinaryMessage(const std::shared_ptr<BinaryHandlers>& binaryHandlers,
+                                                  const std::shared_ptr<CallInvoker>& jsInvoker,
+                                                  uint32_t socketId, NSData* data, NSString* host, uint16_t port) {
+    {
+        std::lock_guard<std::mutex> lock(binaryHandlers->mutex);
+        if (binaryHandlers->handlers.find(socketId) == binaryHandlers->handlers.end()) {
+            return false;
+        }
+    }
+    if (!jsInvoker) {
+        return false;
+    }
+    
+    std::weak_ptr<BinaryHandlers> weakHandlers = binaryHandlers;
+    std::string address = host.UTF8String ?: "";
+    jsInvoker->invokeAsync([weakHandlers, socketId, data, address, port]() {
+        std::shared_ptr<BinaryHandlers> binaryHandlers = weakHandlers.lock();
+        if (!binaryHandlers) return;
+        std::shared_ptr<jsi::Function> handler;
+        jsi::Runtime* runtime = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(binaryHandlers->mutex);
+            auto it = binaryHandlers->handlers.find(socketId);
+            if (it == binaryHandlers->handlers.end() || !binaryHandlers->runtime) return;
+            handler = it->second;
+            runtime = binaryHandlers->runtime;
+        }
+        
+        jsi::Runtime& rt = *runtime;
+        try {
+            auto event = jsi::Object(rt);
+            event.setProperty(rt, "socketId", jsi::String::createFromUtf8(rt, std::to_string(socketId)));
+            // Wraps the received NSData; no copy, no base64
+            event.setProperty(rt, "data", jsi::ArrayBuffer(rt, std::make_shared<NSDataArrayBuffer>(data)));
+            event.setProperty(rt, "address", jsi::String::createFromUtf8(rt, address));
+            event.setProperty(rt, "port", jsi::Value((double)port));
+            event.setProperty(rt, "family", jsi::String::createFromAscii(rt, address.find(':') == std::string::npos ? "IPv4" : "IPv6"));
+            handler->call(rt, event);
+        } catch (const std::exception& e) {
+            NSLog(@"[UDPDirectModuleCxxImpl] Error in binary message handler: %s", e.what());
+        }
+    });
+    return true;
+}
 
 
 jsi::Array UDPDirectModuleCxxImpl::getLocalIPAddresses(jsi::Runtime &rt) {
@@ -408,31 +614,28 @@ jsi::Value UDPDirectModuleCxxImpl::address(jsi::Runtime &rt, jsi::String socketI
         }
         
         // Convert string socketId to NSNumber
-        std::string socketIdStr = socketId.utf8(rt);
-        NSNumber *nsSocketId = @(std::stoi(socketIdStr));
-        NSDictionary *addressInfo = [manager getSocketAddress:nsSocketId];
-        
-        if (addressInfo) {
-            auto addressObj = jsi::Object(rt);
-            
-            NSString *address = addressInfo[@"address"];
-            NSNumber *port = addressInfo[@"port"];
-            NSString *family = addressInfo[@"family"];
-            
-            if (address) {
-                addressObj.setProperty(rt, "address", jsi::String::createFromUtf8(rt, [address UTF8String]));
-            }
-            if (port) {
-                addressObj.setProperty(rt, "port", jsi::Value((double)[port intValue]));
-            }
-            if (family) {
-                addressObj.setProperty(rt, "family", jsi::String::createFromUtf8(rt, [family UTF8String]));
-            }
-            
-            return addressObj;
-        } else {
-            return jsi::Value::null();
-        }
+        NSNumber *nsSocketId = @(socketIdFromString(rt, socketId));
+        promiseContext_->runtime = &rt;
+        std::weak_ptr<PromiseContext> context = promiseContext_;
+        std::shared_ptr<CallInvoker> jsInvoker = jsInvoker_;
+        return createPromiseAsJSIValue(rt, [context, jsInvoker, manager, nsSocketId](jsi::Runtime &rt, std::shared_ptr<Promise> promise) {
+            [manager getSocketAddress:nsSocketId completion:^(NSDictionary* addressInfo, NSError* error) {
+                if (!addressInfo) {
+                    settlePromise(context, jsInvoker, promise, std::string(), [](jsi::Runtime &rt) -> jsi::Value { return jsi::Value::null(); });
+                    return;
+                }
+                std::string address = addressInfo[@"address"] ? [addressInfo[@"address"] UTF8String] : "";
+                double port = [addressInfo[@"port"] doubleValue];
+                std::string family = addressInfo[@"family"] ? [addressInfo[@"family"] UTF8String] : "";
+                settlePromise(context, jsInvoker, promise, std::string(), [address, port, family](jsi::Runtime &rt) -> jsi::Value {
+                    auto addressObj = jsi::Object(rt);
+                    addressObj.setProperty(rt, "address", jsi::String::createFromUtf8(rt, address));
+                    addressObj.setProperty(rt, "port", jsi::Value(port));
+                    addressObj.setProperty(rt, "family", jsi::String::createFromUtf8(rt, family));
+                    return addressObj;
+                });
+            }];
+        });
         
     } catch (const jsi::JSError& e) {
         throw;
@@ -449,20 +652,16 @@ jsi::Value UDPDirectModuleCxxImpl::setBroadcast(jsi::Runtime &rt, jsi::String so
         }
         
         // Convert string socketId to NSNumber  
-        std::string socketIdStr = socketId.utf8(rt);
-        NSNumber *nsSocketId = @(std::stoi(socketIdStr));
-        NSError *error = nil;
-        BOOL success = [manager setBroadcast:nsSocketId enable:flag error:&error];
-        
-        if (success) {
-            return jsi::Value::undefined();
-        } else {
-            std::string errorMsg = "Failed to set broadcast option";
-            if (error) {
-                errorMsg += ": " + std::string([[error localizedDescription] UTF8String]);
-            }
-            throw jsi::JSError(rt, errorMsg);
-        }
+        NSNumber *nsSocketId = @(socketIdFromString(rt, socketId));
+        promiseContext_->runtime = &rt;
+        std::weak_ptr<PromiseContext> context = promiseContext_;
+        std::shared_ptr<CallInvoker> jsInvoker = jsInvoker_;
+        NSDictionary *options = @{@"broadcast": @(flag)};
+        return createPromiseAsJSIValue(rt, [context, jsInvoker, manager, nsSocketId, options](jsi::Runtime &rt, std::shared_ptr<Promise> promise) {
+            [manager configureSocket:nsSocketId options:options completion:^(NSError* error) {
+                settlePromise(context, jsInvoker, promise, error ? managerErrorMessage("Failed to set broadcast option", error) : std::string(), nullptr);
+            }];
+        });
         
     } catch (const jsi::JSError& e) {
         throw;
@@ -549,163 +748,161 @@ jsi::Value UDPDirectModuleCxxImpl::setDataEventHandler(jsi::Runtime &rt, jsi::St
         
         NSLog(@"[UDPDirectModuleCxxImpl] Setting up data event handler for socket: %@", [NSString stringWithUTF8String:socketId.utf8(rt).c_str()]);
         
-        // Store a raw pointer for safe checking - callbacks will be cleared in destructor
-        UDPDirectModuleCxxImpl* selfPtr = this;
+        installSocketCallbacks();
         
-        // Set up the data received callback with validity checking
-        manager.onDataReceived = ^(NSNumber* socketId, NSData* data, NSString* host, uint16_t port, NSNumber* bufferId) {
-            NSLog(@"[UDPDirectModuleCxxImpl] Data received callback - Socket: %@, Data size: %lu, From: %@:%u, BufferId: %@", 
-                  socketId, (unsigned long)data.length, host, port, bufferId);
-            
-            // CRITICAL: Check if module is being destroyed before any operation
-            if (!selfPtr || selfPtr->isBeingDestroyed_) {
-                NSLog(@"[UDPDirectModuleCxxImpl] Data callback called on destroyed module, skipping completely");
-                return;
-            }
-            
-            @try {
-                // Convert data to base64 for safe transport
-                NSString *base64Data = [data base64EncodedStringWithOptions:0];
-                
-                // Additional safety check before emitDeviceEvent
-                if (!selfPtr || selfPtr->isBeingDestroyed_) {
-                    NSLog(@"[UDPDirectModuleCxxImpl] Module destroyed during callback, aborting emit completely");
-                    return;
-                }
-                
-                // Use NSNotificationCenter to emit events to the Objective-C provider
-                // This avoids direct JSI calls from background threads
-                @try {
-                    // Create event data dictionary
-                    NSDictionary *eventData = @{
-                        @"eventName": @"message",
-                        @"socketId": [socketId stringValue],
-                        @"data": base64Data,
-                        @"address": host,
-                        @"port": @(port),
-                        @"family": @"IPv4",
-                        @"bufferId": bufferId ?: [NSNull null]
-                    };
-                    
-                    // Use simplified logging for now to avoid JSI complications
-                    std::string eventDataStr = "socketId=" + std::string([[socketId stringValue] UTF8String]) + 
-                                             ", address=" + std::string([host UTF8String]) + 
-                                             ", port=" + std::to_string(port) +
-                                             ", dataLength=" + std::to_string([base64Data length]);
-                    selfPtr->logEvent("message", eventDataStr);
-                    
-                    NSLog(@"[UDPDirectModuleCxxImpl] Logged 'message' event safely");
-                } @catch (NSException *emitException) {
-                    NSLog(@"[UDPDirectModuleCxxImpl] Exception during event notification: %@", emitException);
-                }
-                
-            } @catch (NSException *exception) {
-                NSLog(@"[UDPDirectModuleCxxImpl] Exception during message event emission: %@", exception);
-            }
-        };
+        // Start receiving on any bound sockets now that callbacks are set up
+        [manager startReceivingOnBoundSockets];
         
-        // Set up error/close callbacks with validity checking
-        manager.onSocketClosed = ^(NSNumber* socketId, NSError* _Nullable error) {
-            NSLog(@"[UDPDirectModuleCxxImpl] Socket closed callback - Socket: %@, Error: %@", socketId, error);
-            
-            // CRITICAL: Check if module is being destroyed before any operation
-            if (!selfPtr || selfPtr->isBeingDestroyed_) {
-                NSLog(@"[UDPDirectModuleCxxImpl] Close callback called on destroyed module, skipping completely");
+        NSLog(@"[UDPDirectModuleCxxImpl] Data event handlers configured successfully - callbacks will be cleared in destructor");
+        return jsi::Value::undefined();
+        
+    } catch (const jsi::JSError& e) {
+        throw;
+    } catch (...) {
+        throw jsi::JSError(rt, "Unknown error setting up data event handler");
+    }
+}
+
+void UDPDirectModuleCxxImpl::installSocketCallbacks() {
+    UDPSocketManager *manager = getSocketManager();
+    if (!manager) {
+        return;
+    }
+    
+    // The blocks run on the delegate queue and may outlive the module, so they hold its
+    // handler state weakly and never the module itself
+    std::weak_ptr<BinaryHandlers> weakHandlers = binaryHandlers_;
+    std::shared_ptr<CallInvoker> jsInvoker = jsInvoker_;
+    
+    // Set up the data received callback with validity checking
+    manager.onDataReceived = ^(NSNumber* socketId, NSData* data, NSString* host, uint16_t port, NSNumber* _Nullable bufferId) {
+        UDP_CXX_DEBUG(@"Data received callback - Socket: %@, Data size: %lu, From: %@:%u, BufferId: %@", 
+              socketId, (unsigned long)data.length, host, port, bufferId);
+        
+        // CRITICAL: Check if module is being destroyed before any operation
+        std::shared_ptr<BinaryHandlers> binaryHandlers = weakHandlers.lock();
+        if (!binaryHandlers) {
+            NSLog(@"[UDPDirectModuleCxxImpl] Data callback called on destroyed module, skipping completely");
+            return;
+        }
+        
+        // Sockets with a binary handler get an ArrayBuffer
+        if (deliverBinaryMessage(binaryHandlers, jsInvoker, socketId.unsignedIntValue, data, host, port)) {
+            return;
+        }
+        
+        // Without one the datagram has nowhere to go: module events are only logged, so
+        // nothing is encoded or boxed per packet for them
+#if UDP_LOG_ENABLED(UDP_LOG_LEVEL_DEBUG)
+        std::string eventDataStr = "socketId=" + std::string([[socketId stringValue] UTF8String]) + 
+                                 ", address=" + std::string([host UTF8String]) + 
+                                 ", port=" + std::to_string(port) +
+                                 ", dataLength=" + std::to_string(data.length);
+        logEvent("message", eventDataStr);
+#endif
+    };
+    
+    // Set up error/close callbacks with validity checking
+    manager.onSocketClosed = ^(NSNumber* socketId, NSError* _Nullable error) {
+        NSLog(@"[UDPDirectModuleCxxImpl] Socket closed callback - Socket: %@, Error: %@", socketId, error);
+        
+        // CRITICAL: Check if module is being destroyed before any operation
+        if (weakHandlers.expired()) {
+            NSLog(@"[UDPDirectModuleCxxImpl] Close callback called on destroyed module, skipping completely");
+            return;
+        }
+        
+        // The handler is a JS function, so it is dropped on the JS thread
+        if (jsInvoker) {
+            uint32_t closedSocketId = socketId.unsignedIntValue;
+            jsInvoker->invokeAsync([weakHandlers, closedSocketId]() {
+                std::shared_ptr<BinaryHandlers> binaryHandlers = weakHandlers.lock();
+                if (!binaryHandlers) return;
+                std::lock_guard<std::mutex> lock(binaryHandlers->mutex);
+                binaryHandlers->handlers.erase(closedSocketId);
+            });
+        }
+        
+        @try {
+            // Additional safety check before emitDeviceEvent
+            if (weakHandlers.expired()) {
+                NSLog(@"[UDPDirectModuleCxxImpl] Module destroyed during close callback, aborting emit completely");
                 return;
             }
             
+            // Use NSNotificationCenter to emit events to the Objective-C provider
+            // This avoids direct JSI calls from background threads
             @try {
-                // Additional safety check before emitDeviceEvent
-                if (!selfPtr || selfPtr->isBeingDestroyed_) {
-                    NSLog(@"[UDPDirectModuleCxxImpl] Module destroyed during close callback, aborting emit completely");
-                    return;
-                }
+                // Create event data dictionary
+                NSDictionary *eventData = @{
+                    @"eventName": @"close",
+                    @"socketId": [socketId stringValue],
+                    @"error": error ? [error localizedDescription] : [NSNull null]
+                };
                 
-                // Use NSNotificationCenter to emit events to the Objective-C provider
-                // This avoids direct JSI calls from background threads
-                @try {
-                    // Create event data dictionary
-                    NSDictionary *eventData = @{
-                        @"eventName": @"close",
-                        @"socketId": [socketId stringValue],
-                        @"error": error ? [error localizedDescription] : [NSNull null]
-                    };
-                    
-                    // Use simplified logging for now to avoid JSI complications  
-                    std::string eventDataStr = "socketId=" + std::string([[socketId stringValue] UTF8String]);
-                    if (error) {
-                        eventDataStr += ", error=" + std::string([[error localizedDescription] UTF8String]);
-                    }
-                    selfPtr->logEvent("close", eventDataStr);
-                    
-                    NSLog(@"[UDPDirectModuleCxxImpl] Logged 'close' event safely");
-                } @catch (NSException *emitException) {
-                    NSLog(@"[UDPDirectModuleCxxImpl] Exception during event notification: %@", emitException);
+                // Use simplified logging for now to avoid JSI complications  
+                std::string eventDataStr = "socketId=" + std::string([[socketId stringValue] UTF8String]);
+                if (error) {
+                    eventDataStr += ", error=" + std::string([[error localizedDescription] UTF8String]);
                 }
+                logEvent("close", eventDataStr);
                 
-            } @catch (NSException *exception) {
-                NSLog(@"[UDPDirectModuleCxxImpl] Exception during close event emission: %@", exception);
+                NSLog(@"[UDPDirectModuleCxxImpl] Logged 'close' event safely");
+            } @catch (NSException *emitException) {
+                NSLog(@"[UDPDirectModuleCxxImpl] Exception during event notification: %@", emitException);
             }
-        };
-        
-        manager.onSendFailure = ^(NSNumber* socketId, long tag, NSError* error) {
-            NSLog(@"[UDPDirectModuleCxxImpl] Send failure callback - Socket: %@, Tag: %ld, Error: %@", socketId, tag, error);
             
-            // CRITICAL: Check if module is being destroyed before any operation
-            if (!selfPtr || selfPtr->isBeingDestroyed_) {
-                NSLog(@"[UDPDirectModuleCxxImpl] Send failure callback called on destroyed module, skipping completely");
+        } @catch (NSException *exception) {
+            NSLog(@"[UDPDirectModuleCxxImpl] Exception during close event emission: %@", exception);
+        }
+    };
+    
+    manager.onSendFailure = ^(NSNumber* socketId, long tag, NSError* error) {
+        NSLog(@"[UDPDirectModuleCxxImpl] Send failure callback - Socket: %@, Tag: %ld, Error: %@", socketId, tag, error);
+        
+        // CRITICAL: Check if module is being destroyed before any operation
+        if (weakHandlers.expired()) {
+            NSLog(@"[UDPDirectModuleCxxImpl] Send failure callback called on destroyed module, skipping completely");
+            return;
+        }
+        
+        @try {
+            // Additional safety check before emitDeviceEvent
+            if (weakHandlers.expired()) {
+                NSLog(@"[UDPDirectModuleCxxImpl] Module destroyed during send failure callback, aborting emit completely");
                 return;
             }
             
+            // Use NSNotificationCenter to emit events to the Objective-C provider
+            // This avoids direct JSI calls from background threads
             @try {
-                // Additional safety check before emitDeviceEvent
-                if (!selfPtr || selfPtr->isBeingDestroyed_) {
-                    NSLog(@"[UDPDirectModuleCxxImpl] Module destroyed during send failure callback, aborting emit completely");
-                    return;
-                }
+                // Create event data dictionary
+                NSDictionary *eventData = @{
+                    @"eventName": @"error",
+                    @"socketId": [socketId stringValue],
+                    @"tag": @(tag),
+                    @"error": [error localizedDescription]
+                };
                 
-                // Use NSNotificationCenter to emit events to the Objective-C provider
-                // This avoids direct JSI calls from background threads
-                @try {
-                    // Create event data dictionary
-                    NSDictionary *eventData = @{
-                        @"eventName": @"error",
-                        @"socketId": [socketId stringValue],
-                        @"tag": @(tag),
-                        @"error": [error localizedDescription]
-                    };
-                    
-                    // Use simplified logging for now to avoid JSI complications
-                    std::string eventDataStr = "socketId=" + std::string([[socketId stringValue] UTF8String]) + 
-                                             ", error=" + std::string([[error localizedDescription] UTF8String]) +
-                                             ", errno=" + std::to_string([error code]);
-                    selfPtr->logEvent("error", eventDataStr);
-                    
-                    NSLog(@"[UDPDirectModuleCxxImpl] Logged 'error' event safely");
-                } @catch (NSException *emitException) {
-                    NSLog(@"[UDPDirectModuleCxxImpl] Exception during event notification: %@", emitException);
-                }
+                // Use simplified logging for now to avoid JSI complications
+                std::string eventDataStr = "socketId=" + std::string([[socketId stringValue] UTF8String]) + 
+                                         ", error=" + std::string([[error localizedDescription] UTF8String]) +
+                                         ", errno=" + std::to_string([error code]);
+                logEvent("error", eventDataStr);
                 
-            } @catch (NSException *exception) {
-                NSLog(@"[UDPDirectModuleCxxImpl] Exception during error event emission: %@", exception);
+                NSLog(@"[UDPDirectModuleCxxImpl] Logged 'error' event safely");
+            } @catch (NSException *emitException) {
+                NSLog(@"[UDPDirectModuleCxxImpl] Exception during event notification: %@", emitException);
             }
-        };
-        
-        // Start receiving on any bound sockets now that callbacks are set up
-        [manager startReceivingOnBoundSockets];
-        
-        NSLog(@"[UDPDirectModuleCxxImpl] Data event handlers configured successfully - callbacks will be cleared in destructor");
-        return jsi::Value::undefined();
-        
-    } catch (const jsi::JSError& e) {
-        throw;
-    } catch (...) {
-        throw jsi::JSError(rt, "Unknown error setting up data event handler");
-    }
+            
+        } @catch (NSException *exception) {
+            NSLog(@"[UDPDirectModuleCxxImpl] Exception during error event emission: %@", exception);
+        }
+    };
 }
 
 void UDPDirectModuleCxxImpl::emitDeviceEvent(const std::string& eventName, const std::function<void(jsi::Runtime& rt, jsi::Object& eventData)>& eventDataBuilder) {
-    NSLog(@"[UDPDirectModuleCxxImpl] emitDeviceEvent called for event: %s", eventName.c_str());
+    UDP_CXX_DEBUG(@"emitDeviceEvent called for event: %s", eventName.c_str());
     
     // Safety check - don't emit events during destruction
     if (isBeingDestroyed_) {
@@ -716,7 +913,7 @@ void UDPDirectModuleCxxImpl::emitDeviceEvent(const std::string& eventName, const
     // Check if there are any listeners for this event
     auto it = eventListenerCounts_.find(eventName);
     if (it == eventListenerCounts_.end() || it->second <= 0) {
-        NSLog(@"[UDPDirectModuleCxxImpl] No listeners for event '%s', skipping emission", eventName.c_str());
+        UDP_CXX_DEBUG(@"No listeners for event '%s', skipping emission", eventName.c_str());
         return;
     }
     
@@ -725,7 +922,7 @@ void UDPDirectModuleCxxImpl::emitDeviceEvent(const std::string& eventName, const
         return;
     }
     
-    NSLog(@"[UDPDirectModuleCxxImpl] Emitting event '%s' to %d listeners", eventName.c_str(), it->second);
+    UDP_CXX_DEBUG(@"Emitting event '%s' to %d listeners", eventName.c_str(), it->second);
     
     // For now, we'll use the NSNotificationCenter approach but with proper safety and listener checking
     dispatch_async(dispatch_get_main_queue(), ^{
@@ -739,13 +936,14 @@ void UDPDirectModuleCxxImpl::emitDeviceEvent(const std::string& eventName, const
             [[NSNotificationCenter defaultCenter] postNotificationName:@"RNUDPModuleEvent"
                                                                 object:nil
                                                               userInfo:eventData];
-            NSLog(@"[UDPDirectModuleCxxImpl] Posted safe notification for event: %s", eventName.c_str());
+            UDP_CXX_DEBUG(@"Posted safe notification for event: %s", eventName.c_str());
         }
     });
 }
 
+// Gated here rather than at each call site, so no event is logged outside debug builds
 void UDPDirectModuleCxxImpl::logEvent(const std::string& eventName, const std::string& data) {
-    NSLog(@"[UDPDirectModuleCxxImpl] 🎯 EVENT: %s - %s", eventName.c_str(), data.c_str());
+    UDP_CXX_DEBUG(@"EVENT: %s - %s", eventName.c_str(), data.c_str());
 }
 
 // diagnoseSocket is not part of the generated spec
@@ -26,6 +26,7 @@ typedef NS_ENUM(NSInteger, UDPErrorCode) {
     UDPErrorCodeSendFailed = 301,
     UDPErrorCodeReceiveFailed = 302,
     UDPErrorCodeBeginReceiveFailed = 303,
+    UDPErrorCodeConnectFailed = 304,
     
     // Buffer / Zero-Copy errors (400-499)
     UDPErrorCodeBufferNotFound = 400,
@@ -56,6 +57,7 @@ static NSString * const UDP_STR_ERR_BIND_FAILED          = @"ERR_BIND_FAILED";
 static NSString * const UDP_STR_ERR_SEND_FAILED          = @"ERR_SEND_FAILED";
 static NSString * const UDP_STR_ERR_RECEIVE_FAILED       = @"ERR_RECEIVE_FAILED";
 static NSString * const UDP_STR_ERR_BEGIN_RECEIVE_FAILED = @"ERR_BEGIN_RECEIVE_FAILED";
+static NSString * const UDP_STR_ERR_CONNECT_FAILED       = @"ERR_CONNECT_FAILED";
 
 // Buffer / Zero-Copy errors
 static NSString * const UDP_STR_ERR_BUFFER_NOT_FOUND          = @"ERR_BUFFER_NOT_FOUND";
@@ -2,17 +2,66 @@
 #import "GCDAsyncUdpSocket.h" // Import GCDAsyncUdpSocket
 #import "UDPErrorCodes.h"   // For error constants
 
+#ifdef __cplusplus
+#include <memory>
+#include "UDPBatchIO.h"
+#include "UDPBufferPool.h"
+#include "UDPCapture.h"
+#include "UDPChecksum.h"
+#include "UDPEndpointTable.h"
+#include "UDPFragmenter.h"
+#include "UDPInterfaceMonitor.h"
+#include "UDPPacketFilter.h"
+#include "UDPSendScheduler.h"
+#include "UDPSocketAddress.h"
+#include "UDPSocketStats.h"
+#include "UDPTrace.h"
+#include "UDPTxArena.h"
+#endif
+
 NS_ASSUME_NONNULL_BEGIN
 
 // Forward declaration for the C++ owner (optional, can use void*)
 // class UDPDirectModuleCxxImpl;
 
+// Upper bound on receive queues; the manager creates one per active core up to this
+static const NSUInteger kUDPMaxReceiveQueues = 8;
+
 // Callback Types
-typedef void (^UDPSocketDidReceiveData)(NSNumber* socketId, NSData* data, NSString* host, uint16_t port, NSNumber* bufferId);
+// bufferId is nil for received datagrams: `data` is handed over as-is and is not tracked in `buffers`
+typedef void (^UDPSocketDidReceiveData)(NSNumber* socketId, NSData* data, NSString* host, uint16_t port, NSNumber* _Nullable bufferId);
 typedef void (^UDPSocketDidClose)(NSNumber* socketId, NSError* _Nullable error);
 typedef void (^UDPSocketDidSendData)(NSNumber* socketId, long tag);
 typedef void (^UDPSocketDidNotSendData)(NSNumber* socketId, long tag, NSError* error);
 
+// Completions of the asynchronous control calls, called on the delegate queue
+typedef void (^UDPSocketCreateCompletion)(NSNumber* _Nullable socketId, NSError* _Nullable error);
+typedef void (^UDPSocketOperationCompletion)(NSError* _Nullable error);
+typedef void (^UDPSocketAddressCompletion)(NSDictionary* _Nullable addressInfo, NSError* _Nullable error);
+
+// Outcome of sendBytesImmediately:
+typedef NS_ENUM(NSInteger, UDPImmediateSendResult) {
+    UDPImmediateSendSent,     // Handed to the kernel before returning
+    UDPImmediateSendDeferred, // Not sent; queue it through sendData: instead
+    UDPImmediateSendFailed    // Rejected by the kernel; onSendFailure has been called
+};
+#ifdef __cplusplus
+// Pooled receive: the block takes ownership of `slot` and must hand it back to receivePool.
+// `route` is 0 for the socket's default handler, or n when a packet filter routed the
+// datagram to route index n - 1. `kernelTimestampNs` is when the kernel received the
+// datagram, on the UDPMonotonicNowNs clock, or 0 if the socket was not created with `timestamps`.
+typedef void (^UDPSocketDidReceiveSlot)(NSNumber* socketId, udpdirect::UDPBufferSlot slot, const udpdirect::UDPSocketAddress& source, uint32_t route, uint64_t kernelTimestampNs);
+// A message reassembled from fragments; `route` as for UDPSocketDidReceiveSlot, taken from its last fragment.
+// A queued send handed to the kernel, for sockets created with `timestamps`. Both times are on
+// the UDPMonotonicNowNs clock: when sendData: queued it and when GCDAsyncUdpSocket reported it sent.
+typedef void (^UDPSocketDidCompleteSend)(NSNumber* socketId, long tag, size_t bytes, uint64_t enqueuedNs, uint64_t completedNs);
+typedef void (^UDPInterfacesDidChange)(uint64_t version);
+typedef void (^UDPSocketDidReassembleMessage)(NSNumber* socketId, std::shared_ptr<std::vector<uint8_t>> message, const udpdirect::UDPSocketAddress& source, uint32_t route);
+// A replay ran out of datagrams, was stopped or lost its socket; called on the socket's receive
+// queue. `error` is set when the socket was not found or the capture file is malformed.
+typedef void (^UDPReplayCompletion)(uint64_t delivered, uint64_t skipped, NSError* _Nullable error);
+#endif
+
 @interface UDPSocketManager : NSObject <GCDAsyncUdpSocketDelegate>
 
 // Properties for callbacks to the C++ owner
@@ -20,6 +69,116 @@ typedef void (^UDPSocketDidNotSendData)(NSNumber* socketId, long tag, NSError* e
 @property (nonatomic, copy, nullable) UDPSocketDidClose onSocketClosed;
 @property (nonatomic, copy, nullable) UDPSocketDidSendData onSendSuccess;
 @property (nonatomic, copy, nullable) UDPSocketDidNotSendData onSendFailure;
+#ifdef __cplusplus
+// When set, received datagrams are copied once into a receivePool slot and delivered here
+// instead of through onDataReceived. Called on the socket's receive queue.
+@property (nonatomic, copy, nullable) UDPSocketDidReceiveSlot onSlotReceived;
+
+// Called on the delegate queue for each completed queued send of a socket created with `timestamps`.
+@property (nonatomic, copy, nullable) UDPSocketDidCompleteSend onSendCompleted;
+
+// Called on the socket's receive queue for each message completed by its reassembler.
+@property (nonatomic, copy, nullable) UDPSocketDidReassembleMessage onMessageReassembled;
+
+// Called on the delegate queue when the interface table publishes a new version.
+@property (nonatomic, copy, nullable) UDPInterfacesDidChange onInterfacesChanged;
+
+// Cached interface table. Re-read after the system reports a path change, or on demand
+// through refresh(); follow an on-demand refresh with applyInterfaceTable so packet
+// filters and onInterfacesChanged see the new version.
+- (std::shared_ptr<udpdirect::UDPInterfaceMonitor>)interfaceMonitor;
+- (void)applyInterfaceTable;
+
+// Slab pool backing onSlotReceived. Shared so slots held by JS can outlive the manager.
+// Slots are refcounted and come back when the last ArrayBuffer holding one is collected;
+// the pool's byte budget bounds how much received data can be outstanding at once.
+- (std::shared_ptr<udpdirect::UDPBufferPool>)receivePool;
+
+// Binary per-packet trace ring, dumped under `trace` in getDiagnostics. Disabled by default.
+- (std::shared_ptr<udpdirect::UDPTrace>)trace;
+
+// Per-socket counters and latency histograms, reported under `stats` in getDiagnostics.
+- (std::shared_ptr<udpdirect::UDPSocketStats>)stats;
+
+// pcapng recorder fed by both receive paths (before filtering) and every send path. Idle,
+// at the cost of one relaxed load per datagram, until started.
+- (std::shared_ptr<udpdirect::UDPCapture>)capture;
+
+// Feeds the inbound datagrams of a capture to the socket as if it had received them:
+// through didReceiveData, so the packet filter, checksum, reassembly and delivery all run
+// as usual, on the socket's receive queue and paced as the replay says. A replay started
+// on a socket that already has one replaces it; closing the socket stops it.
+- (void)startReplay:(std::shared_ptr<udpdirect::UDPCaptureReplay>)replay onSocket:(NSNumber *)socketId completion:(UDPReplayCompletion)completion;
+- (void)stopReplayOnSocket:(NSNumber *)socketId;
+
+// Sends straight from `bytes` with a non-blocking sendto on the calling thread, so the
+// caller's buffer only has to stay valid for the duration of the call. Returns Deferred
+// when the socket is not bound yet, would block, needs broadcast enabled, or still has
+// queued sends that must go out first.
+- (UDPImmediateSendResult)sendBytesImmediately:(const void *)bytes length:(size_t)length onSocket:(NSNumber *)socketId toAddress:(const udpdirect::UDPSocketAddress &)destination tag:(long)tag;
+
+// Same, to a pre-resolved endpoint: no parsing or sockaddr encoding per datagram. A broadcast
+// endpoint turns SO_BROADCAST on for the socket the first time it is used.
+- (UDPImmediateSendResult)sendBytesImmediately:(const void *)bytes length:(size_t)length onSocket:(NSNumber *)socketId toEndpoint:(const udpdirect::UDPEndpoint &)endpoint tag:(long)tag;
+
+// Same, with send() on a socket connected through connectSocket:toEndpoint:completion:. Deferred
+// until the connect has completed.
+- (UDPImmediateSendResult)sendBytesImmediately:(const void *)bytes length:(size_t)length onConnectedSocket:(NSNumber *)socketId tag:(long)tag;
+
+// Queued counterparts of the two immediate sends above
+- (void)sendData:(NSData *)data onSocket:(NSNumber *)socketId toEndpoint:(const udpdirect::UDPEndpoint &)endpoint tag:(long)tag;
+- (void)sendData:(NSData *)data onConnectedSocket:(NSNumber *)socketId tag:(long)tag;
+
+// Fixes the socket's peer (connect(2) through GCDAsyncUdpSocket). Afterwards only sends
+// without an address are accepted, and only datagrams from the peer are received. Runs on
+// the delegate queue; the completion is called there.
+- (void)connectSocket:(NSNumber *)socketId toEndpoint:(const udpdirect::UDPEndpoint &)endpoint completion:(UDPSocketOperationCompletion)completion;
+
+// Classifies every datagram the socket receives before it is copied or delivered; dropped
+// datagrams never reach onSlotReceived or onDataReceived. Pass nullptr to remove the filter.
+// Applied asynchronously on the socket's receive queue and discarded when the socket closes.
+- (void)setPacketFilter:(std::shared_ptr<udpdirect::UDPPacketFilter>)filter forSocket:(NSNumber *)socketId;
+
+// Datagrams that pass the packet filter have their checksum trailer verified before
+// reassembly or delivery; what happens to failures is the verifier's onFailure decision.
+// Pass nullptr to remove it. Applied asynchronously on the socket's receive queue and
+// discarded when the socket closes.
+- (void)setChecksumVerifier:(std::shared_ptr<udpdirect::UDPChecksumVerifier>)verifier forSocket:(NSNumber *)socketId;
+
+// Datagrams that pass the packet filter and carry a fragment header are fed to the
+// reassembler instead of being delivered; completed messages go to onMessageReassembled.
+// Datagrams without the header are delivered as usual. Pass nullptr to remove it.
+// Applied asynchronously on the socket's receive queue and discarded when the socket closes.
+- (void)setReassembler:(std::shared_ptr<udpdirect::UDPReassembler>)reassembler forSocket:(NSNumber *)socketId;
+
+// Paced send: the payload is copied into the send scheduler and released by the socket's
+// token buckets from a timer on the delegate queue, highest priority first. Returns NO when
+// the scheduler queue is full. Completion and failure are reported like any other send.
+- (BOOL)schedulePacedSend:(const void *)bytes length:(size_t)length onSocket:(NSNumber *)socketId toEndpoint:(const udpdirect::UDPEndpoint &)endpoint priority:(udpdirect::UDPSendPriority)priority tag:(long)tag;
+
+// Rate limits for paced sends on the socket, in total and per destination. Unlimited limits
+// remove pacing; the socket's queued sends are dropped when it closes.
+- (void)setSendRateLimit:(const udpdirect::UDPRateLimit &)socketLimit perDestination:(const udpdirect::UDPRateLimit &)destinationLimit forSocket:(NSNumber *)socketId;
+
+// Queue depth and counters of the send scheduler, plus enqueue -> dispatch latency.
+- (udpdirect::UDPSendSchedulerStats)sendSchedulerStats;
+- (udpdirect::UDPLatencySummary)pacedSendLatency;
+
+// Batched form of sendBytesImmediately: (sendmmsg where available). Sends from the front of
+// `items` in order and returns how many went out; the caller queues the rest through sendData:.
+- (size_t)sendBatchImmediately:(const udpdirect::UDPBatchSendItem *)items count:(size_t)count onSocket:(NSNumber *)socketId;
+
+// Sends `length` bytes of TX arena slot `slot`, submitted with `ticket`, without copying them.
+// The slot is completed as soon as the kernel has the bytes: before returning for an immediate
+// send, otherwise on didSendDataWithTag: or didNotSendDataWithTag:. Deferred means the send
+// was queued through GCDAsyncUdpSocket.
+- (UDPImmediateSendResult)sendTxSlot:(uint32_t)slot ticket:(uint32_t)ticket length:(size_t)length arena:(std::shared_ptr<udpdirect::UDPTxArena>)arena onSocket:(NSNumber *)socketId toEndpoint:(const udpdirect::UDPEndpoint &)endpoint;
+#endif
+
+- (void)setTraceEnabled:(BOOL)enabled;
+
+// Unique tag for sendData:, so completion callbacks can be matched to their send (never 0).
+- (long)nextSendTag;
 
 // --- Buffer Management ---
 // We need a simplified buffer management system here, or the C++ layer handles it.
@@ -37,14 +196,32 @@ typedef void (^UDPSocketDidNotSendData)(NSNumber* socketId, long tag, NSError* e
 - (void)sendData:(NSData *)data onSocket:(NSNumber *)socketId toHost:(NSString *)host port:(uint16_t)port tag:(long)tag;
 - (void)sendDataFromBuffer:(NSNumber *)bufferId offset:(NSUInteger)offset length:(NSUInteger)length onSocket:(NSNumber *)socketId toHost:(NSString *)host port:(uint16_t)port tag:(long)tag;
 
+// Non-blocking forms of the above: the work is queued on the delegate queue and the caller
+// returns at once, so a busy queue never stalls the JS thread. A bind completes with the
+// bound address, as from getSocketAddress:.
+- (void)createSocketWithOptions:(NSDictionary *)options completion:(UDPSocketCreateCompletion)completion;
+- (void)bindSocket:(NSNumber *)socketId toPort:(uint16_t)port address:(nullable NSString *)address completion:(UDPSocketAddressCompletion)completion;
+
 - (void)closeSocket:(NSNumber *)socketId;
 - (void)closeAllSockets;
 - (void)closeAllSocketsSynchronously; // Synchronous version for cleanup during app reload
 - (void)startReceivingOnBoundSockets;
 
-// Expose delegate queue for cleanup coordination
+// Expose delegate queue for cleanup coordination. This is the control queue: socket
+// lifecycle, options, queued sends and their completions run here.
 @property (nonatomic, readonly) dispatch_queue_t delegateQueue;
 
+// Receive queues. Each socket is assigned one at creation, either the `receiveQueue` index
+// from its options (modulo the count) or the least loaded one, and all of its receive work
+// runs there: delegate callbacks, batch reads, filtering, reassembly, onSlotReceived and
+// onDataReceived. Sockets on different queues receive in parallel.
+- (NSUInteger)receiveQueueCount;
+- (dispatch_queue_t)receiveQueueAtIndex:(NSUInteger)index;
+// NSNotFound for unknown sockets
+- (NSUInteger)receiveQueueIndexForSocket:(NSNumber *)socketId;
+// Index of the receive queue the caller is running on, or NSNotFound
+- (NSUInteger)currentReceiveQueueIndex;
+
 // Expose internal socket dictionaries for port management (readonly access)
 @property (nonatomic, strong, readonly) NSDictionary<NSNumber*, GCDAsyncUdpSocket*> *asyncSockets;
 @property (nonatomic, strong, readonly) NSDictionary<NSNumber*, NSNumber*> *socketStatus;
@@ -56,9 +233,21 @@ typedef void (^UDPSocketDidNotSendData)(NSNumber* socketId, long tag, NSError* e
 - (BOOL)setMulticastLoopback:(NSNumber *)socketId flag:(BOOL)flag error:(NSError **)error;
 - (BOOL)joinMulticastGroup:(NSNumber *)socketId address:(NSString *)address error:(NSError **)error;
 - (BOOL)leaveMulticastGroup:(NSNumber *)socketId address:(NSString *)address error:(NSError **)error;
+// `interface` is a name ("en0"), index or address from the interface table; nil is the default
+- (BOOL)joinMulticastGroup:(NSNumber *)socketId address:(NSString *)address interface:(nullable NSString *)interface error:(NSError **)error;
+- (BOOL)leaveMulticastGroup:(NSNumber *)socketId address:(NSString *)address interface:(nullable NSString *)interface error:(NSError **)error;
+// Outgoing multicast leaves through `interface` (IP_MULTICAST_IF / IPV6_MULTICAST_IF)
+- (BOOL)setMulticastInterface:(NSNumber *)socketId interface:(NSString *)interface error:(NSError **)error;
+
+// Applies several options in one delegate queue hop, in this order, stopping at the first
+// failure: broadcast (BOOL), ttl, multicastTTL (int), loopback (BOOL, multicast loopback),
+// multicastInterface (NSString, see setMulticastInterface) and groups (NSArray<NSString *> of
+// multicast groups to join, on multicastInterface if given). Absent keys are left alone.
+- (void)configureSocket:(NSNumber *)socketId options:(NSDictionary *)options completion:(UDPSocketOperationCompletion)completion;
 
 // Utility
 - (nullable NSDictionary *)getSocketAddress:(NSNumber *)socketId;
+- (void)getSocketAddress:(NSNumber *)socketId completion:(UDPSocketAddressCompletion)completion;
 - (NSArray<NSString *> *)getLocalIPAddresses;
 
 // Buffer Management methods called by C++
@@ -1,21 +1,47 @@
 #import "UDPSocketManager.h"
 #import "UDPErrorCodes.h"
 #import <GCDAsyncUdpSocket.h>
+#import <Network/Network.h> // nw_path_monitor, for interface change notifications
 #import <React/RCTLog.h> // For logging, can be replaced with a more generic logger if needed
 
-// Required system headers for getLocalIPAddresses and setsockopt
-#import <ifaddrs.h>
+// Required system headers for setsockopt
 #import <sys/socket.h>
 #import <arpa/inet.h>
 #import <netdb.h>
 #import <unistd.h> // For close() in setsockopt related scenarios if direct FD manipulation occurs.
 
-// Log macros for consistent logging within this class
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+#include "UDPDatagramSocket.h"
+#include "UDPHandleTable.h"
+#include "UDPLog.h"
+#include "UDPReceivePipeline.h"
+#include "UDPSocketStats.h"
+
+// Log macros for consistent logging within this class. Levels above UDP_LOG_LEVEL
+// compile to nothing; UDP_SM_DEBUG is for per-packet messages.
 #ifndef UDP_SM_LOG
+#if UDP_LOG_ENABLED(UDP_LOG_LEVEL_INFO)
 #define UDP_SM_LOG(fmt, ...) RCTLogInfo(@"UDPSocketManager: " fmt, ##__VA_ARGS__)
+#else
+#define UDP_SM_LOG(fmt, ...) do { } while (0)
+#endif
+#endif
+#ifndef UDP_SM_DEBUG
+#if UDP_LOG_ENABLED(UDP_LOG_LEVEL_DEBUG)
+#define UDP_SM_DEBUG(fmt, ...) RCTLogInfo(@"UDPSocketManager: " fmt, ##__VA_ARGS__)
+#else
+#define UDP_SM_DEBUG(fmt, ...) do { } while (0)
+#endif
 #endif
 #ifndef UDP_SM_ERROR
+#if UDP_LOG_ENABLED(UDP_LOG_LEVEL_ERROR)
 #define UDP_SM_ERROR(fmt, ...) RCTLogError(@"UDPSocketManager: " fmt, ##__VA_ARGS__)
+#else
+#define UDP_SM_ERROR(fmt, ...) do { } while (0)
+#endif
 #endif
 
 // Define Buffer Status Constants (internal to this manager)
@@ -35,14 +61,108 @@ static NSNumber * const kUDPSocketStatusError = @15;
 // Define the error domain
 NSString * const UDPErrorDomain = @"com.lama.udpdirect.ErrorDomain";
 
+// Read rounds per batch receive wake-up, so one busy socket cannot monopolise its receive queue
+static const int kBatchReceiveMaxRounds = 8;
+
+// Upper bound on simultaneously open sockets
+static const uint32_t kMaxSockets = 4096;
+
+// Settling time after a path change before the interface table is re-read
+static const int64_t kInterfaceRefreshDelayNs = 100 * NSEC_PER_MSEC;
+
+// Replayed datagrams delivered per receive queue block before yielding to real traffic
+static const int kReplayChunk = 256;
+
+// dispatch_queue_set_specific key marking the receive queues; the value is index + 1
+static char kUDPReceiveQueueKey;
+
+// Per-socket native state, addressed by socket id through the handle table
+struct UDPSocketState {
+    int fd4 = -1;             // Kernel descriptors, readable off the socket queue for immediate sends
+    int fd6 = -1;
+    uint32_t queuedSends = 0; // Sends in flight through GCDAsyncUdpSocket; immediate sends wait for these
+    uint32_t directSends = 0; // Immediate sends using fd4/fd6 outside the table lock; close waits for these
+    bool closing = false;     // Descriptors dropped ahead of close; never re-cached
+    bool broadcastEnabled = false; // SO_BROADCAST known to be set, so broadcast sends skip enabling it
+    bool connected = false;   // connect() completed; sends go out with send() and no address
+    udpdirect::UDPSocketAddress connectedPeer; // Its family picks the descriptor for send()
+    uint8_t receiveQueue = 0; // Index into _receiveQueues; fixed for the socket's lifetime
+    bool sendTimestamps = false; // The `timestamps` option, read per send without the options dictionary
+    GCDAsyncUdpSocket *udpSocket = nil; // Same as _asyncSockets[id], which only the delegate queue may read
+};
+
+// One receive queue and the receive-side state of the sockets assigned to it. Everything but
+// `sockets` belongs to `queue`: the socket's GCDAsyncUdpSocket delegate callbacks and batch
+// read sources run there, so receive work on different queues never contends.
+struct UDPReceiveQueue {
+    dispatch_queue_t queue;
+    NSUInteger index = 0;
+    std::unique_ptr<udpdirect::UDPBatchIO> batchIO;
+    std::unordered_map<const void *, uint32_t> socketIds; // Reverse lookup for delegate callbacks
+    std::unique_ptr<udpdirect::UDPReceivePipeline> pipeline; // Per-socket filter, checksum and reassembly stages
+    std::unordered_map<uint32_t, std::shared_ptr<udpdirect::UDPCaptureReplay>> replays; // Running replay per socket
+    uint32_t sockets = 0; // Control queue only; open sockets assigned here, for placement
+};
+
+// A queued send awaiting didSendDataWithTag:, for send latency and byte counts
+struct UDPPendingSend {
+    uint32_t socketId;
+    uint64_t enqueuedNs;
+    size_t bytes;
+    // Sends from a TX arena slot, recycled on completion
+    std::shared_ptr<udpdirect::UDPTxArena> txArena;
+    uint32_t txSlot = 0;
+    uint32_t txTicket = 0;
+};
+
+// Delegate queue only. Recycles the TX arena slot of a send that GCDAsyncUdpSocket is done with.
+static inline void UDPCompleteTxSlot(const UDPPendingSend &pending) {
+    if (pending.txArena) {
+        pending.txArena->complete(pending.txSlot, pending.txTicket);
+    }
+}
+
 @implementation UDPSocketManager {
     NSMutableDictionary<NSNumber*, GCDAsyncUdpSocket*> *_asyncSockets;
     NSMutableDictionary<NSNumber*, NSNumber*> *_socketStatus; // Stores kUDPSocketStatus...
     NSMutableDictionary<NSNumber*, NSDictionary*> *_socketInfo; // Stores original options, bound address/port
-    NSInteger _nextSocketId;
-    long _nextSendTag;
-
-    dispatch_queue_t _delegateQueue; // The queue for GCDAsyncUdpSocket delegate methods & internal sync
+    std::atomic<long> _nextSendTag;
+    std::unordered_map<long, UDPPendingSend> _pendingSends; // Delegate queue only; keyed by tag
+
+    dispatch_queue_t _delegateQueue; // Control queue: socket lifecycle, options, queued sends, send completions
+    std::vector<std::unique_ptr<UDPReceiveQueue>> _receiveQueues; // Fixed after init
+
+    std::shared_ptr<udpdirect::UDPBufferPool> _receivePool; // Slab pool for onSlotReceived delivery
+    std::shared_ptr<udpdirect::UDPTrace> _trace;            // Per-packet trace records, off unless enabled
+    std::shared_ptr<udpdirect::UDPSocketStats> _stats;      // Per-socket counters and latency histograms
+    std::shared_ptr<udpdirect::UDPCapture> _capture;        // pcapng recording, off unless started
+
+    // Socket ids are generation-checked handles into _socketTable, so a stale id never
+    // aliases a newer socket. Immediate sends pin the descriptor under the mutex (directSends)
+    // and make the syscall without it; forgetSocketFDs waits on _directSendsDone until the
+    // pins are gone, so close cannot race them.
+    std::mutex _socketTableMutex;
+    std::condition_variable _directSendsDone;
+    std::unique_ptr<udpdirect::UDPHandleTable<UDPSocketState>> _socketTable;
+
+    std::mutex _sendBatchMutex;
+    std::unique_ptr<udpdirect::UDPBatchIO> _sendBatchIO;    // Used under _sendBatchMutex
+    NSMutableDictionary<NSNumber*, NSArray<dispatch_source_t>*> *_batchReceiveSources; // Sockets read by their receive queue's batchIO instead of GCDAsyncUdpSocket
+
+    // Paced sends. Enqueued from any thread under the mutex; drained by _sendTimer and by an
+    // immediate pass after each enqueue, both on the delegate queue.
+    std::mutex _schedulerMutex;
+    std::unique_ptr<udpdirect::UDPSendScheduler> _sendScheduler;
+    std::vector<udpdirect::UDPScheduledSend> _readySends; // Delegate queue only, reused per drain
+    dispatch_source_t _sendTimer;
+    std::atomic<bool> _sendDrainQueued;
+
+    // Interfaces are re-read only after a path change; changes reported within
+    // kInterfaceRefreshDelayNs of each other are applied with one read. Delegate queue only.
+    std::shared_ptr<udpdirect::UDPInterfaceMonitor> _interfaceMonitor;
+    nw_path_monitor_t _pathMonitor;
+    BOOL _interfaceRefreshQueued;
+    uint64_t _appliedInterfaceVersion; // Table version the packet filters were last given
 }
 
 @synthesize buffers = _buffers; // Synthesize to make readonly property work with internal mutation
@@ -53,6 +173,59 @@ NSString * const UDPErrorDomain = @"com.lama.udpdirect.ErrorDomain";
     return _delegateQueue;
 }
 
+- (NSUInteger)receiveQueueCount {
+    return _receiveQueues.size();
+}
+
+- (dispatch_queue_t)receiveQueueAtIndex:(NSUInteger)index {
+    return _receiveQueues[index]->queue;
+}
+
+- (NSUInteger)receiveQueueIndexForSocket:(NSNumber *)socketId {
+    UDPReceiveQueue *receiveQueue = [self receiveQueueForSocket:socketId];
+    return receiveQueue ? receiveQueue->index : NSNotFound;
+}
+
+- (NSUInteger)currentReceiveQueueIndex {
+    uintptr_t marker = (uintptr_t)dispatch_get_specific(&kUDPReceiveQueueKey);
+    return marker == 0 ? NSNotFound : marker - 1;
+}
+
+- (nullable UDPReceiveQueue *)receiveQueueForSocket:(NSNumber *)socketId {
+    std::lock_guard<std::mutex> lock(_socketTableMutex);
+    UDPSocketState *state = _socketTable->get(socketId.unsignedIntValue);
+    return state ? _receiveQueues[state->receiveQueue].get() : nullptr;
+}
+
+// Only valid inside delegate callbacks and batch read handlers, which run on a receive queue
+- (UDPReceiveQueue *)currentReceiveQueue {
+    return _receiveQueues[[self currentReceiveQueueIndex]].get();
+}
+
+- (std::shared_ptr<udpdirect::UDPBufferPool>)receivePool {
+    return _receivePool;
+}
+
+- (std::shared_ptr<udpdirect::UDPTrace>)trace {
+    return _trace;
+}
+
+- (void)setTraceEnabled:(BOOL)enabled {
+    _trace->setEnabled(enabled);
+}
+
+- (std::shared_ptr<udpdirect::UDPSocketStats>)stats {
+    return _stats;
+}
+
+- (std::shared_ptr<udpdirect::UDPCapture>)capture {
+    return _capture;
+}
+
+- (long)nextSendTag {
+    return _nextSendTag.fetch_add(1, std::memory_order_relaxed);
+}
+
 - (NSDictionary<NSNumber*, GCDAsyncUdpSocket*> *)asyncSockets {
     return [_asyncSockets copy];  // Return immutable copy for thread safety
 }
@@ -84,10 +257,11 @@ NSString * const UDPErrorDomain = @"com.lama.udpdirect.ErrorDomain";
             return nil;
         }
         
-        // Use timestamp-based socket IDs to avoid collisions after reload
-        _nextSocketId = (NSInteger)([[NSDate date] timeIntervalSince1970] * 1000) % 1000000;
-        _nextSendTag = 0;
-        UDP_SM_LOG(@"Initial socket ID counter: %ld", (long)_nextSocketId);
+        // Seed handle generations from the clock so ids from a previous manager
+        // (e.g. before a reload) do not match sockets created by this one
+        uint16_t generationSeed = (uint16_t)((uint64_t)([[NSDate date] timeIntervalSince1970] * 1000) % 0xFFFF) + 1;
+        _socketTable = std::make_unique<udpdirect::UDPHandleTable<UDPSocketState>>(kMaxSockets, generationSeed);
+        _nextSendTag = 1; // 0 is left for callers that do not track their sends
 
         _buffers = [NSMutableDictionary dictionary];
         _bufferStatus = [NSMutableDictionary dictionary];
@@ -99,6 +273,48 @@ NSString * const UDPErrorDomain = @"com.lama.udpdirect.ErrorDomain";
         
         _nextBufferId = 1; // Buffer IDs also start from 1
 
+        _receivePool = std::make_shared<udpdirect::UDPBufferPool>();
+        _trace = std::make_shared<udpdirect::UDPTrace>();
+        _stats = std::make_shared<udpdirect::UDPSocketStats>(kMaxSockets);
+        _capture = std::make_shared<udpdirect::UDPCapture>();
+        _sendBatchIO = std::make_unique<udpdirect::UDPBatchIO>();
+
+        // One serial receive queue per core, so receive work on busy sockets runs in parallel
+        // and never waits behind the control queue
+        NSUInteger receiveQueueCount = MIN(MAX([NSProcessInfo processInfo].activeProcessorCount, (NSUInteger)1), kUDPMaxReceiveQueues);
+        dispatch_queue_attr_t receiveAttr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0);
+        for (NSUInteger i = 0; i < receiveQueueCount; i++) {
+            auto receiveQueue = std::make_unique<UDPReceiveQueue>();
+            NSString *label = [NSString stringWithFormat:@"com.lama.UDPSocketManager.receive.%lu", (unsigned long)i];
+            receiveQueue->queue = dispatch_queue_create(label.UTF8String, receiveAttr);
+            receiveQueue->index = i;
+            receiveQueue->batchIO = std::make_unique<udpdirect::UDPBatchIO>(_receivePool);
+            receiveQueue->pipeline = std::make_unique<udpdirect::UDPReceivePipeline>(_stats, _capture, _trace);
+            dispatch_queue_set_specific(receiveQueue->queue, &kUDPReceiveQueueKey, (void *)(uintptr_t)(i + 1), NULL);
+            _receiveQueues.push_back(std::move(receiveQueue));
+        }
+        _batchReceiveSources = [NSMutableDictionary dictionary];
+
+        _sendScheduler = std::make_unique<udpdirect::UDPSendScheduler>(udpdirect::UDPSendScheduler::Config());
+        _sendDrainQueued = false;
+        _sendTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _delegateQueue);
+        __weak UDPSocketManager *weakSelf = self;
+        dispatch_source_set_event_handler(_sendTimer, ^{
+            [weakSelf drainSendScheduler];
+        });
+        dispatch_source_set_timer(_sendTimer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+        dispatch_resume(_sendTimer);
+
+        _interfaceMonitor = std::make_shared<udpdirect::UDPInterfaceMonitor>();
+        _interfaceRefreshQueued = NO;
+        _appliedInterfaceVersion = 0;
+        _pathMonitor = nw_path_monitor_create();
+        nw_path_monitor_set_queue(_pathMonitor, _delegateQueue);
+        nw_path_monitor_set_update_handler(_pathMonitor, ^(nw_path_t path) {
+            [weakSelf interfacesDidChange];
+        });
+        nw_path_monitor_start(_pathMonitor);
+
         UDP_SM_LOG(@"Manager initialized successfully.");
         NSLog(@"[UDPSocketManager] INIT: Initialization completed successfully");
     } else {
@@ -125,155 +341,206 @@ NSString * const UDPErrorDomain = @"com.lama.udpdirect.ErrorDomain";
     }
     
     __block NSNumber *newSocketId = nil;
-    __block GCDAsyncUdpSocket *udpSocket = nil;
     __block NSError *creationError = nil;
-
-    UDP_SM_LOG(@"About to enter dispatch_sync block for socket creation");
-    
     dispatch_sync(_delegateQueue, ^{
-        UDP_SM_LOG(@"Inside dispatch_sync block - creating socket with next ID: %ld", (long)self->_nextSocketId);
-        
-        newSocketId = @(self->_nextSocketId++);
-        UDP_SM_LOG(@"Socket ID assigned: %@", newSocketId);
-        
-        // Retain self in the block if delegate methods need to access properties of self.
-        // However, GCDAsyncUdpSocket init doesn't capture self unless delegate methods do.
-        UDP_SM_LOG(@"About to create GCDAsyncUdpSocket with delegate: %p, queue: %p", self, self->_delegateQueue);
-        
-        udpSocket = [[GCDAsyncUdpSocket alloc] initWithDelegate:self delegateQueue:self->_delegateQueue];
-        
-        UDP_SM_LOG(@"GCDAsyncUdpSocket creation completed, result: %p", udpSocket);
+        newSocketId = [self createSocketOnQueueWithOptions:options error:&creationError];
+    });
 
-        if (!udpSocket) {
-            UDP_SM_ERROR(@"Failed to initialize GCDAsyncUdpSocket for socket %@", newSocketId);
-            NSDictionary *userInfo = @{NSLocalizedDescriptionKey: @"Failed to initialize GCDAsyncUdpSocket."};
-            creationError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeInternalException userInfo:userInfo];
-            self->_socketStatus[newSocketId] = kUDPSocketStatusError; // Mark as error even if socket is nil
-            // nextSocketId was already incremented, so newSocketId is valid for status tracking
-            return; // from dispatch_sync block
+    if (!newSocketId) {
+        if (error) {
+            *error = creationError;
         }
-        
-        UDP_SM_LOG(@"GCDAsyncUdpSocket created successfully for socket %@", newSocketId);
+        return nil;
+    }
+    return newSocketId;
+}
+
+- (void)createSocketWithOptions:(NSDictionary *)options completion:(UDPSocketCreateCompletion)completion {
+    dispatch_async(_delegateQueue, ^{
+        NSError *creationError = nil;
+        NSNumber *socketId = [self createSocketOnQueueWithOptions:options error:&creationError];
+        completion(socketId, creationError);
+    });
+}
 
-        BOOL useIPv6 = [options[@"ipv6"] boolValue];
-        [udpSocket setIPv6Enabled:useIPv6];
-        UDP_SM_LOG(@"Socket %@: IPv6 enabled: %@", newSocketId, useIPv6 ? @"YES" : @"NO");
+// Delegate queue only. Shared by the synchronous and completion forms of createSocketWithOptions.
+- (nullable NSNumber *)createSocketOnQueueWithOptions:(NSDictionary *)options error:(NSError **)error {
+    NSNumber *newSocketId = nil;
+    GCDAsyncUdpSocket *udpSocket = nil;
 
-        NSNumber *recvBufferSize = options[@"recvBufferSize"];
-        if (recvBufferSize != nil && [recvBufferSize intValue] > 0) {
-            int rcvBufSize = [recvBufferSize intValue];
-            // GCDAsyncUdpSocket documentation recommends setting these per socket type.
-            // For simplicity, setting both. Or, could check `useIPv6`.
-            [udpSocket setMaxReceiveIPv4BufferSize:rcvBufSize];
-            [udpSocket setMaxReceiveIPv6BufferSize:rcvBufSize];
-            UDP_SM_LOG(@"Socket %@: Set receive buffer size to %d", newSocketId, rcvBufSize);
+    uint32_t handle;
+    {
+        std::lock_guard<std::mutex> lock(_socketTableMutex);
+        handle = _socketTable->allocate();
+    }
+    if (handle == udpdirect::UDPHandleTable<UDPSocketState>::kInvalidHandle) {
+        UDP_SM_ERROR(@"Socket limit of %u reached", kMaxSockets);
+        *error = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeInternalException userInfo:@{NSLocalizedDescriptionKey: @"Too many open sockets."}];
+        return nil;
+    }
+    newSocketId = @(handle);
+    _stats->attach(handle);
+
+    // Sockets naming the same receiveQueue share it, e.g. to keep a discovery socket off the
+    // queue of a busy data socket; the rest go to the least loaded queue
+    UDPReceiveQueue *receiveQueue = nullptr;
+    NSNumber *requestedQueue = options[@"receiveQueue"];
+    if (requestedQueue != nil && requestedQueue.integerValue >= 0) {
+        receiveQueue = _receiveQueues[requestedQueue.unsignedIntegerValue % _receiveQueues.size()].get();
+    } else {
+        for (const auto &candidate : _receiveQueues) {
+            if (!receiveQueue || candidate->sockets < receiveQueue->sockets) {
+                receiveQueue = candidate.get();
+            }
         }
+    }
+    UDP_SM_LOG(@"Socket ID assigned: %@", newSocketId);
+    
+    // Retain self in the block if delegate methods need to access properties of self.
+    // However, GCDAsyncUdpSocket init doesn't capture self unless delegate methods do.
+    UDP_SM_LOG(@"About to create GCDAsyncUdpSocket with delegate: %p, receive queue: %lu", self, (unsigned long)receiveQueue->index);
+    
+    udpSocket = [[GCDAsyncUdpSocket alloc] initWithDelegate:self delegateQueue:receiveQueue->queue];
+    
+    UDP_SM_LOG(@"GCDAsyncUdpSocket creation completed, result: %p", udpSocket);
+
+    if (!udpSocket) {
+        UDP_SM_ERROR(@"Failed to initialize GCDAsyncUdpSocket for socket %@", newSocketId);
+        NSDictionary *userInfo = @{NSLocalizedDescriptionKey: @"Failed to initialize GCDAsyncUdpSocket."};
+        *error = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeInternalException userInfo:userInfo];
+        _socketStatus[newSocketId] = kUDPSocketStatusError; // Mark as error even if socket is nil
+        std::lock_guard<std::mutex> lock(_socketTableMutex);
+        _socketTable->release(handle);
+        return nil;
+    }
+    
+    UDP_SM_LOG(@"GCDAsyncUdpSocket created successfully for socket %@", newSocketId);
+
+    BOOL useIPv6 = [options[@"ipv6"] boolValue];
+    [udpSocket setIPv6Enabled:useIPv6];
+    UDP_SM_LOG(@"Socket %@: IPv6 enabled: %@", newSocketId, useIPv6 ? @"YES" : @"NO");
+
+    NSNumber *recvBufferSize = options[@"recvBufferSize"];
+    if (recvBufferSize != nil && [recvBufferSize intValue] > 0) {
+        int rcvBufSize = [recvBufferSize intValue];
+        // GCDAsyncUdpSocket documentation recommends setting these per socket type.
+        // For simplicity, setting both. Or, could check `useIPv6`.
+        [udpSocket setMaxReceiveIPv4BufferSize:rcvBufSize];
+        [udpSocket setMaxReceiveIPv6BufferSize:rcvBufSize];
+        UDP_SM_LOG(@"Socket %@: Set receive buffer size to %d", newSocketId, rcvBufSize);
+    }
+    
+    // Handle reuseAddr and reusePort options BEFORE storing the socket
+    BOOL reuseAddr = [options[@"reuseAddr"] boolValue];
+    BOOL reusePort = [options[@"reusePort"] boolValue];
+    
+    if (reuseAddr || reusePort) {
+        // Get socket file descriptors
+        int fd4 = [udpSocket socket4FD];
+        int fd6 = [udpSocket socket6FD];
         
-        // Handle reuseAddr and reusePort options BEFORE storing the socket
-        BOOL reuseAddr = [options[@"reuseAddr"] boolValue];
-        BOOL reusePort = [options[@"reusePort"] boolValue];
-        
-        if (reuseAddr || reusePort) {
-            // Get socket file descriptors
-            int fd4 = [udpSocket socket4FD];
-            int fd6 = [udpSocket socket6FD];
-            
-            // For SO_REUSEADDR
-            if (reuseAddr) {
-                int optval = 1;
-                if (fd4 != -1) {
-                    if (setsockopt(fd4, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) < 0) {
-                        UDP_SM_ERROR(@"Failed to set SO_REUSEADDR on IPv4 socket: %s", strerror(errno));
-                    } else {
-                        UDP_SM_LOG(@"Socket %@: SO_REUSEADDR enabled on IPv4", newSocketId);
-                    }
+        // For SO_REUSEADDR
+        if (reuseAddr) {
+            int optval = 1;
+            if (fd4 != -1) {
+                if (setsockopt(fd4, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) < 0) {
+                    UDP_SM_ERROR(@"Failed to set SO_REUSEADDR on IPv4 socket: %s", strerror(errno));
+                } else {
+                    UDP_SM_LOG(@"Socket %@: SO_REUSEADDR enabled on IPv4", newSocketId);
                 }
-                if (fd6 != -1) {
-                    if (setsockopt(fd6, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) < 0) {
-                        UDP_SM_ERROR(@"Failed to set SO_REUSEADDR on IPv6 socket: %s", strerror(errno));
-                    } else {
-                        UDP_SM_LOG(@"Socket %@: SO_REUSEADDR enabled on IPv6", newSocketId);
-                    }
+            }
+            if (fd6 != -1) {
+                if (setsockopt(fd6, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) < 0) {
+                    UDP_SM_ERROR(@"Failed to set SO_REUSEADDR on IPv6 socket: %s", strerror(errno));
+                } else {
+                    UDP_SM_LOG(@"Socket %@: SO_REUSEADDR enabled on IPv6", newSocketId);
                 }
             }
-            
-            // For SO_REUSEPORT - when reusePort is true, set BOTH SO_REUSEADDR and SO_REUSEPORT
-            if (reusePort) {
-                // Attempt to use GCDAsyncUdpSocket helper so the option is applied to *all* future FDs
-                // Some versions of CocoaAsyncSocket may not expose the `enableReusePort:` selector. To avoid
-                // a compile-time error we call it dynamically if it exists. If it is not available we simply
-                // rely on the `setsockopt` fallback below which already enables `SO_REUSEPORT`.
+        }
+        
+        // For SO_REUSEPORT - when reusePort is true, set BOTH SO_REUSEADDR and SO_REUSEPORT
+        if (reusePort) {
+            // Attempt to use GCDAsyncUdpSocket helper so the option is applied to *all* future FDs
+            // Some versions of CocoaAsyncSocket may not expose the `enableReusePort:` selector. To avoid
+            // a compile-time error we call it dynamically if it exists. If it is not available we simply
+            // rely on the `setsockopt` fallback below which already enables `SO_REUSEPORT`.
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wundeclared-selector"
-                if ([udpSocket respondsToSelector:@selector(enableReusePort:)]) {
+            if ([udpSocket respondsToSelector:@selector(enableReusePort:)]) {
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Warc-performSelector-leaks"
-                    id result = [udpSocket performSelector:@selector(enableReusePort:) withObject:@(YES)];
+                id result = [udpSocket performSelector:@selector(enableReusePort:) withObject:@(YES)];
 #pragma clang diagnostic pop
-                    // If the helper returned a BOOL wrapped in NSNumber we can log based on its value, otherwise assume success.
-                    BOOL helperSuccess = YES;
-                    if ([result isKindOfClass:[NSNumber class]]) {
-                        helperSuccess = [(NSNumber *)result boolValue];
-                    }
-                    if (!helperSuccess) {
-                        UDP_SM_ERROR(@"Failed to enable SO_REUSEPORT via GCDAsyncUdpSocket helper (dynamic call)");
-                    } else {
-                        UDP_SM_LOG(@"Socket %@: enableReusePort=YES (GCDAsyncUdpSocket via dynamic selector)", newSocketId);
-                    }
+                // If the helper returned a BOOL wrapped in NSNumber we can log based on its value, otherwise assume success.
+                BOOL helperSuccess = YES;
+                if ([result isKindOfClass:[NSNumber class]]) {
+                    helperSuccess = [(NSNumber *)result boolValue];
+                }
+                if (!helperSuccess) {
+                    UDP_SM_ERROR(@"Failed to enable SO_REUSEPORT via GCDAsyncUdpSocket helper (dynamic call)");
                 } else {
-                    UDP_SM_LOG(@"GCDAsyncUdpSocket does not implement enableReusePort:. Falling back to manual setsockopt.");
+                    UDP_SM_LOG(@"Socket %@: enableReusePort=YES (GCDAsyncUdpSocket via dynamic selector)", newSocketId);
                 }
+            } else {
+                UDP_SM_LOG(@"GCDAsyncUdpSocket does not implement enableReusePort:. Falling back to manual setsockopt.");
+            }
 #pragma clang diagnostic pop
 
-                int optval = 1;
-                if (fd4 != -1) {
-                    // First ensure SO_REUSEADDR is set (if not already set above)
-                    if (!reuseAddr) {
-                        if (setsockopt(fd4, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) < 0) {
-                            UDP_SM_ERROR(@"Failed to set SO_REUSEADDR on IPv4 socket: %s", strerror(errno));
-                        } else {
-                            UDP_SM_LOG(@"Socket %@: SO_REUSEADDR enabled on IPv4 (for reusePort)", newSocketId);
-                        }
-                    }
-                    // Then set SO_REUSEPORT
-                    if (setsockopt(fd4, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof(optval)) < 0) {
-                        UDP_SM_ERROR(@"Failed to set SO_REUSEPORT on IPv4 socket: %s", strerror(errno));
+            int optval = 1;
+            if (fd4 != -1) {
+                // First ensure SO_REUSEADDR is set (if not already set above)
+                if (!reuseAddr) {
+                    if (setsockopt(fd4, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) < 0) {
+                        UDP_SM_ERROR(@"Failed to set SO_REUSEADDR on IPv4 socket: %s", strerror(errno));
                     } else {
-                        UDP_SM_LOG(@"Socket %@: SO_REUSEPORT enabled on IPv4", newSocketId);
+                        UDP_SM_LOG(@"Socket %@: SO_REUSEADDR enabled on IPv4 (for reusePort)", newSocketId);
                     }
                 }
-                if (fd6 != -1) {
-                    // First ensure SO_REUSEADDR is set (if not already set above)
-                    if (!reuseAddr) {
-                        if (setsockopt(fd6, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) < 0) {
-                            UDP_SM_ERROR(@"Failed to set SO_REUSEADDR on IPv6 socket: %s", strerror(errno));
-                        } else {
-                            UDP_SM_LOG(@"Socket %@: SO_REUSEADDR enabled on IPv6 (for reusePort)", newSocketId);
-                        }
-                    }
-                    // Then set SO_REUSEPORT
-                    if (setsockopt(fd6, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof(optval)) < 0) {
-                        UDP_SM_ERROR(@"Failed to set SO_REUSEPORT on IPv6 socket: %s", strerror(errno));
+                // Then set SO_REUSEPORT
+                if (setsockopt(fd4, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof(optval)) < 0) {
+                    UDP_SM_ERROR(@"Failed to set SO_REUSEPORT on IPv4 socket: %s", strerror(errno));
+                } else {
+                    UDP_SM_LOG(@"Socket %@: SO_REUSEPORT enabled on IPv4", newSocketId);
+                }
+            }
+            if (fd6 != -1) {
+                // First ensure SO_REUSEADDR is set (if not already set above)
+                if (!reuseAddr) {
+                    if (setsockopt(fd6, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) < 0) {
+                        UDP_SM_ERROR(@"Failed to set SO_REUSEADDR on IPv6 socket: %s", strerror(errno));
                     } else {
-                        UDP_SM_LOG(@"Socket %@: SO_REUSEPORT enabled on IPv6", newSocketId);
+                        UDP_SM_LOG(@"Socket %@: SO_REUSEADDR enabled on IPv6 (for reusePort)", newSocketId);
                     }
                 }
+                // Then set SO_REUSEPORT
+                if (setsockopt(fd6, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof(optval)) < 0) {
+                    UDP_SM_ERROR(@"Failed to set SO_REUSEPORT on IPv6 socket: %s", strerror(errno));
+                } else {
+                    UDP_SM_LOG(@"Socket %@: SO_REUSEPORT enabled on IPv6", newSocketId);
+                }
             }
         }
-        
-        self->_asyncSockets[newSocketId] = udpSocket;
-        self->_socketStatus[newSocketId] = kUDPSocketStatusCreated;
-        NSMutableDictionary *info = [NSMutableDictionary dictionary];
-        info[@"options"] = options ?: @{};
-        self->_socketInfo[newSocketId] = info;
+    }
+    
+    _asyncSockets[newSocketId] = udpSocket;
+    {
+        std::lock_guard<std::mutex> lock(_socketTableMutex);
+        UDPSocketState *state = _socketTable->get(handle);
+        state->udpSocket = udpSocket;
+        state->receiveQueue = (uint8_t)receiveQueue->index;
+        state->sendTimestamps = [options[@"timestamps"] boolValue];
+    }
+    receiveQueue->sockets++;
+    // Queued ahead of anything the socket can deliver, since it is not receiving yet
+    const void *socketKey = (__bridge const void *)udpSocket;
+    dispatch_async(receiveQueue->queue, ^{
+        receiveQueue->socketIds[socketKey] = handle;
     });
+    _socketStatus[newSocketId] = kUDPSocketStatusCreated;
+    NSMutableDictionary *info = [NSMutableDictionary dictionary];
+    info[@"options"] = options ?: @{};
+    _socketInfo[newSocketId] = info;
 
-    if (creationError) {
-        if (error) {
-            *error = creationError;
-        }
-        return nil;
-    }
     UDP_SM_LOG(@"Created socket %@ successfully.", newSocketId);
     return newSocketId;
 }
@@ -281,110 +548,277 @@ NSString * const UDPErrorDomain = @"com.lama.udpdirect.ErrorDomain";
 - (BOOL)bindSocket:(NSNumber *)socketId toPort:(uint16_t)port address:(nullable NSString *)address error:(NSError **)error {
     __block BOOL success = NO;
     __block NSError *bindError = nil;
-
     dispatch_sync(_delegateQueue, ^{
-        GCDAsyncUdpSocket *udpSocket = self->_asyncSockets[socketId];
-        if (!udpSocket) {
-            NSDictionary *userInfo = @{NSLocalizedDescriptionKey: [NSString stringWithFormat:@"Socket %@ not found for bind.", socketId]};
-            bindError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:userInfo];
+        success = [self bindSocketOnQueue:socketId toPort:port address:address error:&bindError];
+    });
+
+    if (!success && error) {
+        *error = bindError;
+    }
+    return success;
+}
+
+- (void)bindSocket:(NSNumber *)socketId toPort:(uint16_t)port address:(nullable NSString *)address completion:(UDPSocketAddressCompletion)completion {
+    dispatch_async(_delegateQueue, ^{
+        NSError *bindError = nil;
+        if (![self bindSocketOnQueue:socketId toPort:port address:address error:&bindError]) {
+            completion(nil, bindError);
             return;
         }
+        completion([self socketAddressOnQueue:socketId], nil);
+    });
+}
 
-        BOOL ipv6Enabled = [udpSocket isIPv6Enabled];
-        NSString *interfaceToBind = address;
+// Delegate queue only. Shared by the synchronous and completion forms of bindSocket.
+- (BOOL)bindSocketOnQueue:(NSNumber *)socketId toPort:(uint16_t)port address:(nullable NSString *)address error:(NSError **)error {
+    GCDAsyncUdpSocket *udpSocket = _asyncSockets[socketId];
+    if (!udpSocket) {
+        NSDictionary *userInfo = @{NSLocalizedDescriptionKey: [NSString stringWithFormat:@"Socket %@ not found for bind.", socketId]};
+        *error = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:userInfo];
+        return NO;
+    }
 
-        if (interfaceToBind) {
-            if (([interfaceToBind isEqualToString:@"0.0.0.0"] && !ipv6Enabled) || ([interfaceToBind isEqualToString:@"::"] && ipv6Enabled)) {
-                UDP_SM_LOG(@"Binding socket %@ to any interface ('%@'), setting interface to nil for GCDAsyncUdpSocket", socketId, interfaceToBind);
-                interfaceToBind = nil;
-            }
-        } else {
-             UDP_SM_LOG(@"Binding socket %@ with nil address, defaulting to any interface.", socketId);
-        }
+    BOOL ipv6Enabled = [udpSocket isIPv6Enabled];
+    NSString *interfaceToBind = address;
 
-        NSError *nativeError = nil;
-        if (![udpSocket bindToPort:port interface:interfaceToBind error:&nativeError]) {
-            NSString *errMsg = [NSString stringWithFormat:@"Failed to bind socket %@ to %@:%u. Error: %@", socketId, address ?: (ipv6Enabled ? @"::" : @"0.0.0.0"), port, nativeError.localizedDescription];
-            NSDictionary *userInfo = @{
-                NSLocalizedDescriptionKey: errMsg,
-                @"nativeErrorCode": @(nativeError.code),
-                @"nativeErrorDomain": nativeError.domain ?: @"UnknownDomain"
-            };
-            bindError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeBindFailed userInfo:userInfo];
-            self->_socketStatus[socketId] = kUDPSocketStatusError;
-            return;
+    if (interfaceToBind) {
+        if (([interfaceToBind isEqualToString:@"0.0.0.0"] && !ipv6Enabled) || ([interfaceToBind isEqualToString:@"::"] && ipv6Enabled)) {
+            UDP_SM_LOG(@"Binding socket %@ to any interface ('%@'), setting interface to nil for GCDAsyncUdpSocket", socketId, interfaceToBind);
+            interfaceToBind = nil;
         }
+    } else {
+         UDP_SM_LOG(@"Binding socket %@ with nil address, defaulting to any interface.", socketId);
+    }
 
-        self->_socketStatus[socketId] = kUDPSocketStatusBound;
-        NSMutableDictionary *info = [self->_socketInfo[socketId] mutableCopy] ?: [NSMutableDictionary dictionary];
-        info[@"boundAddress"] = [udpSocket localHost] ?: (interfaceToBind ?: (ipv6Enabled ? @"::" : @"0.0.0.0"));
-        info[@"boundPort"] = @([udpSocket localPort]);
-        self->_socketInfo[socketId] = info;
-        UDP_SM_LOG(@"Socket %@ bound to %@:%hu (Local: %@:%hu)", socketId, interfaceToBind ?: (ipv6Enabled ? @"::" : @"0.0.0.0"), port, [udpSocket localHost_IPv4] ?: ([udpSocket localHost_IPv6] ?: @"unknown"), [udpSocket localPort]);
-
-        // Only start receiving if callbacks are properly set up to prevent crashes
-        if (self.onDataReceived) {
-            NSError *receiveErr = nil;
-            if (![udpSocket beginReceiving:&receiveErr]) {
-                UDP_SM_ERROR(@"Socket %@: Failed to beginReceiving after bind: %@", socketId, receiveErr.localizedDescription);
-                self->_socketStatus[socketId] = kUDPSocketStatusError;
-                // This is a non-fatal error for the bind operation itself, but owner should be notified.
-                // The C++ layer can decide if this is critical. For now, bind itself is "success".
-            } else {
-                UDP_SM_LOG(@"Socket %@ now listening for datagrams.", socketId);
-            }
+    NSError *nativeError = nil;
+    if (![udpSocket bindToPort:port interface:interfaceToBind error:&nativeError]) {
+        NSString *errMsg = [NSString stringWithFormat:@"Failed to bind socket %@ to %@:%u. Error: %@", socketId, address ?: (ipv6Enabled ? @"::" : @"0.0.0.0"), port, nativeError.localizedDescription];
+        NSDictionary *userInfo = @{
+            NSLocalizedDescriptionKey: errMsg,
+            @"nativeErrorCode": @(nativeError.code),
+            @"nativeErrorDomain": nativeError.domain ?: @"UnknownDomain"
+        };
+        *error = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeBindFailed userInfo:userInfo];
+        _socketStatus[socketId] = kUDPSocketStatusError;
+        return NO;
+    }
+
+    _socketStatus[socketId] = kUDPSocketStatusBound;
+    NSMutableDictionary *info = [_socketInfo[socketId] mutableCopy] ?: [NSMutableDictionary dictionary];
+    info[@"boundAddress"] = [udpSocket localHost] ?: (interfaceToBind ?: (ipv6Enabled ? @"::" : @"0.0.0.0"));
+    info[@"boundPort"] = @([udpSocket localPort]);
+    _socketInfo[socketId] = info;
+    _capture->noteSocket(socketId.unsignedIntValue, [udpSocket localPort]);
+    [self cacheSocketFDs:udpSocket forSocket:socketId];
+    [self refreshPacketFilterAddressesForSocket:socketId];
+    UDP_SM_LOG(@"Socket %@ bound to %@:%hu (Local: %@:%hu)", socketId, interfaceToBind ?: (ipv6Enabled ? @"::" : @"0.0.0.0"), port, [udpSocket localHost_IPv4] ?: ([udpSocket localHost_IPv6] ?: @"unknown"), [udpSocket localPort]);
+
+    // Only start receiving if callbacks are properly set up to prevent crashes
+    if (self.onDataReceived || self.onSlotReceived) {
+        NSError *receiveErr = nil;
+        if (![self beginReceivingOnSocket:udpSocket socketId:socketId error:&receiveErr]) {
+            UDP_SM_ERROR(@"Socket %@: Failed to beginReceiving after bind: %@", socketId, receiveErr.localizedDescription);
+            _socketStatus[socketId] = kUDPSocketStatusError;
+            // This is a non-fatal error for the bind operation itself, but owner should be notified.
+            // The C++ layer can decide if this is critical. For now, bind itself is "success".
         } else {
-            UDP_SM_LOG(@"Socket %@ bound but not yet receiving - waiting for data event handler setup", socketId);
+            UDP_SM_LOG(@"Socket %@ now listening for datagrams.", socketId);
         }
-        
-        NSDictionary *origOptions = self->_socketInfo[socketId][@"options"];
-        if (origOptions && [origOptions[@"broadcast"] boolValue]) {
-            NSError *broadcastError = nil;
-            if (![udpSocket enableBroadcast:YES error:&broadcastError]) {
-                 UDP_SM_ERROR(@"Socket %@: Failed to enable broadcast after bind: %@", socketId, broadcastError.localizedDescription);
-            } else {
-                UDP_SM_LOG(@"Socket %@ broadcast flag enabled after bind.", socketId);
-            }
+    } else {
+        UDP_SM_LOG(@"Socket %@ bound but not yet receiving - waiting for data event handler setup", socketId);
+    }
+    
+    NSDictionary *origOptions = _socketInfo[socketId][@"options"];
+    if (origOptions && [origOptions[@"broadcast"] boolValue]) {
+        NSError *broadcastError = nil;
+        if (![udpSocket enableBroadcast:YES error:&broadcastError]) {
+             UDP_SM_ERROR(@"Socket %@: Failed to enable broadcast after bind: %@", socketId, broadcastError.localizedDescription);
+        } else {
+            [self noteBroadcastEnabled:YES onSocket:socketId];
+            UDP_SM_LOG(@"Socket %@ broadcast flag enabled after bind.", socketId);
         }
-        success = YES;
-    });
-
-    if (!success && error) {
-        *error = bindError;
     }
-    return success;
+    return YES;
 }
 
 - (void)sendData:(NSData *)data onSocket:(NSNumber *)socketId toHost:(NSString *)host port:(uint16_t)port tag:(long)tag {
-    // Perform a quick lookup synchronously so we don't capture a nil socket
-    GCDAsyncUdpSocket *udpSocket = _asyncSockets[socketId];
+    GCDAsyncUdpSocket *udpSocket = [self socketForQueuedSend:socketId tag:tag];
+    if (!udpSocket) {
+        return;
+    }
+
+    UDP_SM_DEBUG(@"Socket %@: Queueing %lu bytes to %@:%u with tag %ld", socketId, (unsigned long)data.length, host, port, tag);
+    BOOL broadcast = [host isEqualToString:@"255.255.255.255"] || [host hasSuffix:@".255"];
+    udpdirect::UDPSocketAddress peer; // Hostnames are recorded without an address
+    if (_capture->active()) {
+        udpdirect::UDPSocketAddress::fromNumericHost(host.UTF8String, port, peer);
+    }
+    [self enqueueSend:data onSocket:udpSocket socketId:socketId peer:peer broadcast:broadcast tag:tag send:^{
+        [udpSocket sendData:data toHost:host port:port withTimeout:-1 tag:tag];
+    }];
+}
+
+- (void)sendData:(NSData *)data onSocket:(NSNumber *)socketId toEndpoint:(const udpdirect::UDPEndpoint &)endpoint tag:(long)tag {
+    GCDAsyncUdpSocket *udpSocket = [self socketForQueuedSend:socketId tag:tag];
+    if (!udpSocket) {
+        return;
+    }
+    // GCDAsyncUdpSocket takes the sockaddr as-is, so nothing is resolved on its queue either
+    NSData *address = [NSData dataWithBytes:&endpoint.sockaddr length:endpoint.sockaddrLength];
+    [self enqueueSend:data onSocket:udpSocket socketId:socketId peer:endpoint.address broadcast:endpoint.broadcast tag:tag send:^{
+        [udpSocket sendData:data toAddress:address withTimeout:-1 tag:tag];
+    }];
+}
+
+- (UDPImmediateSendResult)sendTxSlot:(uint32_t)slot ticket:(uint32_t)ticket length:(size_t)length arena:(std::shared_ptr<udpdirect::UDPTxArena>)arena onSocket:(NSNumber *)socketId toEndpoint:(const udpdirect::UDPEndpoint &)endpoint {
+    uint8_t *bytes = arena->slotData(slot);
+    long tag = [self nextSendTag];
+    UDPImmediateSendResult result = [self sendBytesImmediately:bytes length:length onSocket:socketId toEndpoint:endpoint tag:tag];
+    if (result != UDPImmediateSendDeferred) {
+        arena->complete(slot, ticket);
+        return result;
+    }
+    GCDAsyncUdpSocket *udpSocket = [self socketForQueuedSend:socketId tag:tag];
+    if (!udpSocket) {
+        arena->complete(slot, ticket);
+        return UDPImmediateSendFailed;
+    }
+
+    // Wrap the slot without copying. The deallocator covers sends GCDAsyncUdpSocket drops
+    // without a callback, as on close; the ticket makes whichever completion comes second a no-op.
+    NSData *data = [[NSData alloc] initWithBytesNoCopy:bytes length:length deallocator:^(void *, NSUInteger) {
+        arena->complete(slot, ticket);
+    }];
+    NSData *address = [NSData dataWithBytes:&endpoint.sockaddr length:endpoint.sockaddrLength];
+    [self enqueueSend:data onSocket:udpSocket socketId:socketId peer:endpoint.address broadcast:endpoint.broadcast tag:tag send:^{
+        auto pending = self->_pendingSends.find(tag);
+        if (pending != self->_pendingSends.end()) {
+            pending->second.txArena = arena;
+            pending->second.txSlot = slot;
+            pending->second.txTicket = ticket;
+        }
+        [udpSocket sendData:data toAddress:address withTimeout:-1 tag:tag];
+    }];
+    return UDPImmediateSendDeferred;
+}
+
+- (void)sendData:(NSData *)data onConnectedSocket:(NSNumber *)socketId tag:(long)tag {
+    GCDAsyncUdpSocket *udpSocket = [self socketForQueuedSend:socketId tag:tag];
+    if (!udpSocket) {
+        return;
+    }
+    udpdirect::UDPSocketAddress peer;
+    if (_capture->active()) {
+        std::lock_guard<std::mutex> lock(_socketTableMutex);
+        if (UDPSocketState *state = _socketTable->get(socketId.unsignedIntValue)) {
+            peer = state->connectedPeer;
+        }
+    }
+    // Sends issued while the connect is still in progress wait for it inside GCDAsyncUdpSocket
+    [self enqueueSend:data onSocket:udpSocket socketId:socketId peer:peer broadcast:NO tag:tag send:^{
+        [udpSocket sendData:data withTimeout:-1 tag:tag];
+    }];
+}
+
+// Looks the socket up on the calling thread so a queued send never captures nil; reports
+// a missing socket through onSendFailure. Goes through the handle table under its lock, since
+// the delegate queue mutates _asyncSockets concurrently.
+- (nullable GCDAsyncUdpSocket *)socketForQueuedSend:(NSNumber *)socketId tag:(long)tag {
+    GCDAsyncUdpSocket *udpSocket = nil;
+    {
+        std::lock_guard<std::mutex> lock(_socketTableMutex);
+        if (UDPSocketState *state = _socketTable->get(socketId.unsignedIntValue)) {
+            udpSocket = state->udpSocket;
+        }
+    }
     if (!udpSocket) {
         UDP_SM_ERROR(@"Socket %@ not found for sending.", socketId);
         if (self.onSendFailure) {
             NSDictionary *userInfo = @{NSLocalizedDescriptionKey: [NSString stringWithFormat:@"Socket %@ not found for sending.", socketId]};
-            NSError *notFoundError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:userInfo];
-            self.onSendFailure(socketId, tag, notFoundError);
+            self.onSendFailure(socketId, tag, [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:userInfo]);
         }
-        return;
     }
+    return udpSocket;
+}
+
+// Common tail of the queued sends. `send` hands the datagram to GCDAsyncUdpSocket on the
+// delegate queue, which preserves ordering with the delegate callbacks. `peer` is only
+// for the capture and may be unset.
+- (void)enqueueSend:(NSData *)data onSocket:(GCDAsyncUdpSocket *)udpSocket socketId:(NSNumber *)socketId peer:(const udpdirect::UDPSocketAddress &)peer broadcast:(BOOL)broadcast tag:(long)tag send:(dispatch_block_t)send {
+    [self adjustQueuedSends:socketId by:1];
+    uint64_t enqueuedNs = udpdirect::UDPMonotonicNowNs();
+    udpdirect::UDPSocketAddress capturePeer = peer; // Blocks capture references by reference
 
-    // Use async queue for the real send to preserve ordering with delegate callbacks
     dispatch_async(_delegateQueue, ^{
-        // Ensure broadcast is enabled when sending to broadcast addresses
-        if ([host isEqualToString:@"255.255.255.255"] || [host hasSuffix:@".255"]) {
-            NSError *broadcastError = nil;
-            if (![udpSocket enableBroadcast:YES error:&broadcastError]) {
-                UDP_SM_ERROR(@"Socket %@: Failed to enable broadcast for send: %@", socketId, broadcastError.localizedDescription);
-                if (self.onSendFailure) {
-                    self.onSendFailure(socketId, tag, broadcastError);
-                }
-                return;
+        NSError *broadcastError = nil;
+        if (broadcast && ![self enableBroadcastOnceOnSocket:udpSocket socketId:socketId error:&broadcastError]) {
+            UDP_SM_ERROR(@"Socket %@: Failed to enable broadcast for send: %@", socketId, broadcastError.localizedDescription);
+            [self adjustQueuedSends:socketId by:-1];
+            if (udpdirect::UDPSocketCounters *counters = self->_stats->find(socketId.unsignedIntValue)) {
+                counters->sendFailures.fetch_add(1, std::memory_order_relaxed);
             }
-            UDP_SM_LOG(@"Socket %@: Enabled broadcast for send to %@", socketId, host);
+            if (self.onSendFailure) {
+                self.onSendFailure(socketId, tag, broadcastError);
+            }
+            return;
         }
 
-        UDP_SM_LOG(@"Socket %@: Sending %lu bytes to %@:%u with tag %ld", socketId, (unsigned long)data.length, host, port, tag);
-        [udpSocket sendData:data toHost:host port:port withTimeout:-1 tag:tag];
+        UDP_TRACE(*self->_trace, SendQueued, socketId.unsignedIntValue, data.length);
+        self->_capture->record(udpdirect::UDPCaptureDirection::Outbound, socketId.unsignedIntValue, capturePeer,
+                               (const uint8_t *)data.bytes, data.length);
+        [self trackPendingSend:tag socketId:socketId enqueuedNs:enqueuedNs bytes:data.length];
+        send();
+    });
+}
+
+// Delegate queue only. Broadcast is switched on once per socket, not once per datagram.
+- (BOOL)enableBroadcastOnceOnSocket:(GCDAsyncUdpSocket *)udpSocket socketId:(NSNumber *)socketId error:(NSError **)error {
+    {
+        std::lock_guard<std::mutex> lock(_socketTableMutex);
+        UDPSocketState *state = _socketTable->get(socketId.unsignedIntValue);
+        if (state && state->broadcastEnabled) {
+            return YES;
+        }
+    }
+    if (![udpSocket enableBroadcast:YES error:error]) {
+        return NO;
+    }
+    [self noteBroadcastEnabled:YES onSocket:socketId];
+    UDP_SM_LOG(@"Socket %@: Enabled broadcast", socketId);
+    return YES;
+}
+
+- (void)noteBroadcastEnabled:(BOOL)enabled onSocket:(NSNumber *)socketId {
+    std::lock_guard<std::mutex> lock(_socketTableMutex);
+    if (UDPSocketState *state = _socketTable->get(socketId.unsignedIntValue)) {
+        state->broadcastEnabled = enabled;
+    }
+}
+
+- (void)connectSocket:(NSNumber *)socketId toEndpoint:(const udpdirect::UDPEndpoint &)endpoint completion:(UDPSocketOperationCompletion)completion {
+    NSData *address = [NSData dataWithBytes:&endpoint.sockaddr length:endpoint.sockaddrLength];
+    udpdirect::UDPSocketAddress peer = endpoint.address;
+    BOOL broadcast = endpoint.broadcast;
+    dispatch_async(_delegateQueue, ^{
+        GCDAsyncUdpSocket *udpSocket = self->_asyncSockets[socketId];
+        if (!udpSocket) {
+            completion([NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:@{NSLocalizedDescriptionKey:@"Socket not found"}]);
+            return;
+        }
+        NSError *nativeError = nil;
+        if (![udpSocket connectToAddress:address error:&nativeError] ||
+            (broadcast && ![self enableBroadcastOnceOnSocket:udpSocket socketId:socketId error:&nativeError])) {
+            completion([NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeConnectFailed userInfo:@{NSLocalizedDescriptionKey: nativeError.localizedDescription ?: @"Connect failed", @"nativeError": nativeError ?: [NSNull null]}]);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(self->_socketTableMutex);
+            if (UDPSocketState *state = self->_socketTable->get(socketId.unsignedIntValue)) {
+                state->connectedPeer = peer;
+            }
+        }
+        UDP_SM_LOG(@"Socket %@ connecting to %s:%u", socketId, peer.hostString().c_str(), peer.port);
+        completion(nil);
     });
 }
 
@@ -421,16 +855,266 @@ NSString * const UDPErrorDomain = @"com.lama.udpdirect.ErrorDomain";
         const void *dataPtr = (const char *)buffer.bytes + offset;
         NSData *dataToSend = [NSData dataWithBytesNoCopy:(void*)dataPtr length:length freeWhenDone:NO];
         
-        UDP_SM_LOG(@"Socket %@: Sending %lu bytes from buffer %@ (offset %lu) to %@:%u with tag %ld", socketId, (unsigned long)length, bufferId, (unsigned long)offset, host, port, tag);
+        UDP_SM_DEBUG(@"Socket %@: Sending %lu bytes from buffer %@ (offset %lu) to %@:%u with tag %ld", socketId, (unsigned long)length, bufferId, (unsigned long)offset, host, port, tag);
+        UDP_TRACE(*self->_trace, SendQueued, socketId.unsignedIntValue, length);
+        [self adjustQueuedSends:socketId by:1];
+        [self trackPendingSend:tag socketId:socketId enqueuedNs:udpdirect::UDPMonotonicNowNs() bytes:length];
         [udpSocket sendData:dataToSend toHost:host port:port withTimeout:-1 tag:tag];
     });
 }
 
+- (UDPImmediateSendResult)sendBytesImmediately:(const void *)bytes length:(size_t)length onSocket:(NSNumber *)socketId toAddress:(const udpdirect::UDPSocketAddress &)destination tag:(long)tag {
+    udpdirect::UDPEndpoint endpoint = udpdirect::UDPEndpoint::fromAddress(destination);
+    return [self sendBytesImmediately:bytes length:length onSocket:socketId toEndpoint:endpoint tag:tag];
+}
+
+- (UDPImmediateSendResult)sendBytesImmediately:(const void *)bytes length:(size_t)length onSocket:(NSNumber *)socketId toEndpoint:(const udpdirect::UDPEndpoint &)endpoint tag:(long)tag {
+    if (endpoint.sockaddrLength == 0) {
+        return UDPImmediateSendDeferred;
+    }
+    return [self sendBytesImmediately:bytes length:length onSocket:socketId endpoint:&endpoint tag:tag];
+}
+
+- (UDPImmediateSendResult)sendBytesImmediately:(const void *)bytes length:(size_t)length onConnectedSocket:(NSNumber *)socketId tag:(long)tag {
+    return [self sendBytesImmediately:bytes length:length onSocket:socketId endpoint:nullptr tag:tag];
+}
+
+// Shared immediate send; a null endpoint means the socket's connected peer.
+- (UDPImmediateSendResult)sendBytesImmediately:(const void *)bytes length:(size_t)length onSocket:(NSNumber *)socketId endpoint:(const udpdirect::UDPEndpoint *)endpoint tag:(long)tag {
+    uint32_t handle = socketId.unsignedIntValue;
+    udpdirect::UDPSocketAddress peer;
+    int fd = -1;
+    {
+        std::lock_guard<std::mutex> lock(_socketTableMutex);
+        UDPSocketState *state = _socketTable->get(handle);
+        // Addressed sends on a connected socket are left to the queued path to reject
+        if (!state || state->queuedSends > 0 || state->connected != (endpoint == nullptr)) {
+            return UDPImmediateSendDeferred;
+        }
+        peer = endpoint ? endpoint->address : state->connectedPeer;
+        fd = peer.family == AF_INET6 ? state->fd6 : state->fd4;
+        if (fd == -1) {
+            return UDPImmediateSendDeferred;
+        }
+        if (endpoint && endpoint->broadcast && !state->broadcastEnabled) {
+            int on = 1;
+            if (setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on)) != 0) {
+                return UDPImmediateSendDeferred;
+            }
+            state->broadcastEnabled = true;
+        }
+        state->directSends++;
+    }
+
+    int sendErrno = 0;
+    udpdirect::UDPSendStatus status = endpoint
+        ? udpdirect::UDPSendDatagram(fd, bytes, length, (const struct sockaddr *)&endpoint->sockaddr, endpoint->sockaddrLength, sendErrno)
+        : udpdirect::UDPSendDatagram(fd, bytes, length, nullptr, 0, sendErrno);
+    if (status == udpdirect::UDPSendStatus::Sent) {
+        UDP_TRACE(*_trace, SendDirect, handle, length);
+        _capture->record(udpdirect::UDPCaptureDirection::Outbound, handle, peer, (const uint8_t *)bytes, length);
+        if (udpdirect::UDPSocketCounters *counters = _stats->find(handle)) {
+            counters->countSent(length);
+        }
+    }
+    [self finishDirectSendOnSocket:handle];
+    if (status == udpdirect::UDPSendStatus::Sent) {
+        return UDPImmediateSendSent;
+    }
+    if (status == udpdirect::UDPSendStatus::Deferred) {
+        return UDPImmediateSendDeferred;
+    }
+
+    UDP_SM_ERROR(@"Socket %@: immediate send of %zu bytes failed: %s", socketId, length, strerror(sendErrno));
+    UDP_TRACE(*_trace, SendFailed, handle, length);
+    if (udpdirect::UDPSocketCounters *counters = _stats->find(handle)) {
+        counters->sendFailures.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (self.onSendFailure) {
+        NSError *sendError = [NSError errorWithDomain:NSPOSIXErrorDomain code:sendErrno userInfo:@{NSLocalizedDescriptionKey: [NSString stringWithUTF8String:strerror(sendErrno)]}];
+        self.onSendFailure(socketId, tag, sendError);
+    }
+    return UDPImmediateSendFailed;
+}
+
+- (size_t)sendBatchImmediately:(const udpdirect::UDPBatchSendItem *)items count:(size_t)count onSocket:(NSNumber *)socketId {
+    uint32_t handle = socketId.unsignedIntValue;
+    int fd4 = -1;
+    int fd6 = -1;
+    {
+        std::lock_guard<std::mutex> lock(_socketTableMutex);
+        UDPSocketState *state = _socketTable->get(handle);
+        if (!state || state->queuedSends > 0 || state->connected) {
+            return 0;
+        }
+        fd4 = state->fd4;
+        fd6 = state->fd6;
+        state->directSends++;
+    }
+
+    // One sendmmsg per run of same-family destinations
+    udpdirect::UDPSocketCounters *counters = _stats->find(handle);
+    size_t sent = 0;
+    while (sent < count) {
+        uint8_t family = items[sent].destination.family;
+        size_t runEnd = sent + 1;
+        while (runEnd < count && items[runEnd].destination.family == family) {
+            runEnd++;
+        }
+        int fd = family == AF_INET6 ? fd6 : fd4;
+        if (fd == -1) {
+            break;
+        }
+        int sendErrno = 0;
+        size_t runSent = 0;
+        {
+            std::lock_guard<std::mutex> lock(_sendBatchMutex);
+            runSent = _sendBatchIO->send(fd, items + sent, runEnd - sent, sendErrno);
+        }
+        if (counters) {
+            for (size_t i = sent; i < sent + runSent; i++) {
+                counters->countSent(items[i].length);
+            }
+        }
+#if UDP_TRACE_ENABLED
+        if (_trace->enabled()) {
+            for (size_t i = sent; i < sent + runSent; i++) {
+                _trace->record(udpdirect::UDPTraceEvent::SendDirect, handle, (uint32_t)items[i].length);
+            }
+        }
+#endif
+        if (_capture->active()) {
+            uint64_t nowNs = udpdirect::UDPMonotonicNowNs();
+            for (size_t i = sent; i < sent + runSent; i++) {
+                _capture->record(udpdirect::UDPCaptureDirection::Outbound, handle,
+                                 items[i].destination, (const uint8_t *)items[i].data, items[i].length, nowNs);
+            }
+        }
+        sent += runSent;
+        if (sent < runEnd) {
+            break;
+        }
+    }
+    [self finishDirectSendOnSocket:handle];
+    return sent;
+}
+
+// Drops the pin taken by an immediate send. The socket cannot have been released meanwhile:
+// forgetSocketFDs, which runs first, waits for its pins.
+- (void)finishDirectSendOnSocket:(uint32_t)handle {
+    std::lock_guard<std::mutex> lock(_socketTableMutex);
+    UDPSocketState *state = _socketTable->get(handle);
+    if (state && --state->directSends == 0 && state->closing) {
+        _directSendsDone.notify_all();
+    }
+}
+
+// Delegate or receive queue, never the socket's own queue, which is where the descriptors are read.
+- (void)cacheSocketFDs:(GCDAsyncUdpSocket *)udpSocket forSocket:(NSNumber *)socketId {
+    __block int fd4 = -1;
+    __block int fd6 = -1;
+    [udpSocket performBlock:^{
+        fd4 = [udpSocket socket4FD];
+        fd6 = [udpSocket socket6FD];
+    }];
+
+    std::lock_guard<std::mutex> lock(_socketTableMutex);
+    UDPSocketState *state = _socketTable->get(socketId.unsignedIntValue);
+    if (state && !state->closing) {
+        state->fd4 = fd4;
+        state->fd6 = fd6;
+    }
+}
+
+// Called on the delegate queue before the socket is closed, so neither an immediate send nor
+// a batch read source can reach a recycled descriptor. Immediate sends that already pinned a
+// descriptor are waited for; they never block on the delegate queue, so this cannot deadlock.
+- (void)forgetSocketFDs:(NSNumber *)socketId {
+    [self stopBatchReceiveOnSocket:socketId];
+    std::unique_lock<std::mutex> lock(_socketTableMutex);
+    UDPSocketState *state = _socketTable->get(socketId.unsignedIntValue);
+    if (state) {
+        state->fd4 = -1;
+        state->fd6 = -1;
+        state->closing = true;
+        _directSendsDone.wait(lock, [state] { return state->directSends == 0; });
+    }
+}
+
+// Delegate queue only. Retires the id once the socket has left _asyncSockets.
+- (void)releaseSocketId:(NSNumber *)socketId socket:(GCDAsyncUdpSocket *)udpSocket {
+    [self forgetSocketFDs:socketId];
+    uint32_t handle = socketId.unsignedIntValue;
+    if (UDPReceiveQueue *receiveQueue = [self receiveQueueForSocket:socketId]) {
+        receiveQueue->sockets--;
+        // Callbacks already queued behind this find no id and drop their datagram
+        const void *socketKey = (__bridge const void *)udpSocket;
+        dispatch_async(receiveQueue->queue, ^{
+            receiveQueue->socketIds.erase(socketKey);
+            receiveQueue->pipeline->forgetSocket(handle);
+            receiveQueue->replays.erase(handle);
+        });
+    }
+    _capture->forgetSocket(handle);
+    {
+        std::lock_guard<std::mutex> lock(_schedulerMutex);
+        _sendScheduler->forgetSocket(handle);
+    }
+    for (auto it = _pendingSends.begin(); it != _pendingSends.end();) {
+        it = it->second.socketId == handle ? _pendingSends.erase(it) : std::next(it);
+    }
+    std::lock_guard<std::mutex> lock(_socketTableMutex);
+    _socketTable->release(handle);
+}
+
+// Delegate queue only. Tag 0 marks callers that do not track their sends, so those are
+// counted on completion but not timed.
+- (void)trackPendingSend:(long)tag socketId:(NSNumber *)socketId enqueuedNs:(uint64_t)enqueuedNs bytes:(size_t)bytes {
+    if (tag == 0) return;
+    _pendingSends[tag] = UDPPendingSend{socketId.unsignedIntValue, enqueuedNs, bytes};
+}
+
+// Receive queue only, from the socket's own delegate callbacks. O(1) replacement for
+// scanning _asyncSockets by pointer.
+- (nullable NSNumber *)socketIdForSocket:(GCDAsyncUdpSocket *)udpSocket {
+    UDPReceiveQueue *receiveQueue = [self currentReceiveQueue];
+    auto it = receiveQueue->socketIds.find((__bridge const void *)udpSocket);
+    return it == receiveQueue->socketIds.end() ? nil : @(it->second);
+}
+
+// Send-only sockets get their descriptors from GCDAsyncUdpSocket on the first queued send.
+- (void)cacheSocketFDsIfNeeded:(GCDAsyncUdpSocket *)udpSocket forSocket:(NSNumber *)socketId {
+    {
+        std::lock_guard<std::mutex> lock(_socketTableMutex);
+        UDPSocketState *state = _socketTable->get(socketId.unsignedIntValue);
+        if (!state || state->closing || state->fd4 != -1 || state->fd6 != -1) {
+            return;
+        }
+    }
+    [self cacheSocketFDs:udpSocket forSocket:socketId];
+}
+
+- (void)adjustQueuedSends:(NSNumber *)socketId by:(int)delta {
+    if (!socketId) return;
+    std::lock_guard<std::mutex> lock(_socketTableMutex);
+    UDPSocketState *state = _socketTable->get(socketId.unsignedIntValue);
+    if (!state) return;
+    if (delta > 0) {
+        state->queuedSends += delta;
+    } else {
+        state->queuedSends = state->queuedSends > (uint32_t)-delta ? state->queuedSends + delta : 0;
+    }
+    if (udpdirect::UDPSocketCounters *counters = _stats->find(socketId.unsignedIntValue)) {
+        counters->queueDepth.store(state->queuedSends, std::memory_order_relaxed);
+    }
+}
+
 - (void)closeSocket:(NSNumber *)socketId {
     dispatch_async(_delegateQueue, ^{
         GCDAsyncUdpSocket *udpSocket = self->_asyncSockets[socketId];
         if (udpSocket) {
             UDP_SM_LOG(@"Closing socket %@", socketId);
+            [self forgetSocketFDs:socketId];
             [udpSocket close]; // Delegate method udpSocketDidClose will handle cleanup
         } else {
             UDP_SM_LOG(@"Socket %@ not found for closing, or already closed.", socketId);
@@ -445,6 +1129,7 @@ NSString * const UDPErrorDomain = @"com.lama.udpdirect.ErrorDomain";
         for (NSNumber *sockId in allSocketIds) {
             GCDAsyncUdpSocket *udpSocket = self->_asyncSockets[sockId];
             if (udpSocket && ![udpSocket isClosed]) {
+                [self forgetSocketFDs:sockId];
                 [udpSocket close];
             }
         }
@@ -466,10 +1151,12 @@ NSString * const UDPErrorDomain = @"com.lama.udpdirect.ErrorDomain";
             UDP_SM_LOG(@"Synchronously closing socket %@", sockId);
             
             // Close the socket and immediately clean up
+            [self forgetSocketFDs:sockId];
             [udpSocket close];
             
             // Manually trigger cleanup that would normally happen in udpSocketDidClose:withError:
             // This ensures immediate cleanup without waiting for async delegate callbacks
+            [self releaseSocketId:sockId socket:udpSocket];
             [_asyncSockets removeObjectForKey:sockId];
             [_socketInfo removeObjectForKey:sockId];
             _socketStatus[sockId] = kUDPSocketStatusClosed;
@@ -478,183 +1165,661 @@ NSString * const UDPErrorDomain = @"com.lama.udpdirect.ErrorDomain";
         }
     }
 
-    // Reset socket counter to prevent ID collision after reload
-    // Use a timestamp-based counter to avoid conflicts
-    _nextSocketId = 1000 + (NSInteger)([[NSDate date] timeIntervalSince1970] * 1000) % 100000;
-    UDP_SM_LOG(@"Reset socket ID counter to %ld after cleanup", (long)_nextSocketId);
+    // No id reset needed: released handles bump their generation, so ids held by
+    // the old JS context can never address a socket created after the reload.
+
+    UDP_SM_LOG(@"All sockets closed synchronously. Remaining sockets: %lu", (unsigned long)[_asyncSockets count]);
+}
+
+- (void)startReceivingOnBoundSockets {
+    dispatch_async(_delegateQueue, ^{
+        UDP_SM_LOG(@"Starting to receive on bound sockets...");
+        for (NSNumber *socketId in [self->_socketStatus allKeys]) {
+            NSNumber *status = self->_socketStatus[socketId];
+            if ([status isEqualToNumber:kUDPSocketStatusBound]) {
+                GCDAsyncUdpSocket *udpSocket = self->_asyncSockets[socketId];
+                if (udpSocket) {
+                    NSError *receiveErr = nil;
+                    if ([self beginReceivingOnSocket:udpSocket socketId:socketId error:&receiveErr]) {
+                        UDP_SM_LOG(@"Started receiving on bound socket %@", socketId);
+                    } else {
+                        UDP_SM_ERROR(@"Failed to start receiving on socket %@: %@", socketId, receiveErr.localizedDescription);
+                        self->_socketStatus[socketId] = kUDPSocketStatusError;
+                    }
+                }
+            }
+        }
+    });
+}
+
+#pragma mark - Batched Receive
+
+// Must be called on the delegate queue. Sockets created with `batchReceive` are read with
+// recvmmsg-style batches straight into receivePool slots when onSlotReceived is set;
+// everything else goes through GCDAsyncUdpSocket. `timestamps` implies `batchReceive`, since
+// GCDAsyncUdpSocket reads with recvfrom and never sees the kernel's control messages.
+- (BOOL)beginReceivingOnSocket:(GCDAsyncUdpSocket *)udpSocket socketId:(NSNumber *)socketId error:(NSError **)error {
+    NSDictionary *options = _socketInfo[socketId][@"options"];
+    if (([options[@"batchReceive"] boolValue] || [options[@"timestamps"] boolValue]) && self.onSlotReceived) {
+        if (_batchReceiveSources[socketId]) {
+            return YES;
+        }
+        [udpSocket pauseReceiving];
+        if ([self startBatchReceiveOnSocket:socketId]) {
+            return YES;
+        }
+        UDP_SM_ERROR(@"Socket %@: batch receive unavailable, falling back to GCDAsyncUdpSocket", socketId);
+    }
+    return [udpSocket beginReceiving:error];
+}
+
+- (BOOL)startBatchReceiveOnSocket:(NSNumber *)socketId {
+    UDPSocketState fds;
+    {
+        std::lock_guard<std::mutex> lock(_socketTableMutex);
+        UDPSocketState *state = _socketTable->get(socketId.unsignedIntValue);
+        if (!state) {
+            return NO;
+        }
+        fds = *state;
+    }
+
+    NSDictionary *options = _socketInfo[socketId][@"options"];
+    NSNumber *maxDatagramSize = options[@"maxDatagramSize"];
+    BOOL timestamps = [options[@"timestamps"] boolValue];
+    size_t slotSize = maxDatagramSize.unsignedIntegerValue > 0 ? maxDatagramSize.unsignedIntegerValue : udpdirect::UDPBufferPool::kSizeClasses[0];
+    if (slotSize > udpdirect::UDPBufferPool::maxSlotSize()) {
+        slotSize = udpdirect::UDPBufferPool::maxSlotSize();
+    }
+
+    // Read on the socket's receive queue, alongside its filter and reassembler
+    UDPReceiveQueue *receiveQueue = _receiveQueues[fds.receiveQueue].get();
+    NSMutableArray<dispatch_source_t> *sources = [NSMutableArray array];
+    __weak UDPSocketManager *weakSelf = self;
+    for (int fd : {fds.fd4, fds.fd6}) {
+        if (fd == -1) continue;
+        if (timestamps) {
+            int timestampErrno = udpdirect::UDPBatchIO::enableReceiveTimestamps(fd);
+            if (timestampErrno != 0) {
+                UDP_SM_ERROR(@"Socket %@: receive timestamps unavailable: %s", socketId, strerror(timestampErrno));
+            }
+        }
+        dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, (uintptr_t)fd, 0, receiveQueue->queue);
+        if (!source) continue;
+        dispatch_source_set_event_handler(source, ^{
+            [weakSelf drainBatchReceiveOnFD:fd socketId:socketId slotSize:slotSize];
+        });
+        dispatch_resume(source);
+        [sources addObject:source];
+    }
+    if (sources.count == 0) {
+        return NO;
+    }
+    _batchReceiveSources[socketId] = sources;
+    UDP_SM_LOG(@"Socket %@ receiving in batches of up to %zu (slot size %zu) on receive queue %lu", socketId, udpdirect::UDPBatchIO::kMaxBatch, slotSize, (unsigned long)receiveQueue->index);
+    return YES;
+}
+
+- (void)stopBatchReceiveOnSocket:(NSNumber *)socketId {
+    NSArray<dispatch_source_t> *sources = _batchReceiveSources[socketId];
+    if (!sources) return;
+    for (dispatch_source_t source in sources) {
+        dispatch_source_cancel(source);
+    }
+    [_batchReceiveSources removeObjectForKey:socketId];
+}
+
+- (void)drainBatchReceiveOnFD:(int)fd socketId:(NSNumber *)socketId slotSize:(size_t)slotSize {
+    UDPSocketDidReceiveSlot onSlotReceived = self.onSlotReceived;
+    UDPSocketDidReassembleMessage onMessageReassembled = self.onMessageReassembled;
+    udpdirect::UDPReceivedDatagram datagrams[udpdirect::UDPBatchIO::kMaxBatch];
+    UDPReceiveQueue *receiveQueue = [self currentReceiveQueue];
+    udpdirect::UDPReceivePipeline &pipeline = *receiveQueue->pipeline;
+    udpdirect::UDPReceiveContext context = pipeline.context(socketId.unsignedIntValue);
+
+    for (int round = 0; round < kBatchReceiveMaxRounds; round++) {
+        int receiveErrno = 0;
+        size_t received = receiveQueue->batchIO->receive(fd, slotSize, datagrams, udpdirect::UDPBatchIO::kMaxBatch, receiveErrno);
+        for (size_t i = 0; i < received; i++) {
+            udpdirect::UDPBufferSlot &slot = datagrams[i].slot;
+            size_t length = slot.length;
+            uint32_t route = 0;
+            std::shared_ptr<std::vector<uint8_t>> message;
+            switch (pipeline.process(context, slot.data, length, datagrams[i].source, route, message)) {
+                case udpdirect::UDPReceiveVerdict::Deliver:
+                    slot.length = (uint32_t)length;
+                    if (onSlotReceived) {
+                        onSlotReceived(socketId, slot, datagrams[i].source, route, datagrams[i].kernelTimestampNs);
+                        continue;
+                    }
+                    break;
+                case udpdirect::UDPReceiveVerdict::Reassembled:
+                    if (onMessageReassembled) {
+                        onMessageReassembled(socketId, std::move(message), datagrams[i].source, route);
+                    }
+                    break;
+                case udpdirect::UDPReceiveVerdict::Dropped:
+                case udpdirect::UDPReceiveVerdict::Consumed:
+                    break;
+            }
+            _receivePool->release(slot);
+        }
+        if (receiveErrno == ENOBUFS) {
+            UDP_SM_DEBUG(@"Receive pool exhausted, dropped a datagram on socket %@", socketId);
+            pipeline.countDrop(context, 0);
+        } else if (receiveErrno != 0 && receiveErrno != EAGAIN && receiveErrno != EWOULDBLOCK) {
+            UDP_SM_ERROR(@"Socket %@: batch receive failed: %s", socketId, strerror(receiveErrno));
+        }
+        if (received < udpdirect::UDPBatchIO::kMaxBatch) {
+            break;
+        }
+    }
+}
+
+#pragma mark - Paced Sending
+
+- (BOOL)schedulePacedSend:(const void *)bytes length:(size_t)length onSocket:(NSNumber *)socketId toEndpoint:(const udpdirect::UDPEndpoint &)endpoint priority:(udpdirect::UDPSendPriority)priority tag:(long)tag {
+    udpdirect::UDPScheduledSend send;
+    send.socketId = socketId.unsignedIntValue;
+    send.destination = endpoint;
+    send.payload.assign((const uint8_t *)bytes, (const uint8_t *)bytes + length);
+    send.priority = priority;
+    send.tag = tag;
+    {
+        std::lock_guard<std::mutex> lock(_schedulerMutex);
+        if (!_sendScheduler->enqueue(send)) {
+            return NO;
+        }
+    }
+    // One drain pass per burst of enqueues; the timer covers anything the buckets hold back
+    if (!_sendDrainQueued.exchange(true)) {
+        dispatch_async(_delegateQueue, ^{
+            [self drainSendScheduler];
+        });
+    }
+    return YES;
+}
+
+// Any queue. Whether the socket reports send completions with timestamps.
+- (BOOL)sendTimestampsOnSocket:(uint32_t)handle {
+    std::lock_guard<std::mutex> lock(_socketTableMutex);
+    UDPSocketState *state = _socketTable->get(handle);
+    return state && state->sendTimestamps;
+}
+
+- (void)setSendRateLimit:(const udpdirect::UDPRateLimit &)socketLimit perDestination:(const udpdirect::UDPRateLimit &)destinationLimit forSocket:(NSNumber *)socketId {
+    std::lock_guard<std::mutex> lock(_schedulerMutex);
+    _sendScheduler->setRateLimit(socketId.unsignedIntValue, socketLimit, destinationLimit);
+}
+
+- (udpdirect::UDPSendSchedulerStats)sendSchedulerStats {
+    return _sendScheduler->stats();
+}
+
+- (udpdirect::UDPLatencySummary)pacedSendLatency {
+    return _sendScheduler->shapedLatency().summary();
+}
+
+// Delegate queue only. Sends everything the buckets allow, straight from the scheduler's
+// copy where possible, then re-arms the timer for the next datagram that becomes due.
+- (void)drainSendScheduler {
+    _sendDrainQueued = false;
+    uint64_t nextNs;
+    uint64_t nowNs;
+    {
+        std::lock_guard<std::mutex> lock(_schedulerMutex);
+        nextNs = _sendScheduler->dispatchReady(_readySends);
+        nowNs = _sendScheduler->now();
+    }
+
+    // The scheduler hands out each socket's datagrams together, so the socket id and its
+    // timestamps flag are looked up once per run of them
+    NSNumber *socketId = nil;
+    BOOL timestamps = NO;
+    for (udpdirect::UDPScheduledSend &send : _readySends) {
+        if (socketId == nil || socketId.unsignedIntValue != send.socketId) {
+            socketId = @(send.socketId);
+            timestamps = [self sendTimestampsOnSocket:send.socketId];
+        }
+        UDPImmediateSendResult result = [self sendBytesImmediately:send.payload.data() length:send.payload.size() onSocket:socketId toEndpoint:send.destination tag:send.tag];
+        if (result == UDPImmediateSendDeferred) {
+            NSData *data = [NSData dataWithBytes:send.payload.data() length:send.payload.size()];
+            [self sendData:data onSocket:socketId toEndpoint:send.destination tag:send.tag];
+        } else if (result == UDPImmediateSendSent) {
+            UDPSocketDidCompleteSend onSendCompleted = self.onSendCompleted;
+            if (onSendCompleted && timestamps) {
+                onSendCompleted(socketId, send.tag, send.payload.size(), send.enqueuedNs, udpdirect::UDPMonotonicNowNs());
+            }
+            if (self.onSendSuccess) {
+                self.onSendSuccess(socketId, send.tag);
+            }
+        }
+    }
+    _readySends.clear();
+
+    dispatch_time_t fire = nextNs == 0 ? DISPATCH_TIME_FOREVER
+        : dispatch_time(DISPATCH_TIME_NOW, (int64_t)(nextNs > nowNs ? nextNs - nowNs : 0));
+    dispatch_source_set_timer(_sendTimer, fire, DISPATCH_TIME_FOREVER, 0);
+}
+
+#pragma mark - Packet Filtering
+
+- (void)setPacketFilter:(std::shared_ptr<udpdirect::UDPPacketFilter>)filter forSocket:(NSNumber *)socketId {
+    dispatch_async(_delegateQueue, ^{
+        UDPReceiveQueue *receiveQueue = [self receiveQueueForSocket:socketId];
+        if (!self->_asyncSockets[socketId] || !receiveQueue) {
+            if (filter) {
+                UDP_SM_ERROR(@"Socket %@ not found for setPacketFilter.", socketId);
+            }
+            return;
+        }
+        uint32_t handle = socketId.unsignedIntValue;
+        if (!filter) {
+            dispatch_async(receiveQueue->queue, ^{
+                receiveQueue->pipeline->setPacketFilter(handle, nullptr);
+            });
+            return;
+        }
+        std::vector<udpdirect::UDPSocketAddress> addresses = [self localAddressesForSocket:socketId];
+        dispatch_async(receiveQueue->queue, ^{
+            filter->setLocalAddresses(addresses);
+            receiveQueue->pipeline->setPacketFilter(handle, filter);
+        });
+    });
+}
+
+// Delegate queue only. Self-echo suppression compares senders with every interface address
+// at the socket's bound port, so this runs again once the socket is bound.
+- (void)refreshPacketFilterAddressesForSocket:(NSNumber *)socketId {
+    UDPReceiveQueue *receiveQueue = [self receiveQueueForSocket:socketId];
+    if (!receiveQueue) {
+        return;
+    }
+    uint32_t handle = socketId.unsignedIntValue;
+    std::vector<udpdirect::UDPSocketAddress> addresses = [self localAddressesForSocket:socketId];
+    dispatch_async(receiveQueue->queue, ^{
+        if (udpdirect::UDPPacketFilter *filter = receiveQueue->pipeline->packetFilter(handle)) {
+            filter->setLocalAddresses(addresses);
+        }
+    });
+}
+
+// Delegate queue only. Every interface address with the socket's bound port; empty until bound.
+- (std::vector<udpdirect::UDPSocketAddress>)localAddressesForSocket:(NSNumber *)socketId {
+    uint16_t boundPort = [_socketInfo[socketId][@"boundPort"] unsignedShortValue];
+    std::vector<udpdirect::UDPSocketAddress> addresses;
+    if (boundPort == 0) {
+        return addresses;
+    }
+    std::shared_ptr<const udpdirect::UDPInterfaceTable> table = _interfaceMonitor->table();
+    for (const auto &interface : table->interfaces) {
+        for (udpdirect::UDPSocketAddress local : interface.addresses) {
+            local.port = boundPort;
+            addresses.push_back(local);
+        }
+    }
+    return addresses;
+}
+
+#pragma mark - Network Interfaces
+
+- (std::shared_ptr<udpdirect::UDPInterfaceMonitor>)interfaceMonitor {
+    return _interfaceMonitor;
+}
+
+// Delegate queue only. Path updates come in bursts while an interface comes up, so the
+// table is only marked stale here and re-read once the burst has settled.
+- (void)interfacesDidChange {
+    _interfaceMonitor->invalidate();
+    if (_interfaceRefreshQueued) {
+        return;
+    }
+    _interfaceRefreshQueued = YES;
+    __weak UDPSocketManager *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, kInterfaceRefreshDelayNs), _delegateQueue, ^{
+        UDPSocketManager *strongSelf = weakSelf;
+        if (!strongSelf) return;
+        strongSelf->_interfaceRefreshQueued = NO;
+        [strongSelf applyInterfaceTableOnQueue];
+    });
+}
+
+- (void)applyInterfaceTable {
+    dispatch_async(_delegateQueue, ^{
+        [self applyInterfaceTableOnQueue];
+    });
+}
 
-    UDP_SM_LOG(@"All sockets closed synchronously. Remaining sockets: %lu", (unsigned long)[_asyncSockets count]);
+// Delegate queue only. Hands a new table version to the packet filters and to JS; the table
+// may have been re-read here or, through an explicit refresh, on another thread.
+- (void)applyInterfaceTableOnQueue {
+    uint64_t version = _interfaceMonitor->table()->version;
+    if (version == _appliedInterfaceVersion) {
+        return;
+    }
+    _appliedInterfaceVersion = version;
+    UDP_SM_LOG(@"Network interfaces changed (table version %llu)", (unsigned long long)version);
+    for (NSNumber *socketId in _asyncSockets) {
+        [self refreshPacketFilterAddressesForSocket:socketId];
+    }
+    UDPInterfacesDidChange onInterfacesChanged = self.onInterfacesChanged;
+    if (onInterfacesChanged) {
+        onInterfacesChanged(version);
+    }
 }
 
-- (void)startReceivingOnBoundSockets {
+// Delegate queue only. Looks up an interface by name, index or address in the current table.
+- (BOOL)findInterface:(NSString *)interface result:(udpdirect::UDPInterface &)result error:(NSError **)error {
+    std::shared_ptr<const udpdirect::UDPInterfaceTable> table = _interfaceMonitor->table();
+    const udpdirect::UDPInterface *found = table->find(interface.UTF8String);
+    if (!found) {
+        if (error) *error = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeInvalidArguments userInfo:@{NSLocalizedDescriptionKey: [NSString stringWithFormat:@"No network interface %@", interface]}];
+        return NO;
+    }
+    result = *found;
+    return YES;
+}
+
+#pragma mark - Checksums
+
+- (void)setChecksumVerifier:(std::shared_ptr<udpdirect::UDPChecksumVerifier>)verifier forSocket:(NSNumber *)socketId {
     dispatch_async(_delegateQueue, ^{
-        UDP_SM_LOG(@"Starting to receive on bound sockets...");
-        for (NSNumber *socketId in [self->_socketStatus allKeys]) {
-            NSNumber *status = self->_socketStatus[socketId];
-            if ([status isEqualToNumber:kUDPSocketStatusBound]) {
-                GCDAsyncUdpSocket *udpSocket = self->_asyncSockets[socketId];
-                if (udpSocket) {
-                    NSError *receiveErr = nil;
-                    if ([udpSocket beginReceiving:&receiveErr]) {
-                        UDP_SM_LOG(@"Started receiving on bound socket %@", socketId);
-                    } else {
-                        UDP_SM_ERROR(@"Failed to start receiving on socket %@: %@", socketId, receiveErr.localizedDescription);
-                        self->_socketStatus[socketId] = kUDPSocketStatusError;
-                    }
-                }
+        UDPReceiveQueue *receiveQueue = [self receiveQueueForSocket:socketId];
+        if (!self->_asyncSockets[socketId] || !receiveQueue) {
+            if (verifier) {
+                UDP_SM_ERROR(@"Socket %@ not found for setChecksumVerifier.", socketId);
             }
+            return;
         }
+        uint32_t handle = socketId.unsignedIntValue;
+        dispatch_async(receiveQueue->queue, ^{
+            receiveQueue->pipeline->setChecksumVerifier(handle, verifier);
+        });
     });
 }
 
-#pragma mark - Socket Options Implementations
+#pragma mark - Fragment Reassembly
 
-- (BOOL)setBroadcast:(NSNumber *)socketId enable:(BOOL)enable error:(NSError **)error {
-    __block BOOL success = NO;
-    __block NSError *opError = nil;
-    dispatch_sync(_delegateQueue, ^{
-        GCDAsyncUdpSocket *udpSocket = self->_asyncSockets[socketId];
-        if (!udpSocket) {
-            opError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:@{NSLocalizedDescriptionKey:@"Socket not found"}]; return;
-        }
-        NSError *nativeError = nil;
-        if (![udpSocket enableBroadcast:enable error:&nativeError]) {
-            opError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeInternalException userInfo:@{NSLocalizedDescriptionKey: nativeError.localizedDescription, @"nativeError": nativeError}];
-        } else {
-            UDP_SM_LOG(@"Socket %@ broadcast set to %@", socketId, enable ? @"YES" : @"NO");
-            success = YES;
+- (void)setReassembler:(std::shared_ptr<udpdirect::UDPReassembler>)reassembler forSocket:(NSNumber *)socketId {
+    dispatch_async(_delegateQueue, ^{
+        UDPReceiveQueue *receiveQueue = [self receiveQueueForSocket:socketId];
+        if (!self->_asyncSockets[socketId] || !receiveQueue) {
+            if (reassembler) {
+                UDP_SM_ERROR(@"Socket %@ not found for setReassembler.", socketId);
+            }
+            return;
         }
+        uint32_t handle = socketId.unsignedIntValue;
+        dispatch_async(receiveQueue->queue, ^{
+            receiveQueue->pipeline->setReassembler(handle, reassembler);
+        });
     });
-    if (error && opError) *error = opError;
-    return success;
 }
 
-- (BOOL)setTTL:(NSNumber *)socketId ttl:(int)ttl error:(NSError **)error {
-    __block BOOL success = NO;
-    __block NSError *opError = nil;
-    dispatch_sync(_delegateQueue, ^{
-        GCDAsyncUdpSocket *udpSocket = self->_asyncSockets[socketId];
-        if (!udpSocket) { opError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:@{NSLocalizedDescriptionKey:@"Socket not found"}]; return; }
+#pragma mark - Socket Options Implementations
 
+// Sets an IPv4 option and its IPv6 counterpart on whichever descriptors the socket has open.
+// The descriptors are read and used on the socket's own queue, the only place
+// GCDAsyncUdpSocket hands them out.
+static BOOL UDPSetSocketOption(GCDAsyncUdpSocket *udpSocket,
+                               int level4, int name4, const void *value4, socklen_t length4,
+                               int level6, int name6, const void *value6, socklen_t length6,
+                               NSError **error) {
+    __block BOOL applied = NO;
+    __block int failure = 0;
+    [udpSocket performBlock:^{
         int fd4 = [udpSocket socket4FD];
         int fd6 = [udpSocket socket6FD];
-        BOOL opDone = NO;
-
         if (fd4 != -1) {
-            if (setsockopt(fd4, IPPROTO_IP, IP_TTL, &ttl, sizeof(ttl)) == 0) { opDone = YES; }
-            else { opError = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSLocalizedDescriptionKey:[NSString stringWithUTF8String:strerror(errno)]}]; }
-        }
-        if (fd6 != -1) { // IPV6_UNICAST_HOPS for IPv6
-            if (setsockopt(fd6, IPPROTO_IPV6, IPV6_UNICAST_HOPS, &ttl, sizeof(ttl)) == 0) { opDone = YES; }
-            else if (!opError) { opError = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSLocalizedDescriptionKey:[NSString stringWithUTF8String:strerror(errno)]}]; }
+            if (setsockopt(fd4, level4, name4, value4, length4) == 0) applied = YES;
+            else failure = errno;
         }
-        if (!opDone && (fd4 == -1 && fd6 == -1)) { // No valid FD
-             opError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:@{NSLocalizedDescriptionKey:@"Socket FDs not available for TTL."}];
-        } else if (opDone) {
-            UDP_SM_LOG(@"Socket %@ TTL set to %d", socketId, ttl);
-            success = YES; // If at least one setsockopt succeeded without prior error
+        if (fd6 != -1 && !failure) {
+            if (setsockopt(fd6, level6, name6, value6, length6) == 0) applied = YES;
+            else failure = errno;
         }
-    });
-    if (error && opError) *error = opError;
-    return success;
+    }];
+    if (failure) {
+        if (error) *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:failure userInfo:@{NSLocalizedDescriptionKey:[NSString stringWithUTF8String:strerror(failure)]}];
+        return NO;
+    }
+    if (!applied) {
+        if (error) *error = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:@{NSLocalizedDescriptionKey:@"Socket descriptors not open yet; bind the socket first."}];
+        return NO;
+    }
+    return YES;
 }
 
-- (BOOL)setMulticastTTL:(NSNumber *)socketId ttl:(int)ttl error:(NSError **)error {
+// Runs `operation` on the delegate queue and waits for it. Kept for callers that cannot take
+// a completion; JS uses the completion forms so it never blocks on the queue.
+- (BOOL)performOnQueue:(BOOL (^)(NSError **opError))operation error:(NSError **)error {
     __block BOOL success = NO;
     __block NSError *opError = nil;
     dispatch_sync(_delegateQueue, ^{
-        GCDAsyncUdpSocket *udpSocket = self->_asyncSockets[socketId];
-        if (!udpSocket) { opError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:@{NSLocalizedDescriptionKey:@"Socket not found"}]; return; }
-
-        int fd4 = [udpSocket socket4FD];
-        int fd6 = [udpSocket socket6FD];
-        BOOL opDone = NO;
-
-        if (fd4 != -1) { // IP_MULTICAST_TTL for IPv4
-            if (setsockopt(fd4, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) == 0) { opDone = YES; }
-            else { opError = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSLocalizedDescriptionKey:[NSString stringWithUTF8String:strerror(errno)]}];}
-        }
-        if (fd6 != -1) { // IPV6_MULTICAST_HOPS for IPv6 multicast TTL
-            if (setsockopt(fd6, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, &ttl, sizeof(ttl)) == 0) { opDone = YES; }
-            else if (!opError) { opError = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSLocalizedDescriptionKey:[NSString stringWithUTF8String:strerror(errno)]}]; }
-        }
-         if (!opDone && (fd4 == -1 && fd6 == -1)) {
-             opError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:@{NSLocalizedDescriptionKey:@"Socket FDs not available for Multicast TTL."}];
-        } else if (opDone) {
-            UDP_SM_LOG(@"Socket %@ Multicast TTL set to %d", socketId, ttl);
-            success = YES;
-        }
+        NSError *blockError = nil;
+        success = operation(&blockError);
+        opError = blockError;
     });
-    if (error && opError) *error = opError;
+    if (!success && error) *error = opError;
     return success;
 }
 
-- (BOOL)setMulticastLoopback:(NSNumber *)socketId flag:(BOOL)flag error:(NSError **)error {
-    __block BOOL success = NO;
-    __block NSError *opError = nil;
-    dispatch_sync(_delegateQueue, ^{
-        GCDAsyncUdpSocket *udpSocket = self->_asyncSockets[socketId];
-        if (!udpSocket) { opError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:@{NSLocalizedDescriptionKey:@"Socket not found"}]; return; }
+- (nullable GCDAsyncUdpSocket *)socketForOption:(NSNumber *)socketId error:(NSError **)error {
+    GCDAsyncUdpSocket *udpSocket = _asyncSockets[socketId];
+    if (!udpSocket && error) {
+        *error = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:@{NSLocalizedDescriptionKey:@"Socket not found"}];
+    }
+    return udpSocket;
+}
 
-        // For setsockopt, loopback is typically u_char (0 or 1) or int
-        unsigned char loopbackFlag = flag ? 1 : 0;
-        int fd4 = [udpSocket socket4FD];
-        int fd6 = [udpSocket socket6FD];
-        BOOL opDone = NO;
+- (BOOL)setBroadcast:(NSNumber *)socketId enable:(BOOL)enable error:(NSError **)error {
+    return [self performOnQueue:^BOOL(NSError **opError) {
+        return [self setBroadcastOnQueue:socketId enable:enable error:opError];
+    } error:error];
+}
 
-        if (fd4 != -1) { // IP_MULTICAST_LOOP for IPv4
-            if (setsockopt(fd4, IPPROTO_IP, IP_MULTICAST_LOOP, &loopbackFlag, sizeof(loopbackFlag)) == 0) { opDone = YES; }
-            else { opError = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSLocalizedDescriptionKey:[NSString stringWithUTF8String:strerror(errno)]}]; }
-        }
-        if (fd6 != -1) { // IPV6_MULTICAST_LOOP for IPv6
-            if (setsockopt(fd6, IPPROTO_IPV6, IPV6_MULTICAST_LOOP, &loopbackFlag, sizeof(loopbackFlag)) == 0) { opDone = YES; }
-            else if (!opError) { opError = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSLocalizedDescriptionKey:[NSString stringWithUTF8String:strerror(errno)]}];}
-        }
-        if (!opDone && (fd4 == -1 && fd6 == -1)) {
-            opError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:@{NSLocalizedDescriptionKey:@"Socket FDs not available for Multicast Loopback."}];
-        } else if (opDone) {
-            UDP_SM_LOG(@"Socket %@ Multicast Loopback set to %@", socketId, flag ? @"YES" : @"NO");
-            success = YES;
-        }
-    });
-    if (error && opError) *error = opError;
-    return success;
+- (BOOL)setBroadcastOnQueue:(NSNumber *)socketId enable:(BOOL)enable error:(NSError **)error {
+    GCDAsyncUdpSocket *udpSocket = [self socketForOption:socketId error:error];
+    if (!udpSocket) return NO;
+    NSError *nativeError = nil;
+    if (![udpSocket enableBroadcast:enable error:&nativeError]) {
+        if (error) *error = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeInternalException userInfo:@{NSLocalizedDescriptionKey: nativeError.localizedDescription, @"nativeError": nativeError}];
+        return NO;
+    }
+    [self noteBroadcastEnabled:enable onSocket:socketId];
+    UDP_SM_LOG(@"Socket %@ broadcast set to %@", socketId, enable ? @"YES" : @"NO");
+    return YES;
+}
+
+- (BOOL)setTTL:(NSNumber *)socketId ttl:(int)ttl error:(NSError **)error {
+    return [self performOnQueue:^BOOL(NSError **opError) {
+        return [self setTTLOnQueue:socketId ttl:ttl error:opError];
+    } error:error];
+}
+
+- (BOOL)setTTLOnQueue:(NSNumber *)socketId ttl:(int)ttl error:(NSError **)error {
+    GCDAsyncUdpSocket *udpSocket = [self socketForOption:socketId error:error];
+    if (!udpSocket) return NO;
+    // IP_TTL for IPv4, IPV6_UNICAST_HOPS for IPv6
+    if (!UDPSetSocketOption(udpSocket, IPPROTO_IP, IP_TTL, &ttl, sizeof(ttl),
+                            IPPROTO_IPV6, IPV6_UNICAST_HOPS, &ttl, sizeof(ttl), error)) {
+        return NO;
+    }
+    UDP_SM_LOG(@"Socket %@ TTL set to %d", socketId, ttl);
+    return YES;
+}
+
+- (BOOL)setMulticastTTL:(NSNumber *)socketId ttl:(int)ttl error:(NSError **)error {
+    return [self performOnQueue:^BOOL(NSError **opError) {
+        return [self setMulticastTTLOnQueue:socketId ttl:ttl error:opError];
+    } error:error];
+}
+
+- (BOOL)setMulticastTTLOnQueue:(NSNumber *)socketId ttl:(int)ttl error:(NSError **)error {
+    GCDAsyncUdpSocket *udpSocket = [self socketForOption:socketId error:error];
+    if (!udpSocket) return NO;
+    // IP_MULTICAST_TTL takes a u_char on BSD stacks; IPV6_MULTICAST_HOPS an int
+    unsigned char ttl4 = (unsigned char)ttl;
+    if (!UDPSetSocketOption(udpSocket, IPPROTO_IP, IP_MULTICAST_TTL, &ttl4, sizeof(ttl4),
+                            IPPROTO_IPV6, IPV6_MULTICAST_HOPS, &ttl, sizeof(ttl), error)) {
+        return NO;
+    }
+    UDP_SM_LOG(@"Socket %@ Multicast TTL set to %d", socketId, ttl);
+    return YES;
+}
+
+- (BOOL)setMulticastLoopback:(NSNumber *)socketId flag:(BOOL)flag error:(NSError **)error {
+    return [self performOnQueue:^BOOL(NSError **opError) {
+        return [self setMulticastLoopbackOnQueue:socketId flag:flag error:opError];
+    } error:error];
+}
+
+- (BOOL)setMulticastLoopbackOnQueue:(NSNumber *)socketId flag:(BOOL)flag error:(NSError **)error {
+    GCDAsyncUdpSocket *udpSocket = [self socketForOption:socketId error:error];
+    if (!udpSocket) return NO;
+    // IP_MULTICAST_LOOP takes a u_char, IPV6_MULTICAST_LOOP a u_int
+    unsigned char loop4 = flag ? 1 : 0;
+    unsigned int loop6 = flag ? 1 : 0;
+    if (!UDPSetSocketOption(udpSocket, IPPROTO_IP, IP_MULTICAST_LOOP, &loop4, sizeof(loop4),
+                            IPPROTO_IPV6, IPV6_MULTICAST_LOOP, &loop6, sizeof(loop6), error)) {
+        return NO;
+    }
+    UDP_SM_LOG(@"Socket %@ Multicast Loopback set to %@", socketId, flag ? @"YES" : @"NO");
+    return YES;
 }
 
 - (BOOL)joinMulticastGroup:(NSNumber *)socketId address:(NSString *)address error:(NSError **)error {
-    __block BOOL success = NO;
-    __block NSError *opError = nil;
-    dispatch_sync(_delegateQueue, ^{
-        GCDAsyncUdpSocket *udpSocket = self->_asyncSockets[socketId];
-        if (!udpSocket) { opError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:@{NSLocalizedDescriptionKey:@"Socket not found"}]; return; }
-        NSError *nativeError = nil;
-        if (![udpSocket joinMulticastGroup:address error:&nativeError]) {
-            opError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeInternalException userInfo:@{NSLocalizedDescriptionKey: nativeError.localizedDescription, @"nativeError": nativeError}];
-        } else {
-             UDP_SM_LOG(@"Socket %@ joined multicast group %@", socketId, address);
-            success = YES;
-        }
-    });
-    if (error && opError) *error = opError;
-    return success;
+    return [self joinMulticastGroup:socketId address:address interface:nil error:error];
+}
+
+- (BOOL)joinMulticastGroup:(NSNumber *)socketId address:(NSString *)address interface:(nullable NSString *)interface error:(NSError **)error {
+    return [self performOnQueue:^BOOL(NSError **opError) {
+        return [self joinMulticastGroupOnQueue:socketId address:address interface:interface error:opError];
+    } error:error];
+}
+
+- (BOOL)joinMulticastGroupOnQueue:(NSNumber *)socketId address:(NSString *)address interface:(nullable NSString *)interface error:(NSError **)error {
+    GCDAsyncUdpSocket *udpSocket = [self socketForOption:socketId error:error];
+    if (!udpSocket) return NO;
+    udpdirect::UDPInterface resolved;
+    if (interface && ![self findInterface:interface result:resolved error:error]) return NO;
+    NSError *nativeError = nil;
+    BOOL joined = interface
+        ? [udpSocket joinMulticastGroup:address onInterface:@(resolved.name.c_str()) error:&nativeError]
+        : [udpSocket joinMulticastGroup:address error:&nativeError];
+    if (!joined) {
+        if (error) *error = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeInternalException userInfo:@{NSLocalizedDescriptionKey: nativeError.localizedDescription, @"nativeError": nativeError}];
+        return NO;
+    }
+    UDP_SM_LOG(@"Socket %@ joined multicast group %@ on %@", socketId, address, interface ? @(resolved.name.c_str()) : @"the default interface");
+    return YES;
 }
 
 - (BOOL)leaveMulticastGroup:(NSNumber *)socketId address:(NSString *)address error:(NSError **)error {
-    __block BOOL success = NO;
-    __block NSError *opError = nil;
-    dispatch_sync(_delegateQueue, ^{
-        GCDAsyncUdpSocket *udpSocket = self->_asyncSockets[socketId];
-        if (!udpSocket) { opError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:@{NSLocalizedDescriptionKey:@"Socket not found"}]; return; }
+    return [self leaveMulticastGroup:socketId address:address interface:nil error:error];
+}
+
+- (BOOL)leaveMulticastGroup:(NSNumber *)socketId address:(NSString *)address interface:(nullable NSString *)interface error:(NSError **)error {
+    return [self performOnQueue:^BOOL(NSError **opError) {
+        GCDAsyncUdpSocket *udpSocket = [self socketForOption:socketId error:opError];
+        if (!udpSocket) return NO;
+        udpdirect::UDPInterface resolved;
+        if (interface && ![self findInterface:interface result:resolved error:opError]) return NO;
         NSError *nativeError = nil;
-        if (![udpSocket leaveMulticastGroup:address error:&nativeError]) {
-            opError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeInternalException userInfo:@{NSLocalizedDescriptionKey: nativeError.localizedDescription, @"nativeError": nativeError}];
-        } else {
-            UDP_SM_LOG(@"Socket %@ left multicast group %@", socketId, address);
-            success = YES;
+        BOOL left = interface
+            ? [udpSocket leaveMulticastGroup:address onInterface:@(resolved.name.c_str()) error:&nativeError]
+            : [udpSocket leaveMulticastGroup:address error:&nativeError];
+        if (!left) {
+            *opError = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeInternalException userInfo:@{NSLocalizedDescriptionKey: nativeError.localizedDescription, @"nativeError": nativeError}];
+            return NO;
         }
+        UDP_SM_LOG(@"Socket %@ left multicast group %@", socketId, address);
+        return YES;
+    } error:error];
+}
+
+- (BOOL)setMulticastInterface:(NSNumber *)socketId interface:(NSString *)interface error:(NSError **)error {
+    return [self performOnQueue:^BOOL(NSError **opError) {
+        return [self setMulticastInterfaceOnQueue:socketId interface:interface error:opError];
+    } error:error];
+}
+
+- (BOOL)setMulticastInterfaceOnQueue:(NSNumber *)socketId interface:(NSString *)interface error:(NSError **)error {
+    GCDAsyncUdpSocket *udpSocket = [self socketForOption:socketId error:error];
+    if (!udpSocket) return NO;
+    udpdirect::UDPInterface resolved;
+    if (![self findInterface:interface result:resolved error:error]) return NO;
+    if (!resolved.supportsMulticast()) {
+        if (error) *error = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeInvalidArguments userInfo:@{NSLocalizedDescriptionKey: [NSString stringWithFormat:@"Interface %s does not support multicast", resolved.name.c_str()]}];
+        return NO;
+    }
+    // IPv4 takes the interface index where the platform has IP_MULTICAST_IFINDEX, otherwise one
+    // of its addresses; IPv6 always takes the index
+#ifdef IP_MULTICAST_IFINDEX
+    unsigned int index4 = resolved.index;
+    const int name4 = IP_MULTICAST_IFINDEX;
+    const void *value4 = &index4;
+    socklen_t length4 = sizeof(index4);
+#else
+    struct in_addr address4 = {};
+    udpdirect::UDPSocketAddress first4 = resolved.firstAddress(AF_INET);
+    memcpy(&address4, first4.bytes, sizeof(address4));
+    const int name4 = IP_MULTICAST_IF;
+    const void *value4 = &address4;
+    socklen_t length4 = sizeof(address4);
+#endif
+    unsigned int index6 = resolved.index;
+    if (!UDPSetSocketOption(udpSocket, IPPROTO_IP, name4, value4, length4,
+                            IPPROTO_IPV6, IPV6_MULTICAST_IF, &index6, sizeof(index6), error)) {
+        return NO;
+    }
+    UDP_SM_LOG(@"Socket %@ sends multicast on %s (index %u)", socketId, resolved.name.c_str(), resolved.index);
+    return YES;
+}
+
+- (void)configureSocket:(NSNumber *)socketId options:(NSDictionary *)options completion:(UDPSocketOperationCompletion)completion {
+    dispatch_async(_delegateQueue, ^{
+        NSError *configureError = nil;
+        [self configureSocketOnQueue:socketId options:options error:&configureError];
+        completion(configureError);
     });
-    if (error && opError) *error = opError;
-    return success;
+}
+
+// Delegate queue only. Applies options in a fixed order and stops at the first failure; the
+// error names the option that failed.
+- (BOOL)configureSocketOnQueue:(NSNumber *)socketId options:(NSDictionary *)options error:(NSError **)error {
+    if (![self socketForOption:socketId error:error]) return NO;
+
+    NSError *optionError = nil;
+    NSString *failed = nil;
+    NSNumber *broadcast = options[@"broadcast"];
+    NSNumber *ttl = options[@"ttl"];
+    NSNumber *multicastTTL = options[@"multicastTTL"];
+    NSNumber *loopback = options[@"loopback"];
+    NSString *multicastInterface = options[@"multicastInterface"];
+    if (broadcast && ![self setBroadcastOnQueue:socketId enable:broadcast.boolValue error:&optionError]) {
+        failed = @"broadcast";
+    } else if (ttl && ![self setTTLOnQueue:socketId ttl:ttl.intValue error:&optionError]) {
+        failed = @"ttl";
+    } else if (multicastTTL && ![self setMulticastTTLOnQueue:socketId ttl:multicastTTL.intValue error:&optionError]) {
+        failed = @"multicastTTL";
+    } else if (loopback && ![self setMulticastLoopbackOnQueue:socketId flag:loopback.boolValue error:&optionError]) {
+        failed = @"loopback";
+    } else if (multicastInterface && ![self setMulticastInterfaceOnQueue:socketId interface:multicastInterface error:&optionError]) {
+        failed = @"multicastInterface";
+    } else {
+        for (NSString *group in options[@"groups"]) {
+            if (![self joinMulticastGroupOnQueue:socketId address:group interface:multicastInterface error:&optionError]) {
+                failed = [NSString stringWithFormat:@"groups (%@)", group];
+                break;
+            }
+        }
+    }
+    if (failed) {
+        if (error) *error = [NSError errorWithDomain:optionError.domain code:optionError.code userInfo:@{NSLocalizedDescriptionKey: [NSString stringWithFormat:@"%@: %@", failed, optionError.localizedDescription]}];
+        return NO;
+    }
+    return YES;
 }
 
 #pragma mark - Utility Implementations
@@ -662,58 +1827,58 @@ NSString * const UDPErrorDomain = @"com.lama.udpdirect.ErrorDomain";
 - (nullable NSDictionary *)getSocketAddress:(NSNumber *)socketId {
     __block NSDictionary *addressInfo = nil;
     dispatch_sync(_delegateQueue, ^{
-        GCDAsyncUdpSocket *udpSocket = self->_asyncSockets[socketId];
-        if (udpSocket) {
-            NSString *localHost = [udpSocket localHost_IPv4] ?: [udpSocket localHost_IPv6];
-            uint16_t localPort = [udpSocket localPort];
-            if (localHost) {
-                addressInfo = @{
-                    @"address": localHost,
-                    @"port": @(localPort),
-                    @"family": ([udpSocket isIPv6] ? @"IPv6" : @"IPv4")
-                };
-            } else { // Might be created but not bound
-                 NSDictionary *sInfo = self->_socketInfo[socketId];
-                 if (sInfo && sInfo[@"boundAddress"] && sInfo[@"boundPort"]) {
-                     addressInfo = @{ @"address": sInfo[@"boundAddress"], @"port": sInfo[@"boundPort"], @"family": ([udpSocket isIPv6] ? @"IPv6" : @"IPv4")};
-                 } else {
-                     UDP_SM_LOG(@"Socket %@ found but not bound or local address unavailable.", socketId);
-                 }
-            }
-        } else {
-            UDP_SM_ERROR(@"Socket %@ not found for getSocketAddress.", socketId);
-        }
+        addressInfo = [self socketAddressOnQueue:socketId];
+    });
+    return addressInfo;
+}
+
+- (void)getSocketAddress:(NSNumber *)socketId completion:(UDPSocketAddressCompletion)completion {
+    dispatch_async(_delegateQueue, ^{
+        NSDictionary *addressInfo = [self socketAddressOnQueue:socketId];
+        completion(addressInfo, nil);
     });
+}
+
+// Delegate queue only
+- (nullable NSDictionary *)socketAddressOnQueue:(NSNumber *)socketId {
+    NSDictionary *addressInfo = nil;
+    GCDAsyncUdpSocket *udpSocket = _asyncSockets[socketId];
+    if (udpSocket) {
+        NSString *localHost = [udpSocket localHost_IPv4] ?: [udpSocket localHost_IPv6];
+        uint16_t localPort = [udpSocket localPort];
+        if (localHost) {
+            addressInfo = @{
+                @"address": localHost,
+                @"port": @(localPort),
+                @"family": ([udpSocket isIPv6] ? @"IPv6" : @"IPv4")
+            };
+        } else { // Might be created but not bound
+             NSDictionary *sInfo = _socketInfo[socketId];
+             if (sInfo && sInfo[@"boundAddress"] && sInfo[@"boundPort"]) {
+                 addressInfo = @{ @"address": sInfo[@"boundAddress"], @"port": sInfo[@"boundPort"], @"family": ([udpSocket isIPv6] ? @"IPv6" : @"IPv4")};
+             } else {
+                 UDP_SM_LOG(@"Socket %@ found but not bound or local address unavailable.", socketId);
+             }
+        }
+    } else {
+        UDP_SM_ERROR(@"Socket %@ not found for getSocketAddress.", socketId);
+    }
     return addressInfo;
 }
 
+// From the interface table, so repeated calls cost no getifaddrs walk
 - (NSArray<NSString *> *)getLocalIPAddresses {
     NSMutableArray *ipAddresses = [NSMutableArray array];
-    struct ifaddrs *interfaces = NULL;
-    struct ifaddrs *temp_addr = NULL;
-    int success = getifaddrs(&interfaces);
-    if (success == 0) {
-        temp_addr = interfaces;
-        while(temp_addr != NULL) {
-            if(temp_addr->ifa_addr->sa_family == AF_INET) {
-                NSString *address = [NSString stringWithUTF8String:inet_ntoa(((struct sockaddr_in *)temp_addr->ifa_addr)->sin_addr)];
-                if (address && ![address isEqualToString:@"0.0.0.0"] && ![address isEqualToString:@"127.0.0.1"]) {
-                    [ipAddresses addObject:address];
-                }
-            } else if (temp_addr->ifa_addr->sa_family == AF_INET6) {
-                char addrBuf[INET6_ADDRSTRLEN];
-                const char* str = inet_ntop(AF_INET6, &(((struct sockaddr_in6 *)temp_addr->ifa_addr)->sin6_addr), addrBuf, INET6_ADDRSTRLEN);
-                if (str) {
-                    NSString *address = [NSString stringWithUTF8String:str];
-                    if (address && ![address isEqualToString:@"::1"] && !([address rangeOfString:@"%"].location != NSNotFound) ) {
-                        [ipAddresses addObject:address];
-                    }
-                }
+    std::shared_ptr<const udpdirect::UDPInterfaceTable> table = _interfaceMonitor->table();
+    for (const auto &interface : table->interfaces) {
+        for (const auto &address : interface.addresses) {
+            std::string host = address.hostString();
+            if (host.empty() || host == "0.0.0.0" || host == "127.0.0.1" || host == "::1") {
+                continue;
             }
-            temp_addr = temp_addr->ifa_next;
+            [ipAddresses addObject:@(host.c_str())];
         }
     }
-    freeifaddrs(interfaces);
     UDP_SM_LOG(@"Found IP Addresses: %@", ipAddresses);
     return [ipAddresses copy]; // Return immutable copy
 }
@@ -807,6 +1972,83 @@ NSString * const UDPErrorDomain = @"com.lama.udpdirect.ErrorDomain";
 }
 
 
+#pragma mark - Capture Replay
+
+- (void)startReplay:(std::shared_ptr<udpdirect::UDPCaptureReplay>)replay onSocket:(NSNumber *)socketId completion:(UDPReplayCompletion)completion {
+    dispatch_async(_delegateQueue, ^{
+        GCDAsyncUdpSocket *udpSocket = self->_asyncSockets[socketId];
+        UDPReceiveQueue *receiveQueue = [self receiveQueueForSocket:socketId];
+        if (!udpSocket || !receiveQueue) {
+            UDP_SM_ERROR(@"Socket %@ not found for startReplay.", socketId);
+            completion(0, 0, [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeSocketNotFound userInfo:@{NSLocalizedDescriptionKey:@"Socket not found"}]);
+            return;
+        }
+        uint32_t handle = socketId.unsignedIntValue;
+        dispatch_async(receiveQueue->queue, ^{
+            // A replay this one replaces completes at its next step
+            receiveQueue->replays[handle] = replay;
+            [self continueReplay:replay onSocket:udpSocket socketId:socketId receiveQueue:receiveQueue completion:completion];
+        });
+    });
+}
+
+- (void)stopReplayOnSocket:(NSNumber *)socketId {
+    dispatch_async(_delegateQueue, ^{
+        UDPReceiveQueue *receiveQueue = [self receiveQueueForSocket:socketId];
+        if (!receiveQueue) {
+            return;
+        }
+        uint32_t handle = socketId.unsignedIntValue;
+        dispatch_async(receiveQueue->queue, ^{
+            receiveQueue->replays.erase(handle);
+        });
+    });
+}
+
+// Receive queue only. Delivers what is due, at most kReplayChunk datagrams, then requeues
+// itself: right away when more are due, otherwise for when the next one is. A replay that
+// is no longer the socket's current one (stopped, replaced or closed) completes instead.
+- (void)continueReplay:(std::shared_ptr<udpdirect::UDPCaptureReplay>)replay onSocket:(GCDAsyncUdpSocket *)udpSocket socketId:(NSNumber *)socketId receiveQueue:(UDPReceiveQueue *)receiveQueue completion:(UDPReplayCompletion)completion {
+    auto current = receiveQueue->replays.find(socketId.unsignedIntValue);
+    if (current == receiveQueue->replays.end() || current->second != replay) {
+        completion(replay->delivered(), replay->skipped(), nil);
+        return;
+    }
+
+    for (int i = 0; i < kReplayChunk; i++) {
+        const udpdirect::UDPCapturedDatagram *datagram = replay->peek();
+        if (!datagram) {
+            receiveQueue->replays.erase(current);
+            NSError *error = nil;
+            if (replay->malformed()) {
+                error = [NSError errorWithDomain:UDPErrorDomain code:UDPErrorCodeInvalidArguments userInfo:@{NSLocalizedDescriptionKey:@"Capture file is truncated or malformed"}];
+            }
+            completion(replay->delivered(), replay->skipped(), error);
+            return;
+        }
+        uint64_t nowNs = udpdirect::UDPMonotonicNowNs();
+        uint64_t dueNs = replay->dueNs(nowNs);
+        if (dueNs > nowNs) {
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(dueNs - nowNs)), receiveQueue->queue, ^{
+                [self continueReplay:replay onSocket:udpSocket socketId:socketId receiveQueue:receiveQueue completion:completion];
+            });
+            return;
+        }
+
+        // Copied: the payload lives in the mapped file, and onDataReceived keeps the NSData
+        struct sockaddr_storage storage;
+        socklen_t addressLength = datagram->source.toSockaddr(storage);
+        NSData *data = [NSData dataWithBytes:datagram->payload length:datagram->length];
+        NSData *address = [NSData dataWithBytes:&storage length:addressLength];
+        replay->pop();
+        [self udpSocket:udpSocket didReceiveData:data fromAddress:address withFilterContext:nil];
+    }
+
+    dispatch_async(receiveQueue->queue, ^{
+        [self continueReplay:replay onSocket:udpSocket socketId:socketId receiveQueue:receiveQueue completion:completion];
+    });
+}
+
 #pragma mark - GCDAsyncUdpSocketDelegate Methods
 
 - (void)udpSocket:(GCDAsyncUdpSocket *)sock didReceiveData:(NSData *)data
@@ -819,106 +2061,167 @@ withFilterContext:(nullable id)filterContext {
         return;
     }
 
-    NSString *senderHost = [GCDAsyncUdpSocket hostFromAddress:address];
-    uint16_t senderPort = [GCDAsyncUdpSocket portFromAddress:address];
-
-    __block NSNumber *socketId = nil;
-    __block NSNumber *newBufferId = nil;
-
-    // Find socketId and create buffer within the delegate queue
-    // The delegate methods are already called on _delegateQueue.
-    // No need for another dispatch_sync here unless explicitly managing cross-block state.
+    // Delegate methods run on the socket's receive queue, which owns the reverse map
+    UDPReceiveQueue *receiveQueue = [self currentReceiveQueue];
+    NSNumber *socketId = [self socketIdForSocket:sock];
 
-    // Safety check for _asyncSockets dictionary
-    if (!self->_asyncSockets) {
-        UDP_SM_ERROR(@"_asyncSockets dictionary is null during didReceiveData");
+    if (!socketId) {
+        UDP_SM_ERROR(@"Received data on a socket not tracked by UDPSocketManager.");
         return;
     }
 
-    for (NSNumber *sId in self->_asyncSockets) {
-        if (self->_asyncSockets[sId] == sock) {
-            socketId = sId;
+    // Filter, verify and reassemble straight off the NSData, so noise costs no pool slot,
+    // copy or string conversion
+    udpdirect::UDPSocketAddress source;
+    udpdirect::UDPSocketAddress::fromSockaddr((const struct sockaddr *)address.bytes, (socklen_t)address.length, source);
+    udpdirect::UDPReceivePipeline &pipeline = *receiveQueue->pipeline;
+    udpdirect::UDPReceiveContext context = pipeline.context(socketId.unsignedIntValue);
+    size_t length = data.length;
+    uint32_t route = 0;
+    std::shared_ptr<std::vector<uint8_t>> message;
+    switch (pipeline.process(context, (const uint8_t *)data.bytes, length, source, route, message)) {
+        case udpdirect::UDPReceiveVerdict::Deliver:
             break;
-        }
+        case udpdirect::UDPReceiveVerdict::Reassembled:
+            if (UDPSocketDidReassembleMessage onMessageReassembled = self.onMessageReassembled) {
+                onMessageReassembled(socketId, std::move(message), source, route);
+            }
+            return;
+        case udpdirect::UDPReceiveVerdict::Dropped:
+        case udpdirect::UDPReceiveVerdict::Consumed:
+            return;
     }
 
-    if (!socketId) {
-        UDP_SM_ERROR(@"Received data on a socket not tracked by UDPSocketManager.");
+    // Pooled path: one copy into a preallocated slot, no dictionary bookkeeping.
+    // The slot is owned by the callback from here on.
+    UDPSocketDidReceiveSlot onSlotReceived = self.onSlotReceived;
+    if (onSlotReceived) {
+        udpdirect::UDPBufferSlot slot = _receivePool->acquire(length);
+        if (!slot) {
+            // Counted in the pool's exhausted/overBudget stats; logging every drop would only make a flood worse
+            UDP_SM_DEBUG(@"Receive pool exhausted or over budget, dropping %lu byte datagram on socket %@", (unsigned long)length, socketId);
+            pipeline.countDrop(context, length);
+            return;
+        }
+        memcpy(slot.data, data.bytes, length);
+        onSlotReceived(socketId, slot, source, route, 0);
         return;
     }
 
-    NSMutableData *mutableData = [data mutableCopy]; // Ensure data is mutable for storage
-    newBufferId = @(self->_nextBufferId++);
-    self->_buffers[newBufferId] = mutableData;
-    self->_bufferStatus[newBufferId] = kUDPBufferStatusReadyForJSAccess; // Mark as ready for JS
-    UDP_SM_LOG(@"Stored received data into buffer %@ (size: %lu) for socket %@. Status: ReadyForJSAccess", newBufferId, (unsigned long)mutableData.length, socketId);
-    
+    // onDataReceived has no route handlers; routed datagrams are delivered like any other
+    NSString *senderHost = [GCDAsyncUdpSocket hostFromAddress:address];
+    uint16_t senderPort = [GCDAsyncUdpSocket portFromAddress:address];
+
+    // Hand the datagram over as-is. Received data used to be parked in _buffers until JS
+    // released it, which nothing on the message path ever did, so the map grew forever.
     if (self.onDataReceived) {
-        self.onDataReceived(socketId, mutableData, senderHost, senderPort, newBufferId);
+        NSData *payload = length == data.length ? data : [data subdataWithRange:NSMakeRange(0, length)];
+        self.onDataReceived(socketId, payload, senderHost, senderPort, nil);
     } else {
-        UDP_SM_LOG(@"onDataReceived callback not set, data for socket %@ ignored.", socketId);
+        UDP_SM_DEBUG(@"onDataReceived callback not set, data for socket %@ ignored.", socketId);
     }
 }
 
+// Send and close completions arrive on the socket's receive queue; their bookkeeping is
+// shared with the send paths, so it hops to the delegate queue.
 - (void)udpSocket:(GCDAsyncUdpSocket *)sock didNotSendDataWithTag:(long)tag dueToError:(NSError *)error {
-    __block NSNumber *socketId = nil;
-    // Find socketId for this sock
-    for (NSNumber *sId in self->_asyncSockets) {
-        if (self->_asyncSockets[sId] == sock) {
-            socketId = sId;
-            break;
+    NSNumber *socketId = [self socketIdForSocket:sock];
+    dispatch_async(_delegateQueue, ^{
+        UDP_SM_ERROR(@"Socket %@ failed to send data with tag %ld. Error: %@", socketId ?: @"<unknown>", tag, error.localizedDescription);
+        UDP_TRACE(*self->_trace, SendFailed, socketId.unsignedIntValue, 0);
+        auto pending = self->_pendingSends.find(tag);
+        if (pending != self->_pendingSends.end()) {
+            UDPCompleteTxSlot(pending->second);
+            self->_pendingSends.erase(pending);
         }
-    }
-    UDP_SM_ERROR(@"Socket %@ failed to send data with tag %ld. Error: %@", socketId ?: @"<unknown>", tag, error.localizedDescription);
-    if (self.onSendFailure) {
-        self.onSendFailure(socketId, tag, error);
-    }
+        if (udpdirect::UDPSocketCounters *counters = self->_stats->find(socketId.unsignedIntValue)) {
+            counters->sendFailures.fetch_add(1, std::memory_order_relaxed);
+        }
+        [self adjustQueuedSends:socketId by:-1];
+        if (self.onSendFailure) {
+            self.onSendFailure(socketId, tag, error);
+        }
+    });
 }
 
 - (void)udpSocket:(GCDAsyncUdpSocket *)sock didSendDataWithTag:(long)tag {
-    __block NSNumber *socketId = nil;
-    // Find socketId for this sock
-     for (NSNumber *sId in self->_asyncSockets) {
-        if (self->_asyncSockets[sId] == sock) {
-            socketId = sId;
-            break;
+    NSNumber *socketId = [self socketIdForSocket:sock];
+    uint64_t completedNs = udpdirect::UDPMonotonicNowNs(); // before the hop, which would skew it
+    dispatch_async(_delegateQueue, ^{
+        UDP_SM_DEBUG(@"Socket %@ successfully sent data with tag %ld", socketId ?: @"<unknown>", tag);
+        UDP_TRACE(*self->_trace, SendComplete, socketId.unsignedIntValue, 0);
+        udpdirect::UDPSocketCounters *counters = self->_stats->find(socketId.unsignedIntValue);
+        auto pending = self->_pendingSends.find(tag);
+        if (pending != self->_pendingSends.end()) {
+            self->_stats->sendLatency().record(completedNs - pending->second.enqueuedNs);
+            if (counters) {
+                counters->countSent(pending->second.bytes);
+            }
+            UDPSocketDidCompleteSend onSendCompleted = self.onSendCompleted;
+            if (onSendCompleted && [self sendTimestampsOnSocket:socketId.unsignedIntValue]) {
+                onSendCompleted(socketId, tag, pending->second.bytes, pending->second.enqueuedNs, completedNs);
+            }
+            UDPCompleteTxSlot(pending->second);
+            self->_pendingSends.erase(pending);
+        } else if (counters) {
+            counters->txPackets.fetch_add(1, std::memory_order_relaxed);
         }
-    }
-    UDP_SM_LOG(@"Socket %@ successfully sent data with tag %ld", socketId ?: @"<unknown>", tag);
-    if (self.onSendSuccess) {
-        self.onSendSuccess(socketId, tag);
-    }
+        if (socketId) {
+            [self adjustQueuedSends:socketId by:-1];
+            [self cacheSocketFDsIfNeeded:sock forSocket:socketId];
+        }
+        if (self.onSendSuccess) {
+            self.onSendSuccess(socketId, tag);
+        }
+    });
 }
 
-- (void)udpSocketDidClose:(GCDAsyncUdpSocket *)sock withError:(NSError *)error {
-    __block NSNumber *sockId = nil;
-    // Find the socket ID and remove it
-    // This is already on _delegateQueue
-    for (NSNumber *currentId in [self->_asyncSockets allKeys]) { // Iterate on keys copy
-        if (self->_asyncSockets[currentId] == sock) {
-            sockId = currentId;
-            break;
+- (void)udpSocket:(GCDAsyncUdpSocket *)sock didConnectToAddress:(NSData *)address {
+    NSNumber *socketId = [self socketIdForSocket:sock];
+    if (!socketId) return;
+    // Connecting may have created the descriptor or closed the other family's one
+    [self cacheSocketFDs:sock forSocket:socketId];
+    {
+        std::lock_guard<std::mutex> lock(_socketTableMutex);
+        if (UDPSocketState *state = _socketTable->get(socketId.unsignedIntValue)) {
+            state->connected = true;
         }
     }
+    UDP_SM_LOG(@"Socket %@ connected", socketId);
+}
+
+- (void)udpSocket:(GCDAsyncUdpSocket *)sock didNotConnect:(NSError *)error {
+    NSNumber *socketId = [self socketIdForSocket:sock];
+    UDP_SM_ERROR(@"Socket %@ failed to connect: %@", socketId ?: @"<unknown>", error.localizedDescription);
+    // Sends queued behind the connect fail through didNotSendDataWithTag:
+}
+
+- (void)udpSocketDidClose:(GCDAsyncUdpSocket *)sock withError:(NSError *)error {
+    NSNumber *sockId = [self socketIdForSocket:sock];
 
     if (!sockId) {
-        UDP_SM_ERROR(@"udpSocketDidClose called for an unknown socket instance.");
+        // Also the case after closeAllSocketsSynchronously, which cleans up without waiting for this
+        UDP_SM_DEBUG(@"udpSocketDidClose called for an unknown socket instance.");
         return;
     }
 
-    UDP_SM_LOG(@"Socket %@ did close. Error: %@", sockId, (error ? error.localizedDescription : @"No error"));
-    [self->_asyncSockets removeObjectForKey:sockId];
-    [self->_socketInfo removeObjectForKey:sockId];
-    
-    if (error) {
-        self->_socketStatus[sockId] = kUDPSocketStatusError;
-    } else {
-        self->_socketStatus[sockId] = kUDPSocketStatusClosed;
-    }
-    
-    if (self.onSocketClosed) {
-        self.onSocketClosed(sockId, error);
-    }
+    dispatch_async(_delegateQueue, ^{
+        UDP_SM_LOG(@"Socket %@ did close. Error: %@", sockId, (error ? error.localizedDescription : @"No error"));
+        UDP_TRACE(*self->_trace, Close, sockId.unsignedIntValue, 0);
+        [self releaseSocketId:sockId socket:sock];
+        [self->_asyncSockets removeObjectForKey:sockId];
+        [self->_socketInfo removeObjectForKey:sockId];
+        
+        if (error) {
+            self->_socketStatus[sockId] = kUDPSocketStatusError;
+        } else {
+            self->_socketStatus[sockId] = kUDPSocketStatusClosed;
+        }
+        
+        if (self.onSocketClosed) {
+            self.onSocketClosed(sockId, error);
+        }
+    });
 }
 
 #pragma mark - Diagnostics
@@ -944,6 +2247,135 @@ withFilterContext:(nullable id)filterContext {
         }
         diagnostics[@"buffers"] = bufferDetails;
         diagnostics[@"nextBufferId"] = @(self->_nextBufferId);
+
+        udpdirect::UDPBufferPoolClassStats poolStats[udpdirect::UDPBufferPool::kSizeClassCount];
+        self->_receivePool->getStats(poolStats);
+        NSMutableArray *poolDetails = [NSMutableArray array];
+        for (const auto &classStats : poolStats) {
+            [poolDetails addObject:@{
+                @"slotSize": @(classStats.slotSize),
+                @"slotCount": @(classStats.slotCount),
+                @"inUse": @(classStats.inUse),
+                @"highWater": @(classStats.highWater),
+                @"acquired": @(classStats.acquired),
+                @"exhausted": @(classStats.exhausted)
+            }];
+        }
+        diagnostics[@"receivePool"] = poolDetails;
+
+        udpdirect::UDPBufferPoolBudgetStats budget = self->_receivePool->budgetStats();
+        diagnostics[@"receivePoolBudget"] = @{
+            @"budgetBytes": @(budget.budgetBytes),
+            @"inUseBytes": @(budget.inUseBytes),
+            @"highWaterBytes": @(budget.highWaterBytes),
+            @"heapInUse": @(budget.heapInUse),
+            @"heapAcquired": @(budget.heapAcquired),
+            @"overBudget": @(budget.overBudget)
+        };
+
+        udpdirect::UDPBatchIOStats sendStats = self->_sendBatchIO->stats();
+        udpdirect::UDPBatchIOStats receiveStats;
+        NSMutableArray *receiveQueueDetails = [NSMutableArray arrayWithCapacity:self->_receiveQueues.size()];
+        for (const auto &receiveQueue : self->_receiveQueues) {
+            udpdirect::UDPBatchIOStats queueStats = receiveQueue->batchIO->stats();
+            receiveStats.receiveSyscalls += queueStats.receiveSyscalls;
+            receiveStats.receivedPackets += queueStats.receivedPackets;
+            receiveStats.receivedBytes += queueStats.receivedBytes;
+            receiveStats.truncated += queueStats.truncated;
+            receiveStats.dropped += queueStats.dropped;
+            receiveStats.timestamped += queueStats.timestamped;
+            [receiveQueueDetails addObject:@{
+                @"index": @(receiveQueue->index),
+                @"sockets": @(receiveQueue->sockets),
+                @"receivedPackets": @(queueStats.receivedPackets)
+            }];
+        }
+        diagnostics[@"receiveQueues"] = receiveQueueDetails;
+        diagnostics[@"batchIO"] = @{
+            @"sendSyscalls": @(sendStats.sendSyscalls),
+            @"sentPackets": @(sendStats.sentPackets),
+            @"sentBytes": @(sendStats.sentBytes),
+            @"receiveSyscalls": @(receiveStats.receiveSyscalls),
+            @"receivedPackets": @(receiveStats.receivedPackets),
+            @"receivedBytes": @(receiveStats.receivedBytes),
+            @"truncated": @(receiveStats.truncated),
+            @"dropped": @(receiveStats.dropped),
+            @"timestamped": @(receiveStats.timestamped),
+            @"batchReceiveSockets": @(self->_batchReceiveSources.count)
+        };
+
+        // Trace dump: records are [timestampNs, event, socketId, bytes], oldest first
+        NSMutableDictionary *traceDetails = [NSMutableDictionary dictionary];
+        traceDetails[@"enabled"] = @(self->_trace->enabled());
+        traceDetails[@"capacity"] = @(self->_trace->capacity());
+        traceDetails[@"recorded"] = @(self->_trace->recorded());
+        std::vector<udpdirect::UDPTraceRecord> records = self->_trace->snapshot();
+        NSMutableArray *traceRecords = [NSMutableArray arrayWithCapacity:records.size()];
+        for (const auto &record : records) {
+            [traceRecords addObject:@[@(record.timestampNs), @(udpdirect::UDPTraceEventName(record.event)), @(record.socketId), @(record.bytes)]];
+        }
+        traceDetails[@"records"] = traceRecords;
+        diagnostics[@"trace"] = traceDetails;
+
+        udpdirect::UDPSocketCountersSnapshot totals = self->_stats->totals();
+        auto latencyDetails = [](const udpdirect::UDPLatencySummary &summary) {
+            return @{
+                @"count": @(summary.count),
+                @"minUs": @(summary.minNs / 1000.0),
+                @"meanUs": @(summary.meanNs / 1000.0),
+                @"p50Us": @(summary.p50Ns / 1000.0),
+                @"p90Us": @(summary.p90Ns / 1000.0),
+                @"p99Us": @(summary.p99Ns / 1000.0),
+                @"p999Us": @(summary.p999Ns / 1000.0),
+                @"maxUs": @(summary.maxNs / 1000.0)
+            };
+        };
+        udpdirect::UDPCaptureStats captureStats = self->_capture->stats();
+        diagnostics[@"capture"] = @{
+            @"active": @(captureStats.active),
+            @"captured": @(captureStats.captured),
+            @"dropped": @(captureStats.dropped),
+            @"truncated": @(captureStats.truncated),
+            @"bytesWritten": @(captureStats.bytesWritten),
+            @"writeErrors": @(captureStats.writeErrors),
+            @"ringBytes": @(captureStats.ringBytes),
+            @"ringHighWater": @(captureStats.ringHighWater)
+        };
+
+        udpdirect::UDPInterfaceMonitorStats interfaceStats = self->_interfaceMonitor->stats();
+        diagnostics[@"interfaces"] = @{
+            @"version": @(interfaceStats.version),
+            @"refreshes": @(interfaceStats.refreshes),
+            @"changes": @(interfaceStats.changes),
+            @"failures": @(interfaceStats.failures),
+            @"notifications": @(interfaceStats.notifications)
+        };
+
+        udpdirect::UDPSendSchedulerStats schedulerStats = self->_sendScheduler->stats();
+        diagnostics[@"sendScheduler"] = @{
+            @"queuedPackets": @(schedulerStats.queuedPackets),
+            @"queuedBytes": @(schedulerStats.queuedBytes),
+            @"highWaterPackets": @(schedulerStats.highWaterPackets),
+            @"enqueued": @(schedulerStats.enqueued),
+            @"dispatched": @(schedulerStats.dispatched),
+            @"shaped": @(schedulerStats.shaped),
+            @"rejected": @(schedulerStats.rejected),
+            @"discarded": @(schedulerStats.discarded),
+            @"latency": latencyDetails(self->_sendScheduler->shapedLatency().summary())
+        };
+
+        diagnostics[@"stats"] = @{
+            @"rxPackets": @(totals.rxPackets),
+            @"rxBytes": @(totals.rxBytes),
+            @"txPackets": @(totals.txPackets),
+            @"txBytes": @(totals.txBytes),
+            @"sendFailures": @(totals.sendFailures),
+            @"drops": @(totals.drops),
+            @"queueDepth": @(totals.queueDepth),
+            @"pendingSends": @(self->_pendingSends.size()),
+            @"receiveLatency": latencyDetails(self->_stats->receiveLatency().summary()),
+            @"sendLatency": latencyDetails(self->_stats->sendLatency().summary())
+        };
         
         // Socket information
         NSMutableArray *socketDetails = [NSMutableArray array];
@@ -972,8 +2404,14 @@ withFilterContext:(nullable id)filterContext {
             [socketDetails addObject:details];
         }
         diagnostics[@"sockets"] = socketDetails;
-        diagnostics[@"nextSocketId"] = @(self->_nextSocketId);
-        diagnostics[@"nextSendTag"] = @(self->_nextSendTag);
+        {
+            std::lock_guard<std::mutex> lock(self->_socketTableMutex);
+            diagnostics[@"socketTable"] = @{
+                @"live": @(self->_socketTable->size()),
+                @"capacity": @(self->_socketTable->capacity())
+            };
+        }
+        diagnostics[@"nextSendTag"] = @(self->_nextSendTag.load());
     });
     return diagnostics;
 }
@@ -981,12 +2419,15 @@ withFilterContext:(nullable id)filterContext {
 
 - (void)dealloc {
     UDP_SM_LOG(@"Dealloc starting cleanup...");
+    dispatch_source_cancel(_sendTimer);
+    nw_path_monitor_cancel(_pathMonitor);
     // Ensure cleanup happens on the delegate queue to avoid race conditions with ongoing operations
     dispatch_sync(_delegateQueue, ^{
         for (NSNumber *socketId in [self->_asyncSockets allKeys]) {
             GCDAsyncUdpSocket *udpSocket = self->_asyncSockets[socketId];
             if (udpSocket) {
                 UDP_SM_LOG(@"Dealloc: Closing socket %@", socketId);
+                [self forgetSocketFDs:socketId];
                 [udpSocket close];
             }
         }
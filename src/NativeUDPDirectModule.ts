@@ -6,6 +6,7 @@ export interface UdpSocketOptionsSpec {
   type: string; // 'udp4' | 'udp6'
   reuseAddr: boolean;
   reusePort?: boolean; // Allow SO_REUSEPORT on supported platforms (macOS/iOS)
+  receiveQueue?: number; // Native receive queue index; defaults to the least loaded one
   broadcast: boolean;
   debug?: boolean;
   debugLabel?: string;
@@ -32,8 +33,10 @@ export interface Spec extends TurboModule {
   close(socketId: string): Promise<void>;
   closeAllSockets(): Promise<{ closed: number }>;
 
-  // Data Transmission
+  // Data Transmission. sendBinary takes an ArrayBuffer or a typed array and skips
+  // base64 entirely; send() with base64 is kept for compatibility.
   send(socketId: string, base64Data: string, port: number, address: string, options?: SendOptionsSpec): Promise<void>;
+  sendBinary(socketId: string, data: Object, port: number, address: string, options?: SendOptionsSpec): Promise<void>;
 
   // Network Information
   getLocalIPAddresses(): string[]; // Returns array of local IP addresses
@@ -44,6 +47,10 @@ export interface Spec extends TurboModule {
   
   // Event Handling
   setDataEventHandler(socketId: string): Promise<void>;
+  // Delivers each datagram for the socket as { socketId, data: ArrayBuffer, address, port, family }
+  // instead of a base64 'message' event. Dropped when the socket closes.
+  setBinaryMessageHandler(socketId: string, handler: (event: Object) => void): void;
+  removeBinaryMessageHandler(socketId: string): void;
   
   // Optional: For releasing ports if needed
   forciblyReleasePort?(port: number): Promise<{ success: boolean }>;
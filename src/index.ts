@@ -42,10 +42,54 @@ export const UDP_EVENTS = {
 // Export JSI wrapper for high-performance usage
 export { 
   UDPSocketJSI, 
+  UDPTxArena,
+  UDPPollRing,
   createUDPSocket, 
   isJSIAvailable,
+  resolveEndpoint,
+  releaseEndpoint,
+  getNetworkInterfaces,
+  refreshNetworkInterfaces,
+  onNetworkInterfacesChanged,
+  startCapture,
+  stopCapture,
+  getCaptureStats,
+  UDPStatsField,
+  UDPPollControl,
   type UDPSocketOptions,
   type UDPMessageEvent,
+  type UDPMessageBatchEvent,
+  type UDPBatchOptions,
+  type UDPBatchPacket,
+  type UDPSocketHandle,
+  type UDPEndpointHandle,
+  type UDPTxArenaHandle,
+  type UDPTxArenaStats,
+  type UDPPollOptions,
+  type UDPPollStats,
+  type UDPBackpressurePolicy,
+  type UDPPoolOverflowPolicy,
+  type UDPSendPriority,
+  type UDPRateLimit,
+  type UDPSendRate,
+  type UDPSchedulerStats,
+  type UDPFilterAction,
+  type UDPFilterRule,
+  type UDPPacketFilter,
+  type UDPFilterStats,
+  type UDPChecksumOptions,
+  type UDPChecksumStats,
+  type UDPAddressInfo,
+  type UDPInterface,
+  type UDPInterfaceTable,
+  type UDPCaptureOptions,
+  type UDPCaptureStats,
+  type UDPReplayOptions,
+  type UDPReplayResult,
+  type UDPSocketConfig,
+  type UDPFramingOptions,
+  type UDPFramingStats,
   type UDPErrorEvent,
-  type UDPCloseEvent
+  type UDPCloseEvent,
+  type UDPSentEvent
 } from './jsi-wrapper';
\ No newline at end of file
@@ -6,50 +6,497 @@
  */
 
 declare global {
-  // Global zero-copy send function
+  // Global zero-copy send function. Returns true when the datagram was handed to
+  // the kernel straight from `buffer`, false when it was copied and queued instead.
   function udpSendDirect(
-    socketId: string,
+    socketId: UDPSocketHandle | string,
     buffer: ArrayBuffer,
     offset: number,
     length: number,
     port: number,
     address: string
-  ): void;
+  ): boolean;
 
   // UDP JSI namespace
   const _udpJSI: {
-    createSocket(options: { type?: string; reuseAddr?: boolean; broadcast?: boolean }): string;
-    bind(socketId: string, port: number, address: string): void;
-    close(socketId: string): void;
-    setEventHandler(socketId: string, handlers: {
-      onMessage?: (event: { socketId: string; data: ArrayBuffer; base64Data?: string; address: string; port: number }) => void;
-      onError?: (event: { socketId: string; error: string }) => void;
-      onClose?: (event: { socketId: string; error?: string }) => void;
+    createSocket(options: {
+      type?: string;
+      reuseAddr?: boolean;
+      reusePort?: boolean;
+      broadcast?: boolean;
+      batchReceive?: boolean;
+      timestamps?: boolean;
+      maxDatagramSize?: number;
+      receiveQueue?: number;
+    }): Promise<UDPSocketHandle>;
+    bind(socketId: UDPSocketHandle | string, port: number, address: string): Promise<UDPAddressInfo>;
+    configure(socketId: UDPSocketHandle | string, config: UDPSocketConfig): Promise<void>;
+    address(socketId: UDPSocketHandle | string): Promise<UDPAddressInfo | null>;
+    sendBatch(socketId: UDPSocketHandle | string, buffer: ArrayBuffer, packets: UDPBatchPacket[]): number;
+    resolve(address: string, port: number): UDPEndpointHandle;
+    releaseEndpoint(endpoint: UDPEndpointHandle): boolean;
+    sendTo(socketId: UDPSocketHandle | string, buffer: ArrayBuffer, offset: number, length: number, endpoint: UDPEndpointHandle): boolean;
+    sendPaced(socketId: UDPSocketHandle | string, buffer: ArrayBuffer, offset: number, length: number, endpoint: UDPEndpointHandle, priority?: UDPSendPriority): boolean;
+    setSendRate(socketId: UDPSocketHandle | string, rate: UDPSendRate): void;
+    getSchedulerStats(): UDPSchedulerStats;
+    createTxArena(slotSize: number, slotCount: number): UDPTxArenaInfo;
+    acquireTxSlot(arena: UDPTxArenaHandle): number;
+    submitTx(socketId: UDPSocketHandle | string, arena: UDPTxArenaHandle, slot: number, length: number, endpoint: UDPEndpointHandle): boolean;
+    releaseTxSlot(arena: UDPTxArenaHandle, slot: number): boolean;
+    destroyTxArena(arena: UDPTxArenaHandle): boolean;
+    getTxArenaStats(arena: UDPTxArenaHandle): UDPTxArenaStats;
+    setPollMode(socketId: UDPSocketHandle | string, options: UDPPollOptions | null): UDPPollRingInfo | undefined;
+    poll(socketId: UDPSocketHandle | string): number;
+    pollAddress(socketId: UDPSocketHandle | string, addressIndex: number): string | null;
+    getPollStats(socketId: UDPSocketHandle | string): UDPPollStats;
+    connect(socketId: UDPSocketHandle | string, endpoint: UDPEndpointHandle): Promise<void>;
+    send(socketId: UDPSocketHandle | string, buffer: ArrayBuffer, offset: number, length: number): boolean;
+    close(socketId: UDPSocketHandle | string): void;
+    setEventHandler(socketId: UDPSocketHandle | string, handlers: {
+      onMessage?: (event: UDPMessageEvent) => void;
+      onError?: (event: UDPErrorEvent) => void;
+      onClose?: (event: UDPCloseEvent) => void;
+      onSent?: (event: UDPSentEvent) => void;
+      onMessageBatch?: (event: UDPMessageBatchEvent) => void;
+      maxBatch?: number;
+      maxDelayUs?: number;
+      routes?: Array<(event: UDPMessageEvent) => void>;
     }): void;
+    setFilter(socketId: UDPSocketHandle | string, filter: UDPPacketFilter | null): void;
+    getFilterStats(socketId: UDPSocketHandle | string): UDPFilterStats | null;
+    setChecksum(socketId: UDPSocketHandle | string, checksum: UDPChecksumOptions | null): void;
+    stampChecksum(socketId: UDPSocketHandle | string, buffer: ArrayBuffer, offset: number, length: number): number;
+    getChecksumStats(socketId: UDPSocketHandle | string): UDPChecksumStats | null;
+    setFraming(socketId: UDPSocketHandle | string, framing: UDPFramingOptions | null): void;
+    sendMessage(socketId: UDPSocketHandle | string, buffer: ArrayBuffer, offset: number, length: number, endpoint: UDPEndpointHandle): boolean;
+    getFramingStats(socketId: UDPSocketHandle | string): UDPFramingStats | null;
+    setBackpressure(options: { policy?: UDPBackpressurePolicy; blockTimeoutUs?: number }): void;
+    setMemoryBudget(options: { bytes?: number; overflow?: UDPPoolOverflowPolicy }): void;
+    getDroppedPackets(socketId?: UDPSocketHandle | string): number;
+    setTraceEnabled(enabled: boolean): void;
+    getStats(socketId?: UDPSocketHandle | string | null, out?: Float64Array): Float64Array;
+    now(): number;
+    getInterfaces(sinceVersion?: number): UDPInterfaceTable | null;
+    refreshInterfaces(): UDPInterfaceTable;
+    setInterfaceChangeHandler(handler: ((event: { version: number }) => void) | null): void;
+    startCapture(path: string, options?: UDPCaptureOptions): void;
+    stopCapture(): Promise<UDPCaptureStats>;
+    getCaptureStats(): UDPCaptureStats;
+    replay(socketId: UDPSocketHandle | string, path: string, options?: UDPReplayOptions): Promise<UDPReplayResult>;
+    stopReplay(socketId: UDPSocketHandle | string): void;
   };
 }
 
+/**
+ * Field offsets into the Float64Array returned by `_udpJSI.getStats`.
+ * Counters are per socket (or totals when no socket is given); latency
+ * percentiles cover all sockets and are in microseconds.
+ */
+export const UDPStatsField = {
+  rxPackets: 0,
+  rxBytes: 1,
+  txPackets: 2,
+  txBytes: 3,
+  sendFailures: 4,
+  drops: 5,
+  queueDepth: 6,
+  // datagram read -> JS handler invoked
+  receiveLatencyCount: 7,
+  receiveLatencyMinUs: 8,
+  receiveLatencyMeanUs: 9,
+  receiveLatencyP50Us: 10,
+  receiveLatencyP90Us: 11,
+  receiveLatencyP99Us: 12,
+  receiveLatencyP999Us: 13,
+  receiveLatencyMaxUs: 14,
+  // queued send -> kernel accepted it (sends that go out directly are not timed)
+  sendLatencyCount: 15,
+  sendLatencyMinUs: 16,
+  sendLatencyMeanUs: 17,
+  sendLatencyP50Us: 18,
+  sendLatencyP90Us: 19,
+  sendLatencyP99Us: 20,
+  sendLatencyP999Us: 21,
+  sendLatencyMaxUs: 22,
+  length: 23,
+} as const;
+
+/**
+ * Native socket id. Handles are generation-checked, so an id kept after its
+ * socket closed never refers to a newer socket. Never 0.
+ */
+export type UDPSocketHandle = number;
+
+/**
+ * Destination resolved once by `_udpJSI.resolve(address, port)`. Holds a ready
+ * sockaddr, so sends to it skip string conversion and address parsing.
+ * Resolving the same address and port again returns the same handle;
+ * each resolve is paired with one `releaseEndpoint`.
+ */
+export type UDPEndpointHandle = number;
+
+export type UDPTxArenaHandle = number;
+
+/**
+ * A native send buffer cut into slots. Slot n starts at byte n * slotStride
+ * of `buffer` and holds up to slotSize bytes.
+ */
+export interface UDPTxArenaInfo {
+  arena: UDPTxArenaHandle;
+  buffer: ArrayBuffer;
+  slotSize: number;
+  slotStride: number;
+  slotCount: number;
+}
+
+export interface UDPTxArenaStats {
+  slotSize: number;
+  slotCount: number;
+  writing: number; // acquired, not submitted yet
+  inFlight: number; // submitted, waiting for the send to complete
+  highWaterInFlight: number;
+  acquired: number;
+  exhausted: number; // acquire found every slot taken
+  submitted: number;
+  completed: number;
+}
+
+/**
+ * Priority class of a paced send. Classes are strict: 'bulk' only goes out
+ * when nothing 'high' or 'normal' is sendable.
+ */
+/**
+ * Poll mode geometry. Entries hold at most `maxPayload` bytes; longer
+ * datagrams are truncated and flagged.
+ */
+export interface UDPPollOptions {
+  capacity?: number; // entries, rounded up to a power of two; default 1024
+  maxPayload?: number; // default 1472
+  maxAddresses?: number; // sender hosts interned at once; default 1024
+}
+
+export interface UDPPollRingInfo {
+  buffer: ArrayBuffer;
+  capacity: number;
+  entryStride: number;
+  maxPayload: number;
+  controlSize: number;
+  headerSize: number;
+}
+
+export interface UDPPollStats {
+  capacity: number;
+  maxPayload: number;
+  ready: number; // written, not yet released by poll()
+  written: number;
+  overruns: number; // dropped because every entry was unread
+  truncated: number;
+  addresses: number;
+  addressEvictions: number; // address indices reassigned to a new host
+  addressOverflow: number; // entries written without an address index
+}
+
+/**
+ * Uint32 word offsets into the poll ring's control block
+ */
+export const UDPPollControl = {
+  magic: 0,
+  capacity: 1,
+  entryStride: 2,
+  maxPayload: 3,
+  head: 4,
+  tail: 5,
+  overruns: 6,
+  addressEpoch: 7,
+} as const;
+
+export type UDPSendPriority = 'high' | 'normal' | 'bulk';
+
+/**
+ * Token bucket limits for paced sends. 0 or omitted means unlimited. Bursts
+ * default to 20 ms worth of the rate.
+ */
+export interface UDPRateLimit {
+  bytesPerSecond?: number;
+  packetsPerSecond?: number;
+  burstBytes?: number;
+  burstPackets?: number;
+}
+
+export interface UDPSendRate extends UDPRateLimit {
+  // Applied to each destination separately, on top of the socket-wide limit
+  perDestination?: UDPRateLimit;
+}
+
+export interface UDPSchedulerStats {
+  queuedPackets: number;
+  queuedBytes: number;
+  highWaterPackets: number;
+  enqueued: number;
+  dispatched: number;
+  shaped: number; // held back by a token bucket before going out
+  rejected: number; // queue full
+  discarded: number; // still queued when their socket closed
+  latencyP50Us: number; // sendPaced -> handed to the socket
+  latencyP99Us: number;
+  latencyMaxUs: number;
+}
+
+/**
+ * What native code does when JS falls behind and the receive ring is full.
+ * 'block' waits up to blockTimeoutUs (default 2000) before dropping.
+ */
+export type UDPBackpressurePolicy = 'dropOldest' | 'dropNewest' | 'block';
+
+/**
+ * What the receive pool does once its preallocated slots are used up. 'heap'
+ * allocates extra slots, still capped by the memory budget.
+ */
+export type UDPPoolOverflowPolicy = 'drop' | 'heap';
+
 export interface UDPSocketOptions {
   type?: 'udp4' | 'udp6';
   reuseAddr?: boolean;
+  // SO_REUSEPORT: several sockets bound to one port, each on its own receive queue
+  reusePort?: boolean;
   broadcast?: boolean;
+  // Read datagrams in batches (recvmmsg on Linux) straight into the receive pool
+  batchReceive?: boolean;
+  // Kernel receive timestamps on onMessage, and 'sent' events; implies batchReceive
+  timestamps?: boolean;
+  // Largest datagram batch receive expects; larger ones are dropped (default 1500)
+  maxDatagramSize?: number;
+  // Native receive queue index (modulo the queue count); default is the least loaded queue
+  receiveQueue?: number;
 }
 
+/**
+ * One datagram of a sendBatch call, as a slice of the shared buffer, sent
+ * either to a resolved endpoint or to port/address.
+ */
+export type UDPBatchPacket =
+  | { offset: number; length: number; endpoint: UDPEndpointHandle }
+  | { offset: number; length: number; port: number; address: string };
+
+/**
+ * What a packet filter does with a datagram. 'route' hands it to
+ * `routes[route]` of the socket's event handlers instead of onMessage.
+ */
+export type UDPFilterAction = 'drop' | 'deliver' | 'route';
+
+interface UDPFilterRuleBase {
+  action: UDPFilterAction;
+  route?: number;
+  // Apply the action when the condition does NOT hold
+  invert?: boolean;
+}
+
+/**
+ * One packet filter rule. Rules are tried in order and the first match
+ * decides.
+ *
+ * - magic: `bytes` found at `offset`
+ * - source: sender matches an entry; a missing address or port matches any
+ * - selfEcho: sender is one of our interface addresses at this socket's port
+ * - length: min <= length <= max
+ * - duplicate: the same sender sent the same `width` (1..8) bytes at `offset`
+ *   within `windowMs` (default 1000) of the first sighting
+ */
+export type UDPFilterRule = UDPFilterRuleBase & (
+  | { match: 'magic'; offset?: number; bytes: number[] | ArrayBuffer }
+  | { match: 'source'; sources: Array<{ address?: string; port?: number }> }
+  | { match: 'selfEcho' }
+  | { match: 'length'; min?: number; max?: number }
+  | { match: 'duplicate'; offset?: number; width?: number; windowMs?: number }
+);
+
+export interface UDPPacketFilter {
+  rules: UDPFilterRule[];
+  // Applied to datagrams no rule matched (default 'deliver')
+  defaultAction?: UDPFilterAction;
+  defaultRoute?: number;
+}
+
+export interface UDPFilterStats {
+  hits: number[]; // per rule, in rule order
+  defaultHits: number;
+}
+
+/**
+ * A checksum trailer over each datagram, covering `offset` up to the trailer:
+ * 4 bytes for CRC32C, 8 for xxHash64. Received datagrams are verified after
+ * the packet filter; stampChecksum appends the same trailer before a send.
+ */
+export interface UDPChecksumOptions {
+  kind?: 'crc32c' | 'xxh64'; // default 'crc32c'
+  offset?: number;
+  byteOrder?: 'big' | 'little'; // trailer byte order, default 'big'
+  seed?: number; // xxh64 only
+  // Deliver verified datagrams without their trailer (default true)
+  strip?: boolean;
+  // Applied to datagrams that fail (default 'drop'); 'deliver' keeps the trailer
+  onFailure?: UDPFilterAction;
+  route?: number;
+}
+
+export interface UDPChecksumStats {
+  kernel: string; // CRC32C implementation in use, e.g. 'sse4.2', 'armv8-crc' or 'scalar'
+  verified: number;
+  failed: number;
+  tooShort: number; // also counted as failed
+  stamped: number;
+}
+
+/**
+ * Native fragmentation for messages larger than one datagram. Both ends must
+ * enable it; datagrams without a fragment header are still delivered as-is.
+ */
+export interface UDPAddressInfo {
+  address: string;
+  port: number;
+  family: 'IPv4' | 'IPv6';
+}
+
+/**
+ * Socket options applied together by configure(), in this order; the first
+ * failure rejects and names the option. Absent options are left alone.
+ */
+export interface UDPSocketConfig {
+  broadcast?: boolean;
+  ttl?: number;
+  multicastTTL?: number;
+  loopback?: boolean; // multicast loopback
+  // Interface for outgoing multicast and for joining `groups`: a name, index or address
+  multicastInterface?: string | number;
+  groups?: string[]; // multicast groups to join
+}
+
+export interface UDPInterface {
+  index: number;
+  name: string;
+  mtu: number; // 0 if unknown
+  up: boolean;
+  loopback: boolean;
+  multicast: boolean;
+  addresses: Array<{ address: string; family: 'IPv4' | 'IPv6' }>;
+}
+
+/**
+ * The cached interface table. `version` changes only when the interfaces do.
+ */
+export interface UDPInterfaceTable {
+  version: number;
+  interfaces: UDPInterface[];
+}
+
+export interface UDPCaptureOptions {
+  snapLength?: number; // payload bytes kept per datagram, 1-65535 (default 65535)
+  ringBytes?: number; // buffer between the sockets and the file writer, 64 KB-256 MB (default 4 MB)
+}
+
+export interface UDPCaptureStats {
+  active: boolean;
+  captured: number;
+  dropped: number; // lost because the writer fell a full ring behind
+  truncated: number; // cut to snapLength
+  bytesWritten: number;
+  writeErrors: number;
+  ringBytes: number;
+  ringHighWater: number;
+}
+
+export interface UDPReplayOptions {
+  speed?: number; // multiple of the recorded pace; 0 replays as fast as possible (default 1)
+  recordedSocketId?: number; // replay only what this socket received when recorded
+}
+
+export interface UDPReplayResult {
+  delivered: number;
+  skipped: number; // outbound, other sockets' and non-UDP packets
+  durationMs: number;
+}
+
+export interface UDPFramingOptions {
+  maxDatagramSize?: number; // largest fragment on the wire, 16 byte header included (default 1200)
+  maxMessageSize?: number; // larger incoming messages are dropped (default 1 MB)
+  maxPendingMessages?: number; // partial messages held at once (default 32)
+  maxPendingBytes?: number; // bytes held in partial messages (default 8 MB)
+  timeoutMs?: number; // partial messages are dropped this long after their first fragment (default 2000)
+}
+
+export interface UDPFramingStats {
+  messagesSent: number;
+  fragmentsSent: number;
+  fragmentsReceived: number;
+  duplicateFragments: number;
+  invalidFragments: number;
+  messagesReceived: number;
+  messagesTimedOut: number;
+  messagesEvicted: number; // pushed out by newer messages when the limits were reached
+  pendingMessages: number;
+  pendingBytes: number;
+}
+
+/**
+ * Received datagram. A native host object: each field is produced when it is
+ * read, so reading only `data` skips the address string entirely. Fields are
+ * read-only, and every read of `data` returns a new ArrayBuffer over the same
+ * bytes; keep the first one rather than comparing them.
+ */
 export interface UDPMessageEvent {
-  socketId: string;
+  socketId: UDPSocketHandle;
   data: ArrayBuffer; // Zero-copy ArrayBuffer
   base64Data?: string; // Optional base64 for backward compatibility
   address: string;
   port: number;
+  // Sockets created with `timestamps` only. Milliseconds on the _udpJSI.now()
+  // clock: when the kernel received the datagram and when native code read it.
+  kernelTime?: number;
+  receiveTime?: number;
+}
+
+/**
+ * A queued send handed to the kernel, for sockets created with `timestamps`.
+ * Times are milliseconds on the _udpJSI.now() clock. Sends that went out
+ * directly (udpSendDirect returned true) have no event.
+ */
+export interface UDPSentEvent {
+  socketId: UDPSocketHandle;
+  bytes: number;
+  queuedTime: number;
+  sentTime: number;
+}
+
+/**
+ * A burst of datagrams delivered in one call when batching is enabled.
+ *
+ * `index` holds 5 uint32 values per datagram: offset into `data`, length,
+ * sender port, index into `addresses`, and socket id. Read it with
+ * `new Uint32Array(event.index)`.
+ *
+ * Fields are built when first read. `datagrams` wraps each datagram where it
+ * was received, without a copy; `data` copies them into one buffer.
+ */
+export interface UDPMessageBatchEvent {
+  count: number;
+  data: ArrayBuffer;
+  index: ArrayBuffer;
+  addresses: string[];
+  datagrams: ArrayBuffer[];
+}
+
+export interface UDPBatchOptions {
+  maxBatch?: number; // flush after this many datagrams (default 64)
+  maxDelayUs?: number; // flush at most this long after the first datagram (default 1000)
 }
 
 export interface UDPErrorEvent {
-  socketId: string;
+  socketId: UDPSocketHandle;
   error: string;
 }
 
 export interface UDPCloseEvent {
-  socketId: string;
+  socketId: UDPSocketHandle;
   error?: string;
 }
 
@@ -57,11 +504,17 @@ export interface UDPCloseEvent {
  * High-performance UDP socket class using JSI bindings
  */
 export class UDPSocketJSI {
-  private socketId: string | null = null;
+  private socketId: UDPSocketHandle | null = null;
+  private peer: UDPEndpointHandle | null = null;
   private handlers: {
     onMessage?: (event: UDPMessageEvent) => void;
     onError?: (event: UDPErrorEvent) => void;
     onClose?: (event: UDPCloseEvent) => void;
+    onSent?: (event: UDPSentEvent) => void;
+    onMessageBatch?: (event: UDPMessageBatchEvent) => void;
+    maxBatch?: number;
+    maxDelayUs?: number;
+    routes?: Array<(event: UDPMessageEvent) => void>;
   } = {};
 
   /**
@@ -77,37 +530,100 @@ export class UDPSocketJSI {
       throw new Error('UDP JSI bindings not available. Make sure the native module is properly initialized.');
     }
 
-    this.socketId = _udpJSI.createSocket({
+    this.socketId = await _udpJSI.createSocket({
       type: options.type || 'udp4',
       reuseAddr: options.reuseAddr ?? false,
+      reusePort: options.reusePort ?? false,
       broadcast: options.broadcast ?? false,
+      batchReceive: options.batchReceive ?? false,
+      timestamps: options.timestamps ?? false,
+      maxDatagramSize: options.maxDatagramSize,
+      receiveQueue: options.receiveQueue,
     });
   }
 
   /**
-   * Bind the socket to a port and address
+   * Bind the socket to a port and address. Resolves with the bound address,
+   * which gives the port chosen when binding to port 0.
    */
-  async bind(port: number, address: string = '0.0.0.0'): Promise<void> {
+  async bind(port: number, address: string = '0.0.0.0'): Promise<UDPAddressInfo> {
     if (!this.socketId) {
       throw new Error('Socket not created');
     }
 
-    _udpJSI.bind(this.socketId, port, address);
+    const bound = await _udpJSI.bind(this.socketId, port, address);
     
     // Set up event handlers if any are registered
     if (Object.keys(this.handlers).length > 0) {
       this.updateEventHandlers();
     }
+    return bound;
+  }
+
+  /**
+   * Apply several socket options in one native call. The descriptors only
+   * exist once the socket is bound, so configure after bind().
+   */
+  async configure(config: UDPSocketConfig): Promise<void> {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    await _udpJSI.configure(this.socketId, config);
   }
 
   /**
-   * Send data using zero-copy transfer
+   * Local address of the socket, or null if it is not bound
    */
-  async send(data: Uint8Array | ArrayBuffer, port: number, address: string): Promise<void> {
+  async address(): Promise<UDPAddressInfo | null> {
     if (!this.socketId) {
       throw new Error('Socket not created');
     }
 
+    return _udpJSI.address(this.socketId);
+  }
+
+  /**
+   * Fix the peer for this socket. Afterwards send() takes no address and only
+   * datagrams from the peer are received.
+   */
+  async connect(port: number, address: string): Promise<void> {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    const endpoint = _udpJSI.resolve(address, port);
+    try {
+      await _udpJSI.connect(this.socketId, endpoint);
+    } catch (e) {
+      _udpJSI.releaseEndpoint(endpoint);
+      throw e;
+    }
+    if (this.peer !== null) {
+      _udpJSI.releaseEndpoint(this.peer);
+    }
+    this.peer = endpoint;
+  }
+
+  /**
+   * Send data using zero-copy transfer. Port and address are omitted on a
+   * connected socket.
+   */
+  async send(data: Uint8Array | ArrayBuffer, port?: number, address?: string): Promise<void> {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    const buffer = data instanceof ArrayBuffer ? data : (data.buffer as ArrayBuffer);
+    const offset = data instanceof ArrayBuffer ? 0 : data.byteOffset;
+    if (port === undefined || address === undefined) {
+      if (this.peer === null) {
+        throw new Error('Socket not connected; pass port and address');
+      }
+      _udpJSI.send(this.socketId, buffer, offset, data.byteLength);
+      return;
+    }
+
     if (data instanceof ArrayBuffer) {
       // Send entire ArrayBuffer
       udpSendDirect(this.socketId, data, 0, data.byteLength, port, address);
@@ -118,34 +634,234 @@ export class UDPSocketJSI {
     }
   }
 
+  /**
+   * Zero-copy send to an endpoint from `resolveEndpoint`. Returns true when
+   * the datagram went straight to the kernel, false when it was queued.
+   */
+  sendTo(data: Uint8Array | ArrayBuffer, endpoint: UDPEndpointHandle): boolean {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    if (data instanceof ArrayBuffer) {
+      return _udpJSI.sendTo(this.socketId, data, 0, data.byteLength, endpoint);
+    }
+    return _udpJSI.sendTo(this.socketId, data.buffer as ArrayBuffer, data.byteOffset, data.byteLength, endpoint);
+  }
+
+  /**
+   * Queue a datagram for paced sending under this socket's setSendRate
+   * limits. Returns false when the native send queue is full.
+   */
+  sendPaced(data: Uint8Array | ArrayBuffer, endpoint: UDPEndpointHandle, priority: UDPSendPriority = 'normal'): boolean {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    if (data instanceof ArrayBuffer) {
+      return _udpJSI.sendPaced(this.socketId, data, 0, data.byteLength, endpoint, priority);
+    }
+    return _udpJSI.sendPaced(this.socketId, data.buffer as ArrayBuffer, data.byteOffset, data.byteLength, endpoint, priority);
+  }
+
+  setSendRate(rate: UDPSendRate): void {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    _udpJSI.setSendRate(this.socketId, rate);
+  }
+
+  /**
+   * Send `length` bytes from a slot of `arena` without copying them. The slot
+   * goes back to the arena once the kernel has the bytes; do not write to it
+   * after submitting. Returns true if the datagram went out directly.
+   */
+  submitTx(arena: UDPTxArena, slot: number, length: number, endpoint: UDPEndpointHandle): boolean {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    return _udpJSI.submitTx(this.socketId, arena.handle, slot, length, endpoint);
+  }
+
+  /**
+   * Send several datagrams carved out of one buffer. Returns how many were
+   * handed to the kernel directly; the rest were copied and queued.
+   */
+  sendBatch(buffer: ArrayBuffer, packets: UDPBatchPacket[]): number {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    return _udpJSI.sendBatch(this.socketId, buffer, packets);
+  }
+
+  /**
+   * Counters and latency percentiles for this socket, indexed by UDPStatsField.
+   * Pass `out` to reuse an array when polling.
+   */
+  getStats(out?: Float64Array): Float64Array {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    return _udpJSI.getStats(this.socketId, out);
+  }
+
+  /**
+   * Classify received datagrams natively before they reach JS. Datagrams a
+   * rule routes go to `routes[route]`; pass null to remove the filter.
+   */
+  setFilter(filter: UDPPacketFilter | null, routes?: Array<(event: UDPMessageEvent) => void>): void {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    if (routes !== undefined) {
+      this.handlers.routes = routes;
+      this.updateEventHandlers();
+    }
+    _udpJSI.setFilter(this.socketId, filter);
+  }
+
+  getFilterStats(): UDPFilterStats | null {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    return _udpJSI.getFilterStats(this.socketId);
+  }
+
+  /**
+   * Verify a checksum trailer on every received datagram natively. Failures
+   * the options route go to `routes[route]`; pass null to stop verifying.
+   */
+  setChecksum(checksum: UDPChecksumOptions | null, routes?: Array<(event: UDPMessageEvent) => void>): void {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    if (routes !== undefined) {
+      this.handlers.routes = routes;
+      this.updateEventHandlers();
+    }
+    _udpJSI.setChecksum(this.socketId, checksum);
+  }
+
+  /**
+   * Append the checksum trailer after `length` bytes at `offset`, in place,
+   * e.g. in a TX arena slot. Returns the stamped length to send.
+   */
+  stampChecksum(buffer: ArrayBuffer, offset: number, length: number): number {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    return _udpJSI.stampChecksum(this.socketId, buffer, offset, length);
+  }
+
+  getChecksumStats(): UDPChecksumStats | null {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    return _udpJSI.getChecksumStats(this.socketId);
+  }
+
+  /**
+   * Split messages larger than one datagram natively, and reassemble them on
+   * receive into one 'message' event each. Pass null to turn framing off.
+   */
+  setFraming(framing: UDPFramingOptions | null): void {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    _udpJSI.setFraming(this.socketId, framing);
+  }
+
+  /**
+   * Send a message of any size up to 65535 fragments to an endpoint from
+   * `resolveEndpoint`. Needs setFraming. Returns true when every fragment
+   * went straight to the kernel, false when some were queued.
+   */
+  sendMessage(data: Uint8Array | ArrayBuffer, endpoint: UDPEndpointHandle): boolean {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    if (data instanceof ArrayBuffer) {
+      return _udpJSI.sendMessage(this.socketId, data, 0, data.byteLength, endpoint);
+    }
+    return _udpJSI.sendMessage(this.socketId, data.buffer as ArrayBuffer, data.byteOffset, data.byteLength, endpoint);
+  }
+
+  getFramingStats(): UDPFramingStats | null {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    return _udpJSI.getFramingStats(this.socketId);
+  }
+
+  /**
+   * Deliver the received datagrams of a pcapng or pcap file to this socket as
+   * if they had just arrived: filters, checksums, framing and handlers all
+   * run as usual. Resolves when the file is done or stopReplay is called.
+   */
+  async replay(path: string, options?: UDPReplayOptions): Promise<UDPReplayResult> {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    return _udpJSI.replay(this.socketId, path, options);
+  }
+
+  stopReplay(): void {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    _udpJSI.stopReplay(this.socketId);
+  }
+
+  /**
+   * Switch the socket to polling: received datagrams are written into a
+   * shared ring instead of raising 'message' events, and the caller reads
+   * them with ring.poll() from its own loop. Routed and reassembled
+   * datagrams still arrive as events.
+   */
+  enablePolling(options: UDPPollOptions = {}): UDPPollRing {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    const info = _udpJSI.setPollMode(this.socketId, options)!;
+    return new UDPPollRing(this.socketId, info);
+  }
+
+  disablePolling(): void {
+    if (!this.socketId) {
+      throw new Error('Socket not created');
+    }
+
+    _udpJSI.setPollMode(this.socketId, null);
+  }
+
   /**
    * Set event handlers
    */
   on(event: 'message', handler: (event: UDPMessageEvent) => void): void;
   on(event: 'error', handler: (event: UDPErrorEvent) => void): void;
   on(event: 'close', handler: (event: UDPCloseEvent) => void): void;
-  on(event: string, handler: any): void {
+  on(event: 'sent', handler: (event: UDPSentEvent) => void): void;
+  on(event: 'messageBatch', handler: (event: UDPMessageBatchEvent) => void, options?: UDPBatchOptions): void;
+  on(event: string, handler: any, options?: UDPBatchOptions): void {
     switch (event) {
       case 'message':
-        // Wrap the handler to add debugging
-        this.handlers.onMessage = (event) => {
-          // Debug logging for incoming packets
-          const data = new Uint8Array(event.data);
-          console.log(`[UDPSocketJSI] Incoming packet from ${event.address}:${event.port}, size: ${data.length} bytes`);
-          if (data.length > 0) {
-            console.log(`[UDPSocketJSI] First byte (service type): 0x${data[0].toString(16).padStart(2, '0')}`);
-            if (data[0] === 2) { // Credentials service
-              try {
-                // @ts-ignore
-                const json = new TextDecoder().decode(data.slice(1));
-                console.log('[UDPSocketJSI] Credential service payload:', json);
-              } catch (e) {
-                console.log('[UDPSocketJSI] Failed to decode credential payload');
-              }
-            }
-          }
-          handler(event);
-        };
+        // Passed through as-is: reading fields the handler does not need would defeat the lazy event
+        this.handlers.onMessage = handler;
         break;
       case 'error':
         this.handlers.onError = handler;
@@ -153,6 +869,15 @@ export class UDPSocketJSI {
       case 'close':
         this.handlers.onClose = handler;
         break;
+      case 'sent':
+        this.handlers.onSent = handler;
+        break;
+      case 'messageBatch':
+        // Takes precedence over 'message' for this socket on the native side
+        this.handlers.onMessageBatch = handler;
+        this.handlers.maxBatch = options?.maxBatch;
+        this.handlers.maxDelayUs = options?.maxDelayUs;
+        break;
       default:
         throw new Error(`Unknown event: ${event}`);
     }
@@ -173,6 +898,10 @@ export class UDPSocketJSI {
 
     _udpJSI.close(this.socketId);
     this.socketId = null;
+    if (this.peer !== null) {
+      _udpJSI.releaseEndpoint(this.peer);
+      this.peer = null;
+    }
     this.handlers = {};
   }
 
@@ -185,6 +914,195 @@ export class UDPSocketJSI {
   }
 }
 
+/**
+ * Native send buffer shared with JS. Acquire a slot, write the datagram into
+ * view(slot), then submit it with socket.submitTx(). Slots recycle
+ * themselves when their send completes, so steady-state sending allocates
+ * nothing.
+ *
+ * @example
+ * ```typescript
+ * const arena = new UDPTxArena(1200, 256);
+ * const slot = arena.acquire();
+ * if (slot >= 0) {
+ *   const length = encodeState(arena.view(slot));
+ *   socket.submitTx(arena, slot, length, endpoint);
+ * }
+ * ```
+ */
+export class UDPTxArena {
+  readonly handle: UDPTxArenaHandle;
+  readonly buffer: ArrayBuffer;
+  readonly slotSize: number;
+  readonly slotStride: number;
+  readonly slotCount: number;
+  private readonly views: Array<Uint8Array | undefined>;
+
+  constructor(slotSize: number, slotCount: number) {
+    const info = _udpJSI.createTxArena(slotSize, slotCount);
+    this.handle = info.arena;
+    this.buffer = info.buffer;
+    this.slotSize = info.slotSize;
+    this.slotStride = info.slotStride;
+    this.slotCount = info.slotCount;
+    this.views = new Array(info.slotCount);
+  }
+
+  /**
+   * Take a free slot, or -1 if every slot is being written or in flight
+   */
+  acquire(): number {
+    return _udpJSI.acquireTxSlot(this.handle);
+  }
+
+  /**
+   * The bytes of `slot`. Views are created once per slot and reused.
+   */
+  view(slot: number): Uint8Array {
+    let view = this.views[slot];
+    if (!view) {
+      view = new Uint8Array(this.buffer, slot * this.slotStride, this.slotSize);
+      this.views[slot] = view;
+    }
+    return view;
+  }
+
+  /**
+   * Give back an acquired slot without sending it
+   */
+  release(slot: number): boolean {
+    return _udpJSI.releaseTxSlot(this.handle, slot);
+  }
+
+  getStats(): UDPTxArenaStats {
+    return _udpJSI.getTxArenaStats(this.handle);
+  }
+
+  /**
+   * Forget the arena natively. Sends still in flight finish normally, and
+   * the memory is freed once `buffer` is collected too.
+   */
+  destroy(): void {
+    _udpJSI.destroyTxArena(this.handle);
+  }
+}
+
+/**
+ * Received datagrams of a polling socket, read in place. poll() returns how
+ * many entries are ready; entry i of that batch stays valid until the next
+ * poll(), which also hands its space back to the socket. If the ring fills
+ * up, new datagrams are dropped and show up as a gap in sequence().
+ *
+ * @example
+ * ```typescript
+ * const ring = socket.enablePolling({ capacity: 512 });
+ * function frame() {
+ *   const count = ring.poll();
+ *   for (let i = 0; i < count; i++) {
+ *     applyUpdate(ring.payload(i), ring.address(i), ring.port(i));
+ *   }
+ *   requestAnimationFrame(frame);
+ * }
+ * ```
+ */
+export class UDPPollRing {
+  readonly buffer: ArrayBuffer;
+  readonly capacity: number;
+  readonly entryStride: number;
+  readonly maxPayload: number;
+  private readonly controlSize: number;
+  private readonly headerSize: number;
+  private readonly control: Uint32Array;
+  private readonly entries: DataView;
+  private readonly addresses: Array<string | null> = [];
+  private addressEpoch = 0;
+  private first = 0;
+
+  constructor(private readonly socketId: UDPSocketHandle, info: UDPPollRingInfo) {
+    this.buffer = info.buffer;
+    this.capacity = info.capacity;
+    this.entryStride = info.entryStride;
+    this.maxPayload = info.maxPayload;
+    this.controlSize = info.controlSize;
+    this.headerSize = info.headerSize;
+    this.control = new Uint32Array(info.buffer, 0, info.controlSize / 4);
+    this.entries = new DataView(info.buffer);
+  }
+
+  /**
+   * Release the previous batch and return the number of entries ready now
+   */
+  poll(): number {
+    const count = _udpJSI.poll(this.socketId);
+    this.first = this.control[UDPPollControl.tail];
+    // An index may now name a different host
+    const epoch = this.control[UDPPollControl.addressEpoch];
+    if (epoch !== this.addressEpoch) {
+      this.addressEpoch = epoch;
+      this.addresses.length = 0;
+    }
+    return count;
+  }
+
+  /**
+   * Byte offset of entry i's header in `buffer`; the payload follows it
+   */
+  offset(i: number): number {
+    return this.controlSize + ((this.first + i) & (this.capacity - 1)) * this.entryStride;
+  }
+
+  length(i: number): number {
+    return this.entries.getUint32(this.offset(i), true);
+  }
+
+  port(i: number): number {
+    return this.entries.getUint16(this.offset(i) + 4, true);
+  }
+
+  truncated(i: number): boolean {
+    return (this.entries.getUint16(this.offset(i) + 6, true) & 1) !== 0;
+  }
+
+  /**
+   * Arrival number. Dropped datagrams also take one, so a jump means overrun.
+   */
+  sequence(i: number): number {
+    return this.entries.getUint32(this.offset(i) + 12, true);
+  }
+
+  /**
+   * View of entry i's payload; valid until the next poll()
+   */
+  payload(i: number): Uint8Array {
+    const offset = this.offset(i);
+    return new Uint8Array(this.buffer, offset + this.headerSize, this.entries.getUint32(offset, true));
+  }
+
+  /**
+   * Sender host, looked up natively once per distinct host and cached
+   */
+  address(i: number): string | null {
+    const index = this.entries.getUint32(this.offset(i) + 8, true);
+    if (index === 0xffffffff) {
+      return null;
+    }
+    let address = this.addresses[index];
+    if (address === undefined) {
+      address = _udpJSI.pollAddress(this.socketId, index);
+      this.addresses[index] = address;
+    }
+    return address;
+  }
+
+  get overruns(): number {
+    return this.control[UDPPollControl.overruns];
+  }
+
+  getStats(): UDPPollStats {
+    return _udpJSI.getPollStats(this.socketId);
+  }
+}
+
 /**
  * Utility function to check if JSI bindings are available
  */
@@ -192,6 +1110,61 @@ export function isJSIAvailable(): boolean {
   return typeof udpSendDirect !== 'undefined' && typeof _udpJSI !== 'undefined';
 }
 
+/**
+ * Resolve a destination once for repeated sendTo/sendBatch calls. Hostnames
+ * are looked up synchronously. Release with `releaseEndpoint` when done.
+ */
+export function resolveEndpoint(address: string, port: number): UDPEndpointHandle {
+  return _udpJSI.resolve(address, port);
+}
+
+export function releaseEndpoint(endpoint: UDPEndpointHandle): boolean {
+  return _udpJSI.releaseEndpoint(endpoint);
+}
+
+/**
+ * The network interfaces, from a native table that is re-read only when the
+ * system reports a change. With `sinceVersion`, returns null while the table
+ * is still at that version.
+ */
+export function getNetworkInterfaces(sinceVersion?: number): UDPInterfaceTable | null {
+  return _udpJSI.getInterfaces(sinceVersion);
+}
+
+/**
+ * Re-read the interfaces now instead of waiting for a change notification.
+ */
+export function refreshNetworkInterfaces(): UDPInterfaceTable {
+  return _udpJSI.refreshInterfaces();
+}
+
+/**
+ * Called with the new table version whenever the interfaces change; pass
+ * null to stop.
+ */
+export function onNetworkInterfacesChanged(handler: ((event: { version: number }) => void) | null): void {
+  _udpJSI.setInterfaceChangeHandler(handler);
+}
+
+/**
+ * Record every datagram the sockets receive or send to a pcapng file, one
+ * interface per socket. Throws if a capture is already running.
+ */
+export function startCapture(path: string, options?: UDPCaptureOptions): void {
+  _udpJSI.startCapture(path, options);
+}
+
+/**
+ * Stop recording; resolves once everything buffered is in the file.
+ */
+export function stopCapture(): Promise<UDPCaptureStats> {
+  return _udpJSI.stopCapture();
+}
+
+export function getCaptureStats(): UDPCaptureStats {
+  return _udpJSI.getCaptureStats();
+}
+
 /**
  * Create a UDP socket using JSI bindings
  * 
@@ -0,0 +1,156 @@
+#include "UDPTest.h"
+
+#include "UDPBufferPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace udpdirect;
+
+namespace {
+
+UDPBufferPool::Config smallPool(UDPPoolOverflowPolicy overflow) {
+    UDPBufferPool::Config config;
+    config.slotCounts[0] = 4;
+    config.slotCounts[1] = 0;
+    config.slotCounts[2] = 0;
+    config.overflow = overflow;
+    return config;
+}
+
+uint32_t slabSlotsInUse(const UDPBufferPool& pool) {
+    UDPBufferPoolClassStats stats[UDPBufferPool::kSizeClassCount];
+    pool.getStats(stats);
+    uint32_t inUse = 0;
+    for (const UDPBufferPoolClassStats& sizeClass : stats) {
+        inUse += sizeClass.inUse;
+    }
+    return inUse;
+}
+
+} // namespace
+
+UDP_TEST(heapOverflowGetsDefaultHeadroom) {
+    UDPBufferPool pool(smallPool(UDPPoolOverflowPolicy::Heap));
+    UDP_CHECK_EQ(pool.budgetStats().budgetBytes, pool.defaultBudget(UDPPoolOverflowPolicy::Heap));
+    UDP_CHECK(pool.budgetStats().budgetBytes > pool.slabBytes());
+
+    std::vector<UDPBufferSlot> slots;
+    for (int i = 0; i < 5; i++) {
+        slots.push_back(pool.acquire(1000));
+        UDP_CHECK(slots.back());
+    }
+    UDP_CHECK_EQ(pool.budgetStats().heapInUse, 1u);
+    for (const UDPBufferSlot& slot : slots) {
+        pool.release(slot);
+    }
+    UDP_CHECK_EQ(pool.budgetStats().inUseBytes, 0u);
+}
+
+UDP_TEST(explicitBudgetStaysExplicit) {
+    UDPBufferPool pool(smallPool(UDPPoolOverflowPolicy::Drop));
+    UDP_CHECK_EQ(pool.budgetStats().budgetBytes, pool.slabBytes());
+    UDP_CHECK(pool.budgetStats().defaultBudget);
+
+    // A slab-sized budget leaves Heap nothing to allocate
+    pool.setBudget(pool.slabBytes(), UDPPoolOverflowPolicy::Heap);
+    UDP_CHECK(!pool.budgetStats().defaultBudget);
+    std::vector<UDPBufferSlot> slots;
+    for (int i = 0; i < 4; i++) {
+        slots.push_back(pool.acquire(1000));
+    }
+    UDP_CHECK(!pool.acquire(1000));
+    UDP_CHECK_EQ(pool.budgetStats().overBudget, 1u);
+    for (const UDPBufferSlot& slot : slots) {
+        pool.release(slot);
+    }
+}
+
+// Receive-queue-like acquirers on several threads, each holding a window of slots and handing
+// some to a second reference, as ArrayBuffers do, under Heap overflow: nothing may leak and
+// the budget must hold throughout. A sampler reads budgetStats() while they run, so drift
+// shows up as growth during the soak and not only in the totals at the end.
+UDP_TEST(heapOverflowSoakReturnsEveryByte) {
+    UDPBufferPool::Config config;
+    config.slotCounts[0] = 64;
+    config.slotCounts[1] = 8;
+    config.slotCounts[2] = 2;
+    config.overflow = UDPPoolOverflowPolicy::Heap;
+    UDPBufferPool pool(config);
+    const uint64_t budget = pool.budgetStats().budgetBytes;
+
+    const int kThreads = 4;
+    const size_t kWindow = 32;
+    const uint64_t perThread = test::scaled(10000000) / kThreads;
+    std::atomic<bool> running{true};
+    uint64_t samples = 0;
+    uint64_t maxInUseBytes = 0;
+    uint32_t maxHeapInUse = 0;
+    std::thread sampler([&] {
+        while (running.load(std::memory_order_acquire)) {
+            UDPBufferPoolBudgetStats sample = pool.budgetStats();
+            maxInUseBytes = std::max(maxInUseBytes, sample.inUseBytes);
+            maxHeapInUse = std::max(maxHeapInUse, sample.heapInUse);
+            samples++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    std::vector<std::thread> threads;
+    std::vector<uint64_t> acquired(kThreads, 0);
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&, t] {
+            std::mt19937 random(t + 1);
+            std::uniform_int_distribution<uint32_t> length(1, 9000);
+            std::vector<UDPBufferSlot> window(kWindow);
+            for (uint64_t i = 0; i < perThread; i++) {
+                UDPBufferSlot& held = window[i % kWindow];
+                if (held) {
+                    pool.release(held);
+                    held = UDPBufferSlot();
+                }
+                held = pool.acquire(length(random));
+                if (!held) {
+                    continue;
+                }
+                acquired[t]++;
+                held.data[0] = (uint8_t)i;
+                held.data[held.length - 1] = (uint8_t)i;
+                if (i % 7 == 0) {
+                    pool.retain(held);
+                    pool.release(held);
+                }
+            }
+            for (const UDPBufferSlot& held : window) {
+                if (held) {
+                    pool.release(held);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    running.store(false, std::memory_order_release);
+    sampler.join();
+
+    // At most one slot per window entry is ever out, whichever way it was allocated
+    UDP_CHECK(samples > 0);
+    UDP_CHECK(maxInUseBytes <= budget);
+    UDP_CHECK(maxHeapInUse <= (uint32_t)(kThreads * kWindow));
+
+    UDPBufferPoolBudgetStats stats = pool.budgetStats();
+    UDP_CHECK_EQ(stats.inUseBytes, 0u);
+    UDP_CHECK_EQ(stats.heapInUse, 0u);
+    UDP_CHECK_EQ(slabSlotsInUse(pool), 0u);
+    UDP_CHECK(stats.highWaterBytes <= budget);
+    UDP_CHECK(stats.heapAcquired > 0);
+    uint64_t total = 0;
+    for (uint64_t count : acquired) {
+        total += count;
+    }
+    UDP_CHECK(total > perThread);
+}
@@ -0,0 +1,390 @@
+#include "UDPTest.h"
+
+#include "UDPCapture.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Captures go through real files in TMPDIR; the classic pcap cases are built byte by byte, as
+// another tool would have written them
+
+using namespace udpdirect;
+
+namespace {
+
+std::string tempPath(const char* name) {
+    const char* directory = getenv("TMPDIR");
+    return std::string(directory && *directory ? directory : "/tmp") + "/udp_capture_test_" +
+           std::to_string(getpid()) + "_" + name;
+}
+
+std::vector<uint8_t> readFile(const std::string& path) {
+    std::vector<uint8_t> bytes;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return bytes;
+    }
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + read);
+    }
+    fclose(file);
+    return bytes;
+}
+
+void writeFile(const std::string& path, const std::vector<uint8_t>& bytes) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file) {
+        fwrite(bytes.data(), 1, bytes.size(), file);
+        fclose(file);
+    }
+}
+
+UDPSocketAddress address(const char* host, uint16_t port) {
+    UDPSocketAddress out;
+    UDPSocketAddress::fromNumericHost(host, port, out);
+    return out;
+}
+
+std::vector<uint8_t> payload(size_t length, uint8_t seed) {
+    std::vector<uint8_t> bytes(length);
+    for (size_t i = 0; i < length; i++) {
+        bytes[i] = (uint8_t)(seed + i * 7);
+    }
+    return bytes;
+}
+
+bool samePayload(const UDPCapturedDatagram& datagram, const uint8_t* expected, size_t length) {
+    return datagram.length == length && memcmp(datagram.payload, expected, length) == 0;
+}
+
+UDPCaptureConfig captureConfig() {
+    UDPCaptureConfig config;
+    config.ringBytes = UDPCapture::kMinRingBytes;
+    return config;
+}
+
+// A classic pcap file in big-endian byte order, which a little-endian reader has to swap
+struct BigEndianPcap {
+    std::vector<uint8_t> bytes;
+
+    void be16(uint16_t value) {
+        bytes.push_back((uint8_t)(value >> 8));
+        bytes.push_back((uint8_t)value);
+    }
+
+    void be32(uint32_t value) {
+        be16((uint16_t)(value >> 16));
+        be16((uint16_t)value);
+    }
+
+    explicit BigEndianPcap(uint32_t linkType) {
+        be32(0xA1B2C3D4);  // microsecond timestamps
+        be16(2);
+        be16(4);
+        be32(0);
+        be32(0);
+        be32(65535);
+        be32(linkType);
+    }
+
+    void packet(uint32_t seconds, uint32_t micros, const std::vector<uint8_t>& frame) {
+        be32(seconds);
+        be32(micros);
+        be32((uint32_t)frame.size());
+        be32((uint32_t)frame.size());
+        bytes.insert(bytes.end(), frame.begin(), frame.end());
+    }
+};
+
+void appendBE16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back((uint8_t)(value >> 8));
+    out.push_back((uint8_t)value);
+}
+
+// Ethernet, optionally 802.1Q-tagged, then IPv4 or IPv6 and UDP
+std::vector<uint8_t> ethernetFrame(bool vlan, const UDPSocketAddress& source, const UDPSocketAddress& destination,
+                                   const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> frame(12, 0x02);  // destination and source MAC
+    if (vlan) {
+        appendBE16(frame, 0x8100);
+        appendBE16(frame, 42);
+    }
+    size_t udpLength = 8 + data.size();
+    if (source.isIPv6()) {
+        appendBE16(frame, 0x86DD);
+        frame.insert(frame.end(), {0x60, 0, 0, 0});
+        appendBE16(frame, (uint16_t)udpLength);
+        frame.insert(frame.end(), {17, 64});
+        frame.insert(frame.end(), source.bytes, source.bytes + 16);
+        frame.insert(frame.end(), destination.bytes, destination.bytes + 16);
+    } else {
+        appendBE16(frame, 0x0800);
+        frame.insert(frame.end(), {0x45, 0});
+        appendBE16(frame, (uint16_t)(20 + udpLength));
+        frame.insert(frame.end(), {0, 0, 0x40, 0, 64, 17, 0, 0});
+        frame.insert(frame.end(), source.bytes, source.bytes + 4);
+        frame.insert(frame.end(), destination.bytes, destination.bytes + 4);
+    }
+    appendBE16(frame, source.port);
+    appendBE16(frame, destination.port);
+    appendBE16(frame, (uint16_t)udpLength);
+    appendBE16(frame, 0);
+    frame.insert(frame.end(), data.begin(), data.end());
+    return frame;
+}
+
+} // namespace
+
+// What record() writes reads back with the peer, the socket's local port, the direction and
+// the recorded spacing intact, for both address families
+UDP_TEST(recordedDatagramsReadBack) {
+    std::string path = tempPath("roundtrip.pcapng");
+    UDPSocketAddress peer4 = address("192.168.1.20", 4000);
+    UDPSocketAddress peer6 = address("2001:db8::1", 53);
+    std::vector<uint8_t> small = payload(5, 1);
+    std::vector<uint8_t> large = payload(1300, 2);
+
+    UDPCapture capture;
+    capture.noteSocket(1, 5000);
+    capture.noteSocket(2, 6000);
+    UDP_CHECK_EQ(capture.start(path, captureConfig()), std::string());
+    capture.record(UDPCaptureDirection::Inbound, 1, peer4, small.data(), small.size(), 1000000);
+    capture.record(UDPCaptureDirection::Outbound, 2, peer6, large.data(), large.size(), 1250000);
+    capture.stop();
+    UDPCaptureStats stats = capture.stats();
+    UDP_CHECK_EQ(stats.captured, 2u);
+    UDP_CHECK_EQ(stats.dropped, 0u);
+    UDP_CHECK_EQ(stats.truncated, 0u);
+    UDP_CHECK_EQ(stats.writeErrors, 0u);
+    UDP_CHECK_EQ(stats.bytesWritten, (uint64_t)readFile(path).size());
+
+    UDPCaptureReader reader;
+    UDP_CHECK_EQ(reader.open(path), std::string());
+    UDPCapturedDatagram inbound;
+    UDPCapturedDatagram outbound;
+    UDP_CHECK(reader.next(inbound));
+    UDP_CHECK(reader.next(outbound));
+    UDPCapturedDatagram extra;
+    UDP_CHECK(!reader.next(extra));
+    UDP_CHECK(!reader.malformed());
+    UDP_CHECK_EQ(reader.skipped(), 0u);
+
+    UDP_CHECK(inbound.direction == UDPCaptureDirection::Inbound);
+    UDP_CHECK_EQ(inbound.socketId, 1u);
+    UDP_CHECK(inbound.source == peer4);
+    UDP_CHECK_EQ(inbound.destination.port, 5000);
+    UDP_CHECK(samePayload(inbound, small.data(), small.size()));
+    UDP_CHECK(!inbound.truncated);
+
+    UDP_CHECK(outbound.direction == UDPCaptureDirection::Outbound);
+    UDP_CHECK_EQ(outbound.socketId, 2u);
+    UDP_CHECK(outbound.destination == peer6);
+    UDP_CHECK(outbound.source.isIPv6());
+    UDP_CHECK_EQ(outbound.source.port, 6000);
+    UDP_CHECK(samePayload(outbound, large.data(), large.size()));
+    UDP_CHECK_EQ(outbound.timestampNs - inbound.timestampNs, 250000u);
+    unlink(path.c_str());
+}
+
+UDP_TEST(snapLengthTruncatesPayload) {
+    std::string path = tempPath("snap.pcapng");
+    UDPCaptureConfig config = captureConfig();
+    config.snapLength = 100;
+    std::vector<uint8_t> data = payload(500, 3);
+
+    UDPCapture capture;
+    UDP_CHECK_EQ(capture.start(path, config), std::string());
+    capture.record(UDPCaptureDirection::Inbound, 1, address("10.0.0.1", 9), data.data(), data.size(), 1);
+    capture.record(UDPCaptureDirection::Inbound, 1, address("10.0.0.1", 9), data.data(), 60, 2);
+    capture.stop();
+    UDP_CHECK_EQ(capture.stats().captured, 2u);
+    UDP_CHECK_EQ(capture.stats().truncated, 1u);
+
+    UDPCaptureReader reader;
+    UDP_CHECK_EQ(reader.open(path), std::string());
+    UDPCapturedDatagram cut;
+    UDPCapturedDatagram whole;
+    UDP_CHECK(reader.next(cut));
+    UDP_CHECK(reader.next(whole));
+    UDP_CHECK(cut.truncated);
+    UDP_CHECK(samePayload(cut, data.data(), 100));
+    UDP_CHECK(!whole.truncated);
+    UDP_CHECK(samePayload(whole, data.data(), 60));
+    unlink(path.c_str());
+}
+
+// A record larger than the whole ring can never fit and is always dropped; a burst through the
+// smallest ring may drop some, but every datagram is either in the file or counted as dropped
+UDP_TEST(fullRingDropsAndCounts) {
+    std::string path = tempPath("ring.pcapng");
+    std::vector<uint8_t> huge = payload(65507, 4);
+    std::vector<uint8_t> data = payload(4000, 5);
+    const uint64_t kBurst = 200;
+
+    UDPCapture capture;
+    UDP_CHECK_EQ(capture.start(path, captureConfig()), std::string());
+    capture.record(UDPCaptureDirection::Inbound, 1, address("10.0.0.1", 9), huge.data(), huge.size(), 1);
+    UDP_CHECK_EQ(capture.stats().dropped, 1u);
+    UDP_CHECK_EQ(capture.stats().captured, 0u);
+    for (uint64_t i = 0; i < kBurst; i++) {
+        capture.record(UDPCaptureDirection::Inbound, 1, address("10.0.0.1", 9), data.data(), data.size(), 2 + i);
+    }
+    capture.stop();
+    UDPCaptureStats stats = capture.stats();
+    UDP_CHECK_EQ(stats.captured + stats.dropped, kBurst + 1);
+    UDP_CHECK(stats.ringHighWater <= UDPCapture::kMinRingBytes);
+
+    UDPCaptureReader reader;
+    UDP_CHECK_EQ(reader.open(path), std::string());
+    uint64_t read = 0;
+    UDPCapturedDatagram datagram;
+    while (reader.next(datagram)) {
+        UDP_CHECK(samePayload(datagram, data.data(), data.size()));
+        read++;
+    }
+    UDP_CHECK(!reader.malformed());
+    UDP_CHECK_EQ(read, stats.captured);
+    unlink(path.c_str());
+}
+
+// Big-endian classic pcap over Ethernet: a VLAN-tagged IPv4 datagram, an ARP frame that is
+// skipped, and an untagged IPv6 datagram
+UDP_TEST(byteSwappedPcapDecodesEthernetAndVlan) {
+    std::string path = tempPath("swapped.pcap");
+    UDPSocketAddress source4 = address("10.0.0.1", 1111);
+    UDPSocketAddress destination4 = address("10.0.0.2", 2222);
+    UDPSocketAddress source6 = address("fd00::1", 3333);
+    UDPSocketAddress destination6 = address("fd00::2", 4444);
+    std::vector<uint8_t> data4 = payload(32, 6);
+    std::vector<uint8_t> data6 = payload(700, 7);
+
+    BigEndianPcap pcap(1);
+    pcap.packet(100, 250, ethernetFrame(true, source4, destination4, data4));
+    std::vector<uint8_t> arp(12, 0x02);
+    appendBE16(arp, 0x0806);
+    arp.resize(42, 0);
+    pcap.packet(101, 0, arp);
+    pcap.packet(102, 999999, ethernetFrame(false, source6, destination6, data6));
+    writeFile(path, pcap.bytes);
+
+    UDPCaptureReader reader;
+    UDP_CHECK_EQ(reader.open(path), std::string());
+    UDPCapturedDatagram tagged;
+    UDPCapturedDatagram untagged;
+    UDP_CHECK(reader.next(tagged));
+    UDP_CHECK(reader.next(untagged));
+    UDPCapturedDatagram extra;
+    UDP_CHECK(!reader.next(extra));
+    UDP_CHECK(!reader.malformed());
+    UDP_CHECK_EQ(reader.skipped(), 1u);
+
+    UDP_CHECK_EQ(tagged.timestampNs, 100000250000ull);
+    UDP_CHECK(tagged.direction == UDPCaptureDirection::Unknown);
+    UDP_CHECK_EQ(tagged.socketId, 0u);
+    UDP_CHECK(tagged.source == source4);
+    UDP_CHECK(tagged.destination == destination4);
+    UDP_CHECK(samePayload(tagged, data4.data(), data4.size()));
+
+    UDP_CHECK_EQ(untagged.timestampNs, 102999999000ull);
+    UDP_CHECK(untagged.source == source6);
+    UDP_CHECK(untagged.destination == destination6);
+    UDP_CHECK(samePayload(untagged, data6.data(), data6.size()));
+    unlink(path.c_str());
+}
+
+// A file cut short, as one still being written is, yields what is whole and then reports it
+UDP_TEST(truncatedFileIsMalformed) {
+    std::string path = tempPath("truncated.pcapng");
+    std::vector<uint8_t> data = payload(200, 8);
+    UDPCapture capture;
+    UDP_CHECK_EQ(capture.start(path, captureConfig()), std::string());
+    capture.record(UDPCaptureDirection::Inbound, 1, address("10.0.0.1", 9), data.data(), data.size(), 1);
+    capture.record(UDPCaptureDirection::Inbound, 1, address("10.0.0.1", 9), data.data(), data.size(), 2);
+    capture.stop();
+    std::vector<uint8_t> bytes = readFile(path);
+    bytes.resize(bytes.size() - 10);
+    writeFile(path, bytes);
+
+    UDPCaptureReader pcapng;
+    UDP_CHECK_EQ(pcapng.open(path), std::string());
+    UDPCapturedDatagram datagram;
+    UDP_CHECK(pcapng.next(datagram));
+    UDP_CHECK(!pcapng.malformed());
+    UDP_CHECK(!pcapng.next(datagram));
+    UDP_CHECK(pcapng.malformed());
+
+    BigEndianPcap pcap(1);
+    std::vector<uint8_t> frame = ethernetFrame(false, address("10.0.0.1", 1), address("10.0.0.2", 2), data);
+    pcap.packet(1, 0, frame);
+    pcap.packet(2, 0, frame);
+    pcap.bytes.resize(pcap.bytes.size() - 1);
+    writeFile(path, pcap.bytes);
+
+    UDPCaptureReader classic;
+    UDP_CHECK_EQ(classic.open(path), std::string());
+    UDP_CHECK(classic.next(datagram));
+    UDP_CHECK(!classic.next(datagram));
+    UDP_CHECK(classic.malformed());
+    unlink(path.c_str());
+}
+
+// dueNs against a fake clock: the recorded spacing at speed 1, everything at once at speed 0,
+// and outbound or other sockets' datagrams never scheduled
+UDP_TEST(replaySchedulesInboundDatagrams) {
+    std::string path = tempPath("replay.pcapng");
+    std::vector<uint8_t> data = payload(64, 9);
+    UDPSocketAddress peer = address("10.0.0.1", 9);
+    UDPCapture capture;
+    UDP_CHECK_EQ(capture.start(path, captureConfig()), std::string());
+    capture.record(UDPCaptureDirection::Inbound, 1, peer, data.data(), data.size(), 1000000);
+    capture.record(UDPCaptureDirection::Outbound, 1, peer, data.data(), data.size(), 1500000);
+    capture.record(UDPCaptureDirection::Inbound, 1, peer, data.data(), data.size(), 3000000);
+    capture.record(UDPCaptureDirection::Inbound, 2, peer, data.data(), data.size(), 4000000);
+    capture.stop();
+
+    auto openReplay = [&](double speed, uint32_t socketId) {
+        auto reader = std::make_unique<UDPCaptureReader>();
+        UDP_CHECK_EQ(reader->open(path), std::string());
+        UDPCaptureReplay::Options options;
+        options.speed = speed;
+        options.socketId = socketId;
+        return UDPCaptureReplay(std::move(reader), options);
+    };
+
+    // The first dueNs fixes the start; later ones ignore the clock they are given
+    const uint64_t kStartNs = 500;
+    UDPCaptureReplay realTime = openReplay(1.0, 0);
+    std::vector<uint64_t> due;
+    for (uint64_t nowNs = kStartNs; realTime.peek(); nowNs += 7) {
+        due.push_back(realTime.dueNs(nowNs));
+        realTime.pop();
+    }
+    UDP_CHECK_EQ(due.size(), 3u);
+    if (due.size() == 3) {
+        UDP_CHECK_EQ(due[0], kStartNs);
+        UDP_CHECK_EQ(due[1], kStartNs + 2000000);
+        UDP_CHECK_EQ(due[2], kStartNs + 3000000);
+    }
+    UDP_CHECK_EQ(realTime.delivered(), 3u);
+    UDP_CHECK_EQ(realTime.skipped(), 1u);
+    UDP_CHECK(!realTime.malformed());
+
+    UDPCaptureReplay asFastAsTaken = openReplay(0, 1);
+    uint64_t delivered = 0;
+    for (uint64_t nowNs = kStartNs; asFastAsTaken.peek(); nowNs += 1000000) {
+        UDP_CHECK_EQ(asFastAsTaken.dueNs(nowNs), kStartNs);
+        UDP_CHECK(samePayload(*asFastAsTaken.peek(), data.data(), data.size()));
+        asFastAsTaken.pop();
+        delivered++;
+    }
+    UDP_CHECK_EQ(delivered, 2u);
+    UDP_CHECK_EQ(asFastAsTaken.skipped(), 2u);
+    unlink(path.c_str());
+}
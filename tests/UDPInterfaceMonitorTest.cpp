@@ -0,0 +1,197 @@
+#include "UDPTest.h"
+
+#include "UDPInterfaceMonitor.h"
+
+#include <atomic>
+#include <mutex>
+#include <net/if.h>
+#include <thread>
+#include <vector>
+
+// The monitor reads a fake source standing in for getifaddrs, so versions, failures and
+// invalidation can be driven exactly
+
+using namespace udpdirect;
+
+namespace {
+
+struct FakeSource {
+    std::mutex mutex;
+    std::vector<UDPInterface> interfaces;
+    bool fail = false;
+    int reads = 0;
+
+    UDPInterfaceSource source() {
+        return [this](std::vector<UDPInterface>& out) {
+            std::lock_guard<std::mutex> lock(mutex);
+            reads++;
+            if (fail) {
+                return false;
+            }
+            out = interfaces;
+            return true;
+        };
+    }
+};
+
+UDPSocketAddress address(const char* host, uint16_t port = 0) {
+    UDPSocketAddress out;
+    UDPSocketAddress::fromNumericHost(host, port, out);
+    return out;
+}
+
+UDPInterface interface(uint32_t index, const char* name, std::vector<UDPSocketAddress> addresses) {
+    UDPInterface out;
+    out.index = index;
+    out.name = name;
+    out.mtu = 1500;
+    out.flags = IFF_UP | IFF_RUNNING | IFF_MULTICAST;
+    out.addresses = std::move(addresses);
+    return out;
+}
+
+} // namespace
+
+UDP_TEST(readsOnceUntilInvalidated) {
+    FakeSource fake;
+    fake.interfaces = {interface(2, "en0", {address("192.168.1.10")})};
+    UDPInterfaceMonitor monitor(fake.source());
+    UDP_CHECK(monitor.isStale());
+
+    std::shared_ptr<const UDPInterfaceTable> first = monitor.table();
+    UDP_CHECK_EQ(first->version, 1u);
+    UDP_CHECK(monitor.table() == first);
+    UDP_CHECK(monitor.table() == first);
+    UDP_CHECK_EQ(fake.reads, 1);
+
+    monitor.invalidate();
+    UDP_CHECK(monitor.isStale());
+    monitor.table();
+    UDP_CHECK_EQ(fake.reads, 2);
+    UDP_CHECK(!monitor.isStale());
+}
+
+// Reads that differ only in order or ports describe the same system and publish nothing
+UDP_TEST(unchangedReadKeepsTheVersion) {
+    FakeSource fake;
+    fake.interfaces = {interface(3, "en1", {address("10.0.0.2")}),
+                       interface(2, "en0", {address("192.168.1.10"), address("fe80::1%2")})};
+    UDPInterfaceMonitor monitor(fake.source());
+    std::shared_ptr<const UDPInterfaceTable> first = monitor.table();
+    UDP_CHECK_EQ(first->interfaces[0].name, std::string("en0"));
+
+    fake.interfaces = {interface(2, "en0", {address("fe80::1%2", 5353), address("192.168.1.10", 80)}),
+                       interface(3, "en1", {address("10.0.0.2")})};
+    UDP_CHECK(!monitor.refresh());
+    UDP_CHECK(monitor.table() == first);
+
+    UDPInterfaceMonitorStats stats = monitor.stats();
+    UDP_CHECK_EQ(stats.version, 1u);
+    UDP_CHECK_EQ(stats.refreshes, 2u);
+    UDP_CHECK_EQ(stats.changes, 1u);
+}
+
+// A change publishes a new snapshot; callers holding the old one keep it intact
+UDP_TEST(changePublishesANewVersion) {
+    FakeSource fake;
+    fake.interfaces = {interface(2, "en0", {address("192.168.1.10")})};
+    UDPInterfaceMonitor monitor(fake.source());
+    std::shared_ptr<const UDPInterfaceTable> before = monitor.table();
+
+    fake.interfaces[0].addresses = {address("192.168.1.20")};
+    monitor.invalidate();
+    std::shared_ptr<const UDPInterfaceTable> after = monitor.table();
+    UDP_CHECK_EQ(after->version, 2u);
+    UDP_CHECK(after->byAddress(address("192.168.1.20")) != nullptr);
+    UDP_CHECK(after->byAddress(address("192.168.1.10")) == nullptr);
+    UDP_CHECK(before->byAddress(address("192.168.1.10")) != nullptr);
+
+    fake.interfaces[0].mtu = 9000;
+    UDP_CHECK(monitor.refresh());
+    UDP_CHECK_EQ(monitor.table()->interfaces[0].mtu, 9000u);
+    UDP_CHECK_EQ(monitor.stats().changes, 3u);
+    UDP_CHECK_EQ(monitor.stats().notifications, 1u);
+}
+
+UDP_TEST(failedReadKeepsTheTable) {
+    FakeSource fake;
+    fake.interfaces = {interface(2, "en0", {address("192.168.1.10")})};
+    UDPInterfaceMonitor monitor(fake.source());
+    std::shared_ptr<const UDPInterfaceTable> first = monitor.table();
+
+    fake.fail = true;
+    UDP_CHECK(!monitor.refresh());
+    UDP_CHECK(monitor.table() == first);
+    UDP_CHECK_EQ(monitor.stats().failures, 1u);
+
+    // Before any successful read the table is empty, at version 0
+    UDPInterfaceMonitor failing(fake.source());
+    UDP_CHECK_EQ(failing.table()->version, 0u);
+    UDP_CHECK(failing.table()->interfaces.empty());
+}
+
+UDP_TEST(findAcceptsNameIndexOrAddress) {
+    FakeSource fake;
+    fake.interfaces = {interface(1, "lo0", {address("127.0.0.1"), address("::1")}),
+                       interface(4, "en0", {address("192.168.1.10"), address("fe80::aa%4")})};
+    fake.interfaces[0].flags |= IFF_LOOPBACK;
+    UDPInterfaceMonitor monitor(fake.source());
+    std::shared_ptr<const UDPInterfaceTable> table = monitor.table();
+
+    UDP_CHECK(table->find("en0") == table->byIndex(4));
+    UDP_CHECK(table->find("4") == table->byIndex(4));
+    UDP_CHECK(table->find("192.168.1.10") == table->byIndex(4));
+    // Link-local addresses match without their scope id
+    UDP_CHECK(table->find("fe80::aa") == table->byIndex(4));
+    UDP_CHECK(table->find("7") == nullptr);
+    UDP_CHECK(table->find("") == nullptr);
+    UDP_CHECK(table->find("10.9.9.9") == nullptr);
+    UDP_CHECK(table->byIndex(1)->isLoopback());
+    UDP_CHECK(table->byIndex(4)->isUp());
+    UDP_CHECK_EQ(table->byIndex(4)->firstAddress(AF_INET).hostString(), std::string("192.168.1.10"));
+}
+
+// Notifications arrive on one queue while others read; versions only move forward and
+// every read sees a complete snapshot
+UDP_TEST(concurrentInvalidateAndRead) {
+    FakeSource fake;
+    fake.interfaces = {interface(2, "en0", {address("192.168.1.10")})};
+    UDPInterfaceMonitor monitor(fake.source());
+    const uint64_t rounds = test::scaled(20000);
+    std::atomic<bool> done{false};
+
+    std::thread notifier([&] {
+        for (uint64_t i = 0; i < rounds; i++) {
+            {
+                std::lock_guard<std::mutex> lock(fake.mutex);
+                fake.interfaces[0].mtu = 1500 + (uint32_t)(i % 2);
+            }
+            monitor.invalidate();
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    std::atomic<bool> consistent{true};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; t++) {
+        readers.emplace_back([&] {
+            uint64_t last = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                std::shared_ptr<const UDPInterfaceTable> table = monitor.table();
+                if (table->version < last || table->interfaces.size() != 1) {
+                    consistent.store(false, std::memory_order_relaxed);
+                }
+                last = table->version;
+            }
+        });
+    }
+    notifier.join();
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    UDP_CHECK(consistent.load());
+    UDP_CHECK_EQ(monitor.table()->interfaces.size(), 1u);
+    UDP_CHECK(!monitor.isStale());
+    UDP_CHECK_EQ(monitor.stats().notifications, rounds);
+}
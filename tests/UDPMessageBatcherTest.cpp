@@ -0,0 +1,77 @@
+#include "UDPTest.h"
+
+#include "UDPMessageBatcher.h"
+
+#include <cstring>
+
+using namespace udpdirect;
+
+namespace {
+
+UDPSocketAddress address(const char* host, uint16_t port) {
+    UDPSocketAddress out;
+    UDPSocketAddress::fromNumericHost(host, port, out);
+    return out;
+}
+
+UDPBufferSlot received(UDPBufferPool& pool, uint8_t fill, size_t length) {
+    UDPBufferSlot slot = pool.acquire(length);
+    memset(slot.data, fill, length);
+    return slot;
+}
+
+uint32_t slotsInUse(const UDPBufferPool& pool) {
+    UDPBufferPoolClassStats stats[UDPBufferPool::kSizeClassCount];
+    pool.getStats(stats);
+    return stats[0].inUse;
+}
+
+} // namespace
+
+UDP_TEST(batchKeepsSlotsAndInternsHosts) {
+    auto pool = std::make_shared<UDPBufferPool>();
+    UDPMessageBatcher::Config config;
+    config.maxBatch = 3;
+    UDPMessageBatcher batcher(config, pool);
+
+    UDP_CHECK(batcher.append(7, received(*pool, 1, 10), address("10.0.0.1", 1000), 5) ==
+              UDPMessageBatcher::AppendResult::StartTimer);
+    UDP_CHECK(batcher.append(7, received(*pool, 2, 20), address("10.0.0.1", 1001)) ==
+              UDPMessageBatcher::AppendResult::Appended);
+    UDP_CHECK(batcher.append(7, received(*pool, 3, 30), address("10.0.0.2", 1000)) ==
+              UDPMessageBatcher::AppendResult::FlushNow);
+
+    std::shared_ptr<UDPMessageBatch> batch = batcher.take();
+    UDP_CHECK(batcher.empty());
+    UDP_CHECK_EQ(batch->count(), 3u);
+    UDP_CHECK_EQ(batch->firstReceivedNs, 5u);
+    UDP_CHECK_EQ(batch->payloadBytes, 60u);
+    // One source per host; ports stay per datagram
+    UDP_CHECK_EQ(batch->sources.size(), 2u);
+    UDP_CHECK_EQ(batch->index[1 * UDPMessageBatch::kIndexStride + 2], 1001u);
+    UDP_CHECK_EQ(batch->index[1 * UDPMessageBatch::kIndexStride + 3], 0u);
+    UDP_CHECK_EQ(batch->index[2 * UDPMessageBatch::kIndexStride + 3], 1u);
+    UDP_CHECK_EQ(slotsInUse(*pool), 3u);
+    UDP_CHECK_EQ(batch->datagram(1)[0], 2);
+
+    batch.reset();
+    UDP_CHECK_EQ(slotsInUse(*pool), 0u);
+}
+
+UDP_TEST(packCopiesToIndexOffsets) {
+    auto pool = std::make_shared<UDPBufferPool>();
+    UDPMessageBatcher batcher(UDPMessageBatcher::Config(), pool);
+    batcher.append(1, received(*pool, 0xAA, 4), address("10.0.0.1", 1));
+    batcher.append(1, received(*pool, 0xBB, 6), address("10.0.0.1", 1));
+
+    std::shared_ptr<UDPMessageBatch> batch = batcher.take();
+    batch->pack();
+    batch->releaseSlots();
+    UDP_CHECK_EQ(slotsInUse(*pool), 0u);
+    UDP_CHECK_EQ(batch->payload.size(), 10u);
+    UDP_CHECK_EQ(batch->index[UDPMessageBatch::kIndexStride], 4u);
+    // Reads fall back to the packed copy once the slots are gone
+    UDP_CHECK_EQ(batch->datagram(1), batch->payload.data() + 4);
+    UDP_CHECK_EQ(batch->datagram(1)[5], 0xBB);
+    UDP_CHECK_EQ(batch->datagram(0)[3], 0xAA);
+}
@@ -0,0 +1,182 @@
+#include "UDPTest.h"
+
+#include "UDPPacketRing.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Producer and consumer on separate threads, as the receive queue and the JS thread run them.
+// Build with -DUDP_DIRECT_SANITIZER=thread to have TSan check the ring's orderings too.
+
+using namespace udpdirect;
+
+namespace {
+
+const uint32_t kSocketId = 3;
+
+uint32_t slotsInUse(const UDPBufferPool& pool) {
+    UDPBufferPoolClassStats stats[UDPBufferPool::kSizeClassCount];
+    pool.getStats(stats);
+    uint32_t inUse = 0;
+    for (const UDPBufferPoolClassStats& sizeClass : stats) {
+        inUse += sizeClass.inUse;
+    }
+    return inUse;
+}
+
+// receivedNs carries a sequence number, so the consumer can check order
+UDPPacketDescriptor descriptorFor(UDPBufferPool& pool, uint64_t sequence) {
+    UDPPacketDescriptor descriptor;
+    descriptor.slot = pool.acquire(64);
+    descriptor.socketId = kSocketId;
+    descriptor.receivedNs = sequence;
+    return descriptor;
+}
+
+struct Consumed {
+    uint64_t count = 0;
+    uint64_t lastSequence = 0;
+    bool ordered = true;
+
+    void take(UDPBufferPool& pool, const UDPPacketDescriptor& descriptor) {
+        ordered = ordered && descriptor.receivedNs > lastSequence;
+        lastSequence = descriptor.receivedNs;
+        count++;
+        pool.release(descriptor.slot);
+    }
+};
+
+} // namespace
+
+// The producer evicts from the same cells the consumer pops: every descriptor must come out
+// exactly once, either popped or dropped, with its slot returned
+UDP_TEST(dropOldestConservesEveryDescriptor) {
+    auto pool = std::make_shared<UDPBufferPool>();
+    UDPPacketRing ring(pool, 64, UDPBackpressurePolicy::DropOldest);
+    const uint64_t packets = test::scaled(500000);
+
+    std::atomic<bool> producerDone{false};
+    Consumed consumed;
+    std::thread consumer([&] {
+        UDPPacketDescriptor descriptor;
+        for (;;) {
+            bool done = producerDone.load(std::memory_order_acquire);
+            bool any = false;
+            while (ring.pop(descriptor)) {
+                consumed.take(*pool, descriptor);
+                any = true;
+            }
+            if (done && !any) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+    });
+
+    uint64_t evictions = 0;
+    for (uint64_t i = 1; i <= packets; i++) {
+        UDPPacketDescriptor descriptor = descriptorFor(*pool, i);
+        UDP_CHECK(descriptor.slot);
+        if (ring.push(descriptor) == UDPPacketRing::PushResult::PushedAfterEviction) {
+            evictions++;
+        }
+    }
+    producerDone.store(true, std::memory_order_release);
+    consumer.join();
+
+    UDP_CHECK(consumed.ordered);
+    UDP_CHECK_EQ(consumed.count + ring.droppedTotal(), packets);
+    UDP_CHECK_EQ(ring.droppedTotal(), evictions);
+    UDP_CHECK_EQ(ring.droppedForSocket(kSocketId), ring.droppedTotal());
+    UDP_CHECK_EQ(ring.size(), 0u);
+    UDP_CHECK_EQ(slotsInUse(*pool), 0u);
+}
+
+// A drain is scheduled only when requestWake() says so; no pushed descriptor may be left
+// behind once every scheduled drain has run
+UDP_TEST(wakeProtocolNeverStrandsADescriptor) {
+    auto pool = std::make_shared<UDPBufferPool>();
+    UDPPacketRing ring(pool, 256, UDPBackpressurePolicy::DropNewest);
+    const uint64_t packets = test::scaled(500000);
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    uint64_t scheduled = 0;
+    bool producerDone = false;
+    Consumed consumed;
+    uint64_t drains = 0;
+
+    std::thread consumer([&] {
+        uint64_t handled = 0;
+        UDPPacketDescriptor descriptor;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return scheduled > handled || producerDone; });
+                if (scheduled == handled) {
+                    return;
+                }
+                handled = scheduled;
+            }
+            ring.beginDrain();
+            while (ring.pop(descriptor)) {
+                consumed.take(*pool, descriptor);
+            }
+            drains++;
+        }
+    });
+
+    for (uint64_t i = 1; i <= packets; i++) {
+        ring.push(descriptorFor(*pool, i));
+        if (ring.requestWake()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            scheduled++;
+            wake.notify_one();
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        producerDone = true;
+        wake.notify_one();
+    }
+    consumer.join();
+
+    UDP_CHECK(consumed.ordered);
+    UDP_CHECK_EQ(ring.size(), 0u);
+    UDP_CHECK_EQ(consumed.count + ring.droppedTotal(), packets);
+    UDP_CHECK(drains > 0);
+    UDP_CHECK_EQ(slotsInUse(*pool), 0u);
+}
+
+// Block waits for the consumer instead of dropping, as long as the consumer keeps up within
+// the timeout
+UDP_TEST(blockWaitsForTheConsumer) {
+    auto pool = std::make_shared<UDPBufferPool>();
+    UDPPacketRing ring(pool, 8, UDPBackpressurePolicy::Block);
+    ring.setBlockTimeoutUs(5 * 1000 * 1000);
+    const uint64_t packets = test::scaled(20000);
+
+    Consumed consumed;
+    std::thread consumer([&] {
+        UDPPacketDescriptor descriptor;
+        while (consumed.count < packets) {
+            if (ring.pop(descriptor)) {
+                consumed.take(*pool, descriptor);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (uint64_t i = 1; i <= packets; i++) {
+        UDP_CHECK(ring.push(descriptorFor(*pool, i)) == UDPPacketRing::PushResult::Pushed);
+    }
+    consumer.join();
+
+    UDP_CHECK(consumed.ordered);
+    UDP_CHECK_EQ(consumed.count, packets);
+    UDP_CHECK_EQ(ring.droppedTotal(), 0u);
+    UDP_CHECK_EQ(slotsInUse(*pool), 0u);
+}
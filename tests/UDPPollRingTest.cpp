@@ -0,0 +1,230 @@
+#include "UDPTest.h"
+
+#include "UDPPollRing.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+// Reads the buffer the way the JS side does: control words, then entries at Tail + i
+
+using namespace udpdirect;
+
+namespace {
+
+struct Entry {
+    uint32_t length = 0;
+    uint16_t port = 0;
+    uint16_t flags = 0;
+    uint32_t addressIndex = 0;
+    uint32_t sequence = 0;
+    const uint8_t* payload = nullptr;
+};
+
+uint32_t controlWord(const UDPPollRing& ring, UDPPollRing::ControlWord word) {
+    uint32_t value;
+    memcpy(&value, ring.data() + word * 4, 4);
+    return value;
+}
+
+Entry entryAt(const UDPPollRing& ring, uint32_t i) {
+    uint32_t position = controlWord(ring, UDPPollRing::Tail) + i;
+    const uint8_t* header =
+        ring.data() + UDPPollRing::kControlSize + (size_t)(position & (ring.capacity() - 1)) * ring.entryStride();
+    Entry entry;
+    memcpy(&entry.length, header, 4);
+    memcpy(&entry.port, header + 4, 2);
+    memcpy(&entry.flags, header + 6, 2);
+    memcpy(&entry.addressIndex, header + 8, 4);
+    memcpy(&entry.sequence, header + 12, 4);
+    entry.payload = header + UDPPollRing::kEntryHeaderSize;
+    return entry;
+}
+
+// As after a long uptime; only valid on a ring nothing has been written to
+void startCountersAt(UDPPollRing& ring, uint32_t position) {
+    auto* control = reinterpret_cast<std::atomic<uint32_t>*>(ring.data());
+    control[UDPPollRing::Head].store(position);
+    control[UDPPollRing::Tail].store(position);
+}
+
+UDPSocketAddress address(const char* host, uint16_t port) {
+    UDPSocketAddress out;
+    UDPSocketAddress::fromNumericHost(host, port, out);
+    return out;
+}
+
+bool writeValue(UDPPollRing& ring, uint32_t value, const UDPSocketAddress& source) {
+    return ring.write((const uint8_t*)&value, sizeof(value), source);
+}
+
+uint32_t payloadValue(const Entry& entry) {
+    uint32_t value;
+    memcpy(&value, entry.payload, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+// Entry positions wrap around the ring every `capacity` writes, and the free-running Head and
+// Tail counters wrap around 2^32
+UDP_TEST(countersAndEntriesWrapAround) {
+    UDPPollRing ring(8, 64);
+    startCountersAt(ring, UINT32_MAX - 20);
+    UDPSocketAddress source = address("10.0.0.1", 5000);
+
+    // Half the ring per round, since the batch being read still holds its entries
+    uint32_t next = 0;
+    uint32_t expected = 0;
+    for (int round = 0; round < 40; round++) {
+        for (int i = 0; i < 4; i++) {
+            UDP_CHECK(writeValue(ring, next++, source));
+        }
+        uint32_t ready = ring.poll();
+        UDP_CHECK_EQ(ready, 4u);
+        for (uint32_t i = 0; i < ready; i++) {
+            Entry entry = entryAt(ring, i);
+            UDP_CHECK_EQ(entry.length, 4u);
+            UDP_CHECK_EQ(entry.port, 5000);
+            UDP_CHECK_EQ(entry.sequence, expected);
+            UDP_CHECK_EQ(payloadValue(entry), expected);
+            expected++;
+        }
+    }
+    UDP_CHECK_EQ(ring.poll(), 0u);
+    UDP_CHECK_EQ(ring.stats().overruns, 0u);
+    UDP_CHECK(controlWord(ring, UDPPollRing::Head) < 1000);
+}
+
+// A full ring drops the incoming datagram and counts it; its sequence number is skipped
+UDP_TEST(overrunDropsAndLeavesASequenceGap) {
+    UDPPollRing ring(4, 64);
+    UDPSocketAddress source = address("10.0.0.1", 5000);
+    for (uint32_t i = 0; i < 4; i++) {
+        UDP_CHECK(writeValue(ring, i, source));
+    }
+    UDP_CHECK(!writeValue(ring, 4, source));
+    UDP_CHECK_EQ(controlWord(ring, UDPPollRing::Overruns), 1u);
+
+    // The batch handed out still holds its entries until the next poll
+    UDP_CHECK_EQ(ring.poll(), 4u);
+    UDP_CHECK(!writeValue(ring, 5, source));
+    UDP_CHECK_EQ(ring.poll(), 0u);
+    UDP_CHECK(writeValue(ring, 6, source));
+    UDP_CHECK_EQ(ring.poll(), 1u);
+    UDP_CHECK_EQ(entryAt(ring, 0).sequence, 6u);
+    UDP_CHECK_EQ(payloadValue(entryAt(ring, 0)), 6u);
+    UDP_CHECK_EQ(ring.stats().overruns, 2u);
+}
+
+UDP_TEST(oversizedDatagramsAreTruncated) {
+    UDPPollRing ring(4, 8);
+    uint8_t payload[20];
+    memset(payload, 7, sizeof(payload));
+    UDP_CHECK(ring.write(payload, sizeof(payload), address("10.0.0.1", 1)));
+    UDP_CHECK_EQ(ring.poll(), 1u);
+    Entry entry = entryAt(ring, 0);
+    UDP_CHECK_EQ(entry.length, 8u);
+    UDP_CHECK_EQ(entry.flags & UDPPollRing::kFlagTruncated, UDPPollRing::kFlagTruncated);
+    UDP_CHECK_EQ(ring.stats().truncated, 1u);
+}
+
+// Ports vary per datagram, so they stay in the entry and one host takes one index
+UDP_TEST(sendersAreInternedByHost) {
+    UDPPollRing ring(16, 64);
+    for (uint16_t port = 1000; port < 1010; port++) {
+        UDP_CHECK(writeValue(ring, port, address("10.0.0.1", port)));
+    }
+    UDP_CHECK(writeValue(ring, 0, address("10.0.0.2", 1000)));
+    UDP_CHECK_EQ(ring.poll(), 11u);
+    UDP_CHECK_EQ(entryAt(ring, 0).addressIndex, entryAt(ring, 9).addressIndex);
+    UDP_CHECK_EQ(entryAt(ring, 9).port, 1009);
+    UDP_CHECK(entryAt(ring, 10).addressIndex != entryAt(ring, 0).addressIndex);
+    UDP_CHECK_EQ(ring.stats().addresses, 2u);
+
+    UDPSocketAddress host;
+    UDP_CHECK(ring.address(entryAt(ring, 0).addressIndex, host));
+    UDP_CHECK_EQ(host.hostString(), std::string("10.0.0.1"));
+}
+
+// Past maxAddresses, indices whose entries JS has released go to new hosts and the epoch
+// changes; indices still in an unreleased entry are never reassigned
+UDP_TEST(fullAddressTableReusesReleasedIndices) {
+    UDPPollRing ring(16, 64, 2);
+    UDP_CHECK(writeValue(ring, 0, address("10.0.0.1", 1)));
+    UDP_CHECK(writeValue(ring, 1, address("10.0.0.2", 1)));
+    UDP_CHECK_EQ(ring.poll(), 2u);
+
+    // Both indices are in the batch JS holds
+    UDP_CHECK(writeValue(ring, 2, address("10.0.0.3", 1)));
+    UDP_CHECK_EQ(ring.stats().addressOverflow, 1u);
+    UDP_CHECK_EQ(controlWord(ring, UDPPollRing::AddressEpoch), 0u);
+
+    UDP_CHECK_EQ(ring.poll(), 1u);
+    UDP_CHECK_EQ(entryAt(ring, 0).addressIndex, UDPPollRing::kNoAddress);
+
+    // Released now; 10.0.0.2 keeps its index while 10.0.0.4 takes the other
+    UDP_CHECK(writeValue(ring, 3, address("10.0.0.2", 1)));
+    UDP_CHECK(writeValue(ring, 4, address("10.0.0.4", 1)));
+    UDP_CHECK_EQ(ring.poll(), 2u);
+    UDP_CHECK_EQ(entryAt(ring, 0).addressIndex, 1u);
+    UDP_CHECK_EQ(entryAt(ring, 1).addressIndex, 0u);
+    UDP_CHECK_EQ(controlWord(ring, UDPPollRing::AddressEpoch), 1u);
+    UDPSocketAddress host;
+    UDP_CHECK(ring.address(0, host));
+    UDP_CHECK_EQ(host.hostString(), std::string("10.0.0.4"));
+    UDP_CHECK_EQ(ring.stats().addressEvictions, 1u);
+    UDP_CHECK_EQ(ring.stats().addresses, 2u);
+}
+
+// Receive queue and JS thread at once, with more senders than the table holds: every entry
+// read must be intact, in sequence apart from overruns, and name the host that sent it
+UDP_TEST(concurrentProducerAndPoller) {
+    UDPPollRing ring(64, 64, 4);
+    const uint32_t packets = (uint32_t)test::scaled(300000);
+    std::atomic<bool> producerDone{false};
+
+    std::thread producer([&] {
+        char host[32];
+        for (uint32_t i = 0; i < packets; i++) {
+            snprintf(host, sizeof(host), "10.0.%u.%u", (i / 7) % 3, i % 7 + 1);
+            writeValue(ring, i, address(host, (uint16_t)i));
+        }
+        producerDone.store(true, std::memory_order_release);
+    });
+
+    uint64_t read = 0;
+    uint32_t lastSequence = 0;
+    bool ordered = true;
+    bool intact = true;
+    bool addressed = true;
+    for (;;) {
+        bool done = producerDone.load(std::memory_order_acquire);
+        uint32_t ready = ring.poll();
+        for (uint32_t i = 0; i < ready; i++) {
+            Entry entry = entryAt(ring, i);
+            ordered = ordered && (read == 0 || entry.sequence > lastSequence);
+            intact = intact && payloadValue(entry) == entry.sequence && entry.port == (uint16_t)entry.sequence;
+            UDPSocketAddress host;
+            if (entry.addressIndex != UDPPollRing::kNoAddress && ring.address(entry.addressIndex, host)) {
+                char expected[32];
+                snprintf(expected, sizeof(expected), "10.0.%u.%u", (entry.sequence / 7) % 3, entry.sequence % 7 + 1);
+                addressed = addressed && host.hostString() == expected;
+            }
+            lastSequence = entry.sequence;
+            read++;
+        }
+        if (done && ready == 0) {
+            break;
+        }
+    }
+    producer.join();
+
+    UDP_CHECK(ordered);
+    UDP_CHECK(intact);
+    UDP_CHECK(addressed);
+    UDPPollRingStats stats = ring.stats();
+    UDP_CHECK_EQ(read + stats.overruns, (uint64_t)packets);
+    UDP_CHECK_EQ(stats.written, read);
+}
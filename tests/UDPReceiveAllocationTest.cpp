@@ -0,0 +1,146 @@
+#include "UDPTest.h"
+
+#include "UDPBenchAlloc.h"
+#include "UDPBlockCache.h"
+#include "UDPReceiveDrain.h"
+#include "UDPReceivePipeline.h"
+
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+using namespace udpdirect;
+using udpdirect::bench::allocationSnapshot;
+
+namespace {
+
+const uint32_t kSocketId = 1;
+const size_t kEventBlockSize = 192;  // as UDPDirectJSI
+
+// The two objects UDPDirectJSI makes per datagram: the slot's buffer and the event holding it
+struct SlotBuffer {
+    SlotBuffer(std::shared_ptr<UDPBufferPool> pool, UDPBufferSlot slot) : pool(std::move(pool)), slot(slot) {}
+    ~SlotBuffer() { pool->release(slot); }
+
+    std::shared_ptr<UDPBufferPool> pool;
+    UDPBufferSlot slot;
+};
+
+struct Event {
+    Event(uint32_t socketId, std::shared_ptr<SlotBuffer> data, const UDPSocketAddress& source)
+        : socketId(socketId), data(std::move(data)), source(source) {}
+
+    uint32_t socketId;
+    std::shared_ptr<SlotBuffer> data;
+    UDPSocketAddress source;
+};
+
+struct Handlers {
+    std::function<void(const std::shared_ptr<Event>&)> onMessage;
+};
+
+} // namespace
+
+UDP_TEST(blockCacheReusesReleasedBlocks) {
+    auto cache = std::make_shared<UDPBlockCache>(64, 2);
+
+    void* first = cache->allocate(48);
+    cache->deallocate(first, 48);
+    UDP_CHECK(cache->allocate(32) == first);
+
+    // Oversized requests never enter the free list
+    void* large = cache->allocate(128);
+    cache->deallocate(large, 128);
+    UDP_CHECK_EQ(cache->stats().cached, 0u);
+
+    // Only maxCached blocks are kept
+    void* blocks[3] = {first, cache->allocate(64), cache->allocate(64)};
+    for (void* block : blocks) {
+        cache->deallocate(block, 64);
+    }
+    UDPBlockCacheStats stats = cache->stats();
+    UDP_CHECK_EQ(stats.cached, 2u);
+    UDP_CHECK_EQ(stats.reused, 1u);
+    UDP_CHECK_EQ(stats.allocated, 4u);
+}
+
+UDP_TEST(recycledObjectsOutliveTheirCache) {
+    auto cache = std::make_shared<UDPBlockCache>(kEventBlockSize, 16);
+    auto value = UDPMakeRecycled<std::vector<int>>(cache, 3, 7);
+    cache.reset();
+    UDP_CHECK_EQ(value->size(), 3u);
+    value.reset();
+}
+
+// Pool -> pipeline -> ring -> shared drain -> event, as steady traffic on one socket: once the
+// block cache has warmed up, no step may reach the heap
+UDP_TEST(steadyReceivePathDoesNotAllocate) {
+    auto pool = std::make_shared<UDPBufferPool>();
+    auto stats = std::make_shared<UDPSocketStats>(16);
+    stats->attach(kSocketId);
+    UDPReceivePipeline pipeline(stats, nullptr, nullptr);
+    UDPPacketRing ring(pool, 4096);
+    auto blocks = std::make_shared<UDPBlockCache>(kEventBlockSize, 8192);
+
+    // Events live on after delivery until the engine collects them; keep the last few hundred
+    std::vector<std::shared_ptr<Event>> live(512);
+    size_t nextLive = 0;
+    uint64_t delivered = 0;
+    std::unordered_map<uint32_t, Handlers> table;
+    table[kSocketId].onMessage = [&](const std::shared_ptr<Event>& event) {
+        live[nextLive] = event;
+        nextLive = (nextLive + 1) % live.size();
+        delivered++;
+    };
+    uint64_t tableVersion = 1;
+
+    UDPSocketAddress source;
+    UDPSocketAddress::fromNumericHost("10.0.0.2", 4000, source);
+    uint8_t payload[256];
+    memset(payload, 0x5A, sizeof(payload));
+
+    auto run = [&](uint64_t packets) {
+        UDPReceiveContext context = pipeline.context(kSocketId);
+        for (uint64_t i = 0; i < packets; i++) {
+            UDPBufferSlot slot = pool->acquire(sizeof(payload));
+            UDP_CHECK(slot);
+            memcpy(slot.data, payload, sizeof(payload));
+            size_t length = slot.length;
+            uint32_t route = 0;
+            std::shared_ptr<std::vector<uint8_t>> message;
+            UDP_CHECK(pipeline.process(context, slot.data, length, source, route, message) ==
+                      UDPReceiveVerdict::Deliver);
+
+            UDPPacketDescriptor descriptor;
+            descriptor.slot = slot;
+            descriptor.source = source;
+            descriptor.socketId = kSocketId;
+            descriptor.receivedNs = UDPMonotonicNowNs();
+            ring.push(descriptor);
+            // Drain every 16 packets, as a JS thread that keeps up in bursts would
+            if (i % 16 != 15) {
+                continue;
+            }
+            UDPDrainReceiveRing(ring, table, tableVersion, nullptr, &stats->receiveLatency(),
+                [](const Handlers& handlers, const UDPPacketDescriptor&) { return &handlers.onMessage; },
+                [&](const std::function<void(const std::shared_ptr<Event>&)>& onMessage,
+                    const UDPPacketDescriptor& d) {
+                    onMessage(UDPMakeRecycled<Event>(
+                        blocks, d.socketId, UDPMakeRecycled<SlotBuffer>(blocks, pool, d.slot), d.source));
+                });
+        }
+    };
+
+    run(10000);
+    bench::BenchAllocations before = allocationSnapshot();
+    uint64_t packets = test::scaled(200000);
+    uint64_t deliveredBefore = delivered;
+    run(packets);
+    bench::BenchAllocations after = allocationSnapshot();
+
+    UDP_CHECK(delivered - deliveredBefore >= packets - 16);
+    UDP_CHECK_EQ(after.count - before.count, 0u);
+    // Blocks only for the events alive at once
+    UDP_CHECK(blocks->stats().allocated <= 2 * (live.size() + 1));
+}
@@ -0,0 +1,134 @@
+#include "UDPTest.h"
+
+#include "UDPReceivePipeline.h"
+
+#include <vector>
+
+using namespace udpdirect;
+
+namespace {
+
+const uint32_t kSocketId = 1;
+
+UDPSocketAddress sender() {
+    UDPSocketAddress address;
+    UDPSocketAddress::fromNumericHost("10.0.0.2", 4000, address);
+    return address;
+}
+
+struct Run {
+    UDPReceiveVerdict verdict = UDPReceiveVerdict::Dropped;
+    size_t length = 0;
+    uint32_t route = 0;
+    std::shared_ptr<std::vector<uint8_t>> message;
+};
+
+Run process(UDPReceivePipeline& pipeline, const std::vector<uint8_t>& datagram) {
+    Run run;
+    run.length = datagram.size();
+    run.verdict = pipeline.process(pipeline.context(kSocketId), datagram.data(), run.length, sender(), run.route,
+                                   run.message);
+    return run;
+}
+
+} // namespace
+
+UDP_TEST(deliversAndCountsWithoutStages) {
+    auto stats = std::make_shared<UDPSocketStats>(16);
+    stats->attach(kSocketId);
+    UDPReceivePipeline pipeline(stats, nullptr, nullptr);
+
+    Run run = process(pipeline, std::vector<uint8_t>(100, 7));
+    UDP_CHECK(run.verdict == UDPReceiveVerdict::Deliver);
+    UDP_CHECK_EQ(run.length, 100u);
+    UDP_CHECK_EQ(run.route, 0u);
+
+    UDPSocketCountersSnapshot counters;
+    UDP_CHECK(stats->snapshot(kSocketId, counters));
+    UDP_CHECK_EQ(counters.rxPackets, 1u);
+    UDP_CHECK_EQ(counters.rxBytes, 100u);
+
+    pipeline.countDrop(pipeline.context(kSocketId), 100);
+    stats->snapshot(kSocketId, counters);
+    UDP_CHECK_EQ(counters.drops, 1u);
+}
+
+UDP_TEST(filterDropsAndRoutes) {
+    UDPReceivePipeline pipeline(nullptr, nullptr, nullptr);
+
+    UDPFilterRule magic;
+    magic.match = UDPFilterMatch::Magic;
+    magic.bytes = {0xCA, 0xFE};
+    magic.action = UDPFilterAction::Route;
+    magic.route = 2;
+    UDPFilterRule tooShort;
+    tooShort.match = UDPFilterMatch::Length;
+    tooShort.maxLength = 3;
+    tooShort.action = UDPFilterAction::Drop;
+    pipeline.setPacketFilter(kSocketId, std::make_shared<UDPPacketFilter>(
+        std::vector<UDPFilterRule>{magic, tooShort}, UDPFilterDecision{UDPFilterAction::Deliver, 0}));
+
+    Run routed = process(pipeline, {0xCA, 0xFE, 1, 2, 3});
+    UDP_CHECK(routed.verdict == UDPReceiveVerdict::Deliver);
+    UDP_CHECK_EQ(routed.route, 3u);
+
+    Run dropped = process(pipeline, {1, 2});
+    UDP_CHECK(dropped.verdict == UDPReceiveVerdict::Dropped);
+
+    Run delivered = process(pipeline, {1, 2, 3, 4, 5});
+    UDP_CHECK(delivered.verdict == UDPReceiveVerdict::Deliver);
+    UDP_CHECK_EQ(delivered.route, 0u);
+
+    // Removing the only stage leaves the socket on the fast path
+    pipeline.setPacketFilter(kSocketId, nullptr);
+    UDP_CHECK(pipeline.context(kSocketId).stages == nullptr);
+    UDP_CHECK(process(pipeline, {1, 2}).verdict == UDPReceiveVerdict::Deliver);
+}
+
+UDP_TEST(checksumStripsTrailerAndReroutesFailures) {
+    UDPReceivePipeline pipeline(nullptr, nullptr, nullptr);
+    UDPChecksumConfig config;
+    config.onFailure = {UDPFilterAction::Route, 0};
+    auto verifier = std::make_shared<UDPChecksumVerifier>(config);
+    pipeline.setChecksumVerifier(kSocketId, verifier);
+
+    std::vector<uint8_t> datagram(64, 0x11);
+    datagram.resize(68);
+    UDP_CHECK_EQ(verifier->stamp(datagram.data(), 64, datagram.size()), 68u);
+
+    Run good = process(pipeline, datagram);
+    UDP_CHECK(good.verdict == UDPReceiveVerdict::Deliver);
+    UDP_CHECK_EQ(good.length, 64u);
+    UDP_CHECK_EQ(good.route, 0u);
+
+    datagram[10] ^= 0xFF;
+    Run bad = process(pipeline, datagram);
+    UDP_CHECK(bad.verdict == UDPReceiveVerdict::Deliver);
+    UDP_CHECK_EQ(bad.length, 68u);
+    UDP_CHECK_EQ(bad.route, 1u);
+    UDP_CHECK_EQ(verifier->stats().failed, 1u);
+}
+
+UDP_TEST(reassemblesFragmentedMessages) {
+    UDPReceivePipeline pipeline(nullptr, nullptr, nullptr);
+    pipeline.setReassembler(kSocketId, std::make_shared<UDPReassembler>(UDPReassembler::Config()));
+
+    std::vector<uint8_t> message(3000);
+    for (size_t i = 0; i < message.size(); i++) {
+        message[i] = (uint8_t)i;
+    }
+    UDPFragmentBatch fragments;
+    UDP_CHECK(UDPFragmenter::fragment(message.data(), message.size(), 42, 1200, fragments));
+    UDP_CHECK(fragments.count() > 1);
+
+    Run last;
+    for (size_t i = 0; i < fragments.count(); i++) {
+        const uint8_t* start = fragments.datagrams.data() + fragments.offsets[i];
+        last = process(pipeline, std::vector<uint8_t>(start, start + fragments.lengths[i]));
+        if (i + 1 < fragments.count()) {
+            UDP_CHECK(last.verdict == UDPReceiveVerdict::Consumed);
+        }
+    }
+    UDP_CHECK(last.verdict == UDPReceiveVerdict::Reassembled);
+    UDP_CHECK(last.message && *last.message == message);
+}
@@ -0,0 +1,194 @@
+#include "UDPTest.h"
+
+#include "UDPSendScheduler.h"
+
+#include <vector>
+
+// The scheduler runs off an injected clock, so pacing is checked at exact instants
+
+using namespace udpdirect;
+
+namespace {
+
+const uint64_t kMs = 1000 * 1000;
+
+struct FakeClock {
+    uint64_t nowNs = 1000 * kMs;
+};
+
+UDPSendScheduler::Clock clockOf(FakeClock& clock) {
+    return [&clock] { return clock.nowNs; };
+}
+
+UDPEndpoint endpoint(const char* host, uint16_t port) {
+    UDPSocketAddress address;
+    UDPSocketAddress::fromNumericHost(host, port, address);
+    return UDPEndpoint::fromAddress(address);
+}
+
+UDPScheduledSend datagram(uint32_t socketId, const UDPEndpoint& destination, long tag,
+                          UDPSendPriority priority = UDPSendPriority::Normal) {
+    UDPScheduledSend send;
+    send.socketId = socketId;
+    send.destination = destination;
+    send.payload.assign(100, 0);
+    send.priority = priority;
+    send.tag = tag;
+    return send;
+}
+
+// One packet per 10 ms, no burst to speak of
+UDPRateLimit tenMsPerPacket() {
+    UDPRateLimit limit;
+    limit.packetsPerSecond = 100;
+    limit.burstPackets = 1;
+    return limit;
+}
+
+std::vector<long> tags(const std::vector<UDPScheduledSend>& sends) {
+    std::vector<long> out;
+    for (const UDPScheduledSend& send : sends) {
+        out.push_back(send.tag);
+    }
+    return out;
+}
+
+} // namespace
+
+UDP_TEST(bucketPacesASocket) {
+    FakeClock clock;
+    UDPSendScheduler scheduler(UDPSendScheduler::Config(), clockOf(clock));
+    scheduler.setRateLimit(1, tenMsPerPacket(), UDPRateLimit());
+    UDPEndpoint peer = endpoint("10.0.0.1", 9000);
+    for (long tag = 1; tag <= 3; tag++) {
+        UDPScheduledSend send = datagram(1, peer, tag);
+        UDP_CHECK(scheduler.enqueue(send));
+    }
+
+    std::vector<UDPScheduledSend> out;
+    uint64_t nextNs = scheduler.dispatchReady(out);
+    UDP_CHECK(tags(out) == std::vector<long>({1}));
+    UDP_CHECK(nextNs > clock.nowNs && nextNs <= clock.nowNs + 10 * kMs + 1);
+
+    // Not due yet: nothing goes, and the wake-up time holds
+    out.clear();
+    clock.nowNs += 5 * kMs;
+    UDP_CHECK_EQ(scheduler.dispatchReady(out), nextNs);
+    UDP_CHECK(out.empty());
+
+    clock.nowNs = nextNs;
+    UDP_CHECK(scheduler.dispatchReady(out) > clock.nowNs);
+    UDP_CHECK(tags(out) == std::vector<long>({2}));
+
+    clock.nowNs += 10 * kMs + 1;
+    out.clear();
+    UDP_CHECK_EQ(scheduler.dispatchReady(out), 0u);
+    UDP_CHECK(tags(out) == std::vector<long>({3}));
+
+    UDPSendSchedulerStats stats = scheduler.stats();
+    UDP_CHECK_EQ(stats.dispatched, 3u);
+    UDP_CHECK_EQ(stats.shaped, 2u);
+    UDP_CHECK_EQ(stats.queuedPackets, 0u);
+}
+
+UDP_TEST(blockedSocketDoesNotHoldUpOthers) {
+    FakeClock clock;
+    UDPSendScheduler scheduler(UDPSendScheduler::Config(), clockOf(clock));
+    scheduler.setRateLimit(1, tenMsPerPacket(), UDPRateLimit());
+    UDPEndpoint peer = endpoint("10.0.0.1", 9000);
+    UDPScheduledSend sends[] = {datagram(1, peer, 1), datagram(1, peer, 2), datagram(2, peer, 3), datagram(2, peer, 4)};
+    for (UDPScheduledSend& send : sends) {
+        UDP_CHECK(scheduler.enqueue(send));
+    }
+
+    std::vector<UDPScheduledSend> out;
+    scheduler.dispatchReady(out);
+    UDP_CHECK(tags(out) == std::vector<long>({1, 3, 4}));
+    UDP_CHECK_EQ(scheduler.stats().shaped, 0u);
+}
+
+UDP_TEST(blockedDestinationDoesNotHoldUpTheSocket) {
+    FakeClock clock;
+    UDPSendScheduler scheduler(UDPSendScheduler::Config(), clockOf(clock));
+    scheduler.setRateLimit(1, UDPRateLimit(), tenMsPerPacket());
+    UDPEndpoint a = endpoint("10.0.0.1", 9000);
+    UDPEndpoint b = endpoint("10.0.0.2", 9000);
+    UDPScheduledSend sends[] = {datagram(1, a, 1), datagram(1, a, 2), datagram(1, b, 3), datagram(1, a, 4),
+                                datagram(1, b, 5)};
+    for (UDPScheduledSend& send : sends) {
+        UDP_CHECK(scheduler.enqueue(send));
+    }
+
+    std::vector<UDPScheduledSend> out;
+    uint64_t nextNs = scheduler.dispatchReady(out);
+    UDP_CHECK(tags(out) == std::vector<long>({1, 3}));
+
+    // Each destination keeps its own order
+    out.clear();
+    clock.nowNs = nextNs;
+    nextNs = scheduler.dispatchReady(out);
+    UDP_CHECK(tags(out) == std::vector<long>({2, 5}));
+    out.clear();
+    clock.nowNs = nextNs;
+    UDP_CHECK_EQ(scheduler.dispatchReady(out), 0u);
+    UDP_CHECK(tags(out) == std::vector<long>({4}));
+    UDP_CHECK_EQ(scheduler.stats().shaped, 3u);
+}
+
+UDP_TEST(prioritiesAreStrictAndSocketsTakeTurns) {
+    FakeClock clock;
+    UDPSendScheduler::Config config;
+    config.maxDispatchPerRun = 2;
+    UDPSendScheduler scheduler(config, clockOf(clock));
+    UDPEndpoint peer = endpoint("10.0.0.1", 9000);
+    UDPScheduledSend sends[] = {datagram(1, peer, 1, UDPSendPriority::Bulk), datagram(1, peer, 2),
+                                datagram(1, peer, 3), datagram(1, peer, 4), datagram(2, peer, 5),
+                                datagram(3, peer, 6, UDPSendPriority::High)};
+    for (UDPScheduledSend& send : sends) {
+        UDP_CHECK(scheduler.enqueue(send));
+    }
+
+    // Budget left over after one run comes straight back
+    std::vector<UDPScheduledSend> out;
+    UDP_CHECK_EQ(scheduler.dispatchReady(out), clock.nowNs);
+    UDP_CHECK(tags(out) == std::vector<long>({6, 2}));
+    out.clear();
+    scheduler.dispatchReady(out);
+    UDP_CHECK(tags(out) == std::vector<long>({5, 3}));
+    out.clear();
+    UDP_CHECK_EQ(scheduler.dispatchReady(out), 0u);
+    UDP_CHECK(tags(out) == std::vector<long>({4, 1}));
+}
+
+UDP_TEST(forgetSocketDiscardsItsQueue) {
+    FakeClock clock;
+    UDPSendScheduler scheduler(UDPSendScheduler::Config(), clockOf(clock));
+    scheduler.setRateLimit(1, tenMsPerPacket(), UDPRateLimit());
+    UDPEndpoint peer = endpoint("10.0.0.1", 9000);
+    UDPScheduledSend sends[] = {datagram(1, peer, 1), datagram(1, peer, 2, UDPSendPriority::Bulk),
+                                datagram(2, peer, 3)};
+    for (UDPScheduledSend& send : sends) {
+        UDP_CHECK(scheduler.enqueue(send));
+    }
+
+    UDP_CHECK_EQ(scheduler.forgetSocket(1), 2u);
+    std::vector<UDPScheduledSend> out;
+    UDP_CHECK_EQ(scheduler.dispatchReady(out), 0u);
+    UDP_CHECK(tags(out) == std::vector<long>({3}));
+    UDP_CHECK_EQ(scheduler.stats().discarded, 2u);
+    UDP_CHECK_EQ(scheduler.stats().queuedBytes, 0u);
+}
+
+UDP_TEST(fullQueueRejects) {
+    FakeClock clock;
+    UDPSendScheduler::Config config;
+    config.maxQueuedPackets = 2;
+    UDPSendScheduler scheduler(config, clockOf(clock));
+    UDPEndpoint peer = endpoint("10.0.0.1", 9000);
+    UDPScheduledSend sends[] = {datagram(1, peer, 1), datagram(1, peer, 2), datagram(1, peer, 3)};
+    UDP_CHECK(scheduler.enqueue(sends[0]));
+    UDP_CHECK(scheduler.enqueue(sends[1]));
+    UDP_CHECK(!scheduler.enqueue(sends[2]));
+    UDP_CHECK_EQ(sends[2].payload.size(), 100u);
+    UDP_CHECK_EQ(scheduler.stats().rejected, 1u);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+// UDPTest - a minimal runner for the core's unit tests. UDP_TEST registers a
+// case; the UDP_CHECK macros record a failure and let the case carry on.
+// Every tests/*Test.cpp file links with UDPTestMain.cpp into its own
+// executable, which ctest runs.
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+namespace udpdirect {
+namespace test {
+
+void registerTest(const char* name, void (*run)());
+void reportFailure(const char* file, int line, const std::string& what);
+
+/**
+ * Iteration counts scale with UDP_TEST_SCALE (default 1), so soak and
+ * stress cases can be run longer than ctest runs them.
+ */
+uint64_t scaled(uint64_t iterations);
+
+template <typename A, typename B>
+void checkEqual(const A& actual, const B& expected, const char* actualText, const char* expectedText,
+                const char* file, int line) {
+    if (actual == expected) {
+        return;
+    }
+    std::ostringstream what;
+    what << actualText << " == " << expectedText << " (got " << actual << ", expected " << expected << ")";
+    reportFailure(file, line, what.str());
+}
+
+} // namespace test
+} // namespace udpdirect
+
+#define UDP_TEST(name)                                                                 \
+    static void name();                                                                \
+    static const bool name##Registered = (udpdirect::test::registerTest(#name, name), true); \
+    static void name()
+
+#define UDP_CHECK(condition)                                                      \
+    do {                                                                          \
+        if (!(condition)) {                                                       \
+            udpdirect::test::reportFailure(__FILE__, __LINE__, #condition);       \
+        }                                                                         \
+    } while (0)
+
+#define UDP_CHECK_EQ(actual, expected) \
+    udpdirect::test::checkEqual((actual), (expected), #actual, #expected, __FILE__, __LINE__)
@@ -0,0 +1,76 @@
+#include "UDPTest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace udpdirect {
+namespace test {
+
+namespace {
+
+struct TestCase {
+    const char* name;
+    void (*run)();
+};
+
+// Function-local so registration from other translation units never sees it unconstructed
+std::vector<TestCase>& registry() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+size_t g_failures = 0;
+
+} // namespace
+
+void registerTest(const char* name, void (*run)()) {
+    registry().push_back({name, run});
+}
+
+void reportFailure(const char* file, int line, const std::string& what) {
+    fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what.c_str());
+    g_failures++;
+}
+
+uint64_t scaled(uint64_t iterations) {
+    const char* scale = getenv("UDP_TEST_SCALE");
+    double factor = scale ? atof(scale) : 1.0;
+    if (factor <= 0) {
+        factor = 1.0;
+    }
+    return (uint64_t)((double)iterations * factor);
+}
+
+} // namespace test
+} // namespace udpdirect
+
+// Runs every registered case, or only those named on the command line
+int main(int argc, char** argv) {
+    using namespace udpdirect::test;
+    size_t failedCases = 0;
+    size_t ran = 0;
+    for (const TestCase& test : registry()) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++) {
+            selected = selected || strcmp(argv[i], test.name) == 0;
+        }
+        if (!selected) {
+            continue;
+        }
+        size_t failuresBefore = g_failures;
+        fprintf(stderr, "[ RUN  ] %s\n", test.name);
+        test.run();
+        bool passed = g_failures == failuresBefore;
+        fprintf(stderr, "[ %s ] %s\n", passed ? " OK " : "FAIL", test.name);
+        failedCases += passed ? 0 : 1;
+        ran++;
+    }
+    if (ran == 0) {
+        fprintf(stderr, "no test cases matched\n");
+        return 1;
+    }
+    fprintf(stderr, "%zu of %zu cases passed\n", ran - failedCases, ran);
+    return failedCases == 0 ? 0 : 1;
+}